@@ -249,7 +249,7 @@ public: // LuaEngine
 
 #define LacrimiDatabase (*(sWorld.LacrimiPtr->GetLDB()))
 
-#define g_engine (sLacrimi.L_LuaEngine)
+#define g_engine (g_luaMgr.GetCurrentEngine())
 #define g_luaMgr (*sLacrimi.L_LuaEngineMgr)
 #define LuaEvent (g_luaMgr.LuaEventMgr)
 
@@ -27,9 +27,9 @@ int LuaGameObject_GossipCreateMenu(lua_State * L, GameObject* ptr)
  	int autosend = luaL_checkint(L, 3);
 	Player* plr = (Player*)target;
 
-	objmgr.CreateGossipMenuForPlayer(&g_luaMgr.Menu, ptr->GetGUID(), text_id, plr);
+	objmgr.CreateGossipMenuForPlayer(&g_engine->Menu, ptr->GetGUID(), text_id, plr);
 	if(autosend)
-		g_luaMgr.Menu->SendTo(plr);
+		g_engine->Menu->SendTo(plr);
 
 	return 1;
 }
@@ -37,7 +37,7 @@ int LuaGameObject_GossipCreateMenu(lua_State * L, GameObject* ptr)
 int LuaGameObject_GossipMenuAddItem(lua_State * L, GameObject * ptr)
 {
 	TEST_GO();
-	if(g_luaMgr.Menu == NULL)
+	if(g_engine->Menu == NULL)
 	{
 		printf("Menu used while uninitialized!!!");
 		return 0;
@@ -47,14 +47,14 @@ int LuaGameObject_GossipMenuAddItem(lua_State * L, GameObject * ptr)
 	const char * menu_text = luaL_checkstring(L, 2);
 	int IntId = luaL_checkint(L, 3);
 
-	g_luaMgr.Menu->AddItem(icon, menu_text, IntId);
+	g_engine->Menu->AddItem(icon, menu_text, IntId);
 	return 1;
 }
 
 int LuaGameObject_GossipSendMenu(lua_State * L, GameObject * ptr)
 {
 	TEST_GO();
-	if(g_luaMgr.Menu == NULL)
+	if(g_engine->Menu == NULL)
 	{
 		printf("Menu used while uninitialized!!!");
 		return 0;
@@ -62,14 +62,14 @@ int LuaGameObject_GossipSendMenu(lua_State * L, GameObject * ptr)
 
 	Unit* target = Lunar<Unit>::check(L, 1);
 	Player * plr = (Player*)target;
-	g_luaMgr.Menu->SendTo(plr);
+	g_engine->Menu->SendTo(plr);
 	return 1;
 }
 
 int LuaGameObject_GossipComplete(lua_State * L, GameObject * ptr)
 {
 	TEST_GO();
-	if(g_luaMgr.Menu == NULL)
+	if(g_engine->Menu == NULL)
 	{
 		printf("Menu used while uninitialized!!!");
 		return 0;
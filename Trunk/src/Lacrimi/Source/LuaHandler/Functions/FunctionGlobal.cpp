@@ -139,6 +139,56 @@ int LuaGlobalFunctions_GetGameTime(lua_State * L)
 	return 1;
 }
 
+int LuaGlobalFunctions_SendStateMessage(lua_State * L)
+{
+	const char * channel = luaL_checkstring(L, 1);
+	LuaSharedValue payload;
+	if(!LuaEngineMgr::ReadSharedValue(L, 2, payload))
+		return luaL_error(L, "SendStateMessage: only nil, booleans, numbers and strings can be sent to another state.");
+
+	bool everyState = lua_isnoneornil(L, 3);
+	int32 mapId = luaL_optint(L, 3, -1);
+	uint32 instanceId = luaL_optint(L, 4, 0);
+	RET_INT(g_luaMgr.SendStateMessage(g_engine, channel, payload, everyState, mapId, instanceId));
+}
+
+int LuaGlobalFunctions_RegisterStateMessageHandler(lua_State * L)
+{
+	const char * channel = luaL_checkstring(L, 1);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+	lua_settop(L, 2);
+	g_engine->SetMessageHandler(channel, lua_ref(L, true));
+	return 0;
+}
+
+int LuaGlobalFunctions_ProcessStateMessages(lua_State * L)
+{
+	g_engine->DispatchMessages();
+	return 0;
+}
+
+int LuaGlobalFunctions_SetSharedValue(lua_State * L)
+{
+	const char * key = luaL_checkstring(L, 1);
+	LuaSharedValue value;
+	if(!LuaEngineMgr::ReadSharedValue(L, 2, value))
+		return luaL_error(L, "SetSharedValue: only nil, booleans, numbers and strings can be shared.");
+
+	g_luaMgr.SetSharedValue(key, value);
+	return 0;
+}
+
+int LuaGlobalFunctions_GetSharedValue(lua_State * L)
+{
+	const char * key = luaL_checkstring(L, 1);
+	LuaSharedValue value;
+	if(!g_luaMgr.GetSharedValue(key, value))
+		RET_NIL(true);
+
+	LuaEngineMgr::PushSharedValue(L, value);
+	return 1;
+}
+
 int LuaGlobalFunctions_WorldDBQuery(lua_State * L)
 {
 	const char * qStr = luaL_checkstring(L,1);
@@ -629,12 +679,14 @@ int LuaGlobalFunctions_bit_shiftright(lua_State * L)
 
 int LuaGlobalFunctions_RemoveTimedEvents(lua_State * L)
 {
+	WORLD_STATE_ONLY("RemoveTimedEvents");
 	LuaEvent.RemoveEvents();
 	return 1;
 }
 
 int LuaGlobalFunctions_RemoveTimedEventsWithName(lua_State * L)
 {
+	WORLD_STATE_ONLY("RemoveTimedEventsWithName");
 	const char* name = luaL_checkstring(L,1);
 	LuaEvent.RemoveEventsByName(name);
 	return 1;
@@ -642,6 +694,7 @@ int LuaGlobalFunctions_RemoveTimedEventsWithName(lua_State * L)
 
 int LuaGlobalFunctions_RemoveTimedEvent(lua_State * L)
 {
+	WORLD_STATE_ONLY("RemoveTimedEvent");
 	int ref = luaL_checkint(L,1);
 	LuaEvent.RemoveEventByRef(ref);
 	return 1;
@@ -649,6 +702,7 @@ int LuaGlobalFunctions_RemoveTimedEvent(lua_State * L)
 
 int LuaGlobalFunctions_RemoveTimedEventsInTable(lua_State * L)
 {
+	WORLD_STATE_ONLY("RemoveTimedEventsInTable");
 	const char* table = luaL_checkstring(L,1);
 	LuaEvent.RemoveEventsInTable(table);
 	return 1;
@@ -656,12 +710,14 @@ int LuaGlobalFunctions_RemoveTimedEventsInTable(lua_State * L)
 
 int LuaGlobalFunctions_HasTimedEvents(lua_State * L)
 {
+	WORLD_STATE_ONLY("HasTimedEvents");
 	lua_pushboolean(L, LuaEvent.event_HasEvents() ? 1 : 0);
 	return 1;
 }
 
 int LuaGlobalFunctions_HasTimedEvent(lua_State * L)
 {
+	WORLD_STATE_ONLY("HasTimedEvent");
 	int ref = luaL_checkint(L,1);
 	lua_pushboolean(L, LuaEvent.HasEvent(ref) ? 1 : 0);
 	return 1;
@@ -669,6 +725,7 @@ int LuaGlobalFunctions_HasTimedEvent(lua_State * L)
 
 int LuaGlobalFunctions_HasTimedEventWithName(lua_State * L)
 {
+	WORLD_STATE_ONLY("HasTimedEventWithName");
 	const char * name = luaL_checkstring(L,1);
 	lua_pushboolean(L, LuaEvent.HasEventWithName(name) ? 1 : 0);
 	return 1;
@@ -676,6 +733,7 @@ int LuaGlobalFunctions_HasTimedEventWithName(lua_State * L)
 
 int LuaGlobalFunctions_HasTimedEventInTable(lua_State * L)
 {
+	WORLD_STATE_ONLY("HasTimedEventInTable");
 	const char * table = luaL_checkstring(L,1);
 	lua_pushboolean(L, LuaEvent.HasEventInTable(table) ? 1 : 0);
 	return 1;
@@ -22,6 +22,11 @@
 
 int LuaGlobalFunctions_PerformIngameSpawn(lua_State * L);
 int LuaGlobalFunctions_GetGameTime(lua_State * L);
+int LuaGlobalFunctions_SendStateMessage(lua_State * L);
+int LuaGlobalFunctions_RegisterStateMessageHandler(lua_State * L);
+int LuaGlobalFunctions_ProcessStateMessages(lua_State * L);
+int LuaGlobalFunctions_SetSharedValue(lua_State * L);
+int LuaGlobalFunctions_GetSharedValue(lua_State * L);
 int LuaGlobalFunctions_WorldDBQuery(lua_State * L);
 int LuaGlobalFunctions_CharDBQuery(lua_State * L);
 int LuaGlobalFunctions_WorldDBQueryTable(lua_State * L);
@@ -31,9 +31,9 @@ int luaItem_GossipCreateMenu(lua_State * L, Item * ptr)
 
 	int autosend = luaL_checkint(L, 3);
 	Player* plr = TO_PLAYER(target);
-	objmgr.CreateGossipMenuForPlayer(&g_luaMgr.Menu, ptr->GetGUID(), text_id, plr);
+	objmgr.CreateGossipMenuForPlayer(&g_engine->Menu, ptr->GetGUID(), text_id, plr);
 	if(autosend)
-		g_luaMgr.Menu->SendTo(plr);
+		g_engine->Menu->SendTo(plr);
 	return 1;
 }
 
@@ -43,10 +43,10 @@ int luaItem_GossipMenuAddItem(lua_State * L, Item * ptr)
 	int icon = luaL_checkint(L, 1);
 	const char * menu_text = luaL_checkstring(L, 2);
 	int IntId = luaL_checkint(L, 3);
-	if((menu_text == NULL) || g_luaMgr.Menu == NULL)
+	if((menu_text == NULL) || g_engine->Menu == NULL)
 		RET_NIL(true);
 
-	g_luaMgr.Menu->AddItem(icon, menu_text, IntId);
+	g_engine->Menu->AddItem(icon, menu_text, IntId);
 	return 1;
 }
 
@@ -58,7 +58,7 @@ int luaItem_GossipSendMenu(lua_State * L, Item * ptr)
 		RET_NIL(true);
 
 	Player * plr = TO_PLAYER(target);
-	g_luaMgr.Menu->SendTo(plr);
+	g_engine->Menu->SendTo(plr);
 	return 1;
 }
 
@@ -109,9 +109,9 @@ int luaItem_GossipSendQuickMenu(lua_State * L, Item * ptr)
 	Item->Text = luaL_checkstring( L, 5 );
 	Item->BoxMoney = luaL_checkint( L, 6 );
 	Item->BoxMessage = luaL_checkstring( L, 7 );
-	objmgr.CreateGossipMenuForPlayer(&g_luaMgr.Menu, ptr->GetGUID(), text_id, player);
-	g_luaMgr.Menu->AddItem(Item);
-	g_luaMgr.Menu->SendTo(player);
+	objmgr.CreateGossipMenuForPlayer(&g_engine->Menu, ptr->GetGUID(), text_id, player);
+	g_engine->Menu->AddItem(Item);
+	g_engine->Menu->SendTo(player);
 	return 1;
 }
 
@@ -29,15 +29,15 @@ int LuaUnit_GossipCreateMenu(lua_State * L, Unit * ptr)
 
 	Player* plr = TO_PLAYER(target);
 	int autosend = luaL_checkint(L, 3);
-	objmgr.CreateGossipMenuForPlayer(&g_luaMgr.Menu, ptr->GetGUID(), text_id, plr);
+	objmgr.CreateGossipMenuForPlayer(&g_engine->Menu, ptr->GetGUID(), text_id, plr);
 	if(autosend)
-		g_luaMgr.Menu->SendTo(plr);
+		g_engine->Menu->SendTo(plr);
 	return 1;
 }
 
 int LuaUnit_GossipMenuAddItem(lua_State * L, Unit * ptr)
 {
-	if(g_luaMgr.Menu == NULL)
+	if(g_engine->Menu == NULL)
 	{
 		printf("Menu used while uninitialized!!!");
 		return 0;
@@ -47,13 +47,13 @@ int LuaUnit_GossipMenuAddItem(lua_State * L, Unit * ptr)
 	const char * menu_text = luaL_checkstring(L, 2);
 	int IntId = luaL_checkint(L, 3);
 
-	g_luaMgr.Menu->AddItem(icon, menu_text, IntId);
+	g_engine->Menu->AddItem(icon, menu_text, IntId);
 	return 1;
 }
 
 int LuaUnit_GossipSendMenu(lua_State * L, Unit * ptr)
 {
-	if(g_luaMgr.Menu == NULL)
+	if(g_engine->Menu == NULL)
 	{
 		printf("Menu used while uninitialized!!!");
 		return 0;
@@ -64,7 +64,7 @@ int LuaUnit_GossipSendMenu(lua_State * L, Unit * ptr)
 		RET_NIL(false);
 
 	Player * plr = TO_PLAYER(target);
-	g_luaMgr.Menu->SendTo(plr);
+	g_engine->Menu->SendTo(plr);
 	return 1;
 }
 
@@ -341,7 +341,7 @@ int LuaUnit_RegisterEvent(lua_State * L, Unit * ptr)
 	{
 		Creature * creature = TO_CREATURE(ptr);
 		sEventMgr.AddEvent(creature, &Creature::TriggerScriptEvent, functionRef, EVENT_LUA_CREATURE_EVENTS, delay, repeats, EVENT_FLAG_DO_NOT_EXECUTE_IN_WORLD_CONTEXT);
-		std::map< uint64,std::set<int> > & objRefs = g_luaMgr.getObjectFunctionRefs();
+		std::map< uint64,std::set<int> > & objRefs = g_engine->getObjectFunctionRefs();
 		std::map< uint64,std::set<int> >::iterator itr = objRefs.find(ptr->GetGUID());
 		if(itr == objRefs.end() )
 		{
@@ -364,6 +364,7 @@ calls the wanted function  with the wanted arguments */
 int LuaUnit_CreateLuaEvent(lua_State * L, Unit * ptr)
 {
 	TEST_UNITPLAYER_RET();
+	WORLD_STATE_ONLY("CreateLuaEvent");
 
 	const char * typeName = luaL_typename(L,1);
 	int delay = luaL_checkint(L,2);
@@ -382,7 +383,7 @@ int LuaUnit_CreateLuaEvent(lua_State * L, Unit * ptr)
 	{
 		TimedEvent * ev = TimedEvent::Allocate(ptr,new CallbackP1<LuaEngineMgr,int>(&g_luaMgr,&LuaEngineMgr::CallFunctionByReference,functionRef),EVENT_LUA_CREATURE_EVENTS,delay,repeats);
 		ptr->event_AddEvent(ev);
-		std::map< uint64,std::set<int> > & objRefs = g_luaMgr.getObjectFunctionRefs();
+		std::map< uint64,std::set<int> > & objRefs = g_engine->getObjectFunctionRefs();
 		std::map< uint64,std::set<int> >::iterator itr = objRefs.find(ptr->GetGUID());
 		if(itr == objRefs.end() )
 		{
@@ -404,7 +405,7 @@ int LuaUnit_RemoveEvents(lua_State * L, Unit * ptr)
 	TEST_UNITPLAYER();
 	sEventMgr.RemoveEvents(ptr, EVENT_LUA_CREATURE_EVENTS);
 	//Unref all contained references
-	std::map< uint64,std::set<int> > & objRefs = g_luaMgr.getObjectFunctionRefs();
+	std::map< uint64,std::set<int> > & objRefs = g_engine->getObjectFunctionRefs();
 	std::map< uint64,std::set<int> >::iterator itr = objRefs.find(ptr->GetGUID());
 	if(itr != objRefs.end() )
 	{
@@ -796,6 +796,11 @@ void Lua_RegisterGlobalFunctions(lua_State *L)
 	lua_register(L, "HasTimedEventInTable", &LuaGlobalFunctions_HasTimedEventInTable);
 	lua_register(L, "HasTimedEventWithName", &LuaGlobalFunctions_HasTimedEventWithName);
 	lua_register(L, "HasTimedEvent", &LuaGlobalFunctions_HasTimedEvent);
+	lua_register(L, "SendStateMessage", &LuaGlobalFunctions_SendStateMessage);
+	lua_register(L, "RegisterStateMessageHandler", &LuaGlobalFunctions_RegisterStateMessageHandler);
+	lua_register(L, "ProcessStateMessages", &LuaGlobalFunctions_ProcessStateMessages);
+	lua_register(L, "SetSharedValue", &LuaGlobalFunctions_SetSharedValue);
+	lua_register(L, "GetSharedValue", &LuaGlobalFunctions_GetSharedValue);
 	lua_register(L, "GetPlatform", &LuaGlobalFunctions_GetPlatform);
 	lua_register(L, "NumberToGUID", &LuaGlobalFunctions_NumberToGUID);
 	lua_register(L, "SendPacketToWorld", &LuaGlobalFunctions_SendPacketToWorld);
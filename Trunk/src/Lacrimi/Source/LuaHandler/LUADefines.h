@@ -165,7 +165,25 @@ enum CustomLuaEvenTypes
 };
 
 struct LUALoadScripts { set<string> luaFiles; };
-struct EventInfoHolder { const char * funcName; TimedEvent * te; };
+// funcRef and selfRef are registry refs to the resolved function and, for a
+// Table:Func name, the table it is called on; LUA_NOREF until resolved
+struct EventInfoHolder { const char * funcName; TimedEvent * te; int funcRef; int selfRef; };
+// A value that can be copied between Lua states, tables and functions can't
+struct LuaSharedValue
+{
+	int type;
+	double number;
+	std::string str;
+};
+
+struct LuaStateMessage
+{
+	std::string channel;
+	LuaSharedValue payload;
+	int32 fromMap;
+	uint32 fromInstance;
+};
+
 struct LuaUnitBinding { uint16 Functions[CREATURE_EVENT_COUNT]; };
 struct LuaGameObjectBinding { uint16 Functions[GAMEOBJECT_EVENT_COUNT]; };
 struct LuaQuestBinding { uint16 Functions[QUEST_EVENT_COUNT]; };
@@ -237,8 +255,15 @@ template<> const char * GetTClassName<Aura>();
 #define CHECK_BOOL(L,narg) (lua_toboolean((L),(narg)) > 0) ? true : false
 #define CREATE_L_PTR lua_State* L = GLuas();
 
-#define GET_LOCK g_luaMgr.Lock();
-#define RELEASE_LOCK g_luaMgr.Unlock();
+// The state locked here stays the calling thread's g_engine until the matching RELEASE_LOCK
+#define GET_LOCK LuaEngine * lockedPrevious = g_luaMgr.AcquireEngine();
+#define RELEASE_LOCK g_luaMgr.ReleaseEngine(lockedPrevious);
+
+// Timers and coroutines are run by the world thread against the world state. A map
+// state skips them while its scripts load, the world state has them already.
+#define WORLD_STATE_ONLY(name) if(g_engine->IsMapState()) { \
+	if(g_engine->IsLoading()) return 0; \
+	return luaL_error(L, "%s can only be used by the world Lua state, use SendStateMessage from map states.", name); }
 #define CHECK_BINDING_ACQUIRELOCK GET_LOCK if(m_binding == NULL) { RELEASE_LOCK return; }
 
 #endif // __LUA_DEFINES_H
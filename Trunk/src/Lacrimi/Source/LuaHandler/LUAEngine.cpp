@@ -16,13 +16,19 @@
 
 #include "LacrimiStdAfx.h"
 
-LuaEngine::LuaEngine()
+LuaEngine::LuaEngine(MapMgr * mapMgr, uint32 generation) : m_mapMgr(mapMgr), m_generation(generation), m_loading(false), m_hasMessages(false), Menu(NULL)
 {
 	L = lua_open();
+	memset(m_hookRegistrations, 0, sizeof(m_hookRegistrations));
 }
 
 LuaEngine::~LuaEngine()
 {
+	m_inboxLock.Acquire();
+	for(std::deque<LuaStateMessage*>::iterator itr = m_inbox.begin(); itr != m_inbox.end(); ++itr)
+		delete (*itr);
+	m_inbox.clear();
+	m_inboxLock.Release();
 	lua_close(L);
 }
 
@@ -134,6 +140,7 @@ void LuaEngine::LoadScripts()
 	ScriptLoadDir(((char*)sWorld.LuaScriptPath.c_str()), &rtn);
 
 	unsigned int cnt_uncomp = 0;
+	m_loading = true;
 	luaL_openlibs(L);
 	RegisterCoreFunctions();
 	Log.Notice("LuaEngine", "Loading Scripts...");
@@ -160,7 +167,83 @@ void LuaEngine::LoadScripts()
 		}
 		cnt_uncomp++;
 	}
-	Log.Notice("LuaEngine","Loaded %u Lua scripts.", cnt_uncomp);
+	m_loading = false;
+	if(m_mapMgr != NULL)
+		Log.Notice("LuaEngine","Loaded %u Lua scripts for map %u instance %u.", cnt_uncomp, m_mapMgr->GetMapId(), m_mapMgr->GetInstanceID());
+	else
+		Log.Notice("LuaEngine","Loaded %u Lua scripts.", cnt_uncomp);
+}
+
+void LuaEngine::MapReference(uint16 worldRef, uint16 localRef, bool replace)
+{
+	if(worldRef == 0)
+	{
+		// Nothing in the world state to stand in for
+		lua_unref(L, localRef);
+		return;
+	}
+
+	HM_NAMESPACE::hash_map<uint16, uint16>::iterator itr = m_refMap.find(worldRef);
+	if(itr != m_refMap.end())
+	{
+		if(!replace)
+		{
+			lua_unref(L, localRef);
+			return;
+		}
+		lua_unref(L, itr->second);
+		itr->second = localRef;
+	}
+	else
+		m_refMap.insert(make_pair(worldRef, localRef));
+}
+
+void LuaEngine::PostMessage(LuaStateMessage * msg)
+{
+	m_inboxLock.Acquire();
+	m_inbox.push_back(msg);
+	m_hasMessages = true;
+	m_inboxLock.Release();
+}
+
+void LuaEngine::SetMessageHandler(const char * channel, int ref)
+{
+	std::map<std::string, int>::iterator itr = m_messageHandlers.find(channel);
+	if(itr != m_messageHandlers.end())
+	{
+		lua_unref(L, itr->second);
+		itr->second = ref;
+	}
+	else
+		m_messageHandlers.insert(make_pair(std::string(channel), ref));
+}
+
+void LuaEngine::DispatchMessages()
+{
+	std::deque<LuaStateMessage*> messages;
+	m_inboxLock.Acquire();
+	messages.swap(m_inbox);
+	m_hasMessages = false;
+	m_inboxLock.Release();
+
+	for(std::deque<LuaStateMessage*>::iterator itr = messages.begin(); itr != messages.end(); ++itr)
+	{
+		LuaStateMessage * msg = *itr;
+		std::map<std::string, int>::iterator handler = m_messageHandlers.find(msg->channel);
+		if(handler != m_messageHandlers.end())
+		{
+			int top = lua_gettop(L);
+			lua_getref(L, handler->second);
+			lua_pushstring(L, msg->channel.c_str());
+			LuaEngineMgr::PushSharedValue(L, msg->payload);
+			lua_pushinteger(L, msg->fromMap);
+			lua_pushinteger(L, msg->fromInstance);
+			if(lua_pcall(L, 4, 0, 0))
+				report(L);
+			lua_settop(L, top);
+		}
+		delete msg;
+	}
 }
 
 /*******************************************************************************
@@ -168,6 +251,29 @@ void LuaEngine::LoadScripts()
 *******************************************************************************/
 void LuaEngine::BeginCall(uint16 fReference)
 {
+	if(m_hasMessages)
+		DispatchMessages();
+
+	lua_settop(L, 0); //stack should be empty
+	if(m_mapMgr != NULL)
+	{
+		// Binding refs belong to the world state
+		HM_NAMESPACE::hash_map<uint16, uint16>::iterator itr = m_refMap.find(fReference);
+		if(itr == m_refMap.end())
+		{
+			lua_pushnil(L);
+			return;
+		}
+		fReference = itr->second;
+	}
+	lua_getref(L, fReference);
+}
+
+void LuaEngine::BeginLocalCall(int fReference)
+{
+	if(m_hasMessages)
+		DispatchMessages();
+
 	lua_settop(L, 0); //stack should be empty
 	lua_getref(L, fReference);
 }
@@ -384,6 +490,7 @@ template<> const char * GetTClassName<Aura>() { return "LuaAura"; }
 	*/
 int Lua_CreateLuaEvent(lua_State * L)
 {
+	WORLD_STATE_ONLY("CreateLuaEvent");
 	int delay = luaL_checkinteger(L,2);
 	int repeats = luaL_checkinteger(L,3);
 	if(!strcmp(luaL_typename(L,1),"function") || delay > 0)
@@ -404,6 +511,7 @@ int Lua_CreateLuaEvent(lua_State * L)
 
 int Lua_DestroyLuaEvent(lua_State * L)
 {
+	WORLD_STATE_ONLY("DestroyLuaEvent");
 	//Simply remove the reference, CallFunctionByReference will find the reference has been freed and skip any processing.
 	int ref = luaL_checkinteger(L,1);
 	lua_unref(L,ref);
@@ -414,6 +522,7 @@ int Lua_DestroyLuaEvent(lua_State * L)
 
 int Lua_ModifyLuaEventInterval(lua_State * L)
 {
+	WORLD_STATE_ONLY("ModifyLuaEventInterval");
 	int ref = luaL_checkinteger(L,1);
 	int newinterval = luaL_checkinteger(L,2);
 	ref+= LUA_EVENTS_END;
@@ -495,7 +604,7 @@ int Lua_RegisterDummySpell(lua_State * L)
 	if(!entry || typeName == NULL)
 		return 0;
 
-	if(g_luaMgr.m_luaDummySpells.find(entry) != g_luaMgr.m_luaDummySpells.end())
+	if(!g_engine->IsMapState() && g_luaMgr.m_luaDummySpells.find(entry) != g_luaMgr.m_luaDummySpells.end())
 		luaL_error(L, "LuaEngineMgr : RegisterDummySpell failed! Spell %d already has a registered Lua function!", entry);
 	if(!strcmp(typeName, "function"))
 		functionRef = (uint16)lua_ref(L, true);
@@ -595,6 +704,7 @@ int Lua_RegisterGOGossipEvent(lua_State * L)
 
 int Lua_SuspendLuaThread(lua_State * L)
 {
+	WORLD_STATE_ONLY("SuspendThread");
 	lua_State * thread = (lua_isthread(L,1)) ? lua_tothread(L,1) : NULL;
 	if(thread == NULL)
 		return luaL_error(L,"LuaEngineMgr","SuspendLuaThread expected Lua coroutine, got NULL.");
@@ -620,6 +730,7 @@ int Lua_SuspendLuaThread(lua_State * L)
 
 int Lua_RegisterTimedEvent(lua_State * L) //in this case, L == lu
 {
+	WORLD_STATE_ONLY("RegisterTimedEvent");
 	const char * funcName = strdup(luaL_checkstring(L,1));
 	int delay = luaL_checkint(L,2);
 	int repeats = luaL_checkint(L,3);
@@ -642,6 +753,8 @@ int Lua_RegisterTimedEvent(lua_State * L) //in this case, L == lu
 	EventInfoHolder * ek = new EventInfoHolder;
 	ek->funcName = funcName;
 	ek->te = te;
+	ek->funcRef = ek->selfRef = LUA_NOREF;
+	g_luaMgr.CacheTimedEventFunction(L, ek);
 	g_luaMgr.m_registeredTimedEvents.insert( make_pair(ref, ek) );
 	LuaEvent.event_AddEvent(te);
 	lua_settop(L,0);
@@ -651,6 +764,7 @@ int Lua_RegisterTimedEvent(lua_State * L) //in this case, L == lu
 
 int Lua_RemoveTimedEvents(lua_State * L) //in this case, L == lu
 {
+	WORLD_STATE_ONLY("RemoveTimedEvents");
 	LuaEvent.RemoveEvents();
 	return 1;
 }
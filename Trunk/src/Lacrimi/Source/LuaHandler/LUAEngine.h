@@ -17,17 +17,59 @@
 #ifndef __LUAENGINE_H
 #define __LUAENGINE_H
 
+/************************************************************************/
+/* Lua states                                                           */
+/************************************************************************/
+// There is always the world state, owned by LuaEngineMgr. With per map states
+// enabled every map thread also gets a state of its own, loaded with the same
+// scripts the first time a hook fires on that thread. Only the map's thread
+// ever runs it, so hooks on different maps no longer wait on each other.
+// Bindings keep the refs of the world state, a map state translates them to
+// its own copy of the same function.
+
 class LuaEngine
 {
 private:
 	lua_State *L;
 	Mutex m_Lock, co_lock;
 
+	MapMgr * m_mapMgr;
+	uint32 m_generation;
+	bool m_loading;
+
+	HM_NAMESPACE::hash_map<uint16, uint16> m_refMap;
+	uint32 m_hookRegistrations[NUM_SERVER_HOOKS];
+
+	Mutex m_inboxLock;
+	std::deque<LuaStateMessage*> m_inbox;
+	volatile bool m_hasMessages;
+	std::map<std::string, int> m_messageHandlers;
+
+	std::map< uint64,std::set<int> > m_objectFunctionRefs;
+
 public:
-	LuaEngine();
+	LuaEngine(MapMgr * mapMgr = NULL, uint32 generation = 0);
 	~LuaEngine();
 
+	GossipMenu *Menu;
+
 	HEARTHSTONE_INLINE lua_State* GetMainLuaState() { return L; }
+	HEARTHSTONE_INLINE bool IsMapState() { return m_mapMgr != NULL; }
+	HEARTHSTONE_INLINE MapMgr * GetMapMgr() { return m_mapMgr; }
+	HEARTHSTONE_INLINE uint32 GetGeneration() { return m_generation; }
+	HEARTHSTONE_INLINE bool IsLoading() { return m_loading; }
+	HEARTHSTONE_INLINE std::map< uint64,std::set<int> > & getObjectFunctionRefs() { return m_objectFunctionRefs; }
+
+	// Map states: records that worldRef is localRef in this state
+	void MapReference(uint16 worldRef, uint16 localRef, bool replace = true);
+	// Map states: how many times a server hook was registered while loading
+	HEARTHSTONE_INLINE uint32 NextHookRegistration(uint32 evt) { return m_hookRegistrations[evt]++; }
+
+	// Messages from other states, run before the next hook in this state
+	void PostMessage(LuaStateMessage * msg);
+	void DispatchMessages();
+	void SetMessageHandler(const char * channel, int ref);
+
 	void LoadScripts();
 	void ScriptLoadDir(char* Dirname, LUALoadScripts *pak);
 	void Shutdown();
@@ -37,6 +79,7 @@ public:
 	HEARTHSTONE_INLINE Mutex& GetLock() { return m_Lock; }
 
 	void BeginCall(uint16);
+	void BeginLocalCall(int);
 	bool ExecuteCall(uint8 params = 0,uint8 res = 0);
 	void EndCall(uint8 res = 0);
 
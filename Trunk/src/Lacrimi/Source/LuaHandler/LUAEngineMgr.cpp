@@ -16,49 +16,93 @@
 
 #include "LacrimiStdAfx.h"
 
-// Hyper as in Hyperactive, Jk, its Hypersniper.
-void LuaEngineMgr::HyperCallFunction(const char * FuncName, int ref)
+// Walks a dotted name such as "Boss.Phases.OnTick" from _G. Pushes the function,
+// followed by the table it belongs to for a "Table:Func" name, and returns how
+// many values were pushed; 0 leaves the stack untouched.
+int LuaEngineMgr::PushFunctionByName(lua_State * L, const char * FuncName)
 {
-	CREATE_L_PTR;
-	string sFuncName = string(FuncName);
+	int base = lua_gettop(L);
+	if (strpbrk(FuncName, ".:") == NULL )
+	{
+		lua_getglobal(L, FuncName); //stack: function
+		if (lua_isfunction(L, -1) && !lua_iscfunction(L, -1))
+			return 1;
+		lua_settop(L, base);
+		return 0;
+	}
+
 	char *copy = strdup(FuncName);
-	char *token = strtok(copy, ".:");
-	int top = 1;
-	bool colon = false;
-	//REMEMBER: top is always 1
-	lua_settop(L, 0); //stack should be empty
-	if (strpbrk(FuncName, ".:") == NULL ) //stack: empty
-		lua_getglobal(L, FuncName);  //stack: function
-	else
+	lua_getglobal(L, "_G"); //start out with the global table.  //stack: _G
+	for (char *token = strtok(copy, ".:"); token != NULL; token = strtok(NULL, ".:"))
 	{
-		lua_getglobal(L, "_G"); //start out with the global table.  //stack: _G
-		while (token != NULL)
+		//the separator in front of the token tells us if it's a method call
+		bool colon = (token != copy && FuncName[token - copy - 1] == ':');
+		lua_getfield(L, -1, token); //stack: _G/subt, subtable/func/nil
+		if (lua_isfunction(L, -1) && !lua_iscfunction(L, -1))
 		{
-			lua_getfield(L, -1, token); //get the (hopefully) table/func  //stack: _G, subtable/func/nil
-			if ((int)sFuncName.find(token)-1 > 0) //if it isn't the first token
+			free((void*)copy);
+			if (colon)
 			{
-				if (sFuncName.at(sFuncName.find(token)-1) == ':')
-					colon = true;
-			}
-
-			if (lua_isfunction(L, -1) && !lua_iscfunction(L, -1)) //if it's a Lua function //stack: _G/subt, func
-			{
-				if (colon) //stack: subt, func
-				{
-					lua_pushvalue(L, -2); //make the table the first arg //stack: subt, func, subt
-					lua_remove(L, top); //stack: func, subt
-				}
-				else
-					lua_replace(L, top); //stack: func
-				break; //we don't need anything else
-			}
-			else if(lua_istable(L, -1) ) //stack: _G/subt, subtable
-			{
-				token = strtok(NULL, ".:"); //stack: _G/subt, subtable
-				lua_replace(L, top); //stack: subtable
+				lua_insert(L, -2); //stack: func, subt
+				return 2;
 			}
+			lua_replace(L, -2); //stack: func
+			return 1;
 		}
+		if (!lua_istable(L, -1))
+			break;
+		lua_replace(L, -2); //stack: subtable
+	}
+	free((void*)copy);
+	lua_settop(L, base);
+	return 0;
+}
+
+bool LuaEngineMgr::CacheTimedEventFunction(lua_State * L, EventInfoHolder * ek)
+{
+	int pushed = PushFunctionByName(L, ek->funcName);
+	if (pushed == 0)
+		return false;
+	if (pushed == 2)
+		ek->selfRef = luaL_ref(L, LUA_REGISTRYINDEX);
+	ek->funcRef = luaL_ref(L, LUA_REGISTRYINDEX);
+	return true;
+}
+
+void LuaEngineMgr::FreeTimedEvent(int ref, EventInfoHolder * ek)
+{
+	CREATE_L_PTR;
+	free((void*)ek->funcName);
+	if (ek->funcRef != LUA_NOREF)
+		luaL_unref(L, LUA_REGISTRYINDEX, ek->funcRef);
+	if (ek->selfRef != LUA_NOREF)
+		luaL_unref(L, LUA_REGISTRYINDEX, ek->selfRef);
+	luaL_unref(L, LUA_REGISTRYINDEX, ref);
+	delete ek;
+}
+
+// Hyper as in Hyperactive, Jk, its Hypersniper.
+void LuaEngineMgr::HyperCallFunction(const char * FuncName, int ref)
+{
+	CREATE_L_PTR;
+	hash_map<int, EventInfoHolder*>::iterator itr = m_registeredTimedEvents.find(ref);
+	if (itr == m_registeredTimedEvents.end())
+		return;
+
+	// The name is resolved once, functions defined after RegisterTimedEvent was called are picked up here
+	EventInfoHolder * ek = itr->second;
+	if (ek->funcRef == LUA_NOREF)
+		CacheTimedEventFunction(L, ek);
+
+	lua_settop(L, 0); //stack should be empty
+	lua_rawgeti(L, LUA_REGISTRYINDEX, ek->funcRef); //stack: func, nil if it never resolved and pcall reports it
+	int self = 0;
+	if (ek->selfRef != LUA_NOREF)
+	{
+		lua_rawgeti(L, LUA_REGISTRYINDEX, ek->selfRef); //stack: func, subt
+		self = 1;
 	}
+
 	lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
 	lua_State * M = lua_tothread(L, -1); //repeats, args
 	int thread = lua_gettop(L);
@@ -77,10 +121,8 @@ void LuaEngineMgr::HyperCallFunction(const char * FuncName, int ref)
 	{
 		if (--repeats == 0) //free stuff, then
 		{
-			free((void*)FuncName);
-			luaL_unref(L, LUA_REGISTRYINDEX, ref);
-			hash_map<int, EventInfoHolder*>::iterator itr = g_luaMgr.m_registeredTimedEvents.find(ref);
-			g_luaMgr.m_registeredTimedEvents.erase(itr);
+			m_registeredTimedEvents.erase(itr);
+			FreeTimedEvent(ref, ek);
 		}
 		else
 		{
@@ -90,10 +132,9 @@ void LuaEngineMgr::HyperCallFunction(const char * FuncName, int ref)
 		}
 	}
 	lua_remove(L, thread); //now we can remove the thread object
-	int r = lua_pcall(L, nargs+(colon ? 1 : 0), 0, 0);
+	int r = lua_pcall(L, nargs+self, 0, 0);
 	if (r)
 		report(L);
-	free((void*)copy);
 	lua_settop(L, 0);
 }
 
@@ -189,7 +230,23 @@ void LuaEngineMgr::Restart(ScriptMgr* sMgr)
 {
 	Log.Notice("LuaEngineMgr", "Restarting Engine.");
 	CREATE_L_PTR;
-	g_engine->getcoLock().Acquire();
+	m_engine->getcoLock().Acquire();
+	m_engine->GetLock().Acquire();
+
+	// Map states reload on their next hook, let the ones running a hook finish first
+	++m_stateGeneration;
+	std::vector<LuaEngine*> mapStates;
+	m_mapStateLock.Acquire();
+	for(std::map<MapMgr*, LuaEngine*>::iterator itr = m_mapStates.begin(); itr != m_mapStates.end(); ++itr)
+		mapStates.push_back(itr->second);
+	m_mapStateLock.Release();
+	// They're only ever deleted under the co lock
+	for(std::vector<LuaEngine*>::iterator itr = mapStates.begin(); itr != mapStates.end(); ++itr)
+	{
+		(*itr)->GetLock().Acquire();
+		(*itr)->GetLock().Release();
+	}
+
 	Unload();
 	m_engine->LoadScripts();
 	for(UnitBindingMap::iterator itr = m_unitBinding.begin(); itr != m_unitBinding.end(); ++itr)
@@ -377,8 +434,8 @@ void LuaEngineMgr::Restart(ScriptMgr* sMgr)
 			g_luaMgr.HookInfo.dummyHooks.push_back(itr->first);
 		}
 	}
-	RELEASE_LOCK
-	g_engine->getcoLock().Release();
+	m_engine->GetLock().Release();
+	m_engine->getcoLock().Release();
 
 	//hyper: do OnSpawns for spawned creatures.
 	vector<uint32> temp = OnLoadInfo;
@@ -409,10 +466,11 @@ void LuaEngineMgr::Restart(ScriptMgr* sMgr)
 
 void LuaEngineMgr::CallFunctionByReference(int ref)
 {
-	CREATE_L_PTR;
-	lua_getref(L, ref);
-	if(lua_pcall(L, 0, 0, 0))
-		report(L);
+	// Lua events are world state refs, whichever thread the event fires on
+	LuaEngine * previous = AcquireWorldEngine();
+	g_engine->BeginLocalCall(ref);
+	g_engine->ExecuteCall();
+	ReleaseEngine(previous);
 }
 
 void LuaEngineMgr::DestroyAllLuaEvents()
@@ -434,9 +492,16 @@ void LuaEngineMgr::Startup()
 	m_engine = new LuaEngine();
 	sLacrimi.LuaEngineIsStarting = true;
 	m_engine->LoadScripts();
-	g_engine = m_engine;
+	sLacrimi.L_LuaEngine = m_engine;
 	sLacrimi.LuaEngineIsStarting = false;
 
+	m_perMapStates = sLacrimi.GetConfigBool("LuaEngine", "PerMapStates", false);
+	if(m_perMapStates)
+	{
+		sLacrimi.GetScriptMgr()->register_hook(SERVER_HOOK_EVENT_ON_MAP_SHUTDOWN, (void*)&Lua_OnMapShutdown);
+		Log.Notice("LuaEngineMgr", "Map threads will load their own Lua state.");
+	}
+
 	// stuff is registered, so lets go ahead and make our emulated C++ scripted lua classes.
 	for(UnitBindingMap::iterator itr = m_unitBinding.begin(); itr != m_unitBinding.end(); ++itr)
 		sLacrimi.GetScriptMgr()->register_creature_script( itr->first, CreateLuaCreature );
@@ -464,6 +529,13 @@ void LuaEngineMgr::Startup()
 
 void LuaEngineMgr::RegisterEvent(uint8 regtype, uint32 id, uint32 evt, uint16 functionRef) 
 {
+	LuaEngine * engine = g_engine;
+	if(engine->IsMapState())
+	{
+		_RegisterMapStateEvent(engine, regtype, id, evt, functionRef);
+		return;
+	}
+
 	switch(regtype) 
 	{
 		case REGTYPE_UNIT: 
@@ -619,6 +691,302 @@ void LuaEngineMgr::RegisterEvent(uint8 regtype, uint32 id, uint32 evt, uint16 fu
 	}
 }
 
+void LuaEngineMgr::_RegisterMapStateEvent(LuaEngine * engine, uint8 regtype, uint32 id, uint32 evt, uint16 functionRef)
+{
+	// The world state loaded the same scripts first, find the ref it holds for this registration
+	uint16 worldRef = 0;
+	bool replace = true;
+	switch(regtype)
+	{
+	case REGTYPE_UNIT:
+		{
+			LuaUnitBinding * bind = GetUnitBinding(id);
+			if(bind != NULL && evt < CREATURE_EVENT_COUNT)
+				worldRef = bind->Functions[evt];
+		}break;
+	case REGTYPE_GO:
+		{
+			LuaGameObjectBinding * bind = GetGameObjectBinding(id);
+			if(bind != NULL && evt < GAMEOBJECT_EVENT_COUNT)
+				worldRef = bind->Functions[evt];
+		}break;
+	case REGTYPE_QUEST:
+		{
+			LuaQuestBinding * bind = GetQuestBinding(id);
+			if(bind != NULL && evt < QUEST_EVENT_COUNT)
+				worldRef = bind->Functions[evt];
+		}break;
+	case REGTYPE_INSTANCE:
+		{
+			LuaInstanceBinding * bind = getInstanceBinding(id);
+			if(bind != NULL && evt < INSTANCE_EVENT_COUNT)
+				worldRef = bind->Functions[evt];
+		}break;
+	case REGTYPE_UNIT_GOSSIP:
+		{
+			LuaUnitGossipBinding * bind = GetLuaUnitGossipBinding(id);
+			if(bind != NULL && evt < GOSSIP_EVENT_COUNT)
+				worldRef = bind->Functions[evt];
+		}break;
+	case REGTYPE_ITEM_GOSSIP:
+		{
+			LuaItemGossipBinding * bind = GetLuaItemGossipBinding(id);
+			if(bind != NULL && evt < GOSSIP_EVENT_COUNT)
+				worldRef = bind->Functions[evt];
+		}break;
+	case REGTYPE_GO_GOSSIP:
+		{
+			LuaGOGossipBinding * bind = GetLuaGOGossipBinding(id);
+			if(bind != NULL && evt < GOSSIP_EVENT_COUNT)
+				worldRef = bind->Functions[evt];
+		}break;
+	case REGTYPE_SERVHOOK:
+		{
+			// Hooks are kept in registration order, the nth one here is the nth one there
+			if(evt < NUM_SERVER_HOOKS)
+			{
+				uint32 n = engine->NextHookRegistration(evt);
+				if(n < EventAsToFuncName[evt].size())
+					worldRef = EventAsToFuncName[evt][n];
+			}
+		}break;
+	case REGTYPE_DUMMYSPELL:
+		{
+			// The world state keeps the first function registered for a spell
+			std::map<uint32, uint16>::iterator itr = m_luaDummySpells.find(id);
+			if(itr != m_luaDummySpells.end())
+				worldRef = itr->second;
+			replace = false;
+		}break;
+	}
+	engine->MapReference(worldRef, functionRef, replace);
+}
+
+static THREAD_LOCAL LuaEngine * t_mapState = NULL;
+static THREAD_LOCAL LuaEngine * t_currentEngine = NULL;
+
+LuaEngine * LuaEngineMgr::GetEngine()
+{
+	if(!m_perMapStates)
+		return m_engine;
+
+	MapMgr * mgr = MapMgr::GetThreadMapMgr();
+	if(mgr == NULL)
+		return m_engine;
+
+	LuaEngine * engine = t_mapState;
+	if(engine != NULL && engine->GetMapMgr() == mgr && engine->GetGeneration() == m_stateGeneration)
+		return engine;
+	return _CreateMapState(mgr);
+}
+
+LuaEngine * LuaEngineMgr::GetCurrentEngine()
+{
+	LuaEngine * engine = t_currentEngine;
+	return (engine != NULL ? engine : GetEngine());
+}
+
+LuaEngine * LuaEngineMgr::AcquireEngine()
+{
+	LuaEngine * previous = t_currentEngine;
+	LuaEngine * engine = (previous != NULL ? previous : GetEngine());
+	engine->GetLock().Acquire();
+	t_currentEngine = engine;
+	return previous;
+}
+
+LuaEngine * LuaEngineMgr::AcquireWorldEngine()
+{
+	LuaEngine * previous = t_currentEngine;
+	m_engine->GetLock().Acquire();
+	t_currentEngine = m_engine;
+	return previous;
+}
+
+void LuaEngineMgr::ReleaseEngine(LuaEngine * previous)
+{
+	t_currentEngine->GetLock().Release();
+	t_currentEngine = previous;
+}
+
+LuaEngine * LuaEngineMgr::_CreateMapState(MapMgr * mgr)
+{
+	// Restart holds this while it changes the bindings we translate against
+	m_engine->getcoLock().Acquire();
+	uint32 generation = m_stateGeneration;
+	LuaEngine * engine = NULL, * stale = NULL;
+
+	m_mapStateLock.Acquire();
+	std::map<MapMgr*, LuaEngine*>::iterator itr = m_mapStates.find(mgr);
+	if(itr != m_mapStates.end())
+	{
+		if(itr->second->GetGeneration() == generation)
+			engine = itr->second;
+		else
+		{
+			stale = itr->second;
+			m_mapStates.erase(itr);
+		}
+	}
+
+	bool created = false;
+	if(engine == NULL)
+	{
+		engine = new LuaEngine(mgr, generation);
+		m_mapStates.insert(make_pair(mgr, engine));
+		created = true;
+	}
+	m_mapStateLock.Release();
+
+	if(stale != NULL)
+		delete stale;
+
+	t_mapState = engine;
+	if(created)
+	{
+		LuaEngine * previous = t_currentEngine;
+		t_currentEngine = engine;
+		engine->LoadScripts();
+		t_currentEngine = previous;
+	}
+	m_engine->getcoLock().Release();
+	return engine;
+}
+
+void LuaEngineMgr::DestroyMapState(MapMgr * mgr)
+{
+	LuaEngine * engine = NULL;
+	m_engine->getcoLock().Acquire();
+	m_mapStateLock.Acquire();
+	std::map<MapMgr*, LuaEngine*>::iterator itr = m_mapStates.find(mgr);
+	if(itr != m_mapStates.end())
+	{
+		engine = itr->second;
+		m_mapStates.erase(itr);
+	}
+	m_mapStateLock.Release();
+
+	if(engine != NULL)
+	{
+		if(t_mapState == engine)
+			t_mapState = NULL;
+		if(t_currentEngine == engine)
+			t_currentEngine = NULL;
+		delete engine;
+	}
+	m_engine->getcoLock().Release();
+}
+
+void LuaEngineMgr::SetSharedValue(const char * key, LuaSharedValue & value)
+{
+	m_sharedLock.Acquire();
+	if(value.type == LUA_TNIL)
+		m_sharedValues.erase(key);
+	else
+		m_sharedValues[key] = value;
+	m_sharedLock.Release();
+}
+
+bool LuaEngineMgr::GetSharedValue(const char * key, LuaSharedValue & value)
+{
+	bool found = false;
+	m_sharedLock.Acquire();
+	std::map<std::string, LuaSharedValue>::iterator itr = m_sharedValues.find(key);
+	if(itr != m_sharedValues.end())
+	{
+		value = itr->second;
+		found = true;
+	}
+	m_sharedLock.Release();
+	return found;
+}
+
+// Only values that can be copied out of one state into another, tables and functions can't
+bool LuaEngineMgr::ReadSharedValue(lua_State * L, int index, LuaSharedValue & value)
+{
+	value.type = lua_type(L, index);
+	value.number = 0.0;
+	value.str.clear();
+	switch(value.type)
+	{
+	case LUA_TNONE:
+		value.type = LUA_TNIL;
+	case LUA_TNIL:
+		return true;
+	case LUA_TBOOLEAN:
+		value.number = lua_toboolean(L, index) ? 1.0 : 0.0;
+		return true;
+	case LUA_TNUMBER:
+		value.number = lua_tonumber(L, index);
+		return true;
+	case LUA_TSTRING:
+		{
+			size_t len = 0;
+			const char * str = lua_tolstring(L, index, &len);
+			value.str.assign(str, len);
+		}return true;
+	}
+	return false;
+}
+
+void LuaEngineMgr::PushSharedValue(lua_State * L, LuaSharedValue & value)
+{
+	switch(value.type)
+	{
+	case LUA_TBOOLEAN:
+		lua_pushboolean(L, value.number != 0.0 ? 1 : 0);
+		break;
+	case LUA_TNUMBER:
+		lua_pushnumber(L, value.number);
+		break;
+	case LUA_TSTRING:
+		lua_pushlstring(L, value.str.c_str(), value.str.size());
+		break;
+	default:
+		lua_pushnil(L);
+		break;
+	}
+}
+
+static void PostStateMessage(LuaEngine * to, LuaEngine * from, const char * channel, LuaSharedValue & payload)
+{
+	LuaStateMessage * msg = new LuaStateMessage;
+	msg->channel = channel;
+	msg->payload = payload;
+	msg->fromMap = from->IsMapState() ? int32(from->GetMapMgr()->GetMapId()) : -1;
+	msg->fromInstance = from->IsMapState() ? from->GetMapMgr()->GetInstanceID() : 0;
+	to->PostMessage(msg);
+}
+
+uint32 LuaEngineMgr::SendStateMessage(LuaEngine * from, const char * channel, LuaSharedValue & payload, bool everyState, int32 mapId, uint32 instanceId)
+{
+	uint32 count = 0;
+	if(from != m_engine && (everyState || mapId < 0))
+	{
+		PostStateMessage(m_engine, from, channel, payload);
+		++count;
+	}
+
+	if(everyState || mapId >= 0)
+	{
+		// A map without a state yet has no handlers to run, it gets nothing
+		m_mapStateLock.Acquire();
+		for(std::map<MapMgr*, LuaEngine*>::iterator itr = m_mapStates.begin(); itr != m_mapStates.end(); ++itr)
+		{
+			LuaEngine * engine = itr->second;
+			if(engine == from || engine->GetGeneration() != m_stateGeneration)
+				continue;
+			if(!everyState && (itr->first->GetMapId() != uint32(mapId) || (instanceId != 0 && itr->first->GetInstanceID() != instanceId)))
+				continue;
+
+			PostStateMessage(engine, from, channel, payload);
+			++count;
+		}
+		m_mapStateLock.Release();
+	}
+	return count;
+}
+
 void LuaEngineMgr::ResumeLuaThread(int ref)
 {
 	CREATE_L_PTR;
@@ -39,7 +39,18 @@ private:
 
 	std::set<int> m_pendingThreads;
 	std::set<int> m_functionRefs;
-	std::map< uint64,std::set<int> > m_objectFunctionRefs;
+
+	// Per map states, see LuaEngine
+	bool m_perMapStates;
+	volatile uint32 m_stateGeneration;
+	Mutex m_mapStateLock;
+	std::map<MapMgr*, LuaEngine*> m_mapStates;
+
+	Mutex m_sharedLock;
+	std::map<std::string, LuaSharedValue> m_sharedValues;
+
+	LuaEngine * _CreateMapState(MapMgr * mgr);
+	void _RegisterMapStateEvent(LuaEngine * engine, uint8 regtype, uint32 id, uint32 evt, uint16 functionRef);
 
 	UnitBindingMap m_unitBinding;
 	QuestBindingMap m_questBinding;
@@ -50,7 +61,8 @@ private:
 	GossipGOScriptsBindingMap m_go_gossipBinding;
 
 public:
-	GossipMenu *Menu;
+	LuaEngineMgr() : m_engine(NULL), m_perMapStates(false), m_stateGeneration(0) {}
+
 	LuaEngine *m_engine;
 	void Startup();
 	void Unload();
@@ -59,9 +71,33 @@ public:
 	void RegisterEvent(uint8, uint32, uint32 , uint16);
 	void ResumeLuaThread(int);
 	void HyperCallFunction(const char *, int);
+	int PushFunctionByName(lua_State * L, const char * FuncName);
+	bool CacheTimedEventFunction(lua_State * L, EventInfoHolder * ek);
+	void FreeTimedEvent(int ref, EventInfoHolder * ek);
 	void CallFunctionByReference(int);
 	void DestroyAllLuaEvents();
 
+	// The state for the calling thread: its map's state with per map states
+	// enabled and the thread running a map, the world state otherwise
+	LuaEngine * GetEngine();
+	// The state locked by the innermost GET_LOCK on this thread, or GetEngine()
+	LuaEngine * GetCurrentEngine();
+	// GET_LOCK/RELEASE_LOCK, these nest
+	LuaEngine * AcquireEngine();
+	// Like AcquireEngine, but always the world state, released with ReleaseEngine
+	LuaEngine * AcquireWorldEngine();
+	void ReleaseEngine(LuaEngine * previous);
+	void DestroyMapState(MapMgr * mgr);
+	HEARTHSTONE_INLINE bool HasPerMapStates() { return m_perMapStates; }
+
+	// Plain values every state can read, and messages between states
+	void SetSharedValue(const char * key, LuaSharedValue & value);
+	bool GetSharedValue(const char * key, LuaSharedValue & value);
+	static bool ReadSharedValue(lua_State * L, int index, LuaSharedValue & value);
+	static void PushSharedValue(lua_State * L, LuaSharedValue & value);
+	// No map sends to every other state, map -1 to the world state, instance 0 to every instance of the map
+	uint32 SendStateMessage(LuaEngine * from, const char * channel, LuaSharedValue & payload, bool everyState, int32 mapId, uint32 instanceId);
+
 	LuaUnitBinding * GetUnitBinding(uint32 Id)
 	{
 		UnitBindingMap::iterator itr = m_unitBinding.find(Id);
@@ -105,9 +141,6 @@ public:
 		return (itr == m_go_gossipBinding.end()) ? NULL : &itr->second;
 	}
 
-	HEARTHSTONE_INLINE Mutex& getLock() { return m_engine->GetLock(); }
-	HEARTHSTONE_INLINE void Lock() { m_engine->GetLock().Acquire(); }
-	HEARTHSTONE_INLINE void Unlock() { return m_engine->GetLock().Release(); }
 	HEARTHSTONE_INLINE std::set<int> & getThreadRefs() { return m_pendingThreads; }
 	HEARTHSTONE_INLINE std::set<int> & getFunctionRefs() { return m_functionRefs; }
 	HEARTHSTONE_INLINE std::multimap<uint32, LuaCreature*> & getLuCreatureMap() { return m_cAIScripts; }
@@ -117,7 +150,6 @@ public:
 	HEARTHSTONE_INLINE hash_map<uint32, LuaGossip*> & getUnitGossipInterfaceMap() { return m_unitgAIScripts; }
 	HEARTHSTONE_INLINE hash_map<uint32, LuaGossip*> & getItemGossipInterfaceMap() { return m_itemgAIScripts; }
 	HEARTHSTONE_INLINE hash_map<uint32, LuaGossip*> & getGameObjectGossipInterfaceMap() { return m_gogAIScripts; }
-	HEARTHSTONE_INLINE std::map< uint64,std::set<int> > & getObjectFunctionRefs() { return m_objectFunctionRefs; }
 	hash_map<int, EventInfoHolder*> m_registeredTimedEvents;
 	std::vector<uint16> EventAsToFuncName[NUM_SERVER_HOOKS];
 	std::map<uint32, uint16> m_luaDummySpells;
@@ -57,8 +57,7 @@ void lLuaEventMgr::RemoveEventsInTable(const char * table)
 		if (strncmp(itr2->second->funcName, table, strlen(table)) == 0)
 		{
 			event_RemoveByPointer(itr2->second->te);
-			free((void*)itr2->second->funcName);
-			luaL_unref(g_luaMgr.GLuas(), LUA_REGISTRYINDEX, itr2->first);
+			g_luaMgr.FreeTimedEvent(itr2->first, itr2->second);
 			g_luaMgr.m_registeredTimedEvents.erase(itr2);
 		}
 	}
@@ -73,8 +72,7 @@ void lLuaEventMgr::RemoveEventsByName(const char * name)
 		if (strcmp(itr2->second->funcName, name) == 0)
 		{
 			event_RemoveByPointer(itr2->second->te);
-			free((void*)itr2->second->funcName);
-			luaL_unref(g_luaMgr.GLuas(), LUA_REGISTRYINDEX, itr2->first);
+			g_luaMgr.FreeTimedEvent(itr2->first, itr2->second);
 			g_luaMgr.m_registeredTimedEvents.erase(itr2);
 		}
 	}
@@ -86,8 +84,7 @@ void lLuaEventMgr::RemoveEventByRef(int ref)
 	if (itr != g_luaMgr.m_registeredTimedEvents.end())
 	{
 		event_RemoveByPointer(itr->second->te);
-		free((void*)itr->second->funcName);
-		luaL_unref(g_luaMgr.GLuas(), LUA_REGISTRYINDEX, itr->first);
+		g_luaMgr.FreeTimedEvent(itr->first, itr->second);
 		g_luaMgr.m_registeredTimedEvents.erase(itr);
 	}
 }
@@ -97,9 +94,6 @@ void lLuaEventMgr::RemoveEvents()
 	event_RemoveEvents(EVENT_LUA_TIMED);
 	hash_map<int, EventInfoHolder*>::iterator itr = g_luaMgr.m_registeredTimedEvents.begin();
 	for (; itr != g_luaMgr.m_registeredTimedEvents.end(); ++itr)
-	{
-		free((void*)itr->second->funcName);
-		luaL_unref(g_luaMgr.GLuas(), LUA_REGISTRYINDEX, itr->first);
-	}
+		g_luaMgr.FreeTimedEvent(itr->first, itr->second);
 	g_luaMgr.m_registeredTimedEvents.clear();
 }
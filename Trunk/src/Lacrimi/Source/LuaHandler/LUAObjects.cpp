@@ -605,7 +605,7 @@ void LuaCreature::OnDamageTaken(Unit* mAttacker, float fAmount)
 void LuaCreature::StringFunctionCall(int fRef)
 {
 	CHECK_BINDING_ACQUIRELOCK
-	g_engine->BeginCall(fRef);
+	g_engine->BeginLocalCall(fRef);
 	g_engine->PushUnit(_unit);
 	g_engine->ExecuteCall(1);
 	RELEASE_LOCK
@@ -629,7 +629,7 @@ void LuaCreature::Destroy()
 
 	{
 		//Function Ref clean up
-		std::map< uint64, std::set<int> > & objRefs = g_luaMgr.getObjectFunctionRefs();
+		std::map< uint64, std::set<int> > & objRefs = g_engine->getObjectFunctionRefs();
 		std::map< uint64, std::set<int> >::iterator itr = objRefs.find(_unit->GetGUID());
 		if(itr != objRefs.end() )
 		{
@@ -721,7 +721,7 @@ void LuaGameObject::Destroy()
 			gMap.erase(it);
 	}
 
-	std::map< uint64,std::set<int> > & objRefs = g_luaMgr.getObjectFunctionRefs();
+	std::map< uint64,std::set<int> > & objRefs = g_engine->getObjectFunctionRefs();
 	std::map< uint64,std::set<int> >::iterator itr2 = objRefs.find(_gameobject->GetGUID());
 	if(itr2 != objRefs.end() )
 	{
@@ -916,7 +916,7 @@ bool Lua_HookOnNewCharacter(uint32 Race, uint32 Class, WorldSession* Session, co
 		g_engine->PushUint(Class);
 		if(g_engine->ExecuteCall(4, 1))
 		{
-			lua_State* L = g_luaMgr.GLuas();
+			lua_State* L = g_engine->GetMainLuaState();
 			if(!lua_isnoneornil(L, 1) && !lua_toboolean(L, 1))
 				result = false;
 			g_engine->EndCall(1);
@@ -1004,7 +1004,7 @@ bool Lua_HookOnRepop(Player* pPlayer)
 		g_engine->PushUnit(pPlayer);
 		if(g_engine->ExecuteCall(2, 1))
 		{
-			lua_State* L = g_luaMgr.GLuas();
+			lua_State* L = g_engine->GetMainLuaState();
 			if(!lua_isnoneornil(L, 1) && !lua_toboolean(L, 1))
 				result = false;
 			g_engine->EndCall(1);
@@ -1056,7 +1056,7 @@ bool Lua_HookOnCastSpell(Player* pPlayer, SpellEntry* pSpell, Spell* spell)
 		g_engine->PushSpell(spell);
 		if(g_engine->ExecuteCall(4, 1))
 		{
-			lua_State* L = g_luaMgr.GLuas();
+			lua_State* L = g_engine->GetMainLuaState();
 			if(!lua_isnoneornil(L, 1) && !lua_toboolean(L, 1))
 				result = false;
 			g_engine->EndCall(1);
@@ -1088,7 +1088,7 @@ bool Lua_HookOnLogoutRequest(Player* pPlayer)
 		g_engine->PushUnit(pPlayer);
 		if(g_engine->ExecuteCall(2, 1))
 		{
-			lua_State* L = g_luaMgr.GLuas();
+			lua_State* L = g_engine->GetMainLuaState();
 			if(!lua_isnoneornil(L, 1) && !lua_toboolean(L, 1))
 				result = false;
 			g_engine->EndCall(1);
@@ -1165,7 +1165,7 @@ bool Lua_HookOnChat(Player* pPlayer, uint32 Type, uint32 Lang, const char* Messa
 		g_engine->PushString(Misc);
 		if(g_engine->ExecuteCall(6, 1))
 		{
-			lua_State* L = g_luaMgr.GLuas();
+			lua_State* L = g_engine->GetMainLuaState();
 			if(!lua_isnoneornil(L, 1) && !lua_toboolean(L, 1))
 				result = false;
 			g_engine->EndCall(1);
@@ -1354,7 +1354,7 @@ bool Lua_HookOnPreUnitDie(Unit* Killer, Unit* Victim)
 		g_engine->PushUnit(Victim);
 		if(g_engine->ExecuteCall(3, 1))
 		{
-			lua_State* L = g_luaMgr.GLuas();
+			lua_State* L = g_engine->GetMainLuaState();
 			if(!lua_isnoneornil(L, 1) && !lua_toboolean(L, 1))
 				result = false;
 			g_engine->EndCall(1);
@@ -1417,7 +1417,7 @@ bool Lua_HookOnResurrect(Player* pPlayer)
 		g_engine->PushUnit(pPlayer);
 		if(g_engine->ExecuteCall(2, 1))
 		{
-			lua_State* L = g_luaMgr.GLuas();
+			lua_State* L = g_engine->GetMainLuaState();
 			if(!lua_isnoneornil(L, 1) && !lua_toboolean(L, 1))
 				result = false;
 			g_engine->EndCall(1);
@@ -1437,3 +1437,8 @@ bool Lua_HookOnDummySpell(uint32 effectIndex, Spell* pSpell)
 	RELEASE_LOCK
 	return true;
 }
+
+void Lua_OnMapShutdown(MapMgr* pMgr)
+{
+	g_luaMgr.DestroyMapState(pMgr);
+}
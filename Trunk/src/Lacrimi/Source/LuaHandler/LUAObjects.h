@@ -170,5 +170,6 @@ void Lua_HookOnDuelFinished(Player *pWinner, Player *pLoser);
 void Lua_HookOnAuraRemove(Aura *aura);
 bool Lua_HookOnResurrect(Player *pPlayer);
 bool Lua_HookOnDummySpell(uint32 effectIndex, Spell *pSpell);
+void Lua_OnMapShutdown(MapMgr *pMgr);
 
 #endif // __LUAOBJECTS_H
@@ -8,82 +8,396 @@ initialiseSingleton(AccountMgr);
 initialiseSingleton(IPBanner);
 initialiseSingleton(InformationCore);
 
-void AccountMgr::ReloadAccounts(bool silent)
+#define ACCOUNT_FIELDS "acct, login, password, gm, flags, banned, forceLanguage, muted, SessionKey"
+#define ACCOUNT_LOAD_BATCH 64
+#define ACCOUNT_RELOAD_BATCH 500
+#define ACCOUNT_GRAVEYARD_TIME 60
+
+AccountMgr::AccountMgr() : m_loadCond(&m_loadLock), m_answerCond(&m_loadLock)
+{
+	m_maxCached = 0;
+	m_loaderRunning = false;
+	m_loaderShutdown = false;
+	m_hits = m_misses = m_evictions = 0;
+	m_lastReloadTime = 0;
+}
+
+AccountMgr::~AccountMgr()
+{
+	Shutdown();
+
+#ifdef WIN32
+	for(HM_NAMESPACE::hash_map<string,Account*>::iterator itr = AccountDatabase.begin(); itr != AccountDatabase.end(); ++itr)
+#else
+	for(map<string,Account*>::iterator itr = AccountDatabase.begin(); itr != AccountDatabase.end(); ++itr)
+#endif
+	{
+		delete itr->second;
+	}
+
+	for(list< pair<uint32, Account*> >::iterator itr = m_graveyard.begin(); itr != m_graveyard.end(); ++itr)
+		delete itr->second;
+}
+
+void AccountMgr::Startup(uint32 maxCached)
+{
+	m_maxCached = maxCached;
+	m_loaderRunning = true;
+	ThreadPool.ExecuteTask("AccountLoader", new AccountLoaderThread());
+}
+
+void AccountMgr::Shutdown()
+{
+	m_loadCond.BeginSynchronized();
+	m_loaderShutdown = true;
+	m_loadCond.Broadcast();
+	m_loadCond.EndSynchronized();
+
+	while(m_loaderRunning)
+		Sleep(10);
+}
+
+void AccountMgr::_Touch(Account * acct)
+{
+	acct->LastAccess = (uint32)UNIXTIME;
+	if(acct->LruPos != m_lru.begin())
+		m_lru.splice(m_lru.begin(), m_lru, acct->LruPos);
+}
+
+void AccountMgr::_RemoveAccount(Account * acct)
+{
+	AccountDatabase.erase(acct->Username);
+	m_lru.erase(acct->LruPos);
+	m_graveyard.push_back(make_pair((uint32)UNIXTIME, acct));
+}
+
+void AccountMgr::_Trim()
+{
+	if(m_maxCached && AccountDatabase.size() > m_maxCached)
+	{
+		list<Account*>::iterator itr = m_lru.end();
+		while(itr != m_lru.begin() && AccountDatabase.size() > m_maxCached)
+		{
+			Account * acct = *(--itr);
+			if(acct->Pins.GetVal() > 0)
+				continue;
+
+			// Step back off the node we are about to unlink
+			++itr;
+			_RemoveAccount(acct);
+			++m_evictions;
+		}
+	}
+
+	for(list< pair<uint32, Account*> >::iterator itr = m_graveyard.begin(); itr != m_graveyard.end();)
+	{
+		if(itr->first + ACCOUNT_GRAVEYARD_TIME > (uint32)UNIXTIME || itr->second->Pins.GetVal() > 0)
+		{
+			++itr;
+			continue;
+		}
+
+		delete itr->second;
+		itr = m_graveyard.erase(itr);
+	}
+}
+
+Account * AccountMgr::GetCachedAccount(string Name)
+{
+	setBusy.Acquire();
+	// this should already be uppercase!
+	Account * pAccount = __GetAccount(Name);
+	if(pAccount != NULL)
+	{
+		_Touch(pAccount);
+		++m_hits;
+	}
+	setBusy.Release();
+	return pAccount;
+}
+
+Account * AccountMgr::GetAccount(string Name)
+{
+	Account * pAccount = GetCachedAccount(Name);
+	if(pAccount != NULL)
+		return pAccount;
+
+	QueryResult * result = sLogonSQL->Query("SELECT " ACCOUNT_FIELDS " FROM accounts WHERE login = '%s'", sLogonSQL->EscapeString(Name).c_str());
+	if(result == NULL)
+		return NULL;
+
+	setBusy.Acquire();
+	++m_misses;
+	pAccount = AddAccount(result->Fetch());
+	_Trim();
+	setBusy.Release();
+	delete result;
+	return pAccount;
+}
+
+void AccountMgr::LoadAccountAsync(AuthSocket * socket, string Name)
+{
+	m_loadCond.BeginSynchronized();
+	set<AuthSocket*> & waiters = m_loadWaiters[Name];
+	if(waiters.empty())
+	{
+		m_loadQueue.push_back(Name);
+		m_loadCond.Signal();
+	}
+	waiters.insert(socket);
+	m_loadCond.EndSynchronized();
+}
+
+void AccountMgr::CancelAsyncLoad(AuthSocket * socket)
+{
+	m_answerCond.BeginSynchronized();
+	map<string, set<AuthSocket*> >::iterator itr = m_loadWaiters.find(socket->GetAccountName());
+	if(itr != m_loadWaiters.end())
+	{
+		itr->second.erase(socket);
+		if(itr->second.empty())
+			m_loadWaiters.erase(itr);
+	}
+
+	// The loader is answering this socket, it has to finish before the socket can go away
+	while(m_answering.find(socket) != m_answering.end())
+		m_answerCond.Wait();
+	m_answerCond.EndSynchronized();
+}
+
+void AccountMgr::ProcessLoadQueue(vector<string> & names)
 {
+	// One query for every name that piled up while the last one ran
+	std::stringstream ss;
+	ss << "SELECT " ACCOUNT_FIELDS " FROM accounts WHERE login IN(";
+	for(size_t i = 0; i < names.size(); ++i)
+	{
+		if(i)
+			ss << ",";
+		ss << "'" << sLogonSQL->EscapeString(names[i]) << "'";
+	}
+	ss << ")";
+
+	QueryResult * result = sLogonSQL->QueryNA(ss.str().c_str());
 	setBusy.Acquire();
+	if(result != NULL)
+	{
+		do
+		{
+			AddAccount(result->Fetch());
+			++m_misses;
+		} while(result->NextRow());
+		delete result;
+	}
+	_Trim();
+	setBusy.Release();
+
+	// Take the waiters out under the lock and answer them without it, the answers go out to the network
+	vector< pair<AuthSocket*, string> > answers;
+	m_loadLock.Acquire();
+	for(size_t i = 0; i < names.size(); ++i)
+	{
+		map<string, set<AuthSocket*> >::iterator itr = m_loadWaiters.find(names[i]);
+		if(itr == m_loadWaiters.end())
+			continue;
+
+		for(set<AuthSocket*>::iterator sitr = itr->second.begin(); sitr != itr->second.end(); ++sitr)
+		{
+			answers.push_back(make_pair(*sitr, names[i]));
+			m_answering.insert(*sitr);
+		}
+		m_loadWaiters.erase(itr);
+	}
+	m_loadLock.Release();
+
+	for(size_t i = 0; i < answers.size(); ++i)
+	{
+		setBusy.Acquire();
+		Account * acct = __GetAccount(answers[i].second);
+		setBusy.Release();
+
+		// CancelAsyncLoad waits for us, so the socket can't finish disconnecting meanwhile
+		answers[i].first->OnAccountLoaded(acct);
+
+		m_answerCond.BeginSynchronized();
+		m_answering.erase(answers[i].first);
+		m_answerCond.Broadcast();
+		m_answerCond.EndSynchronized();
+
+		// Out of m_answering, so a handler that disconnects won't wait in CancelAsyncLoad for this thread.
+		// A disconnected socket is only deleted by sSocketDeleter 15 seconds later.
+		answers[i].first->ReplayBufferedInput();
+	}
+}
+
+bool AccountLoaderThread::run()
+{
+	SetThreadName("AccountLoader");
+	vector<string> names;
+	for(;;)
+	{
+		sAccountMgr.m_loadCond.BeginSynchronized();
+		while(!sAccountMgr.m_loaderShutdown && sAccountMgr.m_loadQueue.empty())
+			sAccountMgr.m_loadCond.Wait();
+
+		if(sAccountMgr.m_loaderShutdown)
+		{
+			sAccountMgr.m_loadCond.EndSynchronized();
+			break;
+		}
+
+		names.clear();
+		while(sAccountMgr.m_loadQueue.size() && names.size() < ACCOUNT_LOAD_BATCH)
+		{
+			names.push_back(sAccountMgr.m_loadQueue.front());
+			sAccountMgr.m_loadQueue.pop_front();
+		}
+		sAccountMgr.m_loadCond.EndSynchronized();
+
+		sAccountMgr.ProcessLoadQueue(names);
+	}
+
+	sAccountMgr.m_loaderRunning = false;
+	return true;
+}
+
+void AccountMgr::InvalidateAccount(string Name)
+{
+	HEARTHSTONE_TOUPPER(Name);
+
+	setBusy.Acquire();
+	bool resident = (__GetAccount(Name) != NULL);
+	setBusy.Release();
+
+	// Nothing cached, the next login reads it fresh anyway
+	if(!resident)
+		return;
+
+	QueryResult * result = sLogonSQL->Query("SELECT " ACCOUNT_FIELDS " FROM accounts WHERE login = '%s'", sLogonSQL->EscapeString(Name).c_str());
+	setBusy.Acquire();
+	Account * acct = __GetAccount(Name);
+	if(acct != NULL)
+	{
+		if(result != NULL)
+			UpdateAccount(acct, result->Fetch());
+		else
+			_RemoveAccount(acct);
+	}
+	setBusy.Release();
+
+	if(result != NULL)
+		delete result;
+}
+
+void AccountMgr::ReloadAccounts(bool silent)
+{
 	if(!silent) sLog.outString("[AccountMgr] Reloading Accounts...");
+	uint32 start = getMSTime();
 
-	// Load *all* accounts.
-	QueryResult * result = sLogonSQL->Query("SELECT acct, login, password, gm, flags, banned, forceLanguage, muted FROM accounts");
-	Field * field;
-	string AccountName;
-	set<string> account_list;
-	Account * acct;
+	// Only the resident accounts are refreshed, in batches so setBusy is never held across a query
+	vector<uint32> ids;
+	setBusy.Acquire();
+	ids.reserve(m_lru.size());
+	for(list<Account*>::iterator itr = m_lru.begin(); itr != m_lru.end(); ++itr)
+		ids.push_back((*itr)->AccountId);
+	setBusy.Release();
 
-	if(result)
+	set<uint32> found;
+	for(size_t i = 0; i < ids.size(); i += ACCOUNT_RELOAD_BATCH)
 	{
-		do 
+		std::stringstream ss;
+		ss << "SELECT " ACCOUNT_FIELDS " FROM accounts WHERE acct IN(";
+		for(size_t j = i; j < ids.size() && j < i + ACCOUNT_RELOAD_BATCH; ++j)
 		{
-			field = result->Fetch();
-			AccountName = field[1].GetString();
+			if(j != i)
+				ss << ",";
+			ss << ids[j];
+		}
+		ss << ")";
+
+		QueryResult * result = sLogonSQL->QueryNA(ss.str().c_str());
+		if(result == NULL)
+			continue;
 
-			// transform to uppercase
+		setBusy.Acquire();
+		do
+		{
+			Field * field = result->Fetch();
+			string AccountName = field[1].GetString();
 			HEARTHSTONE_TOUPPER(AccountName);
 
 			//Use private __GetAccount, for locks
-			acct = __GetAccount(AccountName);
-			if(acct == 0)
+			Account * acct = __GetAccount(AccountName);
+			if(acct != NULL)
 			{
-				// New account.
-				AddAccount(field);
-			}
-			else
-			{
-				// Update the account with possible changed details.
 				UpdateAccount(acct, field);
+				found.insert(acct->AccountId);
 			}
-
-			// add to our "known" list
-			account_list.insert(AccountName);
-
 		} while(result->NextRow());
+		setBusy.Release();
 		delete result;
 	}
 
 	// check for any purged/deleted accounts
-#ifdef WIN32
-	HM_NAMESPACE::hash_map<string, Account*>::iterator itr = AccountDatabase.begin();
-	HM_NAMESPACE::hash_map<string, Account*>::iterator it2;
-#else
-	std::map<string, Account*>::iterator itr = AccountDatabase.begin();
-	std::map<string, Account*>::iterator it2;
-#endif
-
-	for(; itr != AccountDatabase.end();)
+	set<uint32> checked(ids.begin(), ids.end());
+	setBusy.Acquire();
+	for(list<Account*>::iterator itr = m_lru.begin(); itr != m_lru.end();)
 	{
-		it2 = itr;
+		Account * acct = *itr;
 		++itr;
 
-		if(account_list.find(it2->first) == account_list.end())
-		{
-			delete it2->second;
-			AccountDatabase.erase(it2);
-		}
-		else
-		{
-			it2->second->UsernamePtr = (std::string*)&it2->first;
-		}
+		if(checked.find(acct->AccountId) != checked.end() && found.find(acct->AccountId) == found.end())
+			_RemoveAccount(acct);
 	}
+	_Trim();
+	m_lastReloadTime = getMSTime() - start;
 
-	if(!silent) sLog.outString("[AccountMgr] Found %u accounts.", AccountDatabase.size());
+	if(!silent) sLog.outString("[AccountMgr] Refreshed %u cached accounts in %ums.", (uint32)AccountDatabase.size(), m_lastReloadTime);
 	setBusy.Release();
 
 	IPBanner::getSingleton().Reload();
 }
 
-void AccountMgr::AddAccount(Field* field)
+void AccountMgr::PrintStats()
 {
-	Account * acct = new Account;
+	setBusy.Acquire();
+	size_t resident = AccountDatabase.size();
+	size_t bytes = 0;
+	for(list<Account*>::iterator itr = m_lru.begin(); itr != m_lru.end(); ++itr)
+	{
+		// Account, its map and lru nodes, the name stored twice and the optional blocks
+		bytes += sizeof(Account) + 64 + ((*itr)->Username.capacity() * 2);
+		if((*itr)->SessionKey != NULL)
+			bytes += 40;
+		if((*itr)->GMFlags != NULL)
+			bytes += strlen((*itr)->GMFlags) + 1;
+	}
+
+	sLog.outString("Console:------Account cache--------");
+	sLog.outString("   Resident:   %u of %u", (uint32)resident, m_maxCached);
+	sLog.outString("   Memory:     ~%u KB", (uint32)(bytes / 1024));
+	sLog.outString("   Hits:       %u", m_hits);
+	sLog.outString("   Loads:      %u", m_misses);
+	sLog.outString("   Evictions:  %u (%u awaiting release)", m_evictions, (uint32)m_graveyard.size());
+	sLog.outString("   Reload:     %ums", m_lastReloadTime);
+	sLog.outString("------------------------------------");
+	setBusy.Release();
+}
+
+Account * AccountMgr::AddAccount(Field* field)
+{
+	// Loaded twice by racing lookups, refresh the one we have
+	string UpperName = field[1].GetString();
+	HEARTHSTONE_TOUPPER(UpperName);
+	Account * acct = __GetAccount(UpperName);
+	if(acct != NULL)
+	{
+		UpdateAccount(acct, field);
+		_Touch(acct);
+		return acct;
+	}
+
+	acct = new Account;
 	Sha1Hash hash;
 	string Username     = field[1].GetString();
 	string Password	    = field[2].GetString();
@@ -172,7 +486,24 @@ void AccountMgr::AddAccount(Field* field)
 		memcpy(acct->SrpHash, hash.GetDigest(), 20);
 	}
 
+	// The last session key survives the account being dropped from the cache
+	const char * sessionKey = field[8].GetString();
+	if(sessionKey != NULL && strlen(sessionKey) == 80)
+	{
+		uint8 key[40];
+		BigNumber bn;
+		bn.SetHexStr(sessionKey);
+		memset(key, 0, 40);
+		memcpy(key, bn.AsByteArray(), bn.GetNumBytes() < 40 ? bn.GetNumBytes() : 40);
+		acct->SetSessionKey(key);
+	}
+
+	acct->Username = Username;
+	acct->LastAccess = (uint32)UNIXTIME;
+	m_lru.push_front(acct);
+	acct->LruPos = m_lru.begin();
 	AccountDatabase[Username] = acct;
+	return acct;
 }
 
 void AccountMgr::UpdateAccount(Account * acct, Field * field)
@@ -183,6 +514,8 @@ void AccountMgr::UpdateAccount(Account * acct, Field * field)
 	string Password	    = field[2].GetString();
 	//string EncryptedPassword = field[3].GetString();
 	string GMFlags		= field[3].GetString();
+	uint8 oldSrpHash[20];
+	memcpy(oldSrpHash, acct->SrpHash, 20);
 
 	if(id != acct->AccountId)
 	{
@@ -270,41 +603,124 @@ void AccountMgr::UpdateAccount(Account * acct, Field * field)
 		hash.Finalize();
 		memcpy(acct->SrpHash, hash.GetDigest(), 20);
 	}
+
+	// Password changed, the cached verifier is stale
+	if(memcmp(oldSrpHash, acct->SrpHash, 20))
+		acct->VerifierValid = false;
+}
+
+void AccountMgr::GetSrpVerifier(Account * acct, BigNumber & salt, BigNumber & verifier)
+{
+	setBusy.Acquire();
+	if(!acct->VerifierValid)
+	{
+		BigNumber N, g, s;
+		N.SetHexStr("894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7");
+		g.SetDword(7);
+		s.SetRand(256);
+		memcpy(acct->Salt, s.AsByteArray(), 32);
+
+		Sha1Hash sha;
+		sha.UpdateData(acct->Salt, 32);
+		sha.UpdateData(acct->SrpHash, 20);
+		sha.Finalize();
+
+		BigNumber x;
+		x.SetBinary(sha.GetDigest(), sha.GetLength());
+		BigNumber v = g.ModExp(x, N);
+
+		memset(acct->Verifier, 0, 32);
+		memcpy(acct->Verifier, v.AsByteArray(), v.GetNumBytes());
+		acct->VerifierValid = true;
+	}
+
+	salt.SetBinary(acct->Salt, 32);
+	verifier.SetBinary(acct->Verifier, 32);
+	setBusy.Release();
 }
 
 void AccountMgr::ReloadAccountsCallback()
 {
 	ReloadAccounts(true);
 }
+IPBanner::IPBanner()
+{
+	m_tree = new IPBanTree();
+}
+
+IPBanner::~IPBanner()
+{
+	for(list<IPBanTree*>::iterator itr = m_retiredTrees.begin(); itr != m_retiredTrees.end(); ++itr)
+		delete *itr;
+	delete m_tree;
+}
+
+void IPBanner::PublishTree()
+{
+	IPBanTree * tree = new IPBanTree();
+	for(list<IPBan>::iterator itr = banList.begin(); itr != banList.end(); ++itr)
+		tree->Insert(itr->Mask, itr->Bytes, itr->Expire);
+
+	// Readers pick up the pointer without locking, the old tree lives on until ExpireBans sees no lookup running
+	IPBanTree * old = m_tree;
+#if PLATFORM == PLATFORM_WIN
+	InterlockedExchangePointer((PVOID*)&m_tree, tree);
+#else
+	__sync_synchronize();
+	m_tree = tree;
+	__sync_synchronize();
+#endif
+	m_retiredTrees.push_back(old);
+}
+
 BAN_STATUS IPBanner::CalculateBanStatus(in_addr ip_address)
 {
-	Guard lguard(listBusy);
-	list<IPBan>::iterator itr;
+	// Counted before the pointer is read, so a retired tree can't be freed under us.
+	// Expired bans still in the tree read as not banned until ExpireBans clears them.
+	++m_readers;
+	IPBanTree * tree = m_tree;
+	BAN_STATUS status = tree->Lookup(ip_address.s_addr, (uint32)UNIXTIME);
+	--m_readers;
+	return status;
+}
+
+void IPBanner::ExpireBans()
+{
+	list<IPBan> expired;
+
+	listBusy.Acquire();
 	list<IPBan>::iterator itr2 = banList.begin();
-	for(; itr2 != banList.end();)
+	for(list<IPBan>::iterator itr; itr2 != banList.end();)
 	{
 		itr = itr2;
 		++itr2;
 
-		if( ParseCIDRBan(ip_address.s_addr, itr->Mask, itr->Bytes) )
+		if( itr->Expire != 0 && (uint32)UNIXTIME >= itr->Expire )
 		{
-			// ban hit
-			if( itr->Expire == 0 )
-				return BAN_STATUS_PERMANENT_BAN;
-			
-			if( (uint32)UNIXTIME >= itr->Expire )
-			{
-				sLogonSQL->Execute("DELETE FROM ipbans WHERE expire = %u AND ip = \"%s\"", itr->Expire, sLogonSQL->EscapeString(itr->db_ip).c_str());
-				banList.erase(itr);
-			}
-			else
-			{
-				return BAN_STATUS_TIME_LEFT_ON_BAN;
-			}
+			expired.push_back(*itr);
+			banList.erase(itr);
 		}
 	}
 
-	return BAN_STATUS_NOT_BANNED;
+	if( expired.size() )
+		PublishTree();
+
+	// Every retired tree was swapped out before this point. With no lookup running, any lookup
+	// from here on reads the current tree, so none of them can still be referenced. If lookups
+	// are running they stay until a later pass, a lookup takes microseconds so that is rare.
+	if( m_retiredTrees.size() && m_readers.GetVal() == 0 )
+	{
+		for(list<IPBanTree*>::iterator itr = m_retiredTrees.begin(); itr != m_retiredTrees.end(); ++itr)
+			delete *itr;
+		m_retiredTrees.clear();
+	}
+	listBusy.Release();
+
+	for(list<IPBan>::iterator itr = expired.begin(); itr != expired.end(); ++itr)
+		sLogonSQL->Execute("DELETE FROM ipbans WHERE expire = %u AND ip = \"%s\"", itr->Expire, sLogonSQL->EscapeString(itr->db_ip).c_str());
+
+	if( expired.size() )
+		DEBUG_LOG("IPBanner", "%u ip bans expired.", (uint32)expired.size());
 }
 
 bool IPBanner::Add(const char * ip, uint32 dur)
@@ -327,9 +743,11 @@ bool IPBanner::Add(const char * ip, uint32 dur)
 	ipb.db_ip = sip;
 	ipb.Bytes = ipmask;
 	ipb.Mask = ipraw;
-	
+	ipb.Expire = dur;
+
 	listBusy.Acquire();
 	banList.push_back(ipb);
+	PublishTree();
 	listBusy.Release();
 
 	return true;
@@ -343,6 +761,7 @@ bool IPBanner::Remove(const char * ip)
 		if( !strcmp(ip, itr->db_ip.c_str()) )
 		{
 			banList.erase(itr);
+			PublishTree();
 			listBusy.Release();
 			return true;
 		}
@@ -390,6 +809,7 @@ void IPBanner::Reload()
 		} while (result->NextRow());
 		delete result;
 	}
+	PublishTree();
 	listBusy.Release();
 }
 
@@ -7,6 +7,7 @@
 
 #include "Common.h"
 #include "../hearthstone-shared/DataStorage/DatabaseEnv.h"
+#include "IPBanTree.h"
 
 enum RealmColours
 {
@@ -31,14 +32,26 @@ struct Account
 	uint8 AccountFlags;
 	uint32 Banned;
 	uint8 SrpHash[20];
+	uint8 Salt[32];
+	uint8 Verifier[32];			// g^x mod N, only valid while VerifierValid is set
+	bool VerifierValid;
 	uint8 * SessionKey;
+	string Username;
 	string * UsernamePtr;
 	uint32 Muted;
 
+	// Cache bookkeeping, see AccountMgr
+	uint32 LastAccess;
+	AtomicCounter Pins;			// Sockets holding this account, pinned accounts are never evicted
+	list<Account*>::iterator LruPos;
+
 	Account()
 	{
 		GMFlags = NULL;
 		SessionKey = NULL;
+		VerifierValid = false;
+		UsernamePtr = &Username;
+		LastAccess = 0;
 	}
 
 	~Account()
@@ -87,71 +100,91 @@ typedef struct IPBan
 	string db_ip;
 } IPBan;
 
-enum BAN_STATUS
-{
-	BAN_STATUS_NOT_BANNED = 0,
-	BAN_STATUS_TIME_LEFT_ON_BAN = 1,
-	BAN_STATUS_PERMANENT_BAN = 2,
-};
-
 class IPBanner : public Singleton< IPBanner >
 {
 public:
+	IPBanner();
+	~IPBanner();
+
 	void Reload();
 
 	bool Add(const char * ip, uint32 dur);
 	bool Remove(const char * ip);
 
+	// Lock free, searches the current ban tree
 	BAN_STATUS CalculateBanStatus(in_addr ip_address);
 
+	// Drops expired bans from memory and the database, run periodically
+	void ExpireBans();
+
 protected:
+	// Rebuilds the ban tree from banList and swaps it in, listBusy must be held
+	void PublishTree();
+
 	Mutex listBusy;
 	list<IPBan> banList;
+
+	IPBanTree * volatile m_tree;
+	list<IPBanTree*> m_retiredTrees;		// swapped out, freed once no lookup is running
+	AtomicCounter m_readers;				// lookups in CalculateBanStatus right now
 };
 
+class AuthSocket;
+
+/************************************************************************/
+/* AccountMgr, resident set of recently used accounts                   */
+/************************************************************************/
+// Accounts are fetched from the database the first time they are needed and
+// kept in a least recently used list. Once the cache grows past its limit
+// the oldest accounts that no socket is holding are dropped. Dropped and
+// deleted accounts are freed a minute later, so a pointer handed out just
+// before stays valid for the call that asked for it.
+
 class AccountMgr : public Singleton < AccountMgr >
 {
+	friend class AccountLoaderThread;
 public:
-	~AccountMgr()
-	{
+	AccountMgr();
+	~AccountMgr();
 
-#ifdef WIN32
-		for(HM_NAMESPACE::hash_map<string,Account*>::iterator itr = AccountDatabase.begin(); itr != AccountDatabase.end(); ++itr)
-#else
-		for(map<string,Account*>::iterator itr = AccountDatabase.begin(); itr != AccountDatabase.end(); ++itr)
-#endif
-		{
-			delete itr->second;
-		}
-	}
+	void Startup(uint32 maxCached);
+	void Shutdown();
 
-	void AddAccount(Field* field);
+	// Resident account, or a blocking database load if it isn't
+	Account* GetAccount(string Name);
 
-	Account* GetAccount(string Name)
-	{
-		setBusy.Acquire();
-		Account * pAccount = NULL;
-		// this should already be uppercase!
-#ifdef WIN32
-		HM_NAMESPACE::hash_map<string, Account*>::iterator itr = AccountDatabase.find(Name);
-#else
-		map<string, Account*>::iterator itr = AccountDatabase.find(Name);
-#endif
+	// Resident account only, never touches the database
+	Account* GetCachedAccount(string Name);
 
-		if(itr == AccountDatabase.end())	pAccount = NULL;
-		else								pAccount = itr->second;
+	// Fetches the account on the loader thread and answers the socket from there
+	void LoadAccountAsync(AuthSocket * socket, string Name);
+	void CancelAsyncLoad(AuthSocket * socket);
 
-		setBusy.Release();
-		return pAccount;
-	}
+	// Re-reads a single account after it was changed outside the logon server
+	void InvalidateAccount(string Name);
+
+	HEARTHSTONE_INLINE void PinAccount(Account * acct) { ++acct->Pins; }
+	HEARTHSTONE_INLINE void UnpinAccount(Account * acct) { --acct->Pins; }
 
 	void UpdateAccount(Account * acct, Field * field);
+
+	// Refreshes every resident account, the rest of the table is never read
 	void ReloadAccounts(bool silent);
 	void ReloadAccountsCallback();
 
+	// Returns the account's SRP6 salt and verifier, they are only recalculated after a password change
+	void GetSrpVerifier(Account * acct, BigNumber & salt, BigNumber & verifier);
+
 	HEARTHSTONE_INLINE size_t GetCount() { return AccountDatabase.size(); }
+	void PrintStats();
 
 private:
+	Account * AddAccount(Field* field);
+	void _RemoveAccount(Account * acct);
+	void _Touch(Account * acct);
+	void _Trim();
+	void ProcessLoadQueue(vector<string> & names);
+
 	Account* __GetAccount(string Name)
 	{
 		// this should already be uppercase!
@@ -171,9 +204,36 @@ private:
 	std::map<string, Account*> AccountDatabase;
 #endif
 
+	list<Account*> m_lru;
+	list< pair<uint32, Account*> > m_graveyard;
+	uint32 m_maxCached;
+
+	// Pending asynchronous loads, sockets waiting on each account name
+	Mutex m_loadLock;
+	Condition m_loadCond;
+	deque<string> m_loadQueue;
+	map<string, set<AuthSocket*> > m_loadWaiters;
+	set<AuthSocket*> m_answering;			// being called back right now, m_loadLock not held
+	Condition m_answerCond;					// a socket left m_answering
+	bool m_loaderRunning;
+	bool m_loaderShutdown;
+
+	// Statistics
+	uint32 m_hits;
+	uint32 m_misses;
+	uint32 m_evictions;
+	uint32 m_lastReloadTime;
+
 protected:
 	Mutex setBusy;
 };
+
+class AccountLoaderThread : public ThreadContext
+{
+public:
+	bool run();
+};
+
 class LogonCommServerSocket;
 typedef struct Realm
 {
@@ -0,0 +1,242 @@
+/***
+ * Demonstrike Core
+ */
+
+#include "LogonStdAfx.h"
+
+initialiseSingleton(AuthCryptoPool);
+
+void AuthCryptoPool::CalculateSessionKey(BigNumber & S, uint8 * key)
+{
+	Sha1Hash sha;
+	uint8 t[32];
+	uint8 t1[16];
+	memset(t, 0, 32);
+	memcpy(t, S.AsByteArray(), S.GetNumBytes() < 32 ? S.GetNumBytes() : 32);
+	for (int i = 0; i < 16; i++)
+	{
+		t1[i] = t[i*2];
+	}
+	sha.UpdateData(t1, 16);
+	sha.Finalize();
+	for (int i = 0; i < 20; i++)
+	{
+		key[i*2] = sha.GetDigest()[i];
+	}
+	for (int i = 0; i < 16; i++)
+	{
+		t1[i] = t[i*2+1];
+	}
+	sha.Initialize();
+	sha.UpdateData(t1, 16);
+	sha.Finalize();
+	for (int i = 0; i < 20; i++)
+	{
+		key[i*2+1] = sha.GetDigest()[i];
+	}
+}
+
+void AuthCryptoPool::CalculateM1(BigNumber & N, BigNumber & g, std::string & username, BigNumber & s, BigNumber & A, BigNumber & B, BigNumber & K, BigNumber & M)
+{
+	Sha1Hash sha;
+	uint8 hash[20];
+
+	sha.UpdateBigNumbers(&N, NULL);
+	sha.Finalize();
+	memcpy(hash, sha.GetDigest(), 20);
+	sha.Initialize();
+	sha.UpdateBigNumbers(&g, NULL);
+	sha.Finalize();
+	for (int i = 0; i < 20; i++)
+	{
+		hash[i] ^= sha.GetDigest()[i];
+	}
+	BigNumber t3;
+	t3.SetBinary(hash, 20);
+
+	sha.Initialize();
+	sha.UpdateData((const uint8*)username.c_str(), (int)username.size());
+	sha.Finalize();
+
+	BigNumber t4;
+	t4.SetBinary(sha.GetDigest(), 20);
+
+	sha.Initialize();
+	sha.UpdateBigNumbers(&t3, &t4, &s, &A, &B, &K, NULL);
+	sha.Finalize();
+
+	M.SetBinary(sha.GetDigest(), 20);
+}
+
+void AuthProofJob::Process()
+{
+	BigNumber bnA;
+	bnA.SetBinary(A, 32);
+
+	Sha1Hash sha;
+	sha.UpdateBigNumbers(&bnA, &B, 0);
+	sha.Finalize();
+
+	BigNumber u;
+	u.SetBinary(sha.GetDigest(), 20);
+
+	BigNumber S = (bnA * (v.ModExp(u, N))).ModExp(b, N);
+	AuthCryptoPool::CalculateSessionKey(S, SessionKey);
+
+	BigNumber K, M;
+	K.SetBinary(SessionKey, 40);
+	AuthCryptoPool::CalculateM1(N, g, Username, s, bnA, B, K, M);
+
+	// Compare M1 values.
+	Success = (memcmp(M1, M.AsByteArray(), 20) == 0);
+	if(!Success)
+		return;
+
+	sha.Initialize();
+	sha.UpdateBigNumbers(&bnA, &M, &K, 0);
+	sha.Finalize();
+	memcpy(M2, sha.GetDigest(), 20);
+}
+
+AuthCryptoPool::AuthCryptoPool() : m_cond(&m_lock), m_doneCond(&m_lock)
+{
+	m_threadCount = 0;
+	m_maxPending = 0;
+	m_shutdown = false;
+}
+
+AuthCryptoPool::~AuthCryptoPool()
+{
+	Shutdown();
+}
+
+void AuthCryptoPool::Startup(uint32 threads, uint32 maxPending)
+{
+	m_threadCount = threads;
+	m_maxPending = maxPending;
+	for(uint32 i = 0; i < m_threadCount; ++i)
+	{
+		++m_activeThreads;
+		ThreadPool.ExecuteTask("AuthCryptoThread", new AuthCryptoThread());
+	}
+
+	Log.Notice("AuthCrypto", "%u crypto threads started, up to %u pending proofs.", m_threadCount, m_maxPending);
+}
+
+void AuthCryptoPool::Shutdown()
+{
+	m_cond.BeginSynchronized();
+	if(m_shutdown)
+	{
+		m_cond.EndSynchronized();
+		return;
+	}
+
+	m_shutdown = true;
+	while(m_queue.size())
+	{
+		AuthProofJob * job = m_queue.front();
+		m_queue.pop_front();
+		delete job;
+	}
+	m_cond.Broadcast();
+	m_cond.EndSynchronized();
+
+	while(m_activeThreads.GetVal() > 0)
+		Sleep(10);
+}
+
+bool AuthCryptoPool::Submit(AuthProofJob * job)
+{
+	// No crypto threads, verify on the calling thread
+	if(m_threadCount == 0)
+	{
+		job->Process();
+		Complete(job);
+		return true;
+	}
+
+	m_cond.BeginSynchronized();
+	if(m_shutdown || m_queue.size() >= m_maxPending)
+	{
+		m_cond.EndSynchronized();
+		return false;
+	}
+
+	m_queue.push_back(job);
+	m_cond.Signal();
+	m_cond.EndSynchronized();
+	return true;
+}
+
+void AuthCryptoPool::CancelJobs(AuthSocket * socket)
+{
+	m_doneCond.BeginSynchronized();
+	for(std::deque<AuthProofJob*>::iterator itr = m_queue.begin(); itr != m_queue.end();)
+	{
+		if((*itr)->Socket == socket)
+		{
+			delete (*itr);
+			itr = m_queue.erase(itr);
+		}
+		else
+			++itr;
+	}
+
+	// A crypto thread is answering this socket right now, it has to finish before the socket can go away
+	while(m_processing.find(socket) != m_processing.end())
+		m_doneCond.Wait();
+	m_doneCond.EndSynchronized();
+}
+
+AuthProofJob * AuthCryptoPool::WaitForJob()
+{
+	m_cond.BeginSynchronized();
+	while(!m_shutdown && m_queue.empty())
+		m_cond.Wait();
+
+	if(m_shutdown)
+	{
+		m_cond.EndSynchronized();
+		return NULL;
+	}
+
+	AuthProofJob * job = m_queue.front();
+	m_queue.pop_front();
+	m_processing.insert(job->Socket);
+	m_cond.EndSynchronized();
+	return job;
+}
+
+void AuthCryptoPool::Complete(AuthProofJob * job)
+{
+	AuthSocket * socket = job->Socket;
+	socket->OnProofComplete(job);
+	delete job;
+
+	if(m_threadCount)
+	{
+		m_doneCond.BeginSynchronized();
+		m_processing.erase(socket);
+		m_doneCond.Broadcast();
+		m_doneCond.EndSynchronized();
+	}
+
+	// Out of m_processing, so a handler that disconnects won't wait in CancelJobs for this thread.
+	// A disconnected socket is only deleted by sSocketDeleter 15 seconds later.
+	socket->ReplayBufferedInput();
+}
+
+bool AuthCryptoThread::run()
+{
+	SetThreadName("AuthCrypto");
+	AuthProofJob * job;
+	while((job = sAuthCrypto.WaitForJob()) != NULL)
+	{
+		job->Process();
+		sAuthCrypto.Complete(job);
+	}
+
+	--sAuthCrypto.m_activeThreads;
+	return true;
+}
@@ -0,0 +1,85 @@
+/***
+ * Demonstrike Core
+ */
+
+#ifndef __AUTHCRYPTO_H
+#define __AUTHCRYPTO_H
+
+class AuthSocket;
+
+/************************************************************************/
+/* SRP6 proof verification, run on crypto threads                       */
+/************************************************************************/
+// The modular exponentiation in a logon proof is by far the most expensive
+// thing the logon server does. Proofs are queued here and verified by a
+// small set of worker threads so a burst of logins cannot stall the socket
+// threads. The queue is bounded, when it is full the client is told the
+// server is busy rather than being left to time out.
+
+struct AuthProofJob
+{
+	AuthSocket * Socket;
+	std::string Username;
+
+	// Server side of the exchange, copied as BigNumber is not thread safe
+	BigNumber N, g, s, v, b, B;
+
+	// Client proof
+	uint8 A[32];
+	uint8 M1[20];
+
+	// Results
+	bool Success;
+	uint8 SessionKey[40];
+	uint8 M2[20];
+
+	void Process();
+};
+
+class AuthCryptoPool : public Singleton< AuthCryptoPool >
+{
+	friend class AuthCryptoThread;
+public:
+	AuthCryptoPool();
+	~AuthCryptoPool();
+
+	void Startup(uint32 threads, uint32 maxPending);
+	void Shutdown();
+
+	// Returns false if the queue is full, the job is not taken in that case
+	bool Submit(AuthProofJob * job);
+
+	// Drops queued jobs for a socket and waits for a running one to complete
+	void CancelJobs(AuthSocket * socket);
+
+	HEARTHSTONE_INLINE uint32 GetThreadCount() { return m_threadCount; }
+	HEARTHSTONE_INLINE uint32 GetQueueSize() { return (uint32)m_queue.size(); }
+
+	static void CalculateSessionKey(BigNumber & S, uint8 * key);
+	static void CalculateM1(BigNumber & N, BigNumber & g, std::string & username, BigNumber & s, BigNumber & A, BigNumber & B, BigNumber & K, BigNumber & M);
+
+protected:
+	AuthProofJob * WaitForJob();
+	void Complete(AuthProofJob * job);
+
+	Mutex m_lock;
+	Condition m_cond;
+	Condition m_doneCond;		// a socket left m_processing
+	std::deque<AuthProofJob*> m_queue;
+	std::set<AuthSocket*> m_processing;
+
+	uint32 m_threadCount;
+	uint32 m_maxPending;
+	bool m_shutdown;
+	AtomicCounter m_activeThreads;
+};
+
+class AuthCryptoThread : public ThreadContext
+{
+public:
+	bool run();
+};
+
+#define sAuthCrypto AuthCryptoPool::getSingleton()
+
+#endif
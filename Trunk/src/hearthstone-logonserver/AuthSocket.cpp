@@ -24,8 +24,9 @@ AuthSocket::AuthSocket(SOCKET fd, const sockaddr_in * peer) : TcpSocket(fd, 3276
 {
 	N.SetHexStr("894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7");
 	g.SetDword(7);
-	s.SetRand(256);
 	m_authenticated = false;
+	m_proofPending = false;
+	m_accountLoading = false;
 	m_account = 0;
 	last_recv = time(NULL);
 	removedFromSet = false;
@@ -39,6 +40,7 @@ AuthSocket::AuthSocket(SOCKET fd, const sockaddr_in * peer) : TcpSocket(fd, 3276
 AuthSocket::~AuthSocket()
 {
 	ASSERT(!m_patchJob);
+	SetAccount(NULL);
 }
 
 void AuthSocket::OnDisconnect()
@@ -50,6 +52,10 @@ void AuthSocket::OnDisconnect()
 		_authSocketLock.Release();
 	}
 
+	// Don't let a crypto thread answer a socket that is going away
+	sAuthCrypto.CancelJobs(this);
+	sAccountMgr.CancelAsyncLoad(this);
+
 	if(m_patchJob)
 	{
 		PatchMgr::getSingleton().AbortPatchJob(m_patchJob);
@@ -160,8 +166,50 @@ void AuthSocket::HandleChallenge()
 		return;
 	}
 
-	// Look up the account information
-	m_account = AccountMgr::getSingleton().GetAccount(AccountName);
+	// Look up the account information, fetching it in the background if it isn't cached
+	Account * acct = AccountMgr::getSingleton().GetCachedAccount(AccountName);
+	if(acct == NULL)
+	{
+		// We are in OnRecvData, so the read buffer lock is held
+		m_accountLoading = true;
+		AccountMgr::getSingleton().LoadAccountAsync(this, AccountName);
+		return;
+	}
+
+	ContinueChallenge(acct);
+}
+
+void AuthSocket::OnAccountLoaded(Account * acct)
+{
+	// The flag goes before the reply so a quick logon proof can't slip in between
+	LockReadBuffer();
+	m_accountLoading = false;
+	ContinueChallenge(acct);
+	UnlockReadBuffer();
+}
+
+void AuthSocket::ReplayBufferedInput()
+{
+	// Whatever the client sent while we were busy is still buffered, the socket thread won't look again
+	LockReadBuffer();
+	OnRecvData();
+	UnlockReadBuffer();
+}
+
+void AuthSocket::SetAccount(Account * acct)
+{
+	if(m_account != NULL)
+		AccountMgr::getSingleton().UnpinAccount(m_account);
+
+	// Keeps the account resident for as long as we point at it
+	m_account = acct;
+	if(m_account != NULL)
+		AccountMgr::getSingleton().PinAccount(m_account);
+}
+
+void AuthSocket::ContinueChallenge(Account * acct)
+{
+	SetAccount(acct);
 	if(m_account == 0)
 	{
 		DEBUG_LOG("AuthChallenge","Account Name: \"%s\" - Account state: INVALID", AccountName.c_str());
@@ -199,15 +247,8 @@ void AuthSocket::HandleChallenge()
 		*(uint32*)&m_account->Locale[0] = *(uint32*)temp;
 	}
 
-	Sha1Hash sha;
-	//uint32 tc = s.GetNumBytes();
-	sha.UpdateData( s.AsByteArray(), 32 );
-	sha.UpdateData( m_account->SrpHash, 20 );
-	sha.Finalize();
-
-	BigNumber x;
-	x.SetBinary( sha.GetDigest(), sha.GetLength() );
-	v = g.ModExp(x, N);
+	// Salt and verifier only change with the password
+	AccountMgr::getSingleton().GetSrpVerifier(m_account, s, v);
 	b.SetRand(152);
 
 	BigNumber gmod = g.ModExp(b, N);
@@ -254,118 +295,72 @@ void AuthSocket::HandleProof()
 	if(!m_account)
 		return;
 
-	DEBUG_LOG("AuthLogonProof","Interleaving and checking proof...");
+	DEBUG_LOG("AuthLogonProof","Queueing proof for verification...");
 
 	sAuthLogonProof_C lp;
 	GetReadBuffer()->Read(&lp, sizeof(sAuthLogonProof_C));
 
-	BigNumber A;
-	A.SetBinary(lp.A, 32);
-
-	Sha1Hash sha;
-	sha.UpdateBigNumbers(&A, &B, 0);
-	sha.Finalize();
-
-	BigNumber u;
-	u.SetBinary(sha.GetDigest(), 20);
-	
-	BigNumber S = (A * (v.ModExp(u, N))).ModExp(b, N);
-	uint8 t[32];
-	uint8 t1[16];
-	uint8 vK[40];
-	memcpy(t, S.AsByteArray(), 32);
-	for (int i = 0; i < 16; i++)
-	{
-		t1[i] = t[i*2];
-	}
-	sha.Initialize();
-	sha.UpdateData(t1, 16);
-	sha.Finalize();
-	for (int i = 0; i < 20; i++)
-	{
-		vK[i*2] = sha.GetDigest()[i];
-	}
-	for (int i = 0; i < 16; i++)
-	{
-		t1[i] = t[i*2+1];
-	}
-	sha.Initialize();
-	sha.UpdateData(t1, 16);
-	sha.Finalize();
-	for (int i = 0; i < 20; i++)
-	{
-		vK[i*2+1] = sha.GetDigest()[i];
-	}
-	m_sessionkey.SetBinary(vK, 40);
-
-	uint8 hash[20];
-
-	sha.Initialize();
-	sha.UpdateBigNumbers(&N, NULL);
-	sha.Finalize();
-	memcpy(hash, sha.GetDigest(), 20);
-	sha.Initialize();
-	sha.UpdateBigNumbers(&g, NULL);
-	sha.Finalize();
-	for (int i = 0; i < 20; i++)
-	{
-		hash[i] ^= sha.GetDigest()[i];
+	AuthProofJob * job = new AuthProofJob;
+	job->Socket = this;
+	job->Username = *m_account->UsernamePtr;
+	job->N = N;
+	job->g = g;
+	job->s = s;
+	job->v = v;
+	job->b = b;
+	job->B = B;
+	memcpy(job->A, lp.A, 32);
+	memcpy(job->M1, lp.M1, 20);
+
+	// The answer is written from the crypto thread, hold back anything else the client sends until then.
+	// We are in OnRecvData, so the read buffer lock is held.
+	m_proofPending = true;
+	if(!sAuthCrypto.Submit(job))
+	{
+		delete job;
+		m_proofPending = false;
+		SendChallengeError(CE_SERVER_FULL);
+		DEBUG_LOG("AuthLogonProof","Crypto queue is full.");
 	}
-	BigNumber t3;
-	t3.SetBinary(hash, 20);
-
-	sha.Initialize();
-	sha.UpdateData((const uint8*)m_account->UsernamePtr->c_str(), (int)m_account->UsernamePtr->size());
-	sha.Finalize();
-
-	BigNumber t4;
-	t4.SetBinary(sha.GetDigest(), 20);
-
-	sha.Initialize();
-	sha.UpdateBigNumbers(&t3, &t4, &s, &A, &B, &m_sessionkey, NULL);
-	sha.Finalize();
-
-	BigNumber M;
-	M.SetBinary(sha.GetDigest(), 20);
+}
 
-	// Compare M1 values.
-	if(memcmp(lp.M1, M.AsByteArray(), 20) != 0)
+void AuthSocket::OnProofComplete(AuthProofJob * job)
+{
+	// The flag goes before the reply so the client's next packet can't slip in between
+	LockReadBuffer();
+	m_proofPending = false;
+	if(!job->Success)
 	{
 		// Authentication failed.
 		//SendProofError(4, 0);
 		SendChallengeError(CE_NO_ACCOUNT);
 		DEBUG_LOG("AuthLogonProof","M1 values don't match.");
+		UnlockReadBuffer();
 		return;
 	}
 
 	// Store sessionkey
-	m_account->SetSessionKey(m_sessionkey.AsByteArray());
+	m_sessionkey.SetBinary(job->SessionKey, 40);
+	m_account->SetSessionKey(job->SessionKey);
 
-//	OUT_DEBUG("========================\nSession key: ");
-//	for(uint32 z = 0; z < 40; ++z)
-//		OUT_DEBUG("%.2X ", m_account->SessionKey[z]);
-//	OUT_DEBUG("\n========================\n");
+	// we're authenticated now :)
+	m_authenticated = true;
 
 	// let the client know
-	sha.Initialize();
-	sha.UpdateBigNumbers(&A, &M, &m_sessionkey, 0);
-	sha.Finalize();
 	if(GetBuild() <= 6005)
 	{
 		sAuthLogonProof_S proof;
 		proof.cmd = 0x01;
 		proof.error = 0;
-		memcpy(proof.M2, sha.GetDigest(), 20);
+		memcpy(proof.M2, job->M2, 20);
 		proof.unk2 = 0;
 		SendPacket( (uint8*) &proof, sizeof(proof) );
 	}
 	else
-		SendProofError(0, sha.GetDigest());
+		SendProofError(0, job->M2);
 
 	DEBUG_LOG("AuthLogonProof","Authentication Success.");
-
-	// we're authenticated now :)
-	m_authenticated = true;
+	UnlockReadBuffer();
 
 	// Don't update when IP banned, but update anyway if it's an account ban
 	const char* m_sessionkey_hex = m_sessionkey.AsHexStr();
@@ -482,6 +477,10 @@ void AuthSocket::OnRecvData()
 	if(GetReadBuffer()->GetSize() < 1)
 		return;
 
+	// Wait for the crypto or account loader thread to answer us first
+	if(m_proofPending || m_accountLoading)
+		return;
+
 	uint8 Command = *(uint8*)GetReadBuffer()->GetBufferOffset();
 	last_recv = UNIXTIME;
 	if(Command < MAX_AUTH_CMD && Handlers[Command] != NULL)
@@ -560,7 +559,7 @@ void AuthSocket::HandleReconnectChallenge()
 	AccountName = (char*)&m_challenge.I;
 	Log.Notice("ReconnectChallenge","Account Name: \"%s\"", AccountName.c_str());
 
-	m_account = AccountMgr::getSingleton().GetAccount(AccountName);
+	SetAccount(AccountMgr::getSingleton().GetAccount(AccountName));
 	if(m_account == 0)
 	{
 		DEBUG_LOG("ReconnectChallenge","Invalid account.");
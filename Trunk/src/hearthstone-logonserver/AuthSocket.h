@@ -11,6 +11,7 @@
 class LogonCommServerSocket;
 struct Patch;
 class PatchJob;
+struct AuthProofJob;
 
 class AuthSocket : public TcpSocket
 {
@@ -30,6 +31,7 @@ public:
 	//////////////////////////
 
 	void HandleChallenge();
+	void ContinueChallenge(Account * acct);
 	void HandleProof();
 	void HandleRealmlist();
 	void HandleReconnectChallenge();
@@ -45,6 +47,16 @@ public:
 
 	void SendChallengeError(uint8 Error);
 	void SendProofError(uint8 Error, uint8 * M2);
+
+	// Called from a crypto thread once our logon proof has been checked
+	void OnProofComplete(AuthProofJob * job);
+
+	// Called from the account loader thread, acct is NULL if there is no such account
+	void OnAccountLoaded(Account * acct);
+
+	// Handles input held back while a crypto or loader thread had us. Called by that thread once
+	// it has let go of the socket, as a handler here may disconnect and wait for it to do so.
+	void ReplayBufferedInput();
 	HEARTHSTONE_INLINE sAuthLogonChallenge_C * GetChallenge() { return &m_challenge; }
 	HEARTHSTONE_INLINE void Send(const uint8* data, const uint16 len) { SendPacket(data, len); };
 	HEARTHSTONE_INLINE void SendPacket(const uint8* data, const uint16 len)
@@ -69,7 +81,10 @@ protected:
 
 	sAuthLogonChallenge_C m_challenge;
 	Account * m_account;
+	void SetAccount(Account * acct);
 	bool m_authenticated;
+	bool m_proofPending;		// read buffer lock
+	bool m_accountLoading;		// read buffer lock
 	std::string AccountName;
 
 	//////////////////////////////////////////////////
@@ -0,0 +1,139 @@
+/***
+ * Demonstrike Core
+ */
+
+#include "LogonStdAfx.h"
+
+int32 IPBanTree::NewNode(uint32 key, uint8 bits)
+{
+	Node n;
+	n.Prefix = MaskKey(key, bits);
+	n.Length = bits;
+	n.Banned = false;
+	n.Expire = 0;
+	n.Child[0] = n.Child[1] = -1;
+	m_nodes.push_back(n);
+	return int32(m_nodes.size() - 1);
+}
+
+void IPBanTree::SetBan(int32 node, uint32 expire)
+{
+	Node & n = m_nodes[node];
+	if(!n.Banned)
+	{
+		n.Banned = true;
+		n.Expire = expire;
+		++m_banCount;
+		return;
+	}
+
+	// Same range banned twice, keep the longer one
+	if(n.Expire != 0 && (expire == 0 || expire > n.Expire))
+		n.Expire = expire;
+}
+
+void IPBanTree::Insert(uint32 ip, uint8 bits, uint32 expire)
+{
+	if(bits > 32)
+		return;
+
+	uint32 key = MaskKey(MakeKey(ip), bits);
+	if(m_root < 0)
+	{
+		m_root = NewNode(key, bits);
+		SetBan(m_root, expire);
+		return;
+	}
+
+	int32 parent = -1;
+	uint32 parentBit = 0;
+	int32 cur = m_root;
+	for(;;)
+	{
+		uint32 nodePrefix = m_nodes[cur].Prefix;
+		uint8 nodeLength = m_nodes[cur].Length;
+
+		// Count the leading bits both prefixes share
+		uint8 max = bits < nodeLength ? bits : nodeLength;
+		uint32 diff = key ^ nodePrefix;
+		uint8 common = 0;
+		while(common < max && !BitAt(diff, common))
+			++common;
+
+		if(common == nodeLength)
+		{
+			if(common == bits)
+			{
+				SetBan(cur, expire);
+				return;
+			}
+
+			// Carry on below this node
+			uint32 bit = BitAt(key, nodeLength);
+			if(m_nodes[cur].Child[bit] < 0)
+			{
+				int32 leaf = NewNode(key, bits);
+				SetBan(leaf, expire);
+				m_nodes[cur].Child[bit] = leaf;
+				return;
+			}
+
+			parent = cur;
+			parentBit = bit;
+			cur = m_nodes[cur].Child[bit];
+			continue;
+		}
+
+		// The new range splits the edge leading to this node
+		int32 split;
+		if(common == bits)
+		{
+			split = NewNode(key, bits);
+			SetBan(split, expire);
+			m_nodes[split].Child[BitAt(nodePrefix, bits)] = cur;
+		}
+		else
+		{
+			split = NewNode(key, common);
+			int32 leaf = NewNode(key, bits);
+			SetBan(leaf, expire);
+			m_nodes[split].Child[BitAt(key, common)] = leaf;
+			m_nodes[split].Child[BitAt(nodePrefix, common)] = cur;
+		}
+
+		if(parent < 0)
+			m_root = split;
+		else
+			m_nodes[parent].Child[parentBit] = split;
+		return;
+	}
+}
+
+BAN_STATUS IPBanTree::Lookup(uint32 ip, uint32 now) const
+{
+	BAN_STATUS status = BAN_STATUS_NOT_BANNED;
+	uint32 key = MakeKey(ip);
+	int32 cur = m_root;
+	while(cur >= 0)
+	{
+		const Node & n = m_nodes[cur];
+		if(MaskKey(key, n.Length) != n.Prefix)
+			break;
+
+		if(n.Banned)
+		{
+			if(n.Expire == 0)
+				return BAN_STATUS_PERMANENT_BAN;
+
+			if(now < n.Expire)
+				status = BAN_STATUS_TIME_LEFT_ON_BAN;
+		}
+
+		if(n.Length == 32)
+			break;
+
+		cur = n.Child[BitAt(key, n.Length)];
+	}
+
+	return status;
+}
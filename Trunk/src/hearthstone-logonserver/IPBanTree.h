@@ -0,0 +1,65 @@
+/***
+ * Demonstrike Core
+ */
+
+#ifndef __IPBANTREE_H
+#define __IPBANTREE_H
+
+/************************************************************************/
+/* IPBanTree, path compressed radix tree of CIDR bans                   */
+/************************************************************************/
+// A lookup walks at most 32 bits of the address, no matter how many bans
+// are loaded. The tree is built once and never modified afterwards, so any
+// number of threads may search it without locking; IPBanner builds a new
+// tree whenever the ban list changes and swaps it in.
+
+enum BAN_STATUS
+{
+	BAN_STATUS_NOT_BANNED = 0,
+	BAN_STATUS_TIME_LEFT_ON_BAN = 1,
+	BAN_STATUS_PERMANENT_BAN = 2,
+};
+
+class IPBanTree
+{
+	struct Node
+	{
+		uint32 Prefix;		// Address bits above Length, the rest are zero
+		uint8 Length;
+		bool Banned;
+		uint32 Expire;		// 0 is permanent
+		int32 Child[2];
+	};
+
+public:
+	IPBanTree() : m_root(-1), m_banCount(0) {}
+
+	// Address bytes as stored in an in_addr or returned by MakeIP
+	void Insert(uint32 ip, uint8 bits, uint32 expire);
+
+	// Every ban covering the address is checked, a permanent one wins over a shorter timed one
+	BAN_STATUS Lookup(uint32 ip, uint32 now) const;
+
+	HEARTHSTONE_INLINE uint32 GetBanCount() const { return m_banCount; }
+	HEARTHSTONE_INLINE size_t GetNodeCount() const { return m_nodes.size(); }
+
+private:
+	// Address bytes in order, first byte highest, so tree bits match ParseCIDRBan
+	static HEARTHSTONE_INLINE uint32 MakeKey(uint32 ip)
+	{
+		const uint8 * b = (const uint8*)&ip;
+		return (uint32(b[0]) << 24) | (uint32(b[1]) << 16) | (uint32(b[2]) << 8) | uint32(b[3]);
+	}
+
+	static HEARTHSTONE_INLINE uint32 MaskKey(uint32 key, uint8 bits) { return bits ? (key & (0xFFFFFFFF << (32 - bits))) : 0; }
+	static HEARTHSTONE_INLINE uint32 BitAt(uint32 key, uint8 pos) { return (key >> (31 - pos)) & 1; }
+
+	int32 NewNode(uint32 key, uint8 bits);
+	void SetBan(int32 node, uint32 expire);
+
+	std::vector<Node> m_nodes;
+	int32 m_root;
+	uint32 m_banCount;
+};
+
+#endif
@@ -555,7 +555,7 @@ void LogonCommServerSocket::HandleDatabaseModify(WorldPacket& recvData)
 			if( pAccount == NULL )
 				return;
 
-			pAccount->SetGMFlags( account.c_str() );
+			pAccount->SetGMFlags( gm.c_str() );
 
 			// update it in the sql (duh)
 			sLogonSQL->Execute("UPDATE accounts SET gm = \"%s\" WHERE login = \"%s\"", sLogonSQL->EscapeString(gm).c_str(), sLogonSQL->EscapeString(account).c_str());
@@ -603,6 +603,14 @@ void LogonCommServerSocket::HandleDatabaseModify(WorldPacket& recvData)
 
 		}break;
 
+	case 6:		// account changed outside of the logon server
+		{
+			string account;
+			recvData >> account;
+
+			sAccountMgr.InvalidateAccount(account);
+		}break;
+
 	}
 }
 
@@ -99,6 +99,7 @@ void LogonConsole::ProcessCmd(char *cmd)
 
 		{"?", &LogonConsole::TranslateHelp}, {"help", &LogonConsole::TranslateHelp},
 		{ "reload", &LogonConsole::ReloadAccts},
+		{ "accounts", &LogonConsole::AccountStats},
 		{ "rehash", &LogonConsole::TranslateRehash},
 		{ "list",  &LogonConsole::ListRealms},
 		{"shutdown", &LogonConsole::TranslateQuit}, {"quit", &LogonConsole::TranslateQuit}, {"exit", &LogonConsole::TranslateQuit}, 
@@ -125,6 +126,11 @@ void LogonConsole::ReloadAccts(char *str)
 	IPBanner::getSingleton().Reload();
 }
 
+void LogonConsole::AccountStats(char *str)
+{
+	sAccountMgr.PrintStats();
+}
+
 void LogonConsole::ListRealms(char *str)
 {
 	Realm* rlm = NULL;
@@ -181,6 +187,7 @@ void LogonConsole::ProcessHelp(char *command)
 		sLog.outString("Console:--------help--------");
 		sLog.outString("   help, ?: print this text");
 		sLog.outString("   reload, reloads accounts");
+		sLog.outString("   accounts, shows account cache usage");
 		sLog.outString("   rehash, rehashes config file");
 		sLog.outString("   list, lists all cached realm information");
 		sLog.outString("   quit, shutdown, exit: close program");
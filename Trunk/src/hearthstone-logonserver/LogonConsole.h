@@ -39,6 +39,7 @@ protected:					// Protected methods:
 	void ProcessHelp(char *command);
 
 	void ReloadAccts(char *str);
+	void AccountStats(char *str);
 	void TranslateRehash(char* str);
 	void ListRealms(char *str);
 };
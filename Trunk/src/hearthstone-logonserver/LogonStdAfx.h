@@ -37,6 +37,7 @@
 #include "PeriodicFunctionCall_Thread.h"
 #include "../hearthstone-logonserver/AutoPatcher.h"
 #include "../hearthstone-logonserver/AuthSocket.h"
+#include "../hearthstone-logonserver/AuthCrypto.h"
 #include "../hearthstone-logonserver/AuthStructs.h"
 #include "../hearthstone-logonserver/LogonOpcodes.h"
 #include "../hearthstone-logonserver/LogonCommServer.h"
@@ -343,17 +343,26 @@ void LogonServer::Run(int argc, char ** argv)
 	new InformationCore;
 
 	new PatchMgr;
-	Log.Notice("AccountMgr", "Precaching accounts...");
-	sAccountMgr.ReloadAccounts(true);
-	Log.Notice("AccountMgr", "%u accounts are loaded and ready.", sAccountMgr.GetCount());
+	// Accounts are loaded on first login, only the bans are read up front
+	uint32 cacheSize = Config.MainConfig.GetIntDefault("LogonServer", "AccountCacheSize", 100000);
+	sAccountMgr.Startup(cacheSize);
+	sIPBanner.Reload();
+	Log.Notice("AccountMgr", "Account cache ready, holding up to %u accounts.", cacheSize);
 	Log.Line();
 
+	new AuthCryptoPool;
+	sAuthCrypto.Startup(Config.MainConfig.GetIntDefault("LogonServer", "CryptoThreads", 2), Config.MainConfig.GetIntDefault("LogonServer", "MaxPendingAuth", 512));
+
 	// Spawn periodic function caller thread for account reload every 10mins
 	int atime = Config.MainConfig.GetIntDefault("Rates", "AccountRefresh",600);
 	atime *= 1000;
 	PeriodicFunctionCaller<AccountMgr> * pfc = new PeriodicFunctionCaller<AccountMgr>(AccountMgr::getSingletonPtr(),&AccountMgr::ReloadAccountsCallback, atime);
 	ThreadPool.ExecuteTask("PeriodicFunctionCaller", pfc);
 
+	// Expired ip bans are swept out here rather than on connect
+	PeriodicFunctionCaller<IPBanner> * ipfc = new PeriodicFunctionCaller<IPBanner>(IPBanner::getSingletonPtr(), &IPBanner::ExpireBans, 60000);
+	ThreadPool.ExecuteTask("PeriodicFunctionCaller", ipfc);
+
 	// Load conf settings..
 	uint32 cport = Config.MainConfig.GetIntDefault("Listen", "RealmListPort", 3724);
 	uint32 sport = Config.MainConfig.GetIntDefault("Listen", "ServerPort", 8093);
@@ -439,16 +448,22 @@ void LogonServer::Run(int argc, char ** argv)
 	signal(SIGHUP, 0);
 #endif
 	pfc->kill();
+	ipfc->kill();
 
 	cl->Disconnect();
 	sl->Disconnect();
 
+	Log.Notice( "AuthCrypto", "Shutting down crypto threads." );
+	sAuthCrypto.Shutdown();
+
 	Log.Notice( "Network", "Shutting down network subsystem." );
 	sSocketEngine.Shutdown();
 
 	sLogonConsole.Kill();
 	delete LogonConsole::getSingletonPtr();
 
+	sAccountMgr.Shutdown();
+
 	// kill db
 	sLog.outString("Waiting for database to close..");
 	sLogonSQL->Shutdown();
@@ -460,11 +475,13 @@ void LogonServer::Run(int argc, char ** argv)
 	remove("logonserver.pid");
 
 	delete AccountMgr::getSingletonPtr();
+	delete AuthCryptoPool::getSingletonPtr();
 	delete InformationCore::getSingletonPtr();
 	delete IPBanner::getSingletonPtr();
 	delete SocketEngine::getSingletonPtr();
 	delete SocketDeleter::getSingletonPtr();
 	delete pfc;
+	delete ipfc;
 	Log.Notice("LogonServer","Shutdown complete.\n");
 }
 
@@ -329,17 +329,31 @@ namespace VMAP
 		}
 		iLoadedSpawns.clear();
 		iLoadedTiles.clear();
+		iTileSpawns.clear();
 	}
 
 	//=========================================================
 
 	bool StaticMapTree::LoadMapTile(uint32 tileX, uint32 tileY, VMapManager2 *vm)
 	{
+		PreparedTile tile;
+		if (!PrepareMapTile(tileX, tileY, vm, tile))
+			return false;
+		ApplyMapTile(tile);
+		return tile.complete;
+	}
+
+	//=========================================================
+	// Reads the tile file and acquires its models. Only touches what InitMap set up, so it can run without the map's lock
+
+	bool StaticMapTree::PrepareMapTile(uint32 tileX, uint32 tileY, VMapManager2 *vm, PreparedTile &tile) const
+	{
+		tile.tileX = tileX;
+		tile.tileY = tileY;
 		if (!iIsTiled)
 		{
 			// currently, core creates grids for all maps, whether it has terrain tiles or not
 			// so we need "fake" tile loads to know when we can unload map geometry
-			iLoadedTiles[packTileID(tileX, tileY)] = false;
 			return true;
 		}
 		if (!iTreeValues)
@@ -347,18 +361,20 @@ namespace VMAP
 			ERROR_LOG("StaticMapTree::LoadMapTile(): Tree has not been initialized! [%u,%u]", tileX, tileY);
 			return false;
 		}
-		bool result = true;
 
 		std::string tilefile = iBasePath + getTileFileName(iMapID, tileX, tileY);
 		FILE* tf = fopen(tilefile.c_str(), "rb");
 		if (tf)
 		{
+			bool result = true;
 			char chunk[8];
 			if (!readChunk(tf, chunk, VMAP_MAGIC, 8))
 				result = false;
 			uint32 numSpawns;
 			if (result && fread(&numSpawns, sizeof(uint32), 1, tf) != 1)
 				result = false;
+			if (result)
+				tile.spawns.reserve(numSpawns);
 			for (uint32 i=0; i<numSpawns && result; ++i)
 			{
 				// read model spawns
@@ -371,40 +387,69 @@ namespace VMAP
 					if (!model)
 						ERROR_LOG("StaticMapTree::LoadMapTile() could not acquire WorldModel pointer for '%s'!", spawn.name.c_str());
 
-					// update tree
 					uint32 referencedVal;
-
 					fread(&referencedVal, sizeof(uint32), 1, tf);
-					if (!iLoadedSpawns.count(referencedVal))
-					{
 #ifdef VMAP_DEBUG
-						if (referencedVal > iNTreeValues)
-						{
-							DEBUG_LOG("MapTree", "invalid tree element! (%u/%u)", referencedVal, iNTreeValues);
-							continue;
-						}
-#endif
-						iTreeValues[referencedVal] = ModelInstance(spawn, model);
-						iLoadedSpawns[referencedVal] = 1;
-					}
-					else
+					if (referencedVal > iNTreeValues)
 					{
-						++iLoadedSpawns[referencedVal];
-#ifdef VMAP_DEBUG
-						if (iTreeValues[referencedVal].ID != spawn.ID)
-							DEBUG_LOG("MapTree", "Error: trying to load wrong spawn in node!");
-						else if (iTreeValues[referencedVal].name != spawn.name)
-							DEBUG_LOG("MapTree", "Error: name mismatch on GUID=%u", spawn.ID);
-#endif
+						DEBUG_LOG("MapTree", "invalid tree element! (%u/%u)", referencedVal, iNTreeValues);
+						continue;
 					}
+#endif
+					tile.spawns.push_back(std::make_pair(referencedVal, ModelInstance(spawn, model)));
 				}
 			}
-			iLoadedTiles[packTileID(tileX, tileY)] = true;
+			tile.hasFile = true;
+			tile.complete = result;
 			fclose(tf);
 		}
-		else
-			iLoadedTiles[packTileID(tileX, tileY)] = false;
-		return result;
+		return true;
+	}
+
+	//=========================================================
+	// Links a prepared tile into the tree, needs the map's write lock
+
+	void StaticMapTree::ApplyMapTile(PreparedTile &tile)
+	{
+		uint32 tileID = packTileID(tile.tileX, tile.tileY);
+		iLoadedTiles[tileID] = tile.hasFile;
+		if (!tile.hasFile)
+			return;
+
+		tileSpawnList &tileSpawns = iTileSpawns[tileID];
+		tileSpawns.reserve(tile.spawns.size());
+		for (size_t i = 0; i < tile.spawns.size(); ++i)
+		{
+			uint32 referencedVal = tile.spawns[i].first;
+			ModelInstance &instance = tile.spawns[i].second;
+			if (!iLoadedSpawns.count(referencedVal))
+			{
+				iTreeValues[referencedVal] = instance;
+				iLoadedSpawns[referencedVal] = 1;
+			}
+			else
+			{
+				++iLoadedSpawns[referencedVal];
+#ifdef VMAP_DEBUG
+				if (iTreeValues[referencedVal].ID != instance.ID)
+					DEBUG_LOG("MapTree", "Error: trying to load wrong spawn in node!");
+				else if (iTreeValues[referencedVal].name != instance.name)
+					DEBUG_LOG("MapTree", "Error: name mismatch on GUID=%u", instance.ID);
+#endif
+			}
+			tileSpawns.push_back(std::make_pair(referencedVal, instance.name));
+		}
+		tile.spawns.clear();
+	}
+
+	//=========================================================
+	// Gives back the models of a tile that was prepared but will never be applied
+
+	void StaticMapTree::ReleasePreparedTile(PreparedTile &tile, VMapManager2 *vm)
+	{
+		for (size_t i = 0; i < tile.spawns.size(); ++i)
+			vm->releaseModelInstance(tile.spawns[i].second.name);
+		tile.spawns.clear();
 	}
 
 	//=========================================================
@@ -420,43 +465,27 @@ namespace VMAP
 		}
 		if (tile->second) // file associated with tile
 		{
-			std::string tilefile = iBasePath + getTileFileName(iMapID, tileX, tileY);
-			FILE* tf = fopen(tilefile.c_str(), "rb");
-			if (tf)
+			loadedTileSpawnMap::iterator spawns = iTileSpawns.find(tileID);
+			if (spawns != iTileSpawns.end())
 			{
-				bool result=true;
-				char chunk[8];
-				if (!readChunk(tf, chunk, VMAP_MAGIC, 8))
-					result = false;
-				uint32 numSpawns;
-				if (fread(&numSpawns, sizeof(uint32), 1, tf) != 1)
-					result = false;
-				for (uint32 i=0; i<numSpawns && result; ++i)
+				for (tileSpawnList::iterator itr = spawns->second.begin(); itr != spawns->second.end(); ++itr)
 				{
-					// read model spawns
-					ModelSpawn spawn;
-					result = ModelSpawn::readFromFile(tf, spawn);
-					if (result)
+					// release model instance
+					vm->releaseModelInstance(itr->second);
+
+					// update tree
+					uint32 referencedNode = itr->first;
+					if (!iLoadedSpawns.count(referencedNode))
 					{
-						// release model instance
-						vm->releaseModelInstance(spawn.name);
-
-						// update tree
-						uint32 referencedNode;
-
-						fread(&referencedNode, sizeof(uint32), 1, tf);
-						if (!iLoadedSpawns.count(referencedNode))
-						{
-							ERROR_LOG("Trying to unload non-referenced model '%s' (ID:%u)", spawn.name.c_str(), spawn.ID);
-						}
-						else if (--iLoadedSpawns[referencedNode] == 0)
-						{
-							iTreeValues[referencedNode].setUnloaded();
-							iLoadedSpawns.erase(referencedNode);
-						}
+						ERROR_LOG("Trying to unload non-referenced model '%s' (node:%u)", itr->second.c_str(), referencedNode);
+					}
+					else if (--iLoadedSpawns[referencedNode] == 0)
+					{
+						iTreeValues[referencedNode].setUnloaded();
+						iLoadedSpawns.erase(referencedNode);
 					}
 				}
-				fclose(tf);
+				iTileSpawns.erase(spawns);
 			}
 		}
 		iLoadedTiles.erase(tile);
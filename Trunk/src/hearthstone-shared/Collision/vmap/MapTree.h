@@ -6,6 +6,7 @@
 
 #include "../../Common.h"
 #include "BIH.h"
+#include "ModelInstance.h"
 
 /*Flag	Meaning
 0x1		Always set
@@ -47,6 +48,17 @@ namespace VMAP
 	class GroupModel;
 	class VMapManager2;
 
+	// A tile read from disk with its models acquired, but not yet linked into the tree.
+	// Reading needs no lock on the tree, only linking does.
+	struct PreparedTile
+	{
+		PreparedTile() : tileX(0), tileY(0), hasFile(false), complete(true) {}
+		uint32 tileX, tileY;
+		bool hasFile;
+		bool complete;
+		std::vector<std::pair<uint32, ModelInstance> > spawns;	// tree index, instance
+	};
+
 	struct LocationInfo
 	{
 		LocationInfo(): hitInstance(0), hitModel(0), ground_Z(-G3D::inf()) {};
@@ -59,6 +71,8 @@ namespace VMAP
 	{
 		typedef UNORDERED_MAP<uint32, bool> loadedTileMap;
 		typedef UNORDERED_MAP<uint32, uint32> loadedSpawnMap;
+		typedef std::vector<std::pair<uint32, std::string> > tileSpawnList;
+		typedef UNORDERED_MAP<uint32, tileSpawnList> loadedTileSpawnMap;
 		private:
 			uint32 iMapID;
 			bool iIsTiled;
@@ -72,6 +86,8 @@ namespace VMAP
 			loadedTileMap iLoadedTiles;
 			// stores <tree_index, reference_count> to invalidate tree values, unload map, and to be able to report errors
 			loadedSpawnMap iLoadedSpawns;
+			// <tree_index, model name> of every spawn a loaded tile referenced, so unloading doesn't have to read the tile again
+			loadedTileSpawnMap iTileSpawns;
 			std::string iBasePath;
 
 		private:
@@ -96,6 +112,9 @@ namespace VMAP
 			bool InitMap(const std::string &fname, VMapManager2 *vm);
 			void UnloadMap(VMapManager2 *vm);
 			bool LoadMapTile(uint32 tileX, uint32 tileY, VMapManager2 *vm);
+			bool PrepareMapTile(uint32 tileX, uint32 tileY, VMapManager2 *vm, PreparedTile &tile) const;
+			void ApplyMapTile(PreparedTile &tile);
+			static void ReleasePreparedTile(PreparedTile &tile, VMapManager2 *vm);
 			void UnloadMapTile(uint32 tileX, uint32 tileY, VMapManager2 *vm);
 			bool isTiled() const { return iIsTiled; }
 			uint32 numLoadedTiles() const { return uint32(iLoadedTiles.size()); }
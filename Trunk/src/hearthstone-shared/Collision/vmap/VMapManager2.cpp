@@ -125,17 +125,58 @@ namespace VMAP
 
 	bool VMapManager2::_loadMap(unsigned int pMapId, const std::string &basePath, uint32 tileX, uint32 tileY)
 	{
+		if (!initMap(basePath.c_str(), pMapId))
+			return false;
+		return iInstanceMapTrees[pMapId]->LoadMapTile(tileX, tileY, this);
+	}
+
+	//=========================================================
+
+	bool VMapManager2::initMap(const char* pBasePath, unsigned int pMapId)
+	{
+		if (iIgnoreMapIds.count(pMapId))
+			return false;
+
 		InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-		if (instanceTree == iInstanceMapTrees.end())
+		if (instanceTree != iInstanceMapTrees.end())
+			return true;
+
+		std::string mapFileName = getMapFileName(pMapId);
+		StaticMapTree *newTree = new StaticMapTree(pMapId, pBasePath);
+		if (!newTree->InitMap(mapFileName, this))
 		{
-			std::string mapFileName = getMapFileName(pMapId);
-			StaticMapTree *newTree = new StaticMapTree(pMapId, basePath);
-			if (!newTree->InitMap(mapFileName, this))
-				return false;
+			delete newTree;
+			return false;
+		}
+
+		iInstanceMapTrees.insert(InstanceTreeMap::value_type(pMapId, newTree));
+		return true;
+	}
+
+	//=========================================================
+
+	bool VMapManager2::prepareMapTile(unsigned int pMapId, int x, int y, PreparedTile &tile)
+	{
+		InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+		if (instanceTree == iInstanceMapTrees.end())
+			return false;
+		return instanceTree->second->PrepareMapTile(x, y, this, tile);
+	}
 
-			instanceTree = iInstanceMapTrees.insert(InstanceTreeMap::value_type(pMapId, newTree)).first;
+	void VMapManager2::applyMapTile(unsigned int pMapId, PreparedTile &tile)
+	{
+		InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+		if (instanceTree == iInstanceMapTrees.end())
+		{
+			releasePreparedTile(tile);
+			return;
 		}
-		return instanceTree->second->LoadMapTile(tileX, tileY, this);
+		instanceTree->second->ApplyMapTile(tile);
+	}
+
+	void VMapManager2::releasePreparedTile(PreparedTile &tile)
+	{
+		StaticMapTree::ReleasePreparedTile(tile, this);
 	}
 
 	//=========================================================
@@ -156,18 +197,12 @@ namespace VMAP
 
 	//=========================================================
 
+	// The tree itself stays, other tiles of the map may be loading from it; unloadMap(pMapId) frees it
 	void VMapManager2::unloadMap(unsigned int  pMapId, int x, int y)
 	{
 		InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
 		if (instanceTree != iInstanceMapTrees.end())
-		{
 			instanceTree->second->UnloadMapTile(x, y, this);
-			if (instanceTree->second->numLoadedTiles() == 0)
-			{
-				delete instanceTree->second;
-				iInstanceMapTrees.erase(pMapId);
-			}
-		}
 	}
 
 	//==========================================================
@@ -288,9 +323,12 @@ namespace VMAP
 
 	WorldModel* VMapManager2::acquireModelInstance(const std::string &basepath, const std::string &filename)
 	{
+		iModelLock.Acquire();
 		ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
 		if (model == iLoadedModelFiles.end())
 		{
+			// Read without the lock so a map thread releasing models doesn't wait on the disk
+			iModelLock.Release();
 			WorldModel *worldmodel = new WorldModel();
 			if (!worldmodel->readFile(basepath + filename + ".vmo"))
 			{
@@ -299,21 +337,31 @@ namespace VMAP
 				return NULL;
 			}
 
-			DEBUG_LOG("VMapManager2", "Loading file '%s%s'.", basepath.c_str(), filename.c_str());
-			ManagedModel *Managed = new ManagedModel();
-			Managed->setModel(worldmodel);
-			iLoadedModelFiles.insert(make_pair(filename, Managed));
+			iModelLock.Acquire();
 			model = iLoadedModelFiles.find(filename);
+			if (model == iLoadedModelFiles.end())
+			{
+				DEBUG_LOG("VMapManager2", "Loading file '%s%s'.", basepath.c_str(), filename.c_str());
+				ManagedModel *Managed = new ManagedModel();
+				Managed->setModel(worldmodel);
+				model = iLoadedModelFiles.insert(make_pair(filename, Managed)).first;
+			}
+			else
+				delete worldmodel;	// someone else loaded it meanwhile
 		}
 		model->second->incRefCount();
-		return model->second->getModel();
+		WorldModel *result = model->second->getModel();
+		iModelLock.Release();
+		return result;
 	}
 
 	void VMapManager2::releaseModelInstance(const std::string &filename)
 	{
+		iModelLock.Acquire();
 		ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
 		if (model == iLoadedModelFiles.end())
 		{
+			iModelLock.Release();
 			ERROR_LOG("VMapManager2: trying to unload non-loaded file '%s'!", filename.c_str());
 			return;
 		}
@@ -324,6 +372,7 @@ namespace VMAP
 			delete model->second;
 			iLoadedModelFiles.erase(model);
 		}
+		iModelLock.Release();
 	}
 	//=========================================================
 
@@ -37,6 +37,7 @@ namespace VMAP
 
 	class StaticMapTree;
 	class WorldModel;
+	struct PreparedTile;
 
 	class ManagedModel
 	{
@@ -59,6 +60,7 @@ namespace VMAP
 		protected:
 			// Tree to check collision
 			ModelFileMap iLoadedModelFiles;
+			Mutex iModelLock;	// tiles load on their own thread, models are shared between maps
 			InstanceTreeMap iInstanceMapTrees;
 			// UNORDERED_MAP<unsigned int , bool> iMapsSplitIntoTiles;
 			UNORDERED_MAP<unsigned int , bool> iIgnoreMapIds;
@@ -77,6 +79,13 @@ namespace VMAP
 
 			VMAPLoadResult loadMap(const char* pBasePath, unsigned int pMapId, int x, int y);
 
+			// Loading a tile in two steps: prepare reads it without touching the tree, apply links it in.
+			// The map has to be initialized first and stays until unloadMap(pMapId).
+			bool initMap(const char* pBasePath, unsigned int pMapId);
+			bool prepareMapTile(unsigned int pMapId, int x, int y, PreparedTile &tile);
+			void applyMapTile(unsigned int pMapId, PreparedTile &tile);
+			void releasePreparedTile(PreparedTile &tile);
+
 			void unloadMap(unsigned int pMapId, int x, int y);
 			void unloadMap(unsigned int pMapId);
 
@@ -462,6 +462,16 @@ Scripting system exports/imports
 	#define SCRIPT_DECL
 #endif
 
+/*
+Thread local storage, only valid for POD types
+*/
+
+#if COMPILER == COMPILER_MICROSOFT
+	#define THREAD_LOCAL __declspec(thread)
+#else
+	#define THREAD_LOCAL __thread
+#endif
+
 
 // Include all threading files
 #include <assert.h>
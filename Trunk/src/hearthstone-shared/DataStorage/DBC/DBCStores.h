@@ -737,6 +737,7 @@ struct SpellEntry
 	float ProcsPerMinute;				//!!! CUSTOM, number of procs per minute
 	uint32 buffIndexType;				//!!! CUSTOM, Tells us what type of buff it is, so we can limit the amount of them.
 	uint32 c_is_flags;					//!!! CUSTOM, store spell checks in a static way : isdamageind,ishealing
+	uint32 c_behaviour[2];				//!!! CUSTOM, NameHash special cases compiled to bits, see SpellBehaviour
 	uint32 buffType;					//!!! CUSTOM, these are related to creating a item through a spell
 	uint32 RankNumber;					//!!! CUSTOM, this protects players from having >1 rank of a spell
 	uint32 NameHash;					//!!! CUSTOM, related to custom spells, summon spell quest related spells
@@ -787,6 +788,7 @@ struct SpellEntry
 
 	// Queries/Commands:
 	bool IsChannelSpell() { return ((AttributesEx & (0x04|0x40)) ? true : (ChannelInterruptFlags != 0 ? true : false)); }
+	bool HasBehaviour(uint32 behaviour) { return (c_behaviour[behaviour >> 5] & (1u << (behaviour & 31))) != 0; }
 };
 
 struct SpellDifficultyEntry
@@ -5,6 +5,7 @@
 #include "DatabaseEnv.h"
 #include "../CrashHandler.h"
 #include "../NGLog.h"
+#include "../Timer.h"
 
 SQLCallbackBase::~SQLCallbackBase()
 {
@@ -47,6 +48,7 @@ bool Database::Initialize(const char* Hostname, unsigned int port, const char* U
 	m_connections = new DatabaseConnection[ConnectionCount];
 	for( i = 0; i < ConnectionCount; ++i )
 	{
+		m_connections[i].Busy.SetLockName("DatabaseConnection::Busy");
 		temp = mysql_init( NULL );
 		if(temp == NULL)
 			continue;
@@ -414,7 +416,10 @@ string Database::EscapeString(const char * esc, DatabaseConnection * con)
 bool Database::_SendQuery(DatabaseConnection *con, const char* Sql, bool Self)
 {
 	//dunno what it does ...leaving untouched 
+	uint64 start = getUSTime();
 	int result = mysql_query(con->conn, Sql);
+	++QueriesSent;
+	QueryTimeUs.Add(long(getUSTime() - start));
 	if(result > 0)
 	{
 		if( Self == false && _HandleError(con, mysql_errno( con->conn ) ) )
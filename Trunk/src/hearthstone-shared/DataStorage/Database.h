@@ -6,6 +6,7 @@
 
 #include <string>
 #include "../Threading/Queue.h"
+#include "../Threading/AtomicCounter.h"
 #include "../CallBack.h"
 #include "../../../dependencies/VC/include/mysql/mysql.h"
 
@@ -86,6 +87,11 @@ public:
 	HEARTHSTONE_INLINE const string& GetHostName() { return mHostname; }
 	HEARTHSTONE_INLINE const string& GetDatabaseName() { return mDatabaseName; }
 	HEARTHSTONE_INLINE const uint32 GetQueueSize() { return queries_queue.get_size(); }
+	HEARTHSTONE_INLINE const uint32 GetBufferQueueSize() { return query_buffer.get_size(); }
+
+	// Every statement sent to the server and the time spent waiting for it, never reset
+	AtomicCounter QueriesSent;
+	AtomicCounter QueryTimeUs;
 
 	string EscapeString(string Escape);
 	void EscapeLongString(const char * str, uint32 len, stringstream& out);
@@ -29,6 +29,7 @@ void InitRandomNumberGenerators()
 	for(uint32 i = 0; i < NUMBER_OF_GENERATORS; ++i) {
 		m_generators[i] = new CRandomMersenne(generate_seed());
 		m_locks[i] = new Mutex();
+		m_locks[i]->SetLockName("RandomNumberGenerator");
 	}
 }
 
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "../Threading/ThreadPool.h"
+#include "../Threading/AtomicCounter.h"
 
 class ThreadContext;
 
@@ -37,6 +38,14 @@ public:
 	/** Called by SocketWorkerThread, this is the network loop.
 	 */
 	virtual void MessageLoop() = 0;
+
+	/** Connected sockets and their traffic, never reset. Events counts the
+	 * readiness notifications of the engines that report them in batches.
+	 */
+	AtomicCounter Connections;
+	AtomicCounter BytesReceived;
+	AtomicCounter BytesSent;
+	AtomicCounter Events;
 };
 
 class SERVER_DECL SocketEngineThread : public ThreadContext
@@ -67,6 +67,8 @@ void epollEngine::MessageLoop()
 	while(m_running)
 	{
         	nfds = epoll_wait(epoll_fd, events, maxevents, 1000);
+		if(nfds > 0)
+			Events.Add(nfds);
 		for(i = 0; i < nfds; ++i)
 		{
 	            s = fds[events[i].data.fd];
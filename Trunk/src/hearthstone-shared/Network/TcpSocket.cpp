@@ -55,11 +55,16 @@ void TcpSocket::OnRead(size_t len)
 	}
 
 	/* IOCP is easy. */
+	LockReadBuffer();
 	if(len != 0xFFFFFFFF)
+	{
 		m_readBuffer->IncrementWritten(len);
+		sSocketEngine.BytesReceived.Add(long(len));
+	}
 
 	/* Wewt, we read again! */
 	OnRecvData();
+	UnlockReadBuffer();
 
 	if(!IsConnected())
 		return;
@@ -84,16 +89,22 @@ void TcpSocket::OnRead(size_t len)
 #else
 
 	/* Any other platform, we have to call recv() to actually get the data. */
+	LockReadBuffer();
 	int bytes = recv(m_fd, (char*)m_readBuffer->GetBuffer(), m_readBuffer->GetSpace(), 0);
 
 	/* Under some socket engines, if this returns 0, we're in deep poo poo. */
 	/* Check if recv() failed. */
 	if(bytes <= 0)
+	{
+		UnlockReadBuffer();
 		Disconnect();			// whoopes. :P
+	}
 	else
 	{
 		m_readBuffer->IncrementWritten(bytes);
+		sSocketEngine.BytesReceived.Add(bytes);
 		OnRecvData();
+		UnlockReadBuffer();
 	}
 
 #endif
@@ -115,6 +126,7 @@ void TcpSocket::OnWrite(size_t len)
 	}
 
 	m_writeBuffer->Remove(len);
+	sSocketEngine.BytesSent.Add(long(len));
 
 	/* Do we still have data to write? */
 	if(m_writeBuffer->GetSize())
@@ -129,7 +141,10 @@ void TcpSocket::OnWrite(size_t len)
 	if(bytes < 0)
 		Disconnect();
 	else
+	{
 		m_writeBuffer->Remove(bytes);
+		sSocketEngine.BytesSent.Add(bytes);
+	}
 #endif
 
 	/* Unlock the write buffer, we're finished */
@@ -139,6 +154,7 @@ void TcpSocket::OnWrite(size_t len)
 void TcpSocket::Finalize()
 {
 	sSocketEngine.AddSocket(this);
+	++sSocketEngine.Connections;
 	OnConnect();
 }
 
@@ -192,6 +208,7 @@ void TcpSocket::Disconnect()
 
 	OnDisconnect();
 	sSocketEngine.RemoveSocket(this);
+	--sSocketEngine.Connections;
 	shutdown(m_fd, SD_BOTH);
 	closesocket(m_fd);
 
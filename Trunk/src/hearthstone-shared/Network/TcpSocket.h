@@ -28,6 +28,15 @@ public:
 	 */
 	inline void UnlockWriteBuffer() { m_writeMutex.Release(); }
 
+	/** Locks the socket's read buffer. OnRecvData runs with it held, so another
+	 * thread can lock it to process data the socket thread left buffered.
+	 */
+	inline void LockReadBuffer() { m_readMutex.Acquire(); }
+
+	/** Unlocks the socket's read buffer
+	 */
+	inline void UnlockReadBuffer() { m_readMutex.Release(); }
+
 	/** Writes the specified data to the end of the socket's write buffer without sending
 	 */
 	bool WriteButHold(const void * data, size_t bytes) { return m_writeBuffer->Write(data, bytes); };
@@ -105,6 +114,10 @@ protected:
 	/** Socket's write buffer protection
 	 */
 	Mutex m_writeMutex;
+
+	/** Socket's read buffer protection
+	 */
+	Mutex m_readMutex;
 };
 
 /** Connect to a server.
@@ -0,0 +1,155 @@
+/***
+ * Demonstrike Core
+ */
+
+#pragma once
+
+/************************************************************************/
+/* ObjectPool, per thread free lists for frequently churned objects     */
+/************************************************************************/
+// Storage is handed out from the calling thread's free list and given back
+// to the free list of whichever thread releases it, so neither side locks.
+// The pool only recycles raw storage; the constructor of the pooled class
+// is what resets an instance, so a recycled object is never visible in its
+// old state. Requests for a different size (derived classes) bypass the pool.
+//
+// Defining POOL_POISON fills released blocks with a pattern which is checked
+// again when the block is reused, catching writes through dangling pointers.
+
+#define POOL_MAX_CACHED_PER_THREAD 4096
+#define POOL_POISON_BYTE 0xDD
+
+struct ObjectPoolStats
+{
+	long allocations;		// Total requests served
+	long recycled;			// Requests served from a free list
+	long inUse;				// Live objects handed out by the pool
+	long cached;			// Blocks sitting in free lists, all threads
+	long poisonFaults;		// Released blocks that were written to
+};
+
+template<class T>
+class ObjectPool
+{
+	struct FreeBlock
+	{
+		FreeBlock * next;
+	};
+
+public:
+	static void * Allocate(size_t size)
+	{
+		if(size != sizeof(T))
+			return ::operator new(size);
+
+		++m_allocations;
+		++m_inUse;
+
+		FreeBlock * block = t_freeList;
+		if(block == NULL)
+			return ::operator new(size);
+
+		t_freeList = block->next;
+		--t_freeCount;
+		--m_cached;
+		++m_recycled;
+
+#ifdef POOL_POISON
+		CheckPoison(block);
+#endif
+		return block;
+	}
+
+	static void Free(void * ptr, size_t size)
+	{
+		if(ptr == NULL)
+			return;
+
+		if(size != sizeof(T))
+		{
+			::operator delete(ptr);
+			return;
+		}
+
+		--m_inUse;
+		if(t_freeCount >= POOL_MAX_CACHED_PER_THREAD)
+		{
+			::operator delete(ptr);
+			return;
+		}
+
+#ifdef POOL_POISON
+		memset(ptr, POOL_POISON_BYTE, sizeof(T));
+#endif
+
+		FreeBlock * block = (FreeBlock*)ptr;
+		block->next = t_freeList;
+		t_freeList = block;
+		++t_freeCount;
+		++m_cached;
+	}
+
+	static void GetStats(ObjectPoolStats & stats)
+	{
+		stats.allocations = m_allocations.GetVal();
+		stats.recycled = m_recycled.GetVal();
+		stats.inUse = m_inUse.GetVal();
+		stats.cached = m_cached.GetVal();
+		stats.poisonFaults = m_poisonFaults.GetVal();
+	}
+
+	// Releases the calling thread's cached blocks back to the heap
+	static void Trim()
+	{
+		while(t_freeList != NULL)
+		{
+			FreeBlock * block = t_freeList;
+			t_freeList = block->next;
+			--m_cached;
+			::operator delete(block);
+		}
+		t_freeCount = 0;
+	}
+
+private:
+#ifdef POOL_POISON
+	static void CheckPoison(FreeBlock * block)
+	{
+		const uint8 * p = ((const uint8*)block) + sizeof(FreeBlock);
+		for(size_t i = 0; i < sizeof(T) - sizeof(FreeBlock); ++i)
+		{
+			if(p[i] != POOL_POISON_BYTE)
+			{
+				++m_poisonFaults;
+				fprintf(stderr, "ObjectPool: block %p of size %u was modified after release (offset %u)\n",
+					(void*)block, (uint32)sizeof(T), (uint32)(i + sizeof(FreeBlock)));
+				ASSERT(false);
+				break;
+			}
+		}
+	}
+#endif
+
+	static THREAD_LOCAL FreeBlock * t_freeList;
+	static THREAD_LOCAL uint32 t_freeCount;
+
+	static AtomicCounter m_allocations;
+	static AtomicCounter m_recycled;
+	static AtomicCounter m_inUse;
+	static AtomicCounter m_cached;
+	static AtomicCounter m_poisonFaults;
+};
+
+template<class T> THREAD_LOCAL typename ObjectPool<T>::FreeBlock * ObjectPool<T>::t_freeList = NULL;
+template<class T> THREAD_LOCAL uint32 ObjectPool<T>::t_freeCount = 0;
+template<class T> AtomicCounter ObjectPool<T>::m_allocations;
+template<class T> AtomicCounter ObjectPool<T>::m_recycled;
+template<class T> AtomicCounter ObjectPool<T>::m_inUse;
+template<class T> AtomicCounter ObjectPool<T>::m_cached;
+template<class T> AtomicCounter ObjectPool<T>::m_poisonFaults;
+
+/** Routes a class' heap allocations through ObjectPool. Place inside the class body.
+ */
+#define DECLARE_POOLED_ALLOCATOR(type) \
+	static void * operator new(size_t size) { return ObjectPool<type>::Allocate(size); } \
+	static void operator delete(void * ptr, size_t size) { ObjectPool<type>::Free(ptr, size); }
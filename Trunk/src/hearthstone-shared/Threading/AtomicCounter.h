@@ -0,0 +1,36 @@
+/***
+ * Demonstrike Core
+ */
+
+#pragma once
+
+/************************************************************************/
+/* Lock free counter, used for statistics shared between threads        */
+/************************************************************************/
+
+class AtomicCounter
+{
+public:
+	HEARTHSTONE_INLINE AtomicCounter() : m_value(0) {}
+
+#if PLATFORM == PLATFORM_WIN
+	HEARTHSTONE_INLINE long operator++() { return InterlockedIncrement(&m_value); }
+	HEARTHSTONE_INLINE long operator--() { return InterlockedDecrement(&m_value); }
+	HEARTHSTONE_INLINE long Add(long val) { return InterlockedExchangeAdd(&m_value, val) + val; }
+	HEARTHSTONE_INLINE long Exchange(long val) { return InterlockedExchange(&m_value, val); }
+#else
+	HEARTHSTONE_INLINE long operator++() { return __sync_add_and_fetch(&m_value, 1); }
+	HEARTHSTONE_INLINE long operator--() { return __sync_sub_and_fetch(&m_value, 1); }
+	HEARTHSTONE_INLINE long Add(long val) { return __sync_add_and_fetch(&m_value, val); }
+	HEARTHSTONE_INLINE long Exchange(long val) { return __sync_lock_test_and_set(&m_value, val); }
+#endif
+
+	HEARTHSTONE_INLINE long GetVal() const { return m_value; }
+
+private:
+	// Disallow copying, every counter is a unique shared location
+	AtomicCounter(const AtomicCounter&);
+	AtomicCounter& operator=(const AtomicCounter&);
+
+	volatile long m_value;
+};
@@ -0,0 +1,177 @@
+/***
+ * Demonstrike Core
+ */
+
+#include "../Common.h"
+#include "LockStats.h"
+
+#if PLATFORM == PLATFORM_WIN
+#define LOCKSTATS_ADD(x, n) InterlockedExchangeAdd64((volatile LONGLONG*)&(x), LONGLONG(n))
+#define LOCKSTATS_CAS(x, cmp, val) uint64(InterlockedCompareExchange64((volatile LONGLONG*)&(x), LONGLONG(val), LONGLONG(cmp)))
+#else
+#define LOCKSTATS_ADD(x, n) __sync_add_and_fetch(&(x), uint64(n))
+#define LOCKSTATS_CAS(x, cmp, val) __sync_val_compare_and_swap(&(x), uint64(cmp), uint64(val))
+#endif
+
+static HEARTHSTONE_INLINE uint32 GetLockStatsBucket(uint64 us)
+{
+	uint32 bucket = 0;
+	while(us != 0 && bucket < LOCK_STATS_BUCKETS - 1)
+	{
+		us >>= 1;
+		++bucket;
+	}
+	return bucket;
+}
+
+static HEARTHSTONE_INLINE void UpdateMax(uint64 & max, uint64 value)
+{
+	uint64 seen = max;
+	while(value > seen)
+	{
+		uint64 prev = LOCKSTATS_CAS(max, seen, value);
+		if(prev == seen)
+			break;
+		seen = prev;
+	}
+}
+
+uint32 LockStatsData::GetPercentile(const uint64 * buckets, uint64 count, uint64 max, uint32 percent)
+{
+	uint64 target = (count * percent + 99) / 100, seen = 0;
+	for(uint32 i = 0; i < LOCK_STATS_BUCKETS; ++i)
+	{
+		seen += buckets[i];
+		if(seen >= target && seen != 0)
+		{
+			// Bucket i holds [2^(i-1), 2^i) us
+			uint64 limit = (i == 0 ? 0 : (uint64(1) << i) - 1);
+			return uint32(std::min(limit, max));
+		}
+	}
+	return uint32(max);
+}
+
+// Locks get named from constructors, some of which run before main or on any thread, so the registry is built on first use
+typedef std::map<std::string, LockStatsData*> LockStatsMap;
+static Mutex * volatile s_registryLock = NULL;
+static LockStatsMap * s_registry = NULL;
+static time_t s_resetTime = 0;
+
+static void ClearLockStats(LockStatsData * stats)
+{
+	stats->Acquires = stats->Contended = stats->FailedTries = stats->Recursions = 0;
+	stats->WaitUs = stats->HoldUs = stats->MaxWaitUs = stats->MaxHoldUs = 0;
+	memset(stats->WaitBuckets, 0, sizeof(stats->WaitBuckets));
+	memset(stats->HoldBuckets, 0, sizeof(stats->HoldBuckets));
+}
+
+static Mutex * GetRegistryLock()
+{
+	if(s_registryLock == NULL)
+	{
+		Mutex * lock = new Mutex();
+#if PLATFORM == PLATFORM_WIN
+		if(InterlockedCompareExchangePointer((volatile PVOID*)&s_registryLock, lock, NULL) != NULL)
+#else
+		if(!__sync_bool_compare_and_swap(&s_registryLock, (Mutex*)NULL, lock))
+#endif
+			delete lock;
+	}
+	return s_registryLock;
+}
+
+LockStatsData * LockStats::Register(const char * name)
+{
+	Mutex * lock = GetRegistryLock();
+	lock->Acquire();
+	if(s_registry == NULL)
+	{
+		s_registry = new LockStatsMap;
+		s_resetTime = UNIXTIME;
+	}
+
+	LockStatsData *& stats = (*s_registry)[name];
+	if(stats == NULL)
+	{
+		stats = new LockStatsData;
+		stats->Name = name;
+		ClearLockStats(stats);
+	}
+	lock->Release();
+	return stats;
+}
+
+void LockStats::RecordAcquire(LockStatsData * stats, uint64 waitUs, bool contended)
+{
+	LOCKSTATS_ADD(stats->Acquires, 1);
+	if(!contended)
+	{
+		LOCKSTATS_ADD(stats->WaitBuckets[0], 1);
+		return;
+	}
+
+	LOCKSTATS_ADD(stats->Contended, 1);
+	LOCKSTATS_ADD(stats->WaitUs, waitUs);
+	LOCKSTATS_ADD(stats->WaitBuckets[GetLockStatsBucket(waitUs)], 1);
+	UpdateMax(stats->MaxWaitUs, waitUs);
+}
+
+void LockStats::RecordRelease(LockStatsData * stats, uint64 holdUs)
+{
+	LOCKSTATS_ADD(stats->HoldUs, holdUs);
+	LOCKSTATS_ADD(stats->HoldBuckets[GetLockStatsBucket(holdUs)], 1);
+	UpdateMax(stats->MaxHoldUs, holdUs);
+}
+
+void LockStats::RecordFailedTry(LockStatsData * stats)
+{
+	LOCKSTATS_ADD(stats->FailedTries, 1);
+}
+
+void LockStats::RecordRecursion(LockStatsData * stats)
+{
+	LOCKSTATS_ADD(stats->Recursions, 1);
+}
+
+static bool SortByWaitTime(const LockStatsData & a, const LockStatsData & b)
+{
+	if(a.WaitUs != b.WaitUs)
+		return a.WaitUs > b.WaitUs;
+	return a.Contended > b.Contended;
+}
+
+void LockStats::GetStats(std::vector<LockStatsData> & stats)
+{
+	stats.clear();
+	if(s_registry == NULL)
+		return;
+
+	// The owners keep counting while we copy, close enough for a report
+	s_registryLock->Acquire();
+	for(LockStatsMap::iterator itr = s_registry->begin(); itr != s_registry->end(); ++itr)
+	{
+		if(itr->second->Acquires != 0 || itr->second->FailedTries != 0)
+			stats.push_back(*itr->second);
+	}
+	s_registryLock->Release();
+
+	std::sort(stats.begin(), stats.end(), SortByWaitTime);
+}
+
+void LockStats::Reset()
+{
+	if(s_registry == NULL)
+		return;
+
+	s_registryLock->Acquire();
+	for(LockStatsMap::iterator itr = s_registry->begin(); itr != s_registry->end(); ++itr)
+		ClearLockStats(itr->second);
+	s_resetTime = UNIXTIME;
+	s_registryLock->Release();
+}
+
+uint32 LockStats::GetSecondsSinceReset()
+{
+	return s_resetTime ? uint32(UNIXTIME - s_resetTime) : 0;
+}
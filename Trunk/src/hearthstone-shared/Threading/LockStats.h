@@ -0,0 +1,60 @@
+/***
+ * Demonstrike Core
+ */
+
+#pragma once
+
+/************************************************************************/
+/* Lock contention statistics                                           */
+/************************************************************************/
+// Built with LOCK_STATS, every Mutex and RWLock that was given a name with
+// SetLockName counts its acquires, contended acquires, failed tries and
+// recursive re-entries, and puts wait and hold times into power of two
+// microsecond buckets. Locks sharing a name (every map's ActiveLock, every
+// group's m_groupLock) add up into one entry. Unnamed locks cost nothing, and
+// without LOCK_STATS SetLockName compiles away.
+
+#define LOCK_STATS_BUCKETS 32
+
+struct LockStatsData
+{
+	std::string Name;
+	uint64 Acquires;
+	uint64 Contended;
+	uint64 FailedTries;
+	uint64 Recursions;
+	uint64 WaitUs;
+	uint64 HoldUs;
+	uint64 MaxWaitUs;
+	uint64 MaxHoldUs;
+	uint64 WaitBuckets[LOCK_STATS_BUCKETS];
+	uint64 HoldBuckets[LOCK_STATS_BUCKETS];
+
+	static uint32 GetPercentile(const uint64 * buckets, uint64 count, uint64 max, uint32 percent);
+};
+
+class SERVER_DECL LockStats
+{
+public:
+	// Entries are never freed, locks keep the pointer for their lifetime
+	static LockStatsData * Register(const char * name);
+
+	static void RecordAcquire(LockStatsData * stats, uint64 waitUs, bool contended);
+	static void RecordRelease(LockStatsData * stats, uint64 holdUs);
+	static void RecordFailedTry(LockStatsData * stats);
+	static void RecordRecursion(LockStatsData * stats);
+
+	// Every named lock seen since the last reset, most time spent waiting first
+	static void GetStats(std::vector<LockStatsData> & stats);
+	static void Reset();
+	static uint32 GetSecondsSinceReset();
+
+	static bool IsEnabled()
+	{
+#ifdef LOCK_STATS
+		return true;
+#else
+		return false;
+#endif
+	}
+};
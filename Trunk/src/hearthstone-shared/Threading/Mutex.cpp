@@ -3,6 +3,7 @@
  */
 
 #include "../Common.h"
+#include "../Timer.h"
 #include "Mutex.h"
 #ifdef __DragonFly__                                                            
 #include <pthread.h>                                                            
@@ -10,7 +11,14 @@
 #if PLATFORM == PLATFORM_WIN
 
 /* Windows Critical Section Implementation */
-Mutex::Mutex() { InitializeCriticalSection(&cs); }
+Mutex::Mutex()
+#ifdef LOCK_STATS
+	: m_stats(NULL), m_depth(0), m_holdStart(0)
+#endif
+{
+	InitializeCriticalSection(&cs);
+}
+
 Mutex::~Mutex() { DeleteCriticalSection(&cs); }
 
 #else
@@ -27,6 +35,9 @@ bool Mutex::attr_initalized = false;
 pthread_mutexattr_t Mutex::attr;
 
 Mutex::Mutex()
+#ifdef LOCK_STATS
+	: m_stats(NULL), m_depth(0), m_holdStart(0)
+#endif
 {
 	if(!attr_initalized)
 	{
@@ -41,3 +52,77 @@ Mutex::Mutex()
 Mutex::~Mutex() { pthread_mutex_destroy(&mutex); }
 
 #endif
+
+#ifdef LOCK_STATS
+
+void Mutex::SetLockName(const char * name)
+{
+	m_stats = LockStats::Register(name);
+}
+
+bool Mutex::_TryLock()
+{
+#if PLATFORM != PLATFORM_WIN
+	return (pthread_mutex_trylock(&mutex) == 0);
+#else
+	return (TryEnterCriticalSection(&cs) == TRUE);
+#endif
+}
+
+void Mutex::_AcquireTracked()
+{
+	// A recursive lock always succeeds the try, so only other threads show up as contention
+	uint64 waitUs = 0;
+	bool contended = !_TryLock();
+	if(contended)
+	{
+		uint64 start = getUSTime();
+#if PLATFORM != PLATFORM_WIN
+		pthread_mutex_lock(&mutex);
+#else
+		EnterCriticalSection(&cs);
+#endif
+		waitUs = getUSTime() - start;
+	}
+
+	if(m_depth++ != 0)
+	{
+		LockStats::RecordRecursion(m_stats);
+		return;
+	}
+
+	LockStats::RecordAcquire(m_stats, waitUs, contended);
+	m_holdStart = getUSTime();
+}
+
+bool Mutex::_AttemptAcquireTracked()
+{
+	if(!_TryLock())
+	{
+		LockStats::RecordFailedTry(m_stats);
+		return false;
+	}
+
+	if(m_depth++ != 0)
+		LockStats::RecordRecursion(m_stats);
+	else
+	{
+		LockStats::RecordAcquire(m_stats, 0, false);
+		m_holdStart = getUSTime();
+	}
+	return true;
+}
+
+void Mutex::_ReleaseTracked()
+{
+	if(--m_depth == 0)
+		LockStats::RecordRelease(m_stats, getUSTime() - m_holdStart);
+
+#if PLATFORM != PLATFORM_WIN
+	pthread_mutex_unlock(&mutex);
+#else
+	LeaveCriticalSection(&cs);
+#endif
+}
+
+#endif
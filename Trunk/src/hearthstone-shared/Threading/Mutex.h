@@ -11,6 +11,8 @@
 #include <Windows.h>
 #endif
 
+struct LockStatsData;
+
 class SERVER_DECL Mutex
 {
 public:
@@ -24,10 +26,26 @@ public:
 	 */
 	~Mutex();
 
+	/** Names this mutex for the contention statistics, locks with the same name are counted together.
+	 * Name a mutex before its first use. Does nothing unless built with LOCK_STATS.
+	 */
+#ifdef LOCK_STATS
+	void SetLockName(const char * name);
+#else
+	HEARTHSTONE_INLINE void SetLockName(const char * name) {}
+#endif
+
 	/** Acquires this mutex. If it cannot be acquired immediately, it will block.
 	 */
 	HEARTHSTONE_INLINE void Acquire()
 	{
+#ifdef LOCK_STATS
+		if(m_stats != NULL)
+		{
+			_AcquireTracked();
+			return;
+		}
+#endif
 #if PLATFORM != PLATFORM_WIN
 		pthread_mutex_lock(&mutex);
 #else
@@ -39,6 +57,13 @@ public:
 	 */
 	HEARTHSTONE_INLINE void Release()
 	{
+#ifdef LOCK_STATS
+		if(m_stats != NULL)
+		{
+			_ReleaseTracked();
+			return;
+		}
+#endif
 #if PLATFORM != PLATFORM_WIN
 		pthread_mutex_unlock(&mutex);
 #else
@@ -52,6 +77,10 @@ public:
 	 */
 	HEARTHSTONE_INLINE bool AttemptAcquire()
 	{
+#ifdef LOCK_STATS
+		if(m_stats != NULL)
+			return _AttemptAcquireTracked();
+#endif
 #if PLATFORM != PLATFORM_WIN
 		return (pthread_mutex_trylock(&mutex) == 0);
 #else
@@ -60,6 +89,20 @@ public:
 	}
 
 protected:
+#ifdef LOCK_STATS
+	void _AcquireTracked();
+	void _ReleaseTracked();
+	bool _AttemptAcquireTracked();
+	bool _TryLock();
+
+	/** Statistics entry for our name, NULL while unnamed. Depth and hold start are only touched by the owner.
+	 * Condition waits keep the depth, so their time counts as held.
+	 */
+	LockStatsData * m_stats;
+	uint32 m_depth;
+	uint64 m_holdStart;
+#endif
+
 #if PLATFORM == PLATFORM_WIN
 	/** Critical section used for system calls
 	 */
@@ -90,6 +133,9 @@ public:
 	HEARTHSTONE_INLINE FastMutex() : m_lock(0),m_recursiveCount(0) {}
 	HEARTHSTONE_INLINE ~FastMutex() {}
 
+	// Spin lock, not counted in the lock statistics
+	HEARTHSTONE_INLINE void SetLockName(const char * name) {}
+
 	HEARTHSTONE_INLINE void Acquire()
 	{
 		DWORD thread_id = GetCurrentThreadId(), owner;
@@ -0,0 +1,223 @@
+/***
+ * Demonstrike Core
+ */
+
+#include "../Common.h"
+#include "../Timer.h"
+#include "Mutex.h"
+#include "AtomicCounter.h"
+#include "RWLock.h"
+
+#if PLATFORM == PLATFORM_WIN
+#define RWLOCK_INCREMENT(x) InterlockedIncrement(&x)
+#define RWLOCK_DECREMENT(x) InterlockedDecrement(&x)
+#else
+#define RWLOCK_INCREMENT(x) __sync_add_and_fetch(&x, 1)
+#define RWLOCK_DECREMENT(x) __sync_sub_and_fetch(&x, 1)
+#endif
+
+// Read locks this thread holds, for recursion. A thread never holds more than a few at once
+#define RWLOCK_MAX_HELD 16
+
+struct RWLockHold
+{
+	RWLock * lock;
+	uint32 depth;
+#ifdef LOCK_STATS
+	uint64 start;
+#endif
+};
+
+static THREAD_LOCAL RWLockHold t_heldLocks[RWLOCK_MAX_HELD];
+static THREAD_LOCAL uint32 t_heldCount = 0;
+static THREAD_LOCAL uint32 t_readerSlot = 0;	// slot + 1, 0 until first use
+static THREAD_LOCAL char t_threadToken = 0;		// only its address is used, unique per live thread
+static AtomicCounter s_readerSlots;
+
+static HEARTHSTONE_INLINE uint32 GetReaderSlot()
+{
+	if(t_readerSlot == 0)
+		t_readerSlot = uint32(++s_readerSlots) % RWLOCK_READER_SLOTS + 1;
+	return t_readerSlot - 1;
+}
+
+static HEARTHSTONE_INLINE RWLockHold * FindHold(RWLock * lock)
+{
+	for(uint32 i = 0; i < t_heldCount; ++i)
+	{
+		if(t_heldLocks[i].lock == lock)
+			return &t_heldLocks[i];
+	}
+	return NULL;
+}
+
+RWLock::RWLock() : m_writersWaiting(0), m_writer(NULL), m_writeDepth(0)
+#ifdef LOCK_STATS
+	, m_readStats(NULL), m_writeStats(NULL), m_writeHoldStart(0)
+#endif
+{
+	for(uint32 i = 0; i < RWLOCK_READER_SLOTS; ++i)
+		m_readers[i].count = 0;
+}
+
+#ifdef LOCK_STATS
+void RWLock::SetLockName(const char * name)
+{
+	std::string base(name);
+	m_readStats = LockStats::Register((base + " [read]").c_str());
+	m_writeStats = LockStats::Register((base + " [write]").c_str());
+}
+#endif
+
+long RWLock::_CountReaders()
+{
+	long readers = 0;
+	for(uint32 i = 0; i < RWLOCK_READER_SLOTS; ++i)
+		readers += m_readers[i].count;
+	return readers;
+}
+
+void RWLock::AcquireReadLock()
+{
+	RWLockHold * hold = FindHold(this);
+	if(hold != NULL)
+	{
+#ifdef LOCK_STATS
+		if(m_readStats != NULL)
+			LockStats::RecordRecursion(m_readStats);
+#endif
+		++hold->depth;
+		return;
+	}
+
+#ifdef LOCK_STATS
+	uint64 waitStart = 0;
+#endif
+	volatile long & count = m_readers[GetReaderSlot()].count;
+	if(m_writer == &t_threadToken)
+	{
+		// Reading under our own write lock
+		RWLOCK_INCREMENT(count);
+	}
+	else
+	{
+		for(;;)
+		{
+			RWLOCK_INCREMENT(count);
+			if(m_writersWaiting == 0)
+				break;
+
+			// Back out and wait for the writer to finish
+			RWLOCK_DECREMENT(count);
+#ifdef LOCK_STATS
+			if(m_readStats != NULL && waitStart == 0)
+				waitStart = getUSTime();
+#endif
+			m_writeLock.Acquire();
+			m_writeLock.Release();
+		}
+	}
+
+#ifdef LOCK_STATS
+	uint64 now = 0;
+	if(m_readStats != NULL)
+	{
+		now = getUSTime();
+		LockStats::RecordAcquire(m_readStats, waitStart ? now - waitStart : 0, waitStart != 0);
+	}
+#endif
+
+	// Past the limit the hold isn't tracked, which only costs recursion while a writer waits
+	if(t_heldCount < RWLOCK_MAX_HELD)
+	{
+		t_heldLocks[t_heldCount].lock = this;
+		t_heldLocks[t_heldCount].depth = 1;
+#ifdef LOCK_STATS
+		t_heldLocks[t_heldCount].start = now;
+#endif
+		++t_heldCount;
+	}
+}
+
+void RWLock::ReleaseReadLock()
+{
+	RWLockHold * hold = FindHold(this);
+	if(hold != NULL)
+	{
+		if(--hold->depth)
+			return;
+
+#ifdef LOCK_STATS
+		if(m_readStats != NULL)
+			LockStats::RecordRelease(m_readStats, getUSTime() - hold->start);
+#endif
+		*hold = t_heldLocks[--t_heldCount];
+	}
+
+	RWLOCK_DECREMENT(m_readers[GetReaderSlot()].count);
+}
+
+void RWLock::AcquireWriteLock()
+{
+	if(m_writer == &t_threadToken)
+	{
+#ifdef LOCK_STATS
+		if(m_writeStats != NULL)
+			LockStats::RecordRecursion(m_writeStats);
+#endif
+		++m_writeDepth;
+		return;
+	}
+
+#ifdef LOCK_STATS
+	uint64 waitStart = (m_writeStats != NULL ? getUSTime() : 0);
+	bool contended = false;
+#endif
+	RWLOCK_INCREMENT(m_writersWaiting);
+#ifdef LOCK_STATS
+	if(!m_writeLock.AttemptAcquire())
+	{
+		contended = true;
+		m_writeLock.Acquire();
+	}
+#else
+	m_writeLock.Acquire();
+#endif
+
+	// If we're upgrading, our own read hold stays counted
+	long ownReads = (FindHold(this) != NULL ? 1 : 0);
+	for(uint32 spins = 0; _CountReaders() != ownReads; ++spins)
+	{
+#ifdef LOCK_STATS
+		contended = true;
+#endif
+		if(spins < 1000)
+			Sleep(0);
+		else
+			Sleep(1);
+	}
+
+	m_writer = &t_threadToken;
+	m_writeDepth = 1;
+#ifdef LOCK_STATS
+	if(m_writeStats != NULL)
+	{
+		m_writeHoldStart = getUSTime();
+		LockStats::RecordAcquire(m_writeStats, m_writeHoldStart - waitStart, contended);
+	}
+#endif
+}
+
+void RWLock::ReleaseWriteLock()
+{
+	if(--m_writeDepth)
+		return;
+
+#ifdef LOCK_STATS
+	if(m_writeStats != NULL)
+		LockStats::RecordRelease(m_writeStats, getUSTime() - m_writeHoldStart);
+#endif
+	m_writer = NULL;
+	RWLOCK_DECREMENT(m_writersWaiting);
+	m_writeLock.Release();
+}
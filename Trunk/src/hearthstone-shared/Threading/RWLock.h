@@ -4,55 +4,61 @@
 
 #pragma once
 
-#include "Condition.h"
 #include "Mutex.h"
 
-class RWLock
+/************************************************************************/
+/* Reader-writer lock                                                   */
+/************************************************************************/
+// Readers only touch their own cache line of reader counts, so they never
+// contend with each other. A writer announces itself first, which turns new
+// readers away (writers get preference), then waits for the counts to drain.
+// Turned away readers queue on the writer mutex rather than spin.
+// Both sides are recursive like the old condition based lock: a thread may
+// read again while reading (even with a writer waiting), read or write again
+// while writing, and take the write lock while it is the only reader.
+
+#define RWLOCK_READER_SLOTS	8
+#define RWLOCK_CACHE_LINE	64
+
+class SERVER_DECL RWLock
 {
-public: 
-  
-	HEARTHSTONE_INLINE void AcquireReadLock()
-	{
-		//_lock.Acquire();
-		_cond.BeginSynchronized();
-		_readers++;
-		//_lock.Release();
-		_cond.EndSynchronized();
-	}
-	
-	HEARTHSTONE_INLINE void ReleaseReadLock()
-	{
-		//_lock.Acquire();
-		_cond.BeginSynchronized();
-		if(!(--_readers))
-			if(_writers)
-				_cond.Signal();
-		//_lock.Release();
-		_cond.EndSynchronized();
-	}
-
-	HEARTHSTONE_INLINE void AcquireWriteLock()
-	{
-		//_lock.Acquire();
-		_cond.BeginSynchronized();
-		_writers++;
-		if(_readers)
-			_cond.Wait();
-	}
-
-	HEARTHSTONE_INLINE void ReleaseWriteLock()
+public:
+	RWLock();
+
+	// Read and write sides show up in the lock statistics as "<name> [read]" and "<name> [write]"
+#ifdef LOCK_STATS
+	void SetLockName(const char * name);
+#else
+	HEARTHSTONE_INLINE void SetLockName(const char * name) {}
+#endif
+
+	void AcquireReadLock();
+	void ReleaseReadLock();
+	void AcquireWriteLock();
+	void ReleaseWriteLock();
+
+private:
+	struct ReaderSlot
 	{
-		if(--_writers)
-			_cond.Signal();
-		//_lock.Release();
-		_cond.EndSynchronized();
-	}
-	HEARTHSTONE_INLINE RWLock() : _cond(&_lock) {_readers=0;_writers=0;}
-  
-	private:
-		Mutex _lock;
-		Condition _cond;
-		volatile unsigned int _readers;
-		volatile unsigned int _writers;
-   
-}; 
+		volatile long count;
+		char pad[RWLOCK_CACHE_LINE - sizeof(long)];
+	};
+
+	long _CountReaders();
+
+	ReaderSlot m_readers[RWLOCK_READER_SLOTS];
+	volatile long m_writersWaiting;
+	void * volatile m_writer;	// the owning thread's token
+	uint32 m_writeDepth;
+	Mutex m_writeLock;
+
+#ifdef LOCK_STATS
+	LockStatsData * m_readStats;
+	LockStatsData * m_writeStats;
+	uint64 m_writeHoldStart;
+#endif
+
+	// Disallow copying, the reader slots are shared state
+	RWLock(const RWLock&);
+	RWLock& operator=(const RWLock&);
+};
@@ -24,13 +24,17 @@ int GenerateThreadId()
 
 SERVER_DECL CThreadPool ThreadPool;
 
-CThreadPool::CThreadPool()
+CThreadPool::CThreadPool() : m_exitHandler(NULL)
 {
 
 }
 
 void CThreadPool::ThreadExit(Thread * t)
 {
+	// still on the exiting thread here
+	if(m_exitHandler != NULL)
+		m_exitHandler();
+
 	// we're definitely no longer active
 	_mutex.Acquire();
 	m_activeThreads.erase(t);
@@ -19,15 +19,21 @@ struct SERVER_DECL Thread
 
 typedef std::set<Thread*> ThreadSet;
 
+typedef void (*ThreadExitHandler)();
+
 class SERVER_DECL CThreadPool
 {
 	Mutex _mutex;
 
 	ThreadSet m_activeThreads;
+	ThreadExitHandler m_exitHandler;
 
 public:
 	CThreadPool();
 
+	// runs on every pool thread as it exits, for releasing per-thread caches
+	HEARTHSTONE_INLINE void SetThreadExitHandler(ThreadExitHandler handler) { m_exitHandler = handler; }
+
 	// shutdown all threads
 	void Shutdown();
 
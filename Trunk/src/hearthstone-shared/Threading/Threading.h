@@ -18,6 +18,12 @@
 // Platform Specific Thread Starter
 #include "ThreadStarter.h"
 
+// Lock free statistics counter
+#include "AtomicCounter.h"
+
+// Named lock contention statistics
+#include "LockStats.h"
+
 // Platform independant locked queue
 #include "LockedQueue.h"
 
@@ -14,3 +14,23 @@ HEARTHSTONE_INLINE uint32 getMSTime()
 	return (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
 }
 #endif
+
+// Microsecond clock for timing short sections, only differences between calls are meaningful
+#if PLATFORM == PLATFORM_WIN
+HEARTHSTONE_INLINE uint64 getUSTime()
+{
+	static LARGE_INTEGER frequency = { 0 };
+	LARGE_INTEGER now;
+	if(frequency.QuadPart == 0)
+		QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&now);
+	return uint64(now.QuadPart / frequency.QuadPart) * 1000000 + uint64((now.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart);
+}
+#else
+HEARTHSTONE_INLINE uint64 getUSTime()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return uint64(tv.tv_sec) * 1000000 + uint64(tv.tv_usec);
+}
+#endif
@@ -3,6 +3,9 @@
  */
 
 #include "Common.h"
+#if PLATFORM != PLATFORM_WIN && UNIX_FLAVOUR == UNIX_FLAVOUR_LINUX
+#include <sys/prctl.h>
+#endif
 
 using namespace std;
 
@@ -57,6 +60,9 @@ void SetThreadName(const char* thread_name)
 	{
 
 	}
+#elif UNIX_FLAVOUR == UNIX_FLAVOUR_LINUX
+	// Shows up in top -H and the per thread cpu metrics, cut to 15 characters
+	prctl(PR_SET_NAME, buffer, 0, 0, 0);
 #endif
 }
 
@@ -363,3 +369,96 @@ unsigned int MakeIP(const char * str)
 	return res;
 }
 
+
+static uint32 FoldCodePoint(uint32 c)
+{
+	if(c < 0x80)
+		return (c >= 'A' && c <= 'Z') ? c + 32 : c;
+
+	// Latin-1, skipping the multiplication sign
+	if(c >= 0xC0 && c <= 0xDE && c != 0xD7)
+		return c + 32;
+
+	// Latin Extended-A, upper case letters are paired with the following lower case one
+	if((c >= 0x100 && c <= 0x12F) || (c >= 0x132 && c <= 0x137) || (c >= 0x14A && c <= 0x177))
+		return c | 1;
+	if((c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E))
+		return (c & 1) ? c + 1 : c;
+	if(c == 0x178)
+		return 0xFF;
+
+	// Greek, skipping the unused final sigma slot
+	if(c >= 0x391 && c <= 0x3AB && c != 0x3A2)
+		return c + 32;
+	if(c == 0x386)
+		return 0x3AC;
+	if(c >= 0x388 && c <= 0x38A)
+		return c + 37;
+	if(c == 0x38C)
+		return 0x3CC;
+	if(c == 0x38E || c == 0x38F)
+		return c + 63;
+
+	// Cyrillic
+	if(c >= 0x400 && c <= 0x40F)
+		return c + 80;
+	if(c >= 0x410 && c <= 0x42F)
+		return c + 32;
+	if(c >= 0x460 && c <= 0x4FF && !(c >= 0x482 && c <= 0x489) && c != 0x4C0)
+	{
+		if(c >= 0x4C1 && c <= 0x4CE)
+			return (c & 1) ? c + 1 : c;
+		return c | 1;
+	}
+
+	return c;
+}
+
+string Utf8FoldCase(const char * str)
+{
+	string out;
+	const uint8 * p = (const uint8*)str;
+	size_t len = strlen(str);
+	out.reserve(len);
+
+	for(size_t i = 0; i < len;)
+	{
+		uint8 b = p[i];
+		uint32 c;
+		size_t n;
+		if(b < 0x80)
+		{
+			out += (char)FoldCodePoint(b);
+			++i;
+			continue;
+		}
+		else if((b & 0xE0) == 0xC0) { c = b & 0x1F; n = 2; }
+		else if((b & 0xF0) == 0xE0) { c = b & 0x0F; n = 3; }
+		else if((b & 0xF8) == 0xF0) { c = b & 0x07; n = 4; }
+		else
+		{
+			out += (char)b;
+			++i;
+			continue;
+		}
+
+		size_t j = 1;
+		for(; j < n && i + j < len && (p[i + j] & 0xC0) == 0x80; ++j)
+			c = (c << 6) | (p[i + j] & 0x3F);
+
+		// Only two byte letters are folded, folding never changes the encoded length
+		if(j != n || n != 2 || c < 0x80)
+		{
+			out.append((const char*)p + i, j);
+			i += j;
+			continue;
+		}
+
+		c = FoldCodePoint(c);
+		out += (char)(0xC0 | (c >> 6));
+		out += (char)(0x80 | (c & 0x3F));
+		i += 2;
+	}
+
+	return out;
+}
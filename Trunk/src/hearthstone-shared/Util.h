@@ -11,6 +11,10 @@
 ///////////////////////////////////////////////////////////////////////////////
 std::vector<std::string> StrSplit(const std::string &src, const std::string &sep);
 
+// Lower cases a UTF-8 string for case insensitive comparison. Latin, Greek and
+// Cyrillic letters are folded, anything else (and invalid sequences) is copied as is.
+std::string Utf8FoldCase(const char * str);
+
 // This HAS to be called outside the threads __try / __except block!
 void SetThreadName(const char* format);
 time_t convTimePeriod ( uint32 dLength, char dType);
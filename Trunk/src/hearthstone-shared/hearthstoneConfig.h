@@ -23,3 +23,10 @@
  * he doesn't get a hang up, and information is sent after the player enters world.
  */
 //#define MULTI_THREADED_OBJECT_PUSHING
+
+/** Fill released ObjectPool blocks (spells, auras) with a poison pattern and verify
+ * it when the block is handed out again, to catch use after free.
+ * Costs a memset and a scan per allocation, only enable for dev use.
+ * Default: Disabled
+ */
+//#define POOL_POISON 1
@@ -835,7 +835,13 @@ void AI_Movement::UpdateMove()
 
 	if(m_pathfinding)
 	{
-		LocationVector PathLocation = NavMeshInterface.BuildPath(m_Unit->GetMapId(), m_sourceX, m_sourceY, m_sourceZ, m_destinationX, m_destinationY, m_destinationZ, true);
+		// Nothing in the way needs no path search, and the best position on the path would be the destination anyway
+		LocationVector PathLocation;
+		if(NavMeshInterface.Raycast(m_Unit->GetMapId(), m_sourceX, m_sourceY, m_sourceZ, m_destinationX, m_destinationY, m_destinationZ, PathLocation, m_Unit)
+			&& PathLocation.DistanceSq(m_destinationX, m_destinationY, m_destinationZ) < 1.0f)
+			PathLocation = LocationVector(m_destinationX, m_destinationY, m_destinationZ);
+		else
+			PathLocation = NavMeshInterface.BuildPath(m_Unit->GetMapId(), m_sourceX, m_sourceY, m_sourceZ, m_destinationX, m_destinationY, m_destinationZ, true);
 		m_nextPosX = PathLocation.x;
 		m_nextPosY = PathLocation.y;
 		m_nextPosZ = PathLocation.z;
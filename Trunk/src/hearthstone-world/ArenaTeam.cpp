@@ -73,7 +73,7 @@ ArenaTeam::ArenaTeam(Field * f)
 			&m_members[i].Played_ThisSeason, &m_members[i].Won_ThisSeason, &m_members[i].PersonalRating);
 		if(ret >= 5)
 		{
-			m_members[i].Info = objmgr.GetPlayerInfo(guid);
+			m_members[i].Info = objmgr.LoadPlayerInfo(guid);
 			if(m_members[i].Info)
 			{
 				m_members[i].Info->arenaTeam[m_type] = this;
@@ -30,6 +30,10 @@ AuctionHouse::AuctionHouse(uint32 ID)
 
 	cut_percent = float( float(dbc->tax) / 100.0f );
 	deposit_percent = float( float(dbc->fee ) / 100.0f );
+
+	itemLock.SetLockName("AuctionHouse::itemLock");
+	auctionLock.SetLockName("AuctionHouse::auctionLock");
+	removalLock.SetLockName("AuctionHouse::removalLock");
 }
 
 AuctionHouse::~AuctionHouse()
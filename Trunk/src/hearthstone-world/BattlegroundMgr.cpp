@@ -95,19 +95,13 @@ const static uint32 GetBGPvPDataCount(uint32 type)
 
 CBattlegroundManager::CBattlegroundManager() : EventableObject()
 {
-	int i, j;
+	int i;
 
 	m_maxBattlegroundId = 0;
 
 	for(i = 0; i < BATTLEGROUND_NUM_TYPES; i++)
 	{
 		m_instances[i].clear();
-		m_queuedGroups[i].clear();
-
-		for (j = 0; j < MAX_LEVEL_GROUP; ++j)
-		{
-			m_queuedPlayers[i][j].clear();
-		}
 	}
 
 	memset(m_averageQueueTimes, 0, sizeof(uint32)*USABLEBSGS*10);
@@ -335,7 +329,7 @@ void CBattlegroundManager::HandleBattlegroundJoin(WorldSession * m_session, Worl
 	plr->m_bgEntryPointMap = plr->GetMapId();
 	plr->m_bgEntryPointInstance = plr->GetInstanceID();
 
-	m_queuedPlayers[bgtype][lgroup].push_back(pguid);
+	m_queuedPlayers[bgtype][lgroup].Add(pguid);
 
 	m_queueLock.Release();
 
@@ -344,18 +338,6 @@ void CBattlegroundManager::HandleBattlegroundJoin(WorldSession * m_session, Worl
 	/* We will get updated next few seconds =) */
 }
 
-void ErasePlayerFromList(uint32 guid, list<uint32>* l)
-{
-	for(list<uint32>::iterator itr = l->begin(); itr != l->end(); itr++)
-	{
-		if((*itr) == guid)
-		{
-			l->erase(itr);
-			return;
-		}
-	}
-}
-
 uint32 CBattlegroundManager::GetArenaGroupQInfo(Group * group, int type, uint32 *avgRating)
 {
 	ArenaTeam *team;
@@ -443,8 +425,6 @@ int CBattlegroundManager::CreateArenaType(int type, Group * group1, Group * grou
 	if (ar == NULL)
 	{
 		Log.Error("BattlegroundMgr", "%s (%u): Couldn't create Arena Instance", __FILE__, __LINE__);
-		m_queueLock.Release();
-		m_instanceLock.Release();
 		return -1;
 	}
 	ar->rated_match=true;
@@ -455,357 +435,371 @@ int CBattlegroundManager::CreateArenaType(int type, Group * group1, Group * grou
 	return 0;
 }
 
-void CBattlegroundManager::AddPlayerToBg(CBattleground* bg, deque<Player*  > *playerVec, uint32 i, uint32 j)
+Player* CBattlegroundManager::LockQueuedPlayer(uint32 i, uint32 j, uint32 guid)
 {
-	Player* plr = *playerVec->begin();
-	playerVec->pop_front();
-	if(bg->CanPlayerJoin(plr))
+	if(!m_queuedPlayers[i][j].LockQueued(guid))
+		return NULL;
+
+	Player* plr = objmgr.GetPlayer(guid);
+	if(plr == NULL)
 	{
-		bg->AddPlayer(plr, plr->GetTeam());
-		ErasePlayerFromList(plr->GetLowGUID(), &m_queuedPlayers[i][j]);
+		m_queuedPlayers[i][j].ClaimLocked(guid);
+		m_queuedPlayers[i][j].Unlock();
 	}
-	else
+	return plr;
+}
+
+bool CBattlegroundManager::AddPlayerToBg(CBattleground* bg, deque<uint32> *playerVec, uint32 i, uint32 j)
+{
+	uint32 guid = *playerVec->begin();
+	playerVec->pop_front();
+
+	// Left the queue or logged out since the snapshot was taken
+	Player* plr = LockQueuedPlayer(i, j, guid);
+	if(plr == NULL)
+		return false;
+
+	if(!bg->CanPlayerJoin(plr))
 	{
 		// Put again the player in the queue
-		playerVec->push_back(plr);
+		m_queuedPlayers[i][j].Unlock();
+		playerVec->push_back(guid);
+		return false;
 	}
+
+	m_queuedPlayers[i][j].ClaimLocked(guid);
+	bg->AddPlayer(plr, plr->GetTeam());
+	m_queuedPlayers[i][j].Unlock();
+	return true;
 }
 
-void CBattlegroundManager::AddPlayerToBgTeam(CBattleground* bg, deque<Player*  > *playerVec, uint32 i, uint32 j, int Team)
+bool CBattlegroundManager::AddPlayerToBgTeam(CBattleground* bg, deque<uint32> *playerVec, uint32 i, uint32 j, int Team)
 {
-	if (bg->HasFreeSlots(Team))
+	// Skips whoever left the queue since the snapshot, until one is placed
+	while(playerVec->size() && bg->HasFreeSlots(Team))
 	{
-		Player* plr = *playerVec->begin();
+		uint32 guid = *playerVec->begin();
 		playerVec->pop_front();
+
+		Player* plr = LockQueuedPlayer(i, j, guid);
+		if(plr == NULL)
+			continue;
+
+		m_queuedPlayers[i][j].ClaimLocked(guid);
 		plr->m_bgTeam = Team;
 		bg->AddPlayer(plr, Team);
-		ErasePlayerFromList(plr->GetLowGUID(), &m_queuedPlayers[i][j]);
+		m_queuedPlayers[i][j].Unlock();
+		return true;
+	}
+	return false;
+}
+
+void CBattlegroundManager::AddPlayersToArena(Arena* arena, deque<uint32> *playerVec, uint32 i, uint32 j)
+{
+	int32 team = arena->GetFreeTeam();
+	while(team >= 0 && !arena->IsFull() && playerVec->size())
+	{
+		uint32 guid = *playerVec->begin();
+		playerVec->pop_front();
+
+		Player* plr = LockQueuedPlayer(i, j, guid);
+		if(plr == NULL)
+			continue;
+
+		m_queuedPlayers[i][j].ClaimLocked(guid);
+		plr->m_bgTeam = team;
+		arena->AddPlayer(plr, team);
+		m_queuedPlayers[i][j].Unlock();
+		team = arena->GetFreeTeam();
+	}
+}
+
+void CBattlegroundManager::AddPlayerPairsToBg(CBattleground* bg, deque<uint32> *playerVec, uint32 i, uint32 j)
+{
+	while(!bg->IsFull() && playerVec[0].size() && playerVec[1].size())
+	{
+		if(!AddPlayerToBgTeam(bg, &playerVec[0], i, j, 0))
+			break;
+		if(!AddPlayerToBgTeam(bg, &playerVec[1], i, j, 1))
+			break;
 	}
 }
 
 void CBattlegroundManager::EventQueueUpdate(bool forceStart)
 {
-	deque<Player*  > tempPlayerVec[2];
-	uint32 i,j,k;
+	// No lock is held across the whole scan, each bracket is copied out and
+	// matched on its own, joins and leaves only wait on the bracket they touch
+	vector<uint32> snapshot;
+	for(uint32 i = 0; i < BATTLEGROUND_NUM_TYPES; i++)
+	{
+		for(uint32 j = 0; j < MAX_LEVEL_GROUP; ++j)
+			UpdateBracket(i, j, forceStart, snapshot);
+	}
+
+	/* Handle paired arena team joining */
+	for(uint32 i = BATTLEGROUND_ARENA_2V2; i <= BATTLEGROUND_ARENA_5V5; i++)
+		UpdateRatedArenas(i, forceStart);
+}
+
+void CBattlegroundManager::UpdateBracket(uint32 i, uint32 j, bool forceStart, vector<uint32> & snapshot)
+{
+	deque<uint32> tempPlayerVec[2];
+	deque<uint32> instancePlayers;
+	uint32 k, guid, queueSlot;
 	Player* plr;
 	CBattleground* bg;
-	list<uint32>::iterator it3, it4;
-	//vector<Player*  >::iterator it6;
 	map<uint32, CBattleground* >::iterator iitr;
-	Arena* arena;
-	int32 team;
-	m_queueLock.Acquire();
-	m_instanceLock.Acquire();
 
-	for(i = 0; i < BATTLEGROUND_NUM_TYPES; i++)
+	if(!m_queuedPlayers[i][j].Size())
+		return;
+
+	// Sort the snapshot out without m_instanceLock, it has to come before a bracket lock
+	m_queuedPlayers[i][j].Snapshot(snapshot);
+	for(vector<uint32>::iterator it3 = snapshot.begin(); it3 != snapshot.end(); ++it3)
 	{
-		for(j = 0; j < MAX_LEVEL_GROUP; ++j)
+		plr = LockQueuedPlayer(i, j, *it3);
+		if(plr == NULL)
+			continue;
+
+		queueSlot = plr->GetBGQueueSlotByBGType(i);
+		if(GetLevelGrouping(plr->getLevel()) != j || (queueSlot < 3 && !plr->m_bgIsQueued[queueSlot]))
 		{
-			if(!m_queuedPlayers[i][j].size())
-				continue;
+			// Levelled out of the bracket, or we've since cancelled our queue
+			m_queuedPlayers[i][j].ClaimLocked(*it3);
+		}
+		else if(queueSlot < 3)
+		{
+			// queued to a specific instance id?
+			if(plr->m_bgQueueInstanceId[queueSlot] != 0)
+				instancePlayers.push_back(*it3);
+			else if(IS_ARENA(i))
+				tempPlayerVec[0].push_back(*it3);
+			else
+				tempPlayerVec[plr->GetTeam()].push_back(*it3);
+		}
+		m_queuedPlayers[i][j].Unlock();
+	}
 
-			tempPlayerVec[0].clear();
-			tempPlayerVec[1].clear();
+	if(instancePlayers.empty() && tempPlayerVec[0].empty() && tempPlayerVec[1].empty())
+		return;
 
-			for(it3 = m_queuedPlayers[i][j].begin(); it3 != m_queuedPlayers[i][j].end();)
-			{
-				it4 = it3++;
-				plr = objmgr.GetPlayer(*it4);
+	m_instanceLock.Acquire();
 
-				if(!plr || GetLevelGrouping(plr->getLevel()) != j)
-				{
-					m_queuedPlayers[i][j].erase(it4);
-					continue;
-				}
+	while(instancePlayers.size())
+	{
+		guid = *instancePlayers.begin();
+		instancePlayers.pop_front();
 
-				uint32 queueSlot = plr->GetBGQueueSlotByBGType(i);
-				if(queueSlot >= 3)
-					continue;
+		plr = LockQueuedPlayer(i, j, guid);
+		if(plr == NULL)
+			continue;
 
-				if( !plr->m_bgIsQueued[queueSlot] )
-				{
-					// We've since cancelled our queue
-					m_queuedPlayers[i][j].erase(it4);
-					continue;
-				}
+		queueSlot = plr->GetBGQueueSlotByBGType(i);
+		if(queueSlot >= 3 || m_instances[i].empty())
+		{
+			m_queuedPlayers[i][j].Unlock();
+			continue;
+		}
 
-				// queued to a specific instance id?
-				if(plr->m_bgQueueInstanceId[queueSlot] != 0 && plr->m_bgIsQueued[queueSlot])
-				{
-					if( m_instances[i].empty() )
-						continue;
+		iitr = m_instances[i].find(plr->m_bgQueueInstanceId[queueSlot]);
+		if(iitr == m_instances[i].end())
+		{
+			// queue no longer valid
+			plr->RemoveFromBattlegroundQueue(queueSlot);
+			SendBattlegroundQueueStatus(plr, queueSlot);
+		}
+		else if(iitr->second->CanPlayerJoin(plr))
+		{
+			// can we join?
+			m_queuedPlayers[i][j].ClaimLocked(guid);
+			iitr->second->AddPlayer(plr, plr->GetTeam());
+		}
+		m_queuedPlayers[i][j].Unlock();
+	}
 
-					iitr = m_instances[i].find( plr->m_bgQueueInstanceId[queueSlot] );
-					if(iitr == m_instances[i].end())
-					{
-						// queue no longer valid
-						//plr->GetSession()->SystemMessage("Your queue on battleground instance id %u is no longer valid. Reason: Instance Deleted.", plr->m_bgQueueInstanceId[queueSlot]);
-						plr->RemoveFromBattlegroundQueue(queueSlot);
-						//m_queuedPlayers[i][j].erase(it4);
-						SendBattlegroundQueueStatus(plr, queueSlot);
-						continue;
-					}
+	// try to join existing instances
+	for(iitr = m_instances[i].begin(); iitr != m_instances[i].end(); iitr++)
+	{
+		if( iitr->second->HasEnded() || iitr->second->GetLevelGroup() != j)
+			continue;
 
-					// can we join?
-					bg = (*iitr).second;
-					if(bg->CanPlayerJoin(plr))
-					{
-						bg->AddPlayer(plr, plr->GetTeam());
-						m_queuedPlayers[i][j].erase(it4);
-					}
-				}
-				else
-				{
-					if(IS_ARENA(i))
-						tempPlayerVec[0].push_back(plr);
-					else
-						tempPlayerVec[plr->GetTeam()].push_back(plr);
-				}
+		if(IS_ARENA(i))
+		{
+			if(!TO_ARENA(iitr->second)->Rated())
+				AddPlayersToArena(TO_ARENA(iitr->second), &tempPlayerVec[0], i, j);
+		}
+		else
+		{
+			bg = iitr->second;
+			if(bg)
+			{
+				AddPlayerPairsToBg(bg, tempPlayerVec, i, j);
+				while(AddPlayerToBgTeam(bg, &tempPlayerVec[0], i, j, 0)) {}
+				while(AddPlayerToBgTeam(bg, &tempPlayerVec[1], i, j, 1)) {}
 			}
+		}
+	}
 
-			// try to join existing instances
-			for(iitr = m_instances[i].begin(); iitr != m_instances[i].end(); iitr++)
+	if(IS_ARENA(i))
+	{
+		// enough players to start a round?
+		if((forceStart == true && tempPlayerVec[0].size() >= 1) ||
+		   (tempPlayerVec[0].size() >= GetBGMinPlayers(i)))
+		{
+			if(CanCreateInstance(i,j))
 			{
-				if( iitr->second->HasEnded() || iitr->second->GetLevelGroup() != j)
-					continue;
-
-				if(IS_ARENA(i))
-				{
-                    arena = TO_ARENA(iitr->second);
-					if(arena->Rated())
-						continue;
-
-					team = arena->GetFreeTeam();
-					while(team >= 0 && tempPlayerVec[0].size())
-					{
-						plr = *tempPlayerVec[0].begin();
-						tempPlayerVec[0].pop_front();
-						plr->m_bgTeam=team;
-						arena->AddPlayer(plr, team);
-						ErasePlayerFromList(plr->GetLowGUID(), &m_queuedPlayers[i][j]);
-						team = arena->GetFreeTeam();
-					}
-				}
-				else
-				{
-					bg = iitr->second;
-					if(bg)
-					{
-						int size = (int)min(tempPlayerVec[0].size(),tempPlayerVec[1].size());
-						for(int counter = 0; (counter < size) && (bg->IsFull() == false); counter++)
-						{
-							AddPlayerToBgTeam(bg, &tempPlayerVec[0], i, j, 0);
-							AddPlayerToBgTeam(bg, &tempPlayerVec[1], i, j, 1);
-						}
-
-						while (tempPlayerVec[0].size() > 0 && bg->HasFreeSlots(0))
-						{
-							AddPlayerToBgTeam(bg, &tempPlayerVec[0], i, j, 0);
-						}
-						while (tempPlayerVec[1].size() > 0 && bg->HasFreeSlots(1))
-						{
-							AddPlayerToBgTeam(bg, &tempPlayerVec[1], i, j, 1);
-						}
-					}
-				}
+				Arena* arena = TO_ARENA(CreateInstance(i, j));
+				if(arena != NULL)
+					AddPlayersToArena(arena, &tempPlayerVec[0], i, j);
 			}
-
-			if(IS_ARENA(i))
+		}
+	}
+	else
+	{
+		if( (forceStart == true && (tempPlayerVec[0].size() >= 1 || tempPlayerVec[1].size() >= 1)) ||
+			(tempPlayerVec[0].size() >= GetBGMinPlayers(i) && tempPlayerVec[1].size() >= GetBGMinPlayers(i)) )
+		{
+			if(CanCreateInstance(i,j))
 			{
-				// enough players to start a round?
-				if((forceStart == true && tempPlayerVec[0].size() >= 1) ||
-				   (tempPlayerVec[0].size() >= GetBGMinPlayers(i)))
+				bg = CreateInstance(i,j);
+				if( bg == NULL )
 				{
-					if(CanCreateInstance(i,j))
+					// creation failed
+					for(k = 0; k < 2; ++k)
 					{
-						arena = TO_ARENA(CreateInstance(i, j));
-						team = arena->GetFreeTeam();
-						while(!arena->IsFull() && tempPlayerVec[0].size() && team >= 0)
+						while(tempPlayerVec[k].size())
 						{
-							plr = *tempPlayerVec[0].begin();
-							tempPlayerVec[0].pop_front();
-
-							plr->m_bgTeam=team;
-							arena->AddPlayer(plr, team);
-							team = arena->GetFreeTeam();
-
-							// remove from the main queue (painful!)
-							ErasePlayerFromList(plr->GetLowGUID(), &m_queuedPlayers[i][j]);
+							m_queuedPlayers[i][j].Remove(*tempPlayerVec[k].begin());
+							tempPlayerVec[k].pop_front();
 						}
 					}
 				}
-			}
-			else
-			{
-				if( (forceStart == true && (tempPlayerVec[0].size() >= 1 || tempPlayerVec[1].size() >= 1)) ||
-					(tempPlayerVec[0].size() >= GetBGMinPlayers(i) && tempPlayerVec[1].size() >= GetBGMinPlayers(i)) )
+				else
 				{
-					if(CanCreateInstance(i,j))
+					// push as many as possible in
+					if (forceStart)
 					{
-						bg = CreateInstance(i,j);
-						if( bg == NULL )
+						for(k = 0; k < 2; ++k)
 						{
-							// creation failed
-							for(k = 0; k < 2; ++k)
-							{
-								while(tempPlayerVec[k].size())
-								{
-									plr = *tempPlayerVec[k].begin();
-									tempPlayerVec[k].pop_front();
-									ErasePlayerFromList(plr->GetLowGUID(), &m_queuedPlayers[i][j]);
-								}
-							}
-						}
-						else
-						{
-							// push as many as possible in
-							if (forceStart)
-							{
-								for(k = 0; k < 2; ++k)
-								{
-									while(tempPlayerVec[k].size() && bg->HasFreeSlots(k))
-									{
-										AddPlayerToBgTeam(bg, &tempPlayerVec[k], i, j, k);
-									}
-								}
-							}
-							else
-							{
-								int size = (int)min(tempPlayerVec[0].size(),tempPlayerVec[1].size());
-								for(int counter = 0; (counter < size) && (bg->IsFull() == false); counter++)
-								{
-									AddPlayerToBgTeam(bg, &tempPlayerVec[0], i, j, 0);
-									AddPlayerToBgTeam(bg, &tempPlayerVec[1], i, j, 1);
-								}
-							}
+							while(AddPlayerToBgTeam(bg, &tempPlayerVec[k], i, j, k)) {}
 						}
 					}
+					else
+						AddPlayerPairsToBg(bg, tempPlayerVec, i, j);
 				}
 			}
 		}
 	}
 
-	/* Handle paired arena team joining */
+	m_instanceLock.Release();
+}
+
+void CBattlegroundManager::UpdateRatedArenas(uint32 i, bool forceStart)
+{
+	ArenaRatingQueue & queue = m_queuedGroups[i - BATTLEGROUND_ARENA_2V2];
+	vector<QueuedArenaGroup> snapshot;
+	queue.Snapshot(snapshot);
+	if(snapshot.empty() || (!forceStart && snapshot.size() < 2))      /* got enough to have an arena battle ;P */
+		return;
+
 	Group * group1, *group2;
-	uint32 teamids[2] = {0,0};
-	uint32 avgRating[2] = {0,0};
-	uint32 n;
-	list<uint32>::iterator itz;
-	for(i = BATTLEGROUND_ARENA_2V2; i <= BATTLEGROUND_ARENA_5V5; i++)
+	if (forceStart && snapshot.size() == 1)
+	{
+		group1 = objmgr.GetGroupById(snapshot[0].GroupId);
+		if(group1 == NULL || !queue.Remove(group1->GetID()))
+			return;
+
+		m_instanceLock.Acquire();
+		int ret = CreateArenaType(i, group1, NULL);
+		m_instanceLock.Release();
+		if(ret == -1)
+			queue.Add(snapshot[0]);
+		else
+			group1->m_isqueued = false;
+		return;
+	}
+
+	vector<ArenaMatch> matches;
+	ArenaRatingQueue::FindMatches(snapshot, ARENA_RATING_WINDOW, matches);
+	for(size_t m = 0; m < matches.size(); ++m)
 	{
-		if(!forceStart && m_queuedGroups[i].size() < 2)      /* got enough to have an arena battle ;P */
+		group1 = objmgr.GetGroupById(matches[m].first.GroupId);
+		group2 = objmgr.GetGroupById(matches[m].second.GroupId);
+		if(group1 == NULL || group2 == NULL)
 		{
+			// Disbanded while queued
+			if(group1 == NULL)
+				queue.Remove(matches[m].first.GroupId);
+			if(group2 == NULL)
+				queue.Remove(matches[m].second.GroupId);
 			continue;
 		}
 
-		for (j=0; j<(uint32)m_queuedGroups[i].size(); j++)
-		{
-			group1 = group2 = NULL;
-			n =	RandomUInt((uint32)m_queuedGroups[i].size()) - 1;
-			for(itz = m_queuedGroups[i].begin(); itz != m_queuedGroups[i].end() && n>0; itz++)
-				--n;
-
-			if(itz == m_queuedGroups[i].end())
-				itz=m_queuedGroups[i].begin();
-
-			if(itz == m_queuedGroups[i].end())
-			{
-				Log.Error("BattlegroundMgr", "Internal error at %s:%u", __FILE__, __LINE__);
-				m_queueLock.Release();
-				m_instanceLock.Release();
-				return;
-			}
-
-			group1 = objmgr.GetGroupById(*itz);
-			if (group1 == NULL)
-			{
-				continue;
-			}
-
-			if (forceStart && m_queuedGroups[i].size() == 1)
-			{
-				if (CreateArenaType(i, group1, NULL) == -1) return;
-				m_queuedGroups[i].remove(group1->GetID());
-				group1->m_isqueued = false;
-				continue;
-			}
-
-			teamids[0] = GetArenaGroupQInfo(group1, i, &avgRating[0]);
-
-			list<uint32> possibleGroups;
-
-			possibleGroups.clear();
-			for(itz = m_queuedGroups[i].begin(); itz != m_queuedGroups[i].end(); itz++)
-			{
-				group2 = objmgr.GetGroupById(*itz);
-				if (group2)
-				{
-					teamids[1] = GetArenaGroupQInfo(group2, i, &avgRating[1]);
-					uint32 delta = abs((int32)avgRating[0] - (int32)avgRating[1]);
-					if (teamids[0] != teamids[1] && delta <= 150)
-					{
-						possibleGroups.push_back(group2->GetID());
-					}
-				}
-			}
+		if(!queue.ClaimPair(group1->GetID(), group2->GetID()))
+			continue;
 
-			if (possibleGroups.size() > 0)
-			{
-				n = RandomUInt((uint32)possibleGroups.size()) - 1;
-				for(itz = possibleGroups.begin(); itz != possibleGroups.end() && n>0; itz++)
-					--n;
+		m_instanceLock.Acquire();
+		int ret = CreateArenaType(i, group1, group2);
+		m_instanceLock.Release();
+		if(ret == -1)
+		{
+			// No room for another arena, try again next update
+			queue.Add(matches[m].first);
+			queue.Add(matches[m].second);
+			return;
+		}
 
-				if(itz == possibleGroups.end())
-					itz=possibleGroups.begin();
+		group1->m_isqueued = false;
+		group2->m_isqueued = false;
+	}
+}
 
-				if(itz == possibleGroups.end())
-				{
-					Log.Error("BattlegroundMgr", "Internal error at %s:%u", __FILE__, __LINE__);
-					m_queueLock.Release();
-					m_instanceLock.Release();
-					return;
-				}
+void CBattlegroundManager::PrintQueueStats(BaseConsole * pConsole)
+{
+	BGQueueLockStats bracketStats, ratedStats;
+	memset(&bracketStats, 0, sizeof(bracketStats));
+	memset(&ratedStats, 0, sizeof(ratedStats));
+	uint32 queuedPlayers = 0, queuedGroups = 0;
 
-				group2 = objmgr.GetGroupById(*itz);
-				if (group2)
-				{
-					if (CreateArenaType(i, group1, group2) == -1) return;
-					m_queuedGroups[i].remove(group1->GetID());
-					group1->m_isqueued = false;
-					m_queuedGroups[i].remove(group2->GetID());
-					group2->m_isqueued = false;
-				}
-			}
+	for(uint32 i = 0; i < BATTLEGROUND_NUM_TYPES; ++i)
+	{
+		for(uint32 j = 0; j < MAX_LEVEL_GROUP; ++j)
+		{
+			queuedPlayers += (uint32)m_queuedPlayers[i][j].Size();
+			m_queuedPlayers[i][j].AddLockStats(bracketStats);
 		}
 	}
 
-	m_queueLock.Release();
-	m_instanceLock.Release();
+	for(uint32 i = 0; i < 3; ++i)
+	{
+		queuedGroups += (uint32)m_queuedGroups[i].Size();
+		m_queuedGroups[i].AddLockStats(ratedStats);
+	}
+
+	pConsole->Write("Queued: %u players, %u rated arena groups\r\n", queuedPlayers, queuedGroups);
+	pConsole->Write("Bracket locks: %u acquisitions, avg held %.2fus, max held %uus\r\n", bracketStats.Acquisitions,
+		bracketStats.Acquisitions ? double(bracketStats.TotalHeldUs) / double(bracketStats.Acquisitions) : 0.0, (uint32)bracketStats.MaxHeldUs);
+	pConsole->Write("Rated queue locks: %u acquisitions, avg held %.2fus, max held %uus\r\n", ratedStats.Acquisitions,
+		ratedStats.Acquisitions ? double(ratedStats.TotalHeldUs) / double(ratedStats.Acquisitions) : 0.0, (uint32)ratedStats.MaxHeldUs);
 }
 
 void CBattlegroundManager::RemovePlayerFromQueues(Player* plr)
 {
 	m_queueLock.Acquire();
 
-	uint32 lgroup = GetLevelGrouping(plr->getLevel());
-
 	uint32 i;
 	for(i = 0; i < 2; i++)
 	{
-		list<uint32>::iterator itr2;
-		list<uint32>::iterator itr = m_queuedPlayers[plr->m_bgQueueType[i]][lgroup].begin();
-		while(itr != m_queuedPlayers[plr->m_bgQueueType[i]][lgroup].end())
+		// The player may have levelled since joining, so try every bracket of the type
+		if(plr->m_bgQueueType[i] < BATTLEGROUND_NUM_TYPES)
 		{
-			itr2 = itr;
-			itr2++;
-			if((*itr) == plr->GetLowGUID())
+			for(uint32 j = 0; j < MAX_LEVEL_GROUP; ++j)
 			{
-				OUT_DEBUG("BattlegroundManager", "Removing player %u from queue instance %u type %u", plr->GetLowGUID(), plr->m_bgQueueInstanceId[i], plr->m_bgQueueType[i]);
-				m_queuedPlayers[plr->m_bgQueueType[i]][lgroup].erase(itr);
+				if(m_queuedPlayers[plr->m_bgQueueType[i]][j].Remove(plr->GetLowGUID()))
+					OUT_DEBUG("BattlegroundManager", "Removing player %u from queue instance %u type %u", plr->GetLowGUID(), plr->m_bgQueueInstanceId[i], plr->m_bgQueueType[i]);
 			}
-
-			itr = itr2;
 		}
+
 		plr->m_bgIsQueued[i] = false;
 		plr->m_bgTeam=plr->GetTeam();
 		plr->m_pendingBattleground[i]=NULLBATTLEGROUND;
@@ -819,16 +813,8 @@ void CBattlegroundManager::RemovePlayerFromQueues(Player* plr)
 void CBattlegroundManager::RemoveGroupFromQueues(Group * grp)
 {
 	m_queueLock.Acquire();
-	for(uint32 i = BATTLEGROUND_ARENA_2V2; i < BATTLEGROUND_ARENA_5V5+1; i++)
-	{
-		for(list<uint32>::iterator itr = m_queuedGroups[i].begin(); itr != m_queuedGroups[i].end(); )
-		{
-			if((*itr) == grp->GetID())
-				itr = m_queuedGroups[i].erase(itr);
-			else
-				++itr;
-		}
-	}
+	for(uint32 i = 0; i < 3; i++)
+		m_queuedGroups[i].Remove(grp->GetID());
 
 	for(GroupMembersSet::iterator itr = grp->GetSubGroup(0)->GetGroupMembersBegin(); itr != grp->GetSubGroup(0)->GetGroupMembersEnd(); itr++)
 		if((*itr)->m_loggedInPlayer)
@@ -1333,37 +1319,32 @@ void CBattlegroundManager::DeleteBattleground(CBattleground* bg)
 	Player* plr;
 
 	m_instanceLock.Acquire();
-	m_queueLock.Acquire();
 	m_instances[i].erase(bg->GetId());
+	m_instanceLock.Release();
 
 	/* erase any queued players */
-	list<uint32>::iterator itr = m_queuedPlayers[i][j].begin();
-	list<uint32>::iterator it2;
-	for(; itr != m_queuedPlayers[i][j].end();)
+	vector<uint32> snapshot;
+	m_queuedPlayers[i][j].Snapshot(snapshot);
+	for(vector<uint32>::iterator itr = snapshot.begin(); itr != snapshot.end(); ++itr)
 	{
-		it2 = itr++;
-		plr = objmgr.GetPlayer(*it2);
+		plr = objmgr.GetPlayer(*itr);
 		if(!plr)
 		{
-			m_queuedPlayers[i][j].erase(it2);
+			m_queuedPlayers[i][j].Remove(*itr);
 			continue;
 		}
 
 		for(uint32 z= 0; z < 2; ++z)
 		{
-			if(plr && plr->m_bgQueueInstanceId[z] == bg->GetId())
+			if(plr->m_bgQueueInstanceId[z] == bg->GetId() && m_queuedPlayers[i][j].Remove(*itr))
 			{
 				sChatHandler.SystemMessageToPlr(plr, "Your queue on battleground instance %u is no longer valid, the instance no longer exists.", bg->GetId());
 				SendBattlegroundQueueStatus(plr, z);
 				plr->m_bgIsQueued[z] = false;
-				m_queuedPlayers[i][j].erase(it2);
 			}
 		}
 	}
 
-	m_queueLock.Release();
-	m_instanceLock.Release();
-
 	bg = NULLBATTLEGROUND;
 	delete bg;
 }
@@ -2035,9 +2016,12 @@ void CBattlegroundManager::HandleArenaJoin(WorldSession * m_session, uint32 Batt
 			pGroup->Unlock();
 			pGroup->m_isqueued = true;
 
-			m_queueLock.Acquire();
-			m_queuedGroups[BattlegroundType].push_back(pGroup->GetID());
-			m_queueLock.Release();
+			// Rating is taken once here, the matchmaker works from the queued value
+			QueuedArenaGroup queued;
+			queued.GroupId = pGroup->GetID();
+			queued.TeamId = GetArenaGroupQInfo(pGroup, BattlegroundType, &queued.Rating);
+			queued.QueueTime = (uint32)UNIXTIME;
+			m_queuedGroups[BattlegroundType - BATTLEGROUND_ARENA_2V2].Add(queued);
 			Log.Success("BattlegroundMgr", "Group %u is now in battleground queue for arena type %u", pGroup->GetID(), BattlegroundType);
 
 			/* send the battleground status packet */
@@ -2049,7 +2033,7 @@ void CBattlegroundManager::HandleArenaJoin(WorldSession * m_session, uint32 Batt
 
 	/* Queue him! */
 	m_queueLock.Acquire();
-	m_queuedPlayers[BattlegroundType][lgroup].push_back(pguid);
+	m_queuedPlayers[BattlegroundType][lgroup].Add(pguid);
 	Log.Success("BattlegroundMgr", "Player %u is now in battleground queue for {Arena %u}", plr->GetLowGUID(), BattlegroundType );
 
 	/* send the battleground status packet */
@@ -5,6 +5,7 @@
 #pragma once
 
 class CBattleground;
+class Arena;
 class MapMgr;
 class Player;
 class Map;
@@ -134,17 +135,21 @@ class SERVER_DECL CBattlegroundManager : public Singleton<CBattlegroundManager>,
 	uint32 m_maxBattlegroundId;
 
 	/* Queue System */
-	// Instance Id -> list<Player guid> [ BattlegroundType ] (instance 0 - first available)
-	list<uint32> m_queuedPlayers[BATTLEGROUND_NUM_TYPES][MAX_LEVEL_GROUP];
+	// Player guids [ BattlegroundType ][ LevelGroup ], each with its own lock
+	BGPlayerQueue m_queuedPlayers[BATTLEGROUND_NUM_TYPES][MAX_LEVEL_GROUP];
 
-	// Instance Id -> list<Group id> [BattlegroundType][LevelGroup]
-	list<uint32> m_queuedGroups[BATTLEGROUND_NUM_TYPES];
+	// Rated arena groups by rating [ BattlegroundType - BATTLEGROUND_ARENA_2V2 ]
+	ArenaRatingQueue m_queuedGroups[3];
 
 	// Last 10 players average wait time
 	uint32 m_averageQueueTimes[BATTLEGROUND_NUM_TYPES][10];
 
+	// Guards the queue fields on Player while joining and leaving, not the queues
 	Mutex m_queueLock;
 
+	void UpdateBracket(uint32 i, uint32 j, bool forceStart, vector<uint32> & snapshot);
+	void UpdateRatedArenas(uint32 i, bool forceStart);
+
 public:
 	CBattlegroundManager();
 	~CBattlegroundManager();
@@ -185,11 +190,23 @@ public:
 	/* Creates an arena with groups group1 and group2 */
 	int CreateArenaType(int type, Group * group1, Group * group2);
 
-	/* Add player to bg team */
-	void AddPlayerToBgTeam(CBattleground* bg, deque<Player*  > *playerVec, uint32 i, uint32 j, int Team);
+	/* Locks the bracket and finds the player again, NULL (and unlocked) if they left the queue or logged out */
+	Player* LockQueuedPlayer(uint32 i, uint32 j, uint32 guid);
+
+	/* Add the next queued player to bg team, false if nobody could be added */
+	bool AddPlayerToBgTeam(CBattleground* bg, deque<uint32> *playerVec, uint32 i, uint32 j, int Team);
 
 	/* Add player to bg */
-	void AddPlayerToBg(CBattleground* bg, deque<Player*  > *playerVec, uint32 i, uint32 j);
+	bool AddPlayerToBg(CBattleground* bg, deque<uint32> *playerVec, uint32 i, uint32 j);
+
+	/* Add one player per team at a time while both teams have someone queued */
+	void AddPlayerPairsToBg(CBattleground* bg, deque<uint32> *playerVec, uint32 i, uint32 j);
+
+	/* Add queued players to an arena until it is full */
+	void AddPlayersToArena(Arena* arena, deque<uint32> *playerVec, uint32 i, uint32 j);
+
+	/* Prints queue sizes and lock hold times */
+	void PrintQueueStats(BaseConsole * pConsole);
 
 	/* Add a group to an arena */
 	void AddGroupToArena(CBattleground* bg, Group * group, int nteam);
@@ -0,0 +1,204 @@
+/***
+ * Demonstrike Core
+ */
+
+#include "StdAfx.h"
+
+void BGQueueLock::AddStats(BGQueueLockStats & stats)
+{
+	m_lock.Acquire();
+	stats.Acquisitions += m_stats.Acquisitions;
+	stats.TotalHeldUs += m_stats.TotalHeldUs;
+	if(m_stats.MaxHeldUs > stats.MaxHeldUs)
+		stats.MaxHeldUs = m_stats.MaxHeldUs;
+	m_lock.Release();
+}
+
+void BGPlayerQueue::Add(uint32 guid)
+{
+	m_lock.Acquire();
+	if(m_index.find(guid) == m_index.end())
+		m_index[guid] = m_players.insert(m_players.end(), guid);
+	m_lock.Release();
+}
+
+bool BGPlayerQueue::Remove(uint32 guid)
+{
+	bool found = false;
+	m_lock.Acquire();
+	HM_NAMESPACE::hash_map<uint32, list<uint32>::iterator>::iterator itr = m_index.find(guid);
+	if(itr != m_index.end())
+	{
+		m_players.erase(itr->second);
+		m_index.erase(itr);
+		found = true;
+	}
+	m_lock.Release();
+	return found;
+}
+
+bool BGPlayerQueue::LockQueued(uint32 guid)
+{
+	m_lock.Acquire();
+	if(m_index.find(guid) != m_index.end())
+		return true;
+	m_lock.Release();
+	return false;
+}
+
+void BGPlayerQueue::ClaimLocked(uint32 guid)
+{
+	HM_NAMESPACE::hash_map<uint32, list<uint32>::iterator>::iterator itr = m_index.find(guid);
+	if(itr != m_index.end())
+	{
+		m_players.erase(itr->second);
+		m_index.erase(itr);
+	}
+}
+
+void BGPlayerQueue::Snapshot(vector<uint32> & out)
+{
+	out.clear();
+	m_lock.Acquire();
+	out.reserve(m_players.size());
+	out.insert(out.end(), m_players.begin(), m_players.end());
+	m_lock.Release();
+}
+
+size_t BGPlayerQueue::Size()
+{
+	m_lock.Acquire();
+	size_t size = m_players.size();
+	m_lock.Release();
+	return size;
+}
+
+void ArenaRatingQueue::Add(QueuedArenaGroup & group)
+{
+	m_lock.Acquire();
+	if(m_byGroup.find(group.GroupId) == m_byGroup.end())
+		m_byGroup[group.GroupId] = m_byRating.insert(make_pair(group.Rating, group));
+	m_lock.Release();
+}
+
+bool ArenaRatingQueue::Remove(uint32 groupId)
+{
+	bool found = false;
+	m_lock.Acquire();
+	HM_NAMESPACE::hash_map<uint32, RatingMap::iterator>::iterator itr = m_byGroup.find(groupId);
+	if(itr != m_byGroup.end())
+	{
+		m_byRating.erase(itr->second);
+		m_byGroup.erase(itr);
+		found = true;
+	}
+	m_lock.Release();
+	return found;
+}
+
+bool ArenaRatingQueue::ClaimPair(uint32 groupId1, uint32 groupId2)
+{
+	m_lock.Acquire();
+	HM_NAMESPACE::hash_map<uint32, RatingMap::iterator>::iterator itr1 = m_byGroup.find(groupId1);
+	HM_NAMESPACE::hash_map<uint32, RatingMap::iterator>::iterator itr2 = m_byGroup.find(groupId2);
+	if(itr1 == m_byGroup.end() || itr2 == m_byGroup.end())
+	{
+		m_lock.Release();
+		return false;
+	}
+
+	m_byRating.erase(itr1->second);
+	m_byRating.erase(itr2->second);
+	m_byGroup.erase(itr1);
+	m_byGroup.erase(groupId2);
+	m_lock.Release();
+	return true;
+}
+
+void ArenaRatingQueue::Snapshot(vector<QueuedArenaGroup> & out)
+{
+	out.clear();
+	m_lock.Acquire();
+	out.reserve(m_byRating.size());
+	for(RatingMap::iterator itr = m_byRating.begin(); itr != m_byRating.end(); ++itr)
+		out.push_back(itr->second);
+	m_lock.Release();
+}
+
+size_t ArenaRatingQueue::Size()
+{
+	m_lock.Acquire();
+	size_t size = m_byRating.size();
+	m_lock.Release();
+	return size;
+}
+
+static bool QueuedArenaGroupRatingLess(const QueuedArenaGroup & a, const QueuedArenaGroup & b)
+{
+	return a.Rating < b.Rating;
+}
+
+struct QueuedArenaGroupWaitLess
+{
+	vector<QueuedArenaGroup> * groups;
+	bool operator()(uint32 a, uint32 b) const { return (*groups)[a].QueueTime < (*groups)[b].QueueTime; }
+};
+
+void ArenaRatingQueue::FindMatches(vector<QueuedArenaGroup> & snapshot, uint32 window, vector<ArenaMatch> & matches)
+{
+	matches.clear();
+	size_t count = snapshot.size();
+	if(count < 2)
+		return;
+
+	vector<uint32> order(count);
+	for(uint32 i = 0; i < count; ++i)
+		order[i] = i;
+
+	QueuedArenaGroupWaitLess waitLess;
+	waitLess.groups = &snapshot;
+	std::stable_sort(order.begin(), order.end(), waitLess);
+
+	vector<bool> matched(count, false);
+	QueuedArenaGroup bound;
+	for(uint32 o = 0; o < count; ++o)
+	{
+		uint32 idx = order[o];
+		if(matched[idx])
+			continue;
+
+		QueuedArenaGroup & group = snapshot[idx];
+		bound.Rating = group.Rating > window ? group.Rating - window : 0;
+		int32 lo = int32(std::lower_bound(snapshot.begin(), snapshot.end(), bound, QueuedArenaGroupRatingLess) - snapshot.begin());
+		bound.Rating = group.Rating + window;
+		int32 hi = int32(std::upper_bound(snapshot.begin(), snapshot.end(), bound, QueuedArenaGroupRatingLess) - snapshot.begin());
+
+		// Closest free group on either side of this one
+		int32 below = -1, above = -1;
+		for(int32 k = int32(idx) - 1; k >= lo; --k)
+		{
+			if(!matched[k] && snapshot[k].TeamId != group.TeamId)
+			{
+				below = k;
+				break;
+			}
+		}
+		for(int32 k = int32(idx) + 1; k < hi; ++k)
+		{
+			if(!matched[k] && snapshot[k].TeamId != group.TeamId)
+			{
+				above = k;
+				break;
+			}
+		}
+
+		int32 best = below;
+		if(above >= 0 && (below < 0 || snapshot[above].Rating - group.Rating < group.Rating - snapshot[below].Rating))
+			best = above;
+		if(best < 0)
+			continue;
+
+		matched[idx] = matched[best] = true;
+		matches.push_back(make_pair(group, snapshot[best]));
+	}
+}
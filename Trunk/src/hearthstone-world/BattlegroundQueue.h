@@ -0,0 +1,124 @@
+/***
+ * Demonstrike Core
+ */
+
+#pragma once
+
+/************************************************************************/
+/* Battleground queues, one lock per bracket                            */
+/************************************************************************/
+// Joining or leaving only ever locks the one bracket involved, and only for
+// a list insert or erase. The matchmaker copies the guids of a bracket out
+// and works on the copy without any queue lock held. Whenever it looks at a
+// player it locks the bracket and goes on only if they are still queued, and
+// it claims and places them before unlocking, so nobody is sent in after
+// cancelling or logging out. m_instanceLock is always taken before a bracket
+// lock, never the other way round.
+
+struct BGQueueLockStats
+{
+	uint32 Acquisitions;
+	uint64 TotalHeldUs;
+	uint64 MaxHeldUs;
+};
+
+class BGQueueLock
+{
+public:
+	BGQueueLock() : m_lockedAt(0) { memset(&m_stats, 0, sizeof(m_stats)); }
+
+	HEARTHSTONE_INLINE void Acquire()
+	{
+		m_lock.Acquire();
+		m_lockedAt = getUSTime();
+	}
+
+	HEARTHSTONE_INLINE void Release()
+	{
+		uint64 held = getUSTime() - m_lockedAt;
+		++m_stats.Acquisitions;
+		m_stats.TotalHeldUs += held;
+		if(held > m_stats.MaxHeldUs)
+			m_stats.MaxHeldUs = held;
+		m_lock.Release();
+	}
+
+	// Adds this lock's figures to stats
+	void AddStats(BGQueueLockStats & stats);
+
+private:
+	Mutex m_lock;
+	uint64 m_lockedAt;
+	BGQueueLockStats m_stats;
+};
+
+class BGPlayerQueue
+{
+public:
+	void Add(uint32 guid);
+	bool Remove(uint32 guid);
+
+	// Locks the queue if the player is still in it. A logout can't get past
+	// RemovePlayerFromQueues while it is locked, so the Player looked up by
+	// guid stays valid until Unlock.
+	bool LockQueued(uint32 guid);
+	HEARTHSTONE_INLINE void Unlock() { m_lock.Release(); }
+
+	// Takes the player out of the queue, only while LockQueued holds it
+	void ClaimLocked(uint32 guid);
+
+	// Queued players in join order
+	void Snapshot(vector<uint32> & out);
+	size_t Size();
+
+	HEARTHSTONE_INLINE void AddLockStats(BGQueueLockStats & stats) { m_lock.AddStats(stats); }
+
+private:
+	BGQueueLock m_lock;
+	list<uint32> m_players;
+	HM_NAMESPACE::hash_map<uint32, list<uint32>::iterator> m_index;
+};
+
+/************************************************************************/
+/* Rated arena queue, ordered by team rating                            */
+/************************************************************************/
+
+struct QueuedArenaGroup
+{
+	uint32 GroupId;
+	uint32 TeamId;
+	uint32 Rating;
+	uint32 QueueTime;
+};
+
+typedef std::pair<QueuedArenaGroup, QueuedArenaGroup> ArenaMatch;
+
+class ArenaRatingQueue
+{
+	typedef multimap<uint32, QueuedArenaGroup> RatingMap;
+
+public:
+	void Add(QueuedArenaGroup & group);
+	bool Remove(uint32 groupId);
+
+	// Takes both groups out of the queue, or neither if one of them has left
+	bool ClaimPair(uint32 groupId1, uint32 groupId2);
+
+	// Queued groups ordered by rating
+	void Snapshot(vector<QueuedArenaGroup> & out);
+	size_t Size();
+
+	HEARTHSTONE_INLINE void AddLockStats(BGQueueLockStats & stats) { m_lock.AddStats(stats); }
+
+	// Pairs the groups of a snapshot, longest waiting first, each with the closest
+	// rated group of another team no more than window away. The snapshot must be
+	// ordered by rating; the search is a binary search plus a walk over the window.
+	static void FindMatches(vector<QueuedArenaGroup> & snapshot, uint32 window, vector<ArenaMatch> & matches);
+
+private:
+	BGQueueLock m_lock;
+	RatingMap m_byRating;
+	HM_NAMESPACE::hash_map<uint32, RatingMap::iterator> m_byGroup;
+};
+
+#define ARENA_RATING_WINDOW 150
@@ -41,6 +41,8 @@ Channel::Channel(const char * name, uint32 team, uint32 type_id, uint32 id)
 	m_typeId = type_id;
 	m_channelId = id;
 	m_deleted = false;
+	m_memberList = NULL;
+	m_lock.SetLockName("Channel::m_lock");
 
 	pDBC = dbcChatChannels.LookupEntryForced(type_id);
 	if( pDBC != NULL )
@@ -105,6 +107,7 @@ void Channel::AttemptJoin(Player* plr, const char * password)
 
 	plr->JoinedChannel(this);
 	m_members.insert(make_pair(plr, flags));
+	_InvalidateMemberList();
 
 	if(m_announce && !plr->bGMTagOn)
 	{
@@ -137,6 +140,7 @@ void Channel::Part(Player* plr, bool silent)
 
 	flags = itr->second;
 	m_members.erase(itr);
+	ChannelMemberList * oldList = _DetachMemberList();
 
 	plr->LeftChannel(this);
 
@@ -167,12 +171,17 @@ void Channel::Part(Player* plr, bool silent)
 	if(m_members.size() == 0 )
 	{
 		m_lock.Release();
+		_ReleaseMemberList(oldList, true);
 		channelmgr.RemoveChannel(this);
 	}
 	else
+	{
 		m_lock.Release();
+		_ReleaseMemberList(oldList, true);
+	}
 #else
 	m_lock.Release();
+	_ReleaseMemberList(oldList, true);
 #endif
 }
 
@@ -315,13 +324,14 @@ void Channel::Moderate(Player* plr)
 
 void Channel::Say(Player* plr, const char * message, Player* for_gm_client, bool forced)
 {
-	Guard mGuard(m_lock);
+	m_lock.Acquire();
 	MemberMap::iterator itr = m_members.find(plr);
 	WorldPacket data(strlen(message)+100);
 	if(!forced)
 	{
 		if(m_members.end() == itr)
 		{
+			m_lock.Release();
 			MakeNotifyPacket(&data, CHANNEL_NOTIFY_FLAG_NOTON);
 			plr->GetSession()->SendPacket(&data);
 			return;
@@ -329,6 +339,7 @@ void Channel::Say(Player* plr, const char * message, Player* for_gm_client, bool
 
 		if(itr->second & CHANNEL_FLAG_MUTED)
 		{
+			m_lock.Release();
 			MakeNotifyPacket(&data, CHANNEL_NOTIFY_FLAG_YOUCANTSPEAK);
 			plr->GetSession()->SendPacket(&data);
 			return;
@@ -336,12 +347,16 @@ void Channel::Say(Player* plr, const char * message, Player* for_gm_client, bool
 
 		if(m_muted && !(itr->second & CHANNEL_FLAG_VOICED) && !(itr->second & CHANNEL_FLAG_MODERATOR) && !(itr->second & CHANNEL_FLAG_OWNER))
 		{
+			m_lock.Release();
 			MakeNotifyPacket(&data, CHANNEL_NOTIFY_FLAG_YOUCANTSPEAK);
 			plr->GetSession()->SendPacket(&data);
 			return;
 		}
 	}
 
+	// SendToAll only needs the lock to pick up the member list
+	m_lock.Release();
+
 	data.SetOpcode(SMSG_MESSAGECHAT);
 	data << uint8(CHAT_MSG_CHANNEL);
 	data << uint32(0);		// language
@@ -416,6 +431,7 @@ void Channel::Kick(Player* plr, Player* die_player, bool ban)
 	}
 
 	m_members.erase(itr);
+	ChannelMemberList * oldList = _DetachMemberList();
 
 	if(flags & CHANNEL_FLAG_OWNER)
 		SetOwner(NULLPLR, NULLPLR);
@@ -426,6 +442,10 @@ void Channel::Kick(Player* plr, Player* die_player, bool ban)
 	MakeNotifyPacket(&data, CHANNEL_NOTIFY_FLAG_YOULEFT);
 	data << m_typeId << uint32(0) << uint8(0);
 	die_player->GetSession()->SendPacket(&data);
+
+	// Like Part, the kicked player may be deleted once we return. Broadcasts don't take
+	// m_lock while they walk the list, so waiting with it held can't stall them.
+	_ReleaseMemberList(oldList, true);
 }
 
 void Channel::Unban(Player* plr, PlayerInfo * bplr)
@@ -801,28 +821,78 @@ Channel::~Channel()
 	m_lock.Acquire();
 	for(MemberMap::iterator itr = m_members.begin(); itr != m_members.end(); itr++)
 		itr->first->LeftChannel(this);
+	_InvalidateMemberList();
 	m_lock.Release();
 	m_deleted = true;
 }
 
-void Channel::SendToAll(WorldPacket * data)
+ChannelMemberList * Channel::_AcquireMemberList()
 {
-	Guard guard(m_lock);
-	for(MemberMap::iterator itr = m_members.begin(); itr != m_members.end(); itr++)
+	if(m_memberList == NULL)
+	{
+		// The channel keeps one reference for as long as the list is current
+		m_memberList = new ChannelMemberList;
+		++m_memberList->References;
+		m_memberList->Members.reserve(m_members.size());
+		for(MemberMap::iterator itr = m_members.begin(); itr != m_members.end(); itr++)
+			m_memberList->Members.push_back(itr->first);
+	}
+
+	++m_memberList->References;
+	return m_memberList;
+}
+
+ChannelMemberList * Channel::_DetachMemberList()
+{
+	ChannelMemberList * list = m_memberList;
+	m_memberList = NULL;
+	return list;
+}
+
+void Channel::_InvalidateMemberList()
+{
+	_ReleaseMemberList(_DetachMemberList(), false);
+}
+
+void Channel::_ReleaseMemberList(ChannelMemberList * list, bool waitForSenders)
+{
+	if(list == NULL)
+		return;
+
+	if(waitForSenders)
 	{
-		if( itr->first->GetSession() )
-			itr->first->GetSession()->SendPacket(data);
+		// Broadcasts only hold the list for one pass over it
+		while(list->References.GetVal() > 1)
+			Sleep(1);
 	}
+
+	if(--list->References == 0)
+		delete list;
+}
+
+void Channel::SendToAll(WorldPacket * data)
+{
+	SendToAll(data, NULLPLR);
 }
 
 void Channel::SendToAll(WorldPacket * data, Player* plr)
 {
-	Guard guard(m_lock);
-	for(MemberMap::iterator itr = m_members.begin(); itr != m_members.end(); itr++)
+	m_lock.Acquire();
+	ChannelMemberList * list = _AcquireMemberList();
+	m_lock.Release();
+
+	// Members with a full send buffer all queue the same copy
+	SharedWorldPacket * shared = NULL;
+	for(vector<Player*>::iterator itr = list->Members.begin(); itr != list->Members.end(); ++itr)
 	{
-		if ( itr->first != plr && itr->first->GetSession() )
-			itr->first->GetSession()->SendPacket(data);
+		WorldSession * session = (*itr)->GetSession();
+		if( *itr != plr && session != NULL )
+			session->SendSharedPacket(data, shared);
 	}
+
+	if(shared != NULL)
+		WorldPacketPool::Free(shared);
+	_ReleaseMemberList(list, false);
 }
 
 Channel * ChannelMgr::GetCreateChannel(const char *name, Player* p, uint32 type_id)
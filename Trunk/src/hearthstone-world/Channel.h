@@ -57,6 +57,14 @@ enum CHANNEL_NOTIFY_FLAGS
 	CHANNEL_NOTIFY_FLAG_VOICE_OFF	= 0x23,
 };
 
+// Copy of the member list that broadcasts walk without holding the channel
+// lock. It is rebuilt on the first broadcast after a join, part or kick.
+struct ChannelMemberList
+{
+	AtomicCounter References;
+	vector<Player*> Members;
+};
+
 class SERVER_DECL Channel
 {
 private:
@@ -64,6 +72,14 @@ private:
 	typedef map<Player* , uint32> MemberMap;
 	MemberMap m_members;
 	set<uint32> m_bannedMembers;
+	ChannelMemberList * m_memberList;
+
+	// All under m_lock
+	ChannelMemberList * _AcquireMemberList();
+	ChannelMemberList * _DetachMemberList();
+	void _InvalidateMemberList();
+	// waitForSenders: don't return while a broadcast still walks the list, used before a member may be deleted
+	static void _ReleaseMemberList(ChannelMemberList * list, bool waitForSenders);
 
 public:
 	friend class ChannelIterator;
@@ -233,6 +233,9 @@ void WorldSession::HandleChannelUnban(WorldPacket& recvPacket)
 
 	chn = channelmgr.GetChannel(channelname.c_str(), _player);
 	plr = objmgr.GetPlayerInfoByName(newp.c_str());
+	if( plr == NULL && DeferUntilPlayerInfoLoaded(objmgr.GetPlayerGuidByName(newp.c_str()), recvPacket) )
+		return;
+
 	if( chn != NULL && plr != NULL )
 		chn->Unban(_player, plr);
 }
@@ -279,7 +279,7 @@ void WorldSession::HandleCharCreateOpcode( WorldPacket & recv_data )
 		return;
 	}
 
-	if(objmgr.GetPlayerInfoByName(name.c_str()) != 0)
+	if(objmgr.GetPlayerGuidByName(name.c_str()) != 0)
 	{
 		data << uint8(CHAR_CREATE_NAME_IN_USE);
 		SendPacket(&data);
@@ -492,7 +492,7 @@ void WorldSession::HandleCharDeleteOpcode( WorldPacket & recv_data )
 
 uint8 WorldSession::DeleteCharacter(uint32 guid)
 {
-	PlayerInfo * inf = objmgr.GetPlayerInfo(guid);
+	PlayerInfo * inf = objmgr.LoadPlayerInfo(guid);
 	if( inf != NULL && inf->m_loggedInPlayer == NULL )
 	{
 		QueryResult * result = CharacterDatabase.Query("SELECT name FROM characters WHERE guid = %u AND acct = %u", (uint32)guid, _accountId);
@@ -579,7 +579,7 @@ uint8 WorldSession::DeleteCharacter(uint32 guid)
 		CharacterDatabase.Execute("DELETE FROM tutorials WHERE playerId = %u", (uint32)guid);
 
 		/* remove player info */
-		objmgr.DeletePlayerInfo((uint32)guid);
+		objmgr.DeletePlayerInfo((uint32)guid, name.c_str());
 		return CHAR_DELETE_SUCCESS;
 	}
 
@@ -594,7 +594,7 @@ void WorldSession::HandleCharRenameOpcode(WorldPacket & recv_data)
 	string name;
 	recv_data >> guid >> name;
 
-	PlayerInfo * pi = objmgr.GetPlayerInfo((uint32)guid);
+	PlayerInfo * pi = objmgr.LoadPlayerInfo((uint32)guid);
 	if(pi == NULL)
 		return;
 
@@ -643,7 +643,7 @@ void WorldSession::HandleCharRenameOpcode(WorldPacket & recv_data)
 	}
 
 	// Check if name is in use.
-	if(objmgr.GetPlayerInfoByName(name.c_str()) != 0)
+	if(objmgr.GetPlayerGuidByName(name.c_str()) != 0)
 	{
 		data << uint8(CHAR_NAME_FAILURE);
 		data << guid << name;
@@ -684,7 +684,7 @@ void WorldSession::HandlePlayerLoginOpcode( WorldPacket & recv_data )
 		response = CHAR_LOGIN_DUPLICATE_CHARACTER;
 	else //Do we exist in DB yet?
 	{
-		PlayerInfo * plrInfo = objmgr.GetPlayerInfo(playerGuid);
+		PlayerInfo * plrInfo = objmgr.LoadPlayerInfo(playerGuid);
 		if( plrInfo )
 			response = CHAR_LOGIN_SUCCESS;
 	}
@@ -767,7 +767,7 @@ void WorldSession::FullLogin(Player* plr)
 	}
 
 	// Make sure our name exists (for premade system)
-	PlayerInfo * info = objmgr.GetPlayerInfo(plr->GetLowGUID());
+	PlayerInfo * info = objmgr.LoadPlayerInfo(plr->GetLowGUID());
 	if(info == NULL)
 	{
 		info = new PlayerInfo;
@@ -973,14 +973,11 @@ bool ChatHandler::HandleRenameCommand(const char * args, WorldSession * m_sessio
 	}
 
 	string new_name = name2;
-	PlayerInfo * pi = objmgr.GetPlayerInfoByName(name1);
+	PlayerInfo * pi = getPlayerInfoByName(name1, m_session);
 	if(pi == 0)
-	{
-		RedSystemMessage(m_session, "Player not found with this name.");
 		return true;
-	}
 
-	if( objmgr.GetPlayerInfoByName(new_name.c_str()) != NULL )
+	if( objmgr.GetPlayerGuidByName(new_name.c_str()) != 0 )
 	{
 		RedSystemMessage(m_session, "Player found with this name in use already.");
 		return true;
@@ -995,7 +992,7 @@ bool ChatHandler::HandleRenameCommand(const char * args, WorldSession * m_sessio
 	Player* plr = objmgr.GetPlayer(pi->guid);
 	if(plr != 0)
 	{
-		plr->SetName(new_name);
+		objmgr.RenamePlayer(plr, new_name);
 		BlueSystemMessageToPlr(plr, "%s changed your name to '%s'.", m_session->GetPlayer()->GetName(), new_name.c_str());
 		plr->SaveToDB(false);
 	}
@@ -1079,7 +1076,7 @@ void WorldSession::HandleCharCustomizeOpcode(WorldPacket & recv_data)
 	recv_data >> gender >> skin >> hairColor >> hairStyle >> facialHair >> face;
 
 	uint32 playerGuid = uint32(guid);
-	PlayerInfo* pi = objmgr.GetPlayerInfo(playerGuid);
+	PlayerInfo* pi = objmgr.LoadPlayerInfo(playerGuid);
 	if( pi == NULL )
 		return;
 
@@ -1117,7 +1114,7 @@ void WorldSession::HandleCharCustomizeOpcode(WorldPacket & recv_data)
 		}
 
 		// Check if name is in use.
-		if(objmgr.GetPlayerInfoByName(name.c_str()) != 0)
+		if(objmgr.GetPlayerGuidByName(name.c_str()) != 0)
 		{
 			data << uint8(0x32);
 			data << guid << name;
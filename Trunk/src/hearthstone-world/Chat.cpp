@@ -294,6 +294,8 @@ void CommandTableStorage::Init()
 		{ "setallratings",				COMMAND_LEVEL_D, &ChatHandler::HandleRatingsCommand,						"Sets rating values to incremental numbers based on their index.",														NULL, 0, 0, 0 },
 		{ "sendmirrortimer",			COMMAND_LEVEL_D, &ChatHandler::HandleMirrorTimerCommand,					"Sends a mirror Timer opcode to target syntax: <type>",																	NULL, 0, 0, 0 },
 		{ "setstartlocation",			COMMAND_LEVEL_D, &ChatHandler::HandleSetPlayerStartLocation,				"",																														NULL, 0, 0, 0 },
+		{ "poolstats",					COMMAND_LEVEL_D, &ChatHandler::HandleDebugPoolStatsCommand,					"Shows occupancy of the spell and aura object pools.",																	NULL, 0, 0, 0 },
+		{ "opcodestats",				COMMAND_LEVEL_D, &ChatHandler::HandleDebugOpcodeStatsCommand,				".opcodestats <count>|reset - Shows the packet handlers that took the most time.",										NULL, 0, 0, 0 },
 		{ NULL,							COMMAND_LEVEL_0, NULL,														"",																														NULL, 0, 0, 0 }
 	};
 	dupe_command_table(debugCommandTable, _debugCommandTable);
@@ -572,6 +574,7 @@ void CommandTableStorage::Init()
 		{ "level",					COMMAND_LEVEL_Z, &ChatHandler::HandleAccountLevelCommand,		"Sets gm level on account. <username><gm_lvl>.",		NULL, 0, 0, 0 },
 		{ "mute",					COMMAND_LEVEL_A, &ChatHandler::HandleAccountMuteCommand,		"Mutes account for <timeperiod>.",						NULL, 0, 0, 0 },
 		{ "unmute",					COMMAND_LEVEL_A, &ChatHandler::HandleAccountUnmuteCommand,		"Unmutes account <x>",									NULL, 0, 0, 0 },
+		{ "refresh",				COMMAND_LEVEL_Z, &ChatHandler::HandleAccountRefreshCommand,		"Makes the logon server reread account <x> from the database.",	NULL, 0, 0, 0 },
 		{ NULL,						COMMAND_LEVEL_0, NULL,											"",														NULL, 0, 0, 0 },
 	};
 	dupe_command_table(accountCommandTable, _accountCommandTable);
@@ -644,6 +647,7 @@ void CommandTableStorage::Init()
 		{ "remove",					COMMAND_LEVEL_2, &ChatHandler::HandleQuestRemoveCommand,		"Removes the quest <id> from the targeted player",				NULL, 0, 0, 0 },
 		{ "reward",					COMMAND_LEVEL_2, &ChatHandler::HandleQuestRewardCommand,		"Shows reward for quest <id>",									NULL, 0, 0, 0 },
 		{ "status",					COMMAND_LEVEL_2, &ChatHandler::HandleQuestStatusCommand,		"Lists the status of quest <id>",								NULL, 0, 0, 0 },
+		{ "cachestats",				COMMAND_LEVEL_2, &ChatHandler::HandleQuestCacheStatsCommand,	"Shows quest giver status cache hits and recomputations",		NULL, 0, 0, 0 },
 		{ "spawn",					COMMAND_LEVEL_2, &ChatHandler::HandleQuestSpawnCommand,			"Port to spawn location for quest <id>",						NULL, 0, 0, 0 },
 		{ "start",					COMMAND_LEVEL_2, &ChatHandler::HandleQuestStartCommand,			"Starts quest <id>",											NULL, 0, 0, 0 },
 		{ NULL,						COMMAND_LEVEL_0, NULL,											"",																NULL, 0, 0, 0 },
@@ -1135,6 +1139,20 @@ Player* ChatHandler::getSelectedChar(WorldSession *m_session, bool showerror)
 	return chr;
 }
 
+PlayerInfo* ChatHandler::getPlayerInfoByName(const char * name, WorldSession *m_session)
+{
+	PlayerInfo * pi = objmgr.GetPlayerInfoByName(name);
+	if(pi != NULL)
+		return pi;
+
+	// Characters that are not resident come in from the database in the background
+	if(objmgr.GetPlayerGuidByName(name) != 0)
+		RedSystemMessage(m_session, "Loading %s from the database, repeat the command in a moment.", name);
+	else
+		RedSystemMessage(m_session, "Player %s does not exist.", name);
+	return NULL;
+}
+
 Creature* ChatHandler::getSelectedCreature(WorldSession *m_session, bool showerror)
 {
 	if(!m_session->GetPlayer()->IsInWorld())
@@ -395,6 +395,7 @@ protected:
 
 	Player* getSelectedChar(WorldSession *m_session, bool showerror = true);
 	Creature* getSelectedCreature(WorldSession *m_session, bool showerror = true);
+	PlayerInfo* getPlayerInfoByName(const char * name, WorldSession *m_session);
 	Unit* getSelectedUnit(WorldSession *m_session, bool showerror = true);
 	bool HandleGOScale(const char* args, WorldSession *m_session);
 	bool HandleReviveStringcommand(const char* args, WorldSession* m_session);
@@ -595,6 +596,7 @@ protected:
 	bool HandleQuestSpawnCommand(const char * args, WorldSession * m_session);
 	bool HandleQuestStartCommand(const char * args, WorldSession * m_session);
 	bool HandleQuestStatusCommand(const char * args, WorldSession * m_session);
+	bool HandleQuestCacheStatsCommand(const char * args, WorldSession * m_session);
 
 	bool HandleCreateArenaTeamCommands(const char * args, WorldSession * m_session);
 	bool HandleNpcSelectCommand(const char * args, WorldSession * m_session);
@@ -608,6 +610,7 @@ protected:
 	bool HandleCollisionGetHeight(const char * args, WorldSession * m_session);
 	bool HandleAccountMuteCommand(const char * args, WorldSession * m_session);
 	bool HandleAccountUnmuteCommand(const char * args, WorldSession * m_session);
+	bool HandleAccountRefreshCommand(const char * args, WorldSession * m_session);
 	/* For skill related GM commands */
 	SkillNameMgr *SkillNameManager;
 
@@ -632,6 +635,8 @@ protected:
 	bool HandleModifyAuraStateCommand(const char *args, WorldSession *m_session);
 	bool HandleMirrorTimerCommand(const char *args, WorldSession *m_session);
 	bool HandleSetPlayerStartLocation(const char *args, WorldSession *m_session);
+	bool HandleDebugPoolStatsCommand(const char *args, WorldSession *m_session);
+	bool HandleDebugOpcodeStatsCommand(const char *args, WorldSession *m_session);
 
 	bool HandleEnableAH(const char *args, WorldSession *m_session);
 	bool HandleDisableAH(const char *args, WorldSession *m_session);
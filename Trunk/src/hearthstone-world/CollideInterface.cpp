@@ -4,11 +4,39 @@
 
 #include "StdAfx.h"
 
+enum CollisionTileState
+{
+	TILE_UNLOADED,
+	TILE_QUEUED,		// waiting for the loader
+	TILE_LOADING,		// being read, the loader drops it if nobody wants it anymore when done
+	TILE_LOADED,
+	TILE_EMPTY,			// nothing to link (map without vmaps), nothing to unload
+};
+
+enum CollisionTileFile
+{
+	TILE_FILE_UNKNOWN,
+	TILE_FILE_FOUND,
+	TILE_FILE_MISSING,
+};
+
+#define PREFETCH_QUEUE_LIMIT 64
+#define PREFETCH_EXPIRE_CHECK 5000
+
+// Lock order: m_mapCreateLock, then a map's m_tileLock, then its m_lock.
+// Only the loader thread holds the create lock while taking the other two,
+// and DeactivateMap, which waits on the loader, never runs on that thread.
 struct CollisionMap
 {
 	uint32 m_loadCount;
 	uint32 m_tileLoadCount[64][64];
-	RWLock m_lock;
+	uint8 m_tileState[64][64];
+	uint8 m_tileFile[64][64];			// whether the tile has vmap data, looked up once
+	uint32 m_tilePrefetchTime[64][64];	// set while only a prefetch wants the tile
+	uint32 m_prefetchedTiles;
+	AtomicCounter m_loadsInFlight;
+	Mutex m_tileLock;					// counts and states
+	RWLock m_lock;						// the tree
 };
 
 SERVER_DECL CCollideInterface CollideInterface;
@@ -16,12 +44,23 @@ VMAP::VMapManager2* CollisionMgr;
 CollisionMap *m_mapLocks[NUM_MAPS];
 Mutex m_mapCreateLock;
 
+CCollideInterface::CCollideInterface() : m_queueCond(&m_queueLock)
+{
+	m_loaderRunning = false;
+	m_loaderShutdown = false;
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
 void CCollideInterface::Init()
 {
 	Log.Notice("CollideInterface", "Init");
 	CollisionMgr = new VMAP::VMapManager2;
 	for(uint32 i = 0; i < NUM_MAPS; i++)
 		m_mapLocks[i] = NULL;
+
+	m_mapCreateLock.SetLockName("CollideInterface::m_mapCreateLock");
+	m_loaderRunning = true;
+	ThreadPool.ExecuteTask("CollisionTileLoader", new CollisionTileLoaderThread());
 }
 
 void CCollideInterface::ActivateMap(uint32 mapId)
@@ -33,8 +72,17 @@ void CCollideInterface::ActivateMap(uint32 mapId)
 	if( m_mapLocks[mapId] == NULL )
 	{
 		m_mapLocks[mapId] = new CollisionMap();
+		m_mapLocks[mapId]->m_lock.SetLockName("CollisionMap::m_lock");
+		m_mapLocks[mapId]->m_tileLock.SetLockName("CollisionMap::m_tileLock");
 		m_mapLocks[mapId]->m_loadCount = 1;
+		m_mapLocks[mapId]->m_prefetchedTiles = 0;
 		memset(&m_mapLocks[mapId]->m_tileLoadCount, 0, sizeof(uint32)*64*64);
+		memset(&m_mapLocks[mapId]->m_tileState, TILE_UNLOADED, sizeof(uint8)*64*64);
+		memset(&m_mapLocks[mapId]->m_tileFile, TILE_FILE_UNKNOWN, sizeof(uint8)*64*64);
+		memset(&m_mapLocks[mapId]->m_tilePrefetchTime, 0, sizeof(uint32)*64*64);
+
+		// The tree has to exist before the loader thread reads tiles into it
+		CollisionMgr->initMap(sWorld.vMapPath.c_str(), mapId);
 	}
 	else
 		m_mapLocks[mapId]->m_loadCount++;
@@ -52,40 +100,113 @@ void CCollideInterface::DeactivateMap(uint32 mapId)
 	--m_mapLocks[mapId]->m_loadCount;
 	if( m_mapLocks[mapId]->m_loadCount == 0 )
 	{
-		// no instances using this anymore
-		delete m_mapLocks[mapId];
-		CollisionMgr->unloadMap(mapId);
+		// no instances using this anymore, the loader can't pick it up again while we hold the lock
+		CollisionMap * map = m_mapLocks[mapId];
 		m_mapLocks[mapId] = NULL;
+		while(map->m_loadsInFlight.GetVal() != 0)
+			Sleep(1);
+
+		map->m_lock.AcquireWriteLock();
+		CollisionMgr->unloadMap(mapId);
+		map->m_lock.ReleaseWriteLock();
+		delete map;
 	}
 	m_mapCreateLock.Release();
 }
 
+void CCollideInterface::QueueTile(uint32 mapId, uint32 tileX, uint32 tileY, bool prefetch)
+{
+	CollisionTileRequest request;
+	request.mapId = mapId;
+	request.tileX = uint16(tileX);
+	request.tileY = uint16(tileY);
+	request.prefetch = prefetch;
+
+	m_queueCond.BeginSynchronized();
+	if(prefetch)
+		m_prefetchQueue.push_back(request);
+	else
+		m_demandQueue.push_back(request);
+	m_queueCond.Signal();
+	m_queueCond.EndSynchronized();
+}
+
+void CCollideInterface::AddMapStall(uint32 startUs)
+{
+	uint32 us = getUSTime() - startUs;
+	m_statsLock.Acquire();
+	m_stats.MapStallUs += us;
+	if(us > m_stats.MaxMapStallUs)
+		m_stats.MaxMapStallUs = us;
+	m_statsLock.Release();
+}
+
 bool CCollideInterface::ActivateTile(uint32 mapId, uint32 tileX, uint32 tileY)
 {
 	ASSERT(m_mapLocks[mapId] != NULL);
 	if( !CollisionMgr )
 		return false;
 
-	// acquire write lock
-	m_mapLocks[mapId]->m_lock.AcquireWriteLock();
-	if( m_mapLocks[mapId]->m_tileLoadCount[tileX][tileY] == 0 )
+	uint32 start = getUSTime();
+	CollisionMap * map = m_mapLocks[mapId];
+	if(map->m_tileFile[tileX][tileY] == TILE_FILE_UNKNOWN)
 	{
-		if(CollisionMgr->loadMap(sWorld.vMapPath.c_str(), mapId, tileX, tileY))
-			OUT_DEBUG("Loading VMap [%u/%u] successful", tileX, tileY);
-		else
+		// Only the file headers, once per tile, so the answer doesn't have to wait for the loader
+		bool found = CollisionMgr->existsMap(sWorld.vMapPath.c_str(), mapId, tileX, tileY);
+		map->m_tileFile[tileX][tileY] = found ? TILE_FILE_FOUND : TILE_FILE_MISSING;
+	}
+
+	map->m_tileLock.Acquire();
+	if( map->m_tileLoadCount[tileX][tileY]++ == 0 )
+	{
+		bool prefetched = map->m_tilePrefetchTime[tileX][tileY] != 0;
+		if(prefetched)
 		{
-			OUT_DEBUG("Loading VMap [%u/%u] unsuccessful", tileX, tileY);
-			m_mapLocks[mapId]->m_lock.ReleaseWriteLock();
-			return false;
+			// a cell has it now, it no longer expires
+			map->m_tilePrefetchTime[tileX][tileY] = 0;
+			--map->m_prefetchedTiles;
 		}
+
+		switch(map->m_tileState[tileX][tileY])
+		{
+		case TILE_UNLOADED:
+			map->m_tileState[tileX][tileY] = TILE_QUEUED;
+			QueueTile(mapId, tileX, tileY, false);
+			break;
+		case TILE_QUEUED:
+			// still behind other prefetches, move it up front
+			if(prefetched)
+				QueueTile(mapId, tileX, tileY, false);
+			break;
+		}
+
+		uint8 state = map->m_tileState[tileX][tileY];
+		m_statsLock.Acquire();
+		if(state != TILE_LOADED && state != TILE_EMPTY)
+			++m_stats.ActivatedEarly;
+		else if(prefetched)
+			++m_stats.PrefetchHits;
+		m_statsLock.Release();
 	}
 
-	// increment count
-	m_mapLocks[mapId]->m_tileLoadCount[tileX][tileY]++;
+	// Loaded or read as empty is the real result, until then it's whether there is anything to load
+	bool loaded;
+	switch(map->m_tileState[tileX][tileY])
+	{
+	case TILE_LOADED:
+		loaded = true;
+		break;
+	case TILE_EMPTY:
+		loaded = false;
+		break;
+	default:
+		loaded = map->m_tileFile[tileX][tileY] == TILE_FILE_FOUND;
+		break;
+	}
+	map->m_tileLock.Release();
 
-	// release lock
-	m_mapLocks[mapId]->m_lock.ReleaseWriteLock();
-	return true;
+	AddMapStall(start);
+	return loaded;
 }
 
 void CCollideInterface::DeactivateTile(uint32 mapId, uint32 tileX, uint32 tileY)
@@ -94,13 +215,35 @@ void CCollideInterface::DeactivateTile(uint32 mapId, uint32 tileX, uint32 tileY)
 	if( !CollisionMgr )
 		return;
 
-	// get write lock
-	m_mapLocks[mapId]->m_lock.AcquireWriteLock();
-	if( (--m_mapLocks[mapId]->m_tileLoadCount[tileX][tileY]) == 0 )
-		CollisionMgr->unloadMap(mapId, tileX, tileY);
+	uint32 start = getUSTime();
+	CollisionMap * map = m_mapLocks[mapId];
+	map->m_tileLock.Acquire();
+	if( (--map->m_tileLoadCount[tileX][tileY]) == 0 )
+	{
+		switch(map->m_tileState[tileX][tileY])
+		{
+		case TILE_QUEUED:
+		case TILE_EMPTY:
+			// the loader skips requests for tiles that aren't queued anymore
+			map->m_tileState[tileX][tileY] = TILE_UNLOADED;
+			break;
+		case TILE_LOADED:
+			// spawns are kept in memory, so this doesn't touch the disk
+			map->m_lock.AcquireWriteLock();
+			CollisionMgr->unloadMap(mapId, tileX, tileY);
+			map->m_lock.ReleaseWriteLock();
+			map->m_tileState[tileX][tileY] = TILE_UNLOADED;
+
+			m_statsLock.Acquire();
+			++m_stats.TilesUnloaded;
+			m_statsLock.Release();
+			break;
+		}
+		// TILE_LOADING: the loader sees the count and drops it
+	}
+	map->m_tileLock.Release();
 
-	// release write lock
-	m_mapLocks[mapId]->m_lock.ReleaseWriteLock();
+	AddMapStall(start);
 }
 
 bool CCollideInterface::IsActiveTile(uint32 mapId, uint32 tileX, uint32 tileY)
@@ -109,15 +252,220 @@ bool CCollideInterface::IsActiveTile(uint32 mapId, uint32 tileX, uint32 tileY)
 	if( !CollisionMgr )
 		return false;
 
-	bool isactive = false;
+	// a stale answer only means one lookup more or less without collision
+	return m_mapLocks[mapId]->m_tileLoadCount[tileX][tileY] != 0 && m_mapLocks[mapId]->m_tileState[tileX][tileY] == TILE_LOADED;
+}
+
+void CCollideInterface::PrefetchTile(uint32 mapId, uint32 tileX, uint32 tileY)
+{
+	if( !CollisionMgr || tileX >= 64 || tileY >= 64 )
+		return;
+
+	CollisionMap * map = m_mapLocks[mapId];
+	if( map == NULL )
+		return;
+
+	map->m_tileLock.Acquire();
+	if( map->m_tileLoadCount[tileX][tileY] == 0 && map->m_tileState[tileX][tileY] == TILE_UNLOADED )
+	{
+		m_queueCond.BeginSynchronized();
+		bool full = m_prefetchQueue.size() >= PREFETCH_QUEUE_LIMIT;
+		m_queueCond.EndSynchronized();
+
+		if(!full)
+		{
+			map->m_tileState[tileX][tileY] = TILE_QUEUED;
+			map->m_tilePrefetchTime[tileX][tileY] = getMSTime() | 1;
+			++map->m_prefetchedTiles;
+			QueueTile(mapId, tileX, tileY, true);
+		}
+	}
+	map->m_tileLock.Release();
+}
+
+void CCollideInterface::PrefetchPosition(uint32 mapId, float x, float y)
+{
+	if( x <= _minX || x >= _maxX || y <= _minY || y >= _maxY )
+		return;
+
+	PrefetchTile(mapId, uint32((_maxX - x) / TileSize), uint32((_maxY - y) / TileSize));
+}
+
+bool CCollideInterface::GetNextRequest(CollisionTileRequest & request)
+{
+	m_queueCond.BeginSynchronized();
+	while(!m_loaderShutdown && m_demandQueue.empty() && m_prefetchQueue.empty())
+		m_queueCond.Wait();
+
+	if(m_loaderShutdown)
+	{
+		m_queueCond.EndSynchronized();
+		return false;
+	}
+
+	// cells that are active already go first
+	std::deque<CollisionTileRequest> & queue = m_demandQueue.size() ? m_demandQueue : m_prefetchQueue;
+	request = queue.front();
+	queue.pop_front();
+	m_queueCond.EndSynchronized();
+	return true;
+}
+
+void CCollideInterface::LoadTile(const CollisionTileRequest & request)
+{
+	uint32 mapId = request.mapId, tileX = request.tileX, tileY = request.tileY;
+
+	// Counted in flight under the create lock, DeactivateMap waits for it before freeing the map
+	m_mapCreateLock.Acquire();
+	CollisionMap * map = m_mapLocks[mapId];
+	if(map != NULL)
+		++map->m_loadsInFlight;
+	m_mapCreateLock.Release();
+	if(map == NULL)
+		return;
+
+	map->m_tileLock.Acquire();
+	if(map->m_tileState[tileX][tileY] != TILE_QUEUED)
+	{
+		// deactivated meanwhile, or a demand request for a prefetch that already went through
+		map->m_tileLock.Release();
+		--map->m_loadsInFlight;
+		return;
+	}
+	map->m_tileState[tileX][tileY] = TILE_LOADING;
+	map->m_tileLock.Release();
+
+	uint32 start = getUSTime();
+	VMAP::PreparedTile tile;
+	bool prepared = CollisionMgr->prepareMapTile(mapId, tileX, tileY, tile);
+
+	bool discarded = false;
+	map->m_tileLock.Acquire();
+	map->m_tileFile[tileX][tileY] = prepared ? TILE_FILE_FOUND : TILE_FILE_MISSING;
+	if(map->m_tileLoadCount[tileX][tileY] == 0 && map->m_tilePrefetchTime[tileX][tileY] == 0)
+	{
+		map->m_tileState[tileX][tileY] = TILE_UNLOADED;
+		discarded = true;
+	}
+	else if(!prepared)
+		map->m_tileState[tileX][tileY] = TILE_EMPTY;
+	else
+	{
+		map->m_lock.AcquireWriteLock();
+		CollisionMgr->applyMapTile(mapId, tile);
+		map->m_lock.ReleaseWriteLock();
+		map->m_tileState[tileX][tileY] = TILE_LOADED;
+		OUT_DEBUG("Loading VMap [%u/%u] successful", tileX, tileY);
+	}
+	map->m_tileLock.Release();
+
+	if(discarded)
+		CollisionMgr->releasePreparedTile(tile);
+	--map->m_loadsInFlight;
+
+	uint32 us = getUSTime() - start;
+	m_statsLock.Acquire();
+	m_stats.LoaderUs += us;
+	if(us > m_stats.MaxLoaderUs)
+		m_stats.MaxLoaderUs = us;
+	if(discarded)
+		++m_stats.TilesDiscarded;
+	else
+	{
+		++m_stats.TilesLoaded;
+		if(request.prefetch)
+			++m_stats.Prefetched;
+	}
+	m_statsLock.Release();
+}
+
+void CCollideInterface::ExpirePrefetchedTiles()
+{
+	uint32 now = getMSTime();
+	uint32 expired = 0;
+
+	// Holding the create lock keeps the maps alive, DeactivateMap only waits on loads in flight.
+	// Each map's m_tileLock and then its m_lock are taken under it, see the lock order above.
+	m_mapCreateLock.Acquire();
+	for(uint32 mapId = 0; mapId < NUM_MAPS; ++mapId)
+	{
+		CollisionMap * map = m_mapLocks[mapId];
+		if(map == NULL || map->m_prefetchedTiles == 0)
+			continue;
 
-	// acquire write lock
-	m_mapLocks[mapId]->m_lock.AcquireWriteLock();
-	if(m_mapLocks[mapId]->m_tileLoadCount[tileX][tileY])
-		isactive = true;
-	m_mapLocks[mapId]->m_lock.ReleaseWriteLock(); // release lock
+		map->m_tileLock.Acquire();
+		for(uint32 x = 0; x < 64 && map->m_prefetchedTiles; ++x)
+		{
+			for(uint32 y = 0; y < 64; ++y)
+			{
+				uint32 prefetchTime = map->m_tilePrefetchTime[x][y];
+				if(prefetchTime == 0 || now - prefetchTime < sWorld.m_collisionPrefetchExpire)
+					continue;
+
+				// queued or loading tiles are dropped by the loader once this is cleared
+				map->m_tilePrefetchTime[x][y] = 0;
+				--map->m_prefetchedTiles;
+				++expired;
+				if(map->m_tileState[x][y] == TILE_LOADED)
+				{
+					map->m_lock.AcquireWriteLock();
+					CollisionMgr->unloadMap(mapId, x, y);
+					map->m_lock.ReleaseWriteLock();
+					map->m_tileState[x][y] = TILE_UNLOADED;
+				}
+				else if(map->m_tileState[x][y] == TILE_EMPTY)
+					map->m_tileState[x][y] = TILE_UNLOADED;
+			}
+		}
+		map->m_tileLock.Release();
+	}
+	m_mapCreateLock.Release();
+
+	if(expired)
+	{
+		m_statsLock.Acquire();
+		m_stats.PrefetchExpired += expired;
+		m_statsLock.Release();
+	}
+}
+
+void CCollideInterface::GetStats(CollisionStats & stats, uint32 & queued)
+{
+	m_statsLock.Acquire();
+	stats = m_stats;
+	m_statsLock.Release();
 
-	return isactive;
+	m_queueCond.BeginSynchronized();
+	queued = uint32(m_demandQueue.size() + m_prefetchQueue.size());
+	m_queueCond.EndSynchronized();
+}
+
+void CCollideInterface::ResetStats()
+{
+	m_statsLock.Acquire();
+	memset(&m_stats, 0, sizeof(m_stats));
+	m_statsLock.Release();
+}
+
+bool CollisionTileLoaderThread::run()
+{
+	SetThreadName("CollisionTileLoader");
+	uint32 lastExpireCheck = getMSTime();
+	CollisionTileRequest request;
+	while(CollideInterface.GetNextRequest(request))
+	{
+		CollideInterface.LoadTile(request);
+
+		// prefetches only pile up while players move, so checking between requests is enough
+		if(getMSTime() - lastExpireCheck >= PREFETCH_EXPIRE_CHECK)
+		{
+			CollideInterface.ExpirePrefetchedTiles();
+			lastExpireCheck = getMSTime();
+		}
+	}
+
+	CollideInterface.OnLoaderExit();
+	return true;
 }
 
 bool CCollideInterface::CheckLOS(uint32 mapId, float x1, float y1, float z1, float x2, float y2, float z2)
@@ -272,5 +620,11 @@ uint32 CCollideInterface::GetVmapAreaFlags(uint32 mapId, float x, float y, float
 
 void CCollideInterface::DeInit()
 {
-	// bleh.
+	m_queueCond.BeginSynchronized();
+	m_loaderShutdown = true;
+	m_queueCond.Broadcast();
+	m_queueCond.EndSynchronized();
+
+	while(m_loaderRunning)
+		Sleep(10);
 }
@@ -10,24 +10,84 @@
 
 extern VMAP::VMapManager2* CollisionMgr;
 
+struct CollisionTileRequest
+{
+	uint32 mapId;
+	uint16 tileX, tileY;
+	bool prefetch;
+};
+
+struct CollisionStats
+{
+	uint64 MapStallUs;			// map threads inside Activate/DeactivateTile
+	uint64 MaxMapStallUs;
+	uint64 LoaderUs;			// reading and linking tiles, what the maps used to wait for
+	uint64 MaxLoaderUs;
+	uint32 TilesLoaded;
+	uint32 TilesUnloaded;
+	uint32 TilesDiscarded;		// nobody wanted them anymore by the time they were read
+	uint32 Prefetched;
+	uint32 PrefetchHits;		// cell activated on a tile the prefetcher had already read
+	uint32 PrefetchExpired;
+	uint32 ActivatedEarly;		// cell activated before its tile was in
+};
+
 class SERVER_DECL CCollideInterface
 {
 public:
+	CCollideInterface();
+
 	void Init();
 	void DeInit();
 
+	// Tiles load on the collision loader thread, a cell can be active before its tile is;
+	// until then IsActiveTile is false and lookups behave as if there were no vmap there.
+	// Returns false if the tile has no vmap data, the loader reading it or not.
 	bool ActivateTile(uint32 mapId, uint32 tileX, uint32 tileY);
 	void DeactivateTile(uint32 mapId, uint32 tileX, uint32 tileY);
 	bool IsActiveTile(uint32 mapId, uint32 tileX, uint32 tileY);
 	void ActivateMap(uint32 mapId);
 	void DeactivateMap(uint32 mapId);
 
+	// Reads a tile nobody uses yet at low priority, dropped again if no cell needs it in time
+	void PrefetchTile(uint32 mapId, uint32 tileX, uint32 tileY);
+	void PrefetchPosition(uint32 mapId, float x, float y);
+
 	bool CheckLOS(uint32 mapId, float x1, float y1, float z1, float x2, float y2, float z2);
 	bool GetFirstPoint(uint32 mapId, float x1, float y1, float z1, float x2, float y2, float z2, float & outx, float & outy, float & outz, float distmod);
 	bool IsIndoor(uint32 mapId, float x, float y, float z);
 	bool IsIncity(uint32 mapid, float x, float y, float z);
 	uint32 GetVmapAreaFlags(uint32 mapId, float x, float y, float z);
 	float GetHeight(uint32 mapId, float x, float y, float z);
+
+	void GetStats(CollisionStats & stats, uint32 & queued);
+	void ResetStats();
+
+	// loader thread
+	bool GetNextRequest(CollisionTileRequest & request);
+	void LoadTile(const CollisionTileRequest & request);
+	void ExpirePrefetchedTiles();
+	void OnLoaderExit() { m_loaderRunning = false; }
+
+private:
+	void QueueTile(uint32 mapId, uint32 tileX, uint32 tileY, bool prefetch);
+	void AddMapStall(uint32 startUs);
+
+	Mutex m_queueLock;
+	Condition m_queueCond;
+	std::deque<CollisionTileRequest> m_demandQueue;
+	std::deque<CollisionTileRequest> m_prefetchQueue;
+	volatile bool m_loaderRunning;
+	bool m_loaderShutdown;
+
+	Mutex m_statsLock;
+	CollisionStats m_stats;
+};
+
+class CollisionTileLoaderThread : public ThreadContext
+{
+public:
+	bool run();
 };
 
 extern SERVER_DECL CCollideInterface CollideInterface;
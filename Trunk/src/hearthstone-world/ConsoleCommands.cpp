@@ -255,6 +255,144 @@ bool HandlePlayerInfoCommand(BaseConsole * pConsole, int argc, const char * argv
 	return true;
 }
 
+bool HandleCharCacheCommand(BaseConsole * pConsole, int argc, const char * argv[])
+{
+	objmgr.PrintPlayerInfoStats(pConsole);
+	return true;
+}
+
+bool HandleBGQueuesCommand(BaseConsole * pConsole, int argc, const char * argv[])
+{
+	BattlegroundManager.PrintQueueStats(pConsole);
+	return true;
+}
+
+bool HandlePacketPoolCommand(BaseConsole * pConsole, int argc, const char * argv[])
+{
+	WorldPacketPoolStats stats;
+	WorldPacketPool::GetStats(stats);
+	pConsole->Write("Packet pool: " I64FMTD " packets allocated, %.1f%% from the pool, over %u threads.\r\n", stats.Allocations,
+		stats.Allocations ? double(stats.PoolHits) * 100.0 / double(stats.Allocations) : 0.0, stats.Threads);
+	pConsole->Write("  " I64FMTD " freed on their own thread, " I64FMTD " returned from others, " I64FMTD " cached.\r\n",
+		stats.LocalFrees, stats.RemoteFrees, stats.Cached);
+	return true;
+}
+
+bool HandleMetricsCommand(BaseConsole * pConsole, int argc, const char * argv[])
+{
+	if(argc > 1 && stricmp(argv[1], "write"))
+		return false;
+
+	if(ServerMetrics::WriteFile(sWorld.m_metricsFile.c_str()))
+		pConsole->Write("Metrics written to %s.\r\n", sWorld.m_metricsFile.c_str());
+	else
+		pConsole->Write("Could not write metrics to %s.\r\n", sWorld.m_metricsFile.c_str());
+	return true;
+}
+
+bool HandleMapTicksCommand(BaseConsole * pConsole, int argc, const char * argv[])
+{
+	bool reset = (argc > 1 && !stricmp(argv[1], "reset"));
+	if(!reset)
+	{
+		pConsole->Write("Creature update tiers are %s.\r\n", sWorld.m_creatureUpdateTiered ? "on" : "off");
+		pConsole->Write("%6s | %7s | %8s | %8s | %8s | %12s | %7s\r\n", "Map", "Players", "Ticks", "Avg ms", "Max ms", "Creature upd", "Skipped");
+	}
+
+	// Map threads keep counting while we read, close enough for a report
+	MapMgr* mgr;
+	for(uint32 i = 0; i < NUM_MAPS; ++i)
+	{
+		mgr = sInstanceMgr.GetMapMgr(i);
+		if(mgr == NULL)
+			continue;
+
+		if(reset)
+		{
+			mgr->ResetTickStats();
+			continue;
+		}
+
+		if(mgr->m_tickCount == 0)
+			continue;
+
+		uint64 total = mgr->m_creatureUpdates + mgr->m_creatureDeferrals;
+		pConsole->Write("%6u | %7u | %8u | %8.2f | %8u | %12u | %6.1f%%\r\n", i, uint32(mgr->GetPlayerCount()), mgr->m_tickCount,
+			float(mgr->m_tickTotalTime) / float(mgr->m_tickCount), mgr->m_tickMaxTime, uint32(mgr->m_creatureUpdates),
+			total ? float(mgr->m_creatureDeferrals) * 100.0f / float(total) : 0.0f);
+	}
+
+	if(reset)
+		pConsole->Write("Map tick statistics reset.\r\n");
+	return true;
+}
+
+bool HandleLockStatsCommand(BaseConsole * pConsole, int argc, const char * argv[])
+{
+	if(!LockStats::IsEnabled())
+	{
+		pConsole->Write("Lock statistics are not compiled in, rebuild with LOCK_STATS turned on.\r\n");
+		return true;
+	}
+
+	if(argc > 1 && !stricmp(argv[1], "reset"))
+	{
+		LockStats::Reset();
+		pConsole->Write("Lock statistics reset.\r\n");
+		return true;
+	}
+
+	uint32 count = 20;
+	if(argc > 1)
+		count = std::max(atoi(argv[1]), 1);
+
+	std::vector<LockStatsData> stats;
+	LockStats::GetStats(stats);
+	pConsole->Write("Named locks over the last %u seconds, most time spent waiting first:\r\n", LockStats::GetSecondsSinceReset());
+	pConsole->Write("%-44s %10s %7s %10s %8s %8s %8s %8s %8s %8s\r\n", "Lock", "Acquires", "Cont%", "Wait ms", "Wait p99", "Max wait",
+		"Hold avg", "Hold p99", "Max hold", "Recurse");
+	for(uint32 i = 0; i < stats.size() && i < count; ++i)
+	{
+		const LockStatsData & s = stats[i];
+		pConsole->Write("%-44s %10u %6.2f%% %10.1f %8u %8u %8u %8u %8u %8u\r\n", s.Name.c_str(), uint32(s.Acquires),
+			s.Acquires ? double(s.Contended) * 100.0 / double(s.Acquires) : 0.0, double(s.WaitUs) / 1000.0,
+			LockStatsData::GetPercentile(s.WaitBuckets, s.Acquires, s.MaxWaitUs, 99), uint32(s.MaxWaitUs),
+			s.Acquires ? uint32(s.HoldUs / s.Acquires) : 0, LockStatsData::GetPercentile(s.HoldBuckets, s.Acquires, s.MaxHoldUs, 99),
+			uint32(s.MaxHoldUs), uint32(s.Recursions));
+		if(s.FailedTries)
+			pConsole->Write("  " I64FMTD " failed tries\r\n", s.FailedTries);
+	}
+	return true;
+}
+
+bool HandleCollisionStatsCommand(BaseConsole * pConsole, int argc, const char * argv[])
+{
+	if(!sWorld.Collision)
+	{
+		pConsole->Write("Collision is turned off.\r\n");
+		return true;
+	}
+
+	if(argc > 1 && !stricmp(argv[1], "reset"))
+	{
+		CollideInterface.ResetStats();
+		pConsole->Write("Collision statistics reset.\r\n");
+		return true;
+	}
+
+	CollisionStats stats;
+	uint32 queued;
+	CollideInterface.GetStats(stats, queued);
+	pConsole->Write("Map threads waited %.1f ms on tile (de)activation, longest %u us.\r\n", double(stats.MapStallUs) / 1000.0, uint32(stats.MaxMapStallUs));
+	pConsole->Write("Loader spent %.1f ms reading %u tiles (avg %u us, longest %u us), %u requests queued.\r\n", double(stats.LoaderUs) / 1000.0,
+		stats.TilesLoaded + stats.TilesDiscarded, (stats.TilesLoaded + stats.TilesDiscarded) ? uint32(stats.LoaderUs / (stats.TilesLoaded + stats.TilesDiscarded)) : 0,
+		uint32(stats.MaxLoaderUs), queued);
+	pConsole->Write("Tiles: %u loaded, %u unloaded, %u read for nothing.\r\n", stats.TilesLoaded, stats.TilesUnloaded, stats.TilesDiscarded);
+	pConsole->Write("Cells activated: %u on a tile already in, %u before their tile was in.\r\n", stats.PrefetchHits, stats.ActivatedEarly);
+	pConsole->Write("Prefetches: %u read, %u expired unused.\r\n", stats.Prefetched, stats.PrefetchExpired);
+	return true;
+}
+
 void TestConsoleLogin(string& username, string& password, uint32 requestno)
 {
 	sLogonCommHandler.TestConsoleLogon(username, password, requestno);
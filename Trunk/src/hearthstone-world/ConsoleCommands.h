@@ -21,6 +21,13 @@ bool HandleUnbanAccountCommand(BaseConsole * pConsole, int argc, const char * ar
 bool HandleMOTDCommand(BaseConsole * pConsole, int argc, const char * argv[]);
 bool HandleOnlinePlayersCommand(BaseConsole * pConsole, int argc, const char * argv[]);
 bool HandlePlayerInfoCommand(BaseConsole * pConsole, int argc, const char * argv[]);
+bool HandleCharCacheCommand(BaseConsole * pConsole, int argc, const char * argv[]);
+bool HandleBGQueuesCommand(BaseConsole * pConsole, int argc, const char * argv[]);
+bool HandlePacketPoolCommand(BaseConsole * pConsole, int argc, const char * argv[]);
+bool HandleMapTicksCommand(BaseConsole * pConsole, int argc, const char * argv[]);
+bool HandleMetricsCommand(BaseConsole * pConsole, int argc, const char * argv[]);
+bool HandleLockStatsCommand(BaseConsole * pConsole, int argc, const char * argv[]);
+bool HandleCollisionStatsCommand(BaseConsole * pConsole, int argc, const char * argv[]);
 bool HandleCreateAccountCommand(BaseConsole * pConsole, int argc, const char * argv[]);
 bool HandleRehashCommand(BaseConsole * pConsole, int argc, const char * argv[]);
 bool HandleBackupDBCommand(BaseConsole * pConsole, int argc, const char * argv[]);
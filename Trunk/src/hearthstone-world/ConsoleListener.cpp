@@ -323,11 +323,18 @@ void HandleConsoleInput(BaseConsole * pConsole, const char * szInput)
 		{ &HandleBanAccountCommand, "ban", "<account> <timeperiod>", "Bans account x for time y." },
 		{ &HandleBanAccountCommand, "banaccount", "<account> <timeperiod>", "Bans account x for time y." },
 		{ &HandleBackupDBCommand, "backupdb", "none", "Backups Character Database" },
+		{ &HandleBGQueuesCommand, "bgqueues", "none", "Shows battleground queue sizes and queue lock hold times." },
 		{ &HandleCancelCommand, "cancel", "none", "Cancels a pending shutdown." },
+		{ &HandleCharCacheCommand, "charcache", "none", "Shows character name index and cache sizes." },
 		{ &HandleCreateAccountCommand, "createaccount", "<name> <pass> <email> <flags>", "Creates an account." },
 		{ &HandleInfoCommand, "info", "none", "Gives server runtime information." },
 		{ &HandleGMsCommand, "gms", "none", "Shows online GMs." },
 		{ &HandleKickCommand, "kick", "<plrname> <reason>", "Kicks player x for reason y." },
+		{ &HandleLockStatsCommand, "lockstats", "[count|reset]", "Ranks named locks by time spent waiting on them (LOCK_STATS builds)." },
+		{ &HandleCollisionStatsCommand, "collisionstats", "[reset]", "Shows how long maps waited on collision tiles and how prefetching did." },
+		{ &HandlePacketPoolCommand, "packetpool", "", "Shows how often packets came out of the packet pool." },
+		{ &HandleMetricsCommand, "metrics", "[write]", "Rewrites the Prometheus metrics file now." },
+		{ &HandleMapTicksCommand, "mapticks", "[reset]", "Shows tick times of the continents and how many creature updates the update tiers skipped." },
 		{ &HandleMOTDCommand, "getmotd", "none", "View the current MOTD" },
 		{ &HandleMOTDCommand, "setmotd", "<new motd>", "Sets a new MOTD" },
 		{ &HandleNameHashCommand, "getnamehash" , "<spell_id>" , "Returns the crc32 hash of <spell_id>" } ,
@@ -39,6 +39,8 @@ Creature::Creature(uint64 guid)
 	auctionHouse = NULL;
 	m_escorter = NULLPLR;
 	m_respawnCell = NULL;
+	m_updateDeferUntil = 0;
+	m_deferredUpdateTime = 0;
 	myFamily = NULL;
 
 	mTaxiNode = 0;
@@ -369,6 +371,7 @@ void Creature::DeleteFromDB()
 void Creature::AddQuest(QuestRelation *Q)
 {
 	m_quests->push_back(Q);
+	sQuestMgr.OnQuestRelationsChanged();
 }
 
 void Creature::DeleteQuest(QuestRelation *Q)
@@ -384,6 +387,7 @@ void Creature::DeleteQuest(QuestRelation *Q)
 	}
 
 	m_quests->clear();
+	sQuestMgr.OnQuestRelationsChanged();
 }
 
 Quest* Creature::FindQuest(uint32 quest_id, uint8 quest_relation)
@@ -562,6 +566,10 @@ bool Creature::RemoveEnslave()
 
 void Creature::AddInRangeObject(Object* pObj)
 {
+	// someone to react to, back to updating every tick
+	if(pObj->IsPlayer())
+		WakeForUpdate();
+
 	Unit::AddInRangeObject(pObj);
 }
 
@@ -767,21 +775,127 @@ WayPoint * Creature::CreateWaypointStruct()
 	return new WayPoint();
 }
 
+static void AddTemplateField(CreatureSpawnTemplate & t, uint32 index, uint32 value)
+{
+	t.Fields.push_back(std::make_pair(index, value));
+}
+
+static void AddTemplateField(CreatureSpawnTemplate & t, uint32 index, float value)
+{
+	uint32 bits;
+	memcpy(&bits, &value, sizeof(uint32));
+	t.Fields.push_back(std::make_pair(index, bits));
+}
+
+bool Creature::BuildSpawnTemplate(uint32 entry, uint32 mode, CreatureSpawnTemplate & t)
+{
+	t.Generation = 0;
+	t.Proto = CreatureProtoStorage.LookupEntry(entry);
+	t.Info = CreatureNameStorage.LookupEntry(entry);
+	if(t.Proto == NULL || t.Info == NULL)
+		return false;
+
+	CreatureProto* cp = t.Proto;
+	t.Extra = CreatureInfoExtraStorage.LookupEntry(cp->Id);
+	t.Family = dbcCreatureFamily.LookupEntry(t.Info->Family);
+	t.ModeProto = NULL;
+	if(mode)
+	{
+		HM_NAMESPACE::hash_map<uint8, CreatureProtoMode*>::iterator itr = cp->ModeProto.find(mode);
+		if(itr != cp->ModeProto.end())
+			t.ModeProto = itr->second;
+	}
+
+	t.Fields.clear();
+	AddTemplateField(t, OBJECT_FIELD_ENTRY, cp->Id);
+	for(uint32 i = 0; i < 7; i++)
+		AddTemplateField(t, UNIT_FIELD_RESISTANCES + i, t.ModeProto != NULL ? t.ModeProto->Resistances[i] : cp->Resistances[i]);
+	AddTemplateField(t, UNIT_FIELD_BASEATTACKTIME, cp->AttackTime);
+	AddTemplateField(t, UNIT_FIELD_RANGEDATTACKTIME, cp->RangedAttackTime);
+	AddTemplateField(t, UNIT_FIELD_MINRANGEDDAMAGE, cp->RangedMinDamage);
+	AddTemplateField(t, UNIT_FIELD_MAXRANGEDDAMAGE, cp->RangedMaxDamage);
+	AddTemplateField(t, UNIT_VIRTUAL_ITEM_SLOT_ID, cp->Item1);
+	AddTemplateField(t, UNIT_VIRTUAL_ITEM_SLOT_ID+1, cp->Item2);
+	AddTemplateField(t, UNIT_VIRTUAL_ITEM_SLOT_ID+2, cp->Item3);
+	AddTemplateField(t, UNIT_FIELD_BOUNDINGRADIUS, cp->BoundingRadius);
+	AddTemplateField(t, UNIT_FIELD_COMBATREACH, cp->CombatReach);
+	AddTemplateField(t, UNIT_NPC_FLAGS, cp->NPCFLags);
+	AddTemplateField(t, UNIT_MOD_CAST_SPEED, 1.0f);   // better set this one
+
+	t.Spells.clear();
+	for(list<AI_Spell*>::iterator itr = cp->spells.begin(); itr != cp->spells.end(); itr++)
+		if((*itr)->difficulty_mask == -1 || (*itr)->difficulty_mask & (1 << mode))
+			t.Spells.push_back(*itr);
+
+	t.CombatText = objmgr.HasMonsterSay(cp->Id, MONSTER_SAY_EVENT_ENTER_COMBAT);
+	t.WaypointText = objmgr.HasMonsterSay(cp->Id, MONSTER_SAY_EVENT_RANDOM_WAYPOINT);
+	t.Guard = isGuard(cp->Id);
+
+	t.Shield = NULL;
+	t.HasShield = t.ParryItem = false;
+	if(cp->Item1)
+	{
+		ItemEntry* DBCItem = dbcItem.LookupEntry(cp->Item1);
+		if(DBCItem)
+		{
+			if(DBCItem->InventoryType == INVTYPE_SHIELD)
+			{
+				t.HasShield = true;
+				t.Shield = ItemPrototypeStorage.LookupEntry(cp->Item1);
+			}
+			else
+				t.ParryItem = true; // Who cares what else it is
+		}
+	}
+
+	if(cp->Item2)
+	{
+		ItemEntry* DBCItem = dbcItem.LookupEntry(cp->Item2);
+		if(DBCItem)
+		{
+			if(!t.HasShield && DBCItem->InventoryType == INVTYPE_SHIELD)
+			{
+				t.HasShield = true;
+				t.Shield = ItemPrototypeStorage.LookupEntry(cp->Item2);
+			}
+			else if(DBCItem->InventoryType == INVTYPE_WEAPONOFFHAND || DBCItem->InventoryType == INVTYPE_WEAPON)
+				t.ParryItem = true; // We can hold non weapons here, so we need to be careful and do checks.
+		}
+	}
+	return true;
+}
+
 bool Creature::Load(CreatureSpawn *spawn, uint32 mode, MapInfo *info)
 {
 	if(m_loadedFromDB)
 		return true;
 
-	m_spawn = spawn;
-	proto = CreatureProtoStorage.LookupEntry(spawn->entry);
-	if(!proto)
+	Map* pMap = info != NULL ? sInstanceMgr.GetMap(info->mapid) : NULL;
+	if(pMap != NULL && sWorld.m_spawnTemplates)
+		return Load(spawn, mode, pMap->GetCreatureTemplate(spawn->entry, mode));
+
+	CreatureSpawnTemplate t;
+	if(!BuildSpawnTemplate(spawn->entry, mode, t))
 		return false;
+	return Load(spawn, mode, &t);
+}
 
-	creature_info = CreatureNameStorage.LookupEntry(spawn->entry);
-	ExtraInfo = CreatureInfoExtraStorage.LookupEntry(proto->Id);
-	if(!creature_info)
+bool Creature::Load(CreatureSpawn *spawn, uint32 mode, CreatureSpawnTemplate *t)
+{
+	if(m_loadedFromDB)
+		return true;
+	if(t == NULL)
 		return false;
 
+	m_spawn = spawn;
+	proto = t->Proto;
+	creature_info = t->Info;
+	ExtraInfo = t->Extra;
+
+	// Not in world yet, nothing to mark for updates
+	for(std::vector<std::pair<uint32, uint32> >::iterator itr = t->Fields.begin(); itr != t->Fields.end(); ++itr)
+		m_uint32Values[itr->first] = itr->second;
+
 	uint32 health = 0;
 	uint32 power = 0;
 	float mindmg = 0.0f;
@@ -800,13 +914,10 @@ bool Creature::Load(CreatureSpawn *spawn, uint32 mode, MapInfo *info)
 	original_emotestate = spawn->emote_state;
 	original_MountedDisplayID = spawn->MountedDisplay ? spawn->MountedDisplay->MountedDisplayID : 0;
 
-	//Set fields
-	SetUInt32Value(OBJECT_FIELD_ENTRY,proto->Id);
-
 	// Heroic stats
 	if(mode)
 	{
-		LoadedProto = proto->ModeProto[mode];
+		LoadedProto = t->ModeProto;
 		if(LoadedProto != NULL)
 		{
 			decidingfactor[0] = LoadedProto->Maxlevel - LoadedProto->Minlevel;
@@ -835,14 +946,9 @@ bool Creature::Load(CreatureSpawn *spawn, uint32 mode, MapInfo *info)
 				level = LoadedProto->Minlevel + decidingfactor[1];
 			}
 			power = LoadedProto->Power;
-			for(uint32 i = 0; i < 7; i++)
-				SetUInt32Value(UNIT_FIELD_RESISTANCES + i, LoadedProto->Resistances[i]);
 		}
 		else
 		{
-			for(uint32 i = 0; i < 7; i++)
-				SetUInt32Value(UNIT_FIELD_RESISTANCES+i,proto->Resistances[i]);
-
 			float calcu = ((mode*2)/10);
 
 			switch(mode) // TODO: find calculations
@@ -907,8 +1013,6 @@ bool Creature::Load(CreatureSpawn *spawn, uint32 mode, MapInfo *info)
 				power = proto->MinPower + powerdiff*decidingfactor[1] + RandomUInt(powerdiff);
 			}
 		}
-		for(uint32 i = 0; i < 7; i++)
-			SetUInt32Value(UNIT_FIELD_RESISTANCES+i,proto->Resistances[i]);
 	}
 
 	for(uint32 i = 1; i < 7; i++)
@@ -943,21 +1047,11 @@ bool Creature::Load(CreatureSpawn *spawn, uint32 mode, MapInfo *info)
 	SetUInt32Value(UNIT_NPC_EMOTESTATE, original_emotestate);
 	SetUInt32Value(UNIT_FIELD_MOUNTDISPLAYID,original_MountedDisplayID);
 	SetUInt32Value(UNIT_FIELD_LEVEL, level);
-	SetUInt32Value(UNIT_FIELD_BASEATTACKTIME,proto->AttackTime);
 	SetFloatValue(UNIT_FIELD_MINDAMAGE, mindmg);
 	SetFloatValue(UNIT_FIELD_MAXDAMAGE, maxdmg);
-	SetUInt32Value(UNIT_FIELD_RANGEDATTACKTIME,proto->RangedAttackTime);
-	SetFloatValue(UNIT_FIELD_MINRANGEDDAMAGE,proto->RangedMinDamage);
-	SetFloatValue(UNIT_FIELD_MAXRANGEDDAMAGE,proto->RangedMaxDamage);
-
-	SetUInt32Value(UNIT_VIRTUAL_ITEM_SLOT_ID, proto->Item1);
-	SetUInt32Value(UNIT_VIRTUAL_ITEM_SLOT_ID+1, proto->Item2);
-	SetUInt32Value(UNIT_VIRTUAL_ITEM_SLOT_ID+2, proto->Item3);
 
 	SetUInt32Value(UNIT_FIELD_FACTIONTEMPLATE, spawn->factionid);
 	SetUInt32Value(UNIT_FIELD_FLAGS, spawn->flags);
-	SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, proto->BoundingRadius);
-	SetFloatValue(UNIT_FIELD_COMBATREACH, proto->CombatReach);
 
 	// set position
 	SetPosition( spawn->x, spawn->y, spawn->z, spawn->o, true);
@@ -979,8 +1073,6 @@ bool Creature::Load(CreatureSpawn *spawn, uint32 mode, MapInfo *info)
 
 
 //SETUP NPC FLAGS
-	SetUInt32Value(UNIT_NPC_FLAGS,proto->NPCFLags);
-
 	if ( HasFlag( UNIT_NPC_FLAGS, UNIT_NPC_FLAG_VENDOR ) )
 		m_SellItems = objmgr.GetVendorList(GetEntry());
 
@@ -1010,14 +1102,11 @@ bool Creature::Load(CreatureSpawn *spawn, uint32 mode, MapInfo *info)
 	BaseRangedDamage[1]=GetFloatValue(UNIT_FIELD_MAXRANGEDDAMAGE);
 	BaseAttackType=proto->AttackType;
 
-	SetFloatValue(UNIT_MOD_CAST_SPEED, 1.0f);   // better set this one
-
 ////////////AI
 
 	// kek
-	for(list<AI_Spell*>::iterator itr = proto->spells.begin(); itr != proto->spells.end(); itr++)
-		if((*itr)->difficulty_mask == -1 || (*itr)->difficulty_mask & (1 << mode))
-			m_aiInterface->addSpellToList(*itr);
+	for(std::vector<AI_Spell*>::iterator itr = t->Spells.begin(); itr != t->Spells.end(); itr++)
+		m_aiInterface->addSpellToList(*itr);
 
 	if(ExtraInfo != NULL)
 	{
@@ -1053,7 +1142,7 @@ bool Creature::Load(CreatureSpawn *spawn, uint32 mode, MapInfo *info)
 	m_aiInterface->SetFormationFollowAngle( (form == NULL ? 0.0f : form->ang) );
 
 //////////////AI
-	myFamily = dbcCreatureFamily.LookupEntry(creature_info->Family);
+	myFamily = t->Family;
 
 
 // PLACE FOR DIRTY FIX BASTARDS
@@ -1128,9 +1217,9 @@ bool Creature::Load(CreatureSpawn *spawn, uint32 mode, MapInfo *info)
 		}break;
 	}
 
-	has_combat_text = objmgr.HasMonsterSay(GetEntry(), MONSTER_SAY_EVENT_ENTER_COMBAT);
-	has_waypoint_text = objmgr.HasMonsterSay(GetEntry(), MONSTER_SAY_EVENT_RANDOM_WAYPOINT);
-	m_aiInterface->m_isGuard = isGuard(GetEntry());
+	has_combat_text = t->CombatText;
+	has_waypoint_text = t->WaypointText;
+	m_aiInterface->m_isGuard = t->Guard;
 
 	m_aiInterface->getMoveFlags();
 	//CanMove (overrules AI)
@@ -1153,40 +1242,13 @@ bool Creature::Load(CreatureSpawn *spawn, uint32 mode, MapInfo *info)
 	if( spawn->stand_state )
 		SetStandState( (uint8)spawn->stand_state );
 
-	uint32 tmpitemid;
-	if(tmpitemid = proto->Item1)
+	if(t->HasShield)
 	{
-		ItemEntry* DBCItem = dbcItem.LookupEntry(tmpitemid);
-		if(DBCItem)
-		{
-			if(DBCItem->InventoryType == INVTYPE_SHIELD)
-			{
-				b_has_shield = true;
-				IP_shield = ItemPrototypeStorage.LookupEntry(tmpitemid);
-			}
-			else if(getLevel() > 10)
-				setcanperry(true); // Who cares what else it is, set parry = true.
-		}
-	}
-
-	if(tmpitemid = proto->Item2)
-	{
-		ItemEntry* DBCItem = dbcItem.LookupEntry(tmpitemid);
-		if(DBCItem)
-		{
-			if(!b_has_shield && DBCItem->InventoryType == INVTYPE_SHIELD)
-			{
-				b_has_shield = true;
-				IP_shield = ItemPrototypeStorage.LookupEntry(tmpitemid);
-			}
-			else if(getLevel() > 10)
-			{
-				if(DBCItem->InventoryType == INVTYPE_WEAPONOFFHAND
-					|| DBCItem->InventoryType == INVTYPE_WEAPON)
-					setcanperry(true); // We can hold non weapons here, so we need to be careful and do checks.
-			}
-		}
+		b_has_shield = true;
+		IP_shield = t->Shield;
 	}
+	if(t->ParryItem && getLevel() > 10)
+		setcanperry(true);
 
 	m_loadedFromDB = true;
 	return true;
@@ -319,6 +319,26 @@ class CreatureAIScript;
 class GossipScript;
 class AuctionHouse;
 struct Trainer;
+
+// What loading a spawn of an entry in a mode always comes to, built once per map and stamped onto each creature.
+// Anything random (level, health, model) or owned by the spawn (faction, flags, waypoints) is still done per creature.
+struct CreatureSpawnTemplate
+{
+	uint32 Generation;
+	CreatureProto* Proto;
+	CreatureProtoMode* ModeProto;
+	CreatureInfo* Info;
+	CreatureInfoExtra* Extra;
+	CreatureFamilyEntry* Family;
+	std::vector<std::pair<uint32, uint32> > Fields;		// index, value of the update fields that only depend on the entry
+	std::vector<AI_Spell*> Spells;						// already filtered by mode
+	ItemPrototype* Shield;
+	bool HasShield;
+	bool ParryItem;										// can parry from level 11
+	bool CombatText;
+	bool WaypointText;
+	bool Guard;
+};
 #define CALL_SCRIPT_EVENT(obj, func) if(obj->GetTypeId() == TYPEID_UNIT && TO_CREATURE(obj)->GetScript() != NULL) TO_CREATURE(obj)->GetScript()->func
 
 ///////////////////
@@ -335,6 +355,8 @@ public:
 	virtual void Destruct();
 
 	bool Load(CreatureSpawn *spawn, uint32 mode, MapInfo *info);
+	bool Load(CreatureSpawn *spawn, uint32 mode, CreatureSpawnTemplate *t);
+	static bool BuildSpawnTemplate(uint32 entry, uint32 mode, CreatureSpawnTemplate & t);
 	bool Load(CreatureProto * proto_, uint32 mode, float x, float y, float z, float o = 0.0f);
 
 	void AddToWorld();
@@ -591,6 +613,11 @@ public:
 
 	WayPointMap * m_custom_waypoint_map;
 	Player* m_escorter;
+
+	// MapMgr skips idle creatures with nobody close on most ticks and hands them the time on the next update
+	uint32 m_updateDeferUntil;
+	uint32 m_deferredUpdateTime;
+	HEARTHSTONE_INLINE void WakeForUpdate() { m_updateDeferUntil = 0; }
 	void DestroyCustomWaypointMap();
 	bool IsInLimboState() { return m_limbostate; }
 	uint32 GetLineByFamily(CreatureFamilyEntry * family){return family->skilline ? family->skilline : 0;};
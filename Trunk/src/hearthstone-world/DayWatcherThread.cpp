@@ -184,7 +184,7 @@ void DayWatcherThread::update_arena()
 			Field * f = result->Fetch();
 			guid = f[0].GetUInt32();
 
-			inf = objmgr.GetPlayerInfo(guid);
+			inf = objmgr.LoadPlayerInfo(guid);
 			if( inf == NULL )
 				continue;
 
@@ -115,6 +115,7 @@ enum EventTypes
 	EVENT_PLAYER_DUEL_COUNTDOWN,
 	EVENT_PLAYER_DUEL_BOUNDARY_CHECK,
 	EVENT_GAMEOBJECT_TRAP_SEARCH_TARGET,
+	EVENT_GAMEOBJECT_TRAP_REPEAT,
 	EVENT_PLAYER_TELEPORT,
 	EVENT_UNIT_DIMINISHING_RETURN,
 	EVENT_UNIT_UNROOT,
@@ -9,6 +9,7 @@ EventableObject::EventableObject()
 	m_holder = 0;
 	m_event_Instanceid = -1;
 	m_events.clear();
+	m_lock.SetLockName("EventableObject::m_lock");
 }
 
 EventableObject::~EventableObject()
@@ -310,6 +311,8 @@ bool EventableObject::event_HasEvent(uint32 EventType)
 
 EventableObjectHolder::EventableObjectHolder(int32 instance_id) : mInstanceId(instance_id)
 {
+	m_lock.SetLockName("EventableObjectHolder::m_lock");
+	m_insertPoolLock.SetLockName("EventableObjectHolder::m_insertPoolLock");
 	sEventMgr.AddEventHolder(this, instance_id);
 }
 
@@ -174,7 +174,12 @@ bool ChatHandler::HandleGMTicketListCommand(const char* args, WorldSession *m_se
 		{
 			aplr = objmgr.GetPlayer((uint32)(*itr)->assignedToPlayer);
 			if(aplr == NULLPLR)
-				aplri = objmgr.GetPlayerInfo((uint32)(*itr)->assignedToPlayer);
+			{
+				// Never wait on the database here, a GM who isn't resident shows up in the next listing
+				aplri = objmgr.GetCachedPlayerInfo((uint32)(*itr)->assignedToPlayer);
+				if(aplri == NULL)
+					objmgr.LoadPlayerInfoAsync((uint32)(*itr)->assignedToPlayer, 0, NULL);
+			}
 		}
 
 		std::stringstream ss;
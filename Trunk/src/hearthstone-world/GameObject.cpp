@@ -4,6 +4,8 @@
 
 #include "StdAfx.h"
 
+#define TRAP_MAX_CROSSING_STEP 40.0f
+
 GameObject::GameObject(uint64 guid)
 {
 	m_objectTypeId = TYPEID_GAMEOBJECT;
@@ -16,12 +18,12 @@ GameObject::GameObject(uint64 guid)
 	m_wowGuid.Init(GetGUID());
 	SetFloatValue( OBJECT_FIELD_SCALE_X, 1);
 	SetAnimProgress(100);
-	counter = 0;
 	bannerslot = bannerauraslot = -1;
 	m_summonedGo = false;
 	invisible = false;
 	invisibilityFlag = INVIS_FLAG_NORMAL;
 	spell = NULL;
+	m_triggerRegistered = false;
 	m_summoner = NULLUNIT;
 	charges = -1;
 	m_ritualmembers = NULL;
@@ -126,7 +128,18 @@ bool GameObject::CreateFromProto(uint32 entry,uint32 mapid, float x, float y, fl
 
 void GameObject::TrapSearchTarget()
 {
-	Update(200);
+	if(!IsInWorld() || m_deleted || !m_triggerRegistered)
+		return;
+
+	// From here on the map tells us when units move in or out
+	for(unordered_set<Object*>::iterator itr = GetInRangeSetBegin(), it2; itr != GetInRangeSetEnd();)
+	{
+		it2 = itr++;
+		if((*it2)->IsUnit())
+			m_mapMgr->UpdateTriggerVolume(TO_GAMEOBJECT(this), TO_UNIT(*it2));
+		if(m_deleted || !IsInWorld())
+			return;
+	}
 }
 
 void GameObject::Update(uint32 p_time)
@@ -136,67 +149,136 @@ void GameObject::Update(uint32 p_time)
 		event_Relocate();
 		return;
 	}
+}
 
-	if(!IsInWorld())
+bool GameObject::IsInTriggerVolume(Unit* pUnit)
+{
+	if(pUnit == m_summoner || GetDistanceSq(pUnit) > range)
+		return false;
+
+	if(GetType() == GAMEOBJECT_TYPE_AURA_GENERATOR)
+		return pUnit->IsPlayer() || pUnit->IsVehicle();
+	return true;
+}
+
+// For a unit outside the trap now that was outside it at from too
+bool GameObject::CrossedTriggerVolume(Unit* pUnit, const LocationVector & from)
+{
+	if(pUnit == m_summoner || GetType() == GAMEOBJECT_TYPE_AURA_GENERATOR)
+		return false;
+
+	// Longer steps are teleports, not a path through anything
+	float dx = pUnit->GetPositionX() - from.x, dy = pUnit->GetPositionY() - from.y, dz = pUnit->GetPositionZ() - from.z;
+	float len = dx * dx + dy * dy + dz * dz;
+	if(len == 0.0f || len > TRAP_MAX_CROSSING_STEP * TRAP_MAX_CROSSING_STEP)
+		return false;
+
+	// Closest point of the step to the trap
+	float t = ((GetPositionX() - from.x) * dx + (GetPositionY() - from.y) * dy + (GetPositionZ() - from.z) * dz) / len;
+	if(t <= 0.0f || t >= 1.0f)
+		return false;
+
+	float px = from.x + dx * t - GetPositionX(), py = from.y + dy * t - GetPositionY(), pz = from.z + dz * t - GetPositionZ();
+	return px * px + py * py + pz * pz <= range;
+}
+
+void GameObject::OnTriggerEnter(Unit* pUnit)
+{
+	if(GetType() == GAMEOBJECT_TYPE_AURA_GENERATOR)
+	{
+		if(!pUnit->HasAura(spell->Id))
+			pUnit->AddAura(new Aura(spell, -1, pUnit, pUnit));
 		return;
+	}
 
-	if(m_deleted)
+	// Placed traps keep going off on whoever stays inside, the way they did when they scanned on their own
+	if(!m_summonedGo && !sEventMgr.HasEvent(this, EVENT_GAMEOBJECT_TRAP_REPEAT))
+		sEventMgr.AddEvent(this, &GameObject::EventTriggerRepeat, EVENT_GAMEOBJECT_TRAP_REPEAT, checkrate * 100, 0, EVENT_FLAG_DO_NOT_EXECUTE_IN_WORLD_CONTEXT);
+
+	TriggerTrap(pUnit);
+}
+
+void GameObject::OnTriggerLeave(Unit* pUnit)
+{
+	if(GetType() == GAMEOBJECT_TYPE_AURA_GENERATOR)
+	{
+		pUnit->RemoveAura(spell->Id, pUnit->GetGUID());
 		return;
+	}
 
-	if(spell != NULL && GetState() == 1 && GetType() != GAMEOBJECT_TYPE_AURA_GENERATOR)
+	if(m_triggerOccupants.empty())
+		sEventMgr.RemoveEvents(this, EVENT_GAMEOBJECT_TRAP_REPEAT);
+}
+
+void GameObject::EventTriggerRepeat()
+{
+	if(m_event_Instanceid != m_instanceId)
+	{
+		event_Relocate();
+		return;
+	}
+
+	if(!IsInWorld() || m_deleted || m_triggerOccupants.empty())
 	{
-		if(checkrate > 1)
+		sEventMgr.RemoveEvents(this, EVENT_GAMEOBJECT_TRAP_REPEAT);
+		return;
+	}
+
+	// Casting can move units, which changes the occupant set under us
+	std::vector<uint64> occupants(m_triggerOccupants.begin(), m_triggerOccupants.end());
+	for(std::vector<uint64>::iterator itr = occupants.begin(); itr != occupants.end(); ++itr)
+	{
+		Unit* pUnit = m_mapMgr->GetUnit(*itr);
+		if(pUnit == NULL || !IsInTriggerVolume(pUnit))
 		{
-			if(counter++%checkrate)
-				return;
+			m_triggerOccupants.erase(*itr);
+			continue;
 		}
 
-		Object::InRangeSet::iterator itr,it2;
-		Unit* pUnit;
-		float dist;
-		for( it2 = GetInRangeSetBegin(); it2 != GetInRangeSetEnd(); it2++)
-		{
-			itr = it2;
-			dist = GetDistanceSq((*itr));
-			if( (*itr) != m_summoner && (*itr)->IsUnit() && dist <= range)
-			{
-				pUnit = TO_UNIT(*itr);
+		if(!TriggerTrap(pUnit) || !IsInWorld())
+			break;
+	}
+}
 
-				if(m_summonedGo)
-				{
-					if(!m_summoner)
-					{
-						ExpireAndDelete();
-						return;
-					}
-					if(!isAttackable(m_summoner,pUnit))
-						continue;
-				}
+// Returns false once the trap is spent or hit everything it will this time
+bool GameObject::TriggerTrap(Unit* pUnit)
+{
+	if(m_deleted || GetState() != 1)
+		return false;
 
-				Spell* sp = (new Spell(TO_OBJECT(this),spell,true,NULLAURA));
-				SpellCastTargets tgt((*itr)->GetGUID());
-				tgt.m_destX = GetPositionX();
-				tgt.m_destY = GetPositionY();
-				tgt.m_destZ = GetPositionZ();
-				sp->prepare(&tgt);
-				if(pInfo->Type == 6)
-				{
-					if(m_summoner != NULL)
-						m_summoner->HandleProc(PROC_ON_TRAP_TRIGGER, NULL, pUnit, spell);
-				}
+	if(m_summonedGo)
+	{
+		if(!m_summoner)
+		{
+			ExpireAndDelete();
+			return false;
+		}
+		if(!isAttackable(m_summoner,pUnit))
+			return true;
+	}
 
-				if(m_summonedGo)
-				{
-					ExpireAndDelete();
-					return;
-				}
+	Spell* sp = (new Spell(TO_OBJECT(this),spell,true,NULLAURA));
+	SpellCastTargets tgt(pUnit->GetGUID());
+	tgt.m_destX = GetPositionX();
+	tgt.m_destY = GetPositionY();
+	tgt.m_destZ = GetPositionZ();
+	sp->prepare(&tgt);
+	if(pInfo->Type == 6)
+	{
+		if(m_summoner != NULL)
+			m_summoner->HandleProc(PROC_ON_TRAP_TRIGGER, NULL, pUnit, spell);
+	}
 
-				if(spell->EffectImplicitTargetA[0] == 16 ||
-					spell->EffectImplicitTargetB[0] == 16)
-					return;	 // on area dont continue.
-			}
-		}
+	if(m_summonedGo)
+	{
+		ExpireAndDelete();
+		return false;
 	}
+
+	if(spell->EffectImplicitTargetA[0] == 16 ||
+		spell->EffectImplicitTargetB[0] == 16)
+		return false;	 // on area dont continue.
+	return true;
 }
 
 void GameObject::Spawn( MapMgr* m)
@@ -333,8 +415,8 @@ void GameObject::InitAI()
 		}break;
 	case GAMEOBJECT_TYPE_AURA_GENERATOR:
 		{
-			spellid = GetInfo()->AuraGenerator.AuraID1;
-			sEventMgr.AddEvent(this, &GameObject::AuraGenSearchTarget, EVENT_GAMEOBJECT_TRAP_SEARCH_TARGET, 1000, 0, EVENT_FLAG_DO_NOT_EXECUTE_IN_WORLD_CONTEXT);
+			spell = dbcSpell.LookupEntry(GetInfo()->AuraGenerator.AuraID1);
+			range = float(GetInfo()->AuraGenerator.Radius * GetInfo()->AuraGenerator.Radius);
 			return;
 		}break;
 	}
@@ -516,6 +598,7 @@ void GameObject::FishHooked(Player* player)
 void GameObject::AddQuest(QuestRelation *Q)
 {
 	m_quests->push_back(Q);
+	sQuestMgr.OnQuestRelationsChanged();
 }
 
 void GameObject::DeleteQuest(QuestRelation *Q)
@@ -530,6 +613,8 @@ void GameObject::DeleteQuest(QuestRelation *Q)
 			break;
 		}
 	}
+
+	sQuestMgr.OnQuestRelationsChanged();
 }
 
 Quest* GameObject::FindQuest(uint32 quest_id, uint8 quest_relation)
@@ -668,6 +753,8 @@ void GameObject::ExpireAndDelete(uint32 delay)
 void GameObject::OnPushToWorld()
 {
 	Object::OnPushToWorld();
+	if(IsTriggerVolume())
+		m_mapMgr->AddTriggerVolume(TO_GAMEOBJECT(this));
 }
 
 void GameObject::OnRemoveInRangeObject(Object* pObj)
@@ -687,6 +774,7 @@ void GameObject::OnRemoveInRangeObject(Object* pObj)
 void GameObject::RemoveFromWorld(bool free_guid)
 {
 	sEventMgr.RemoveEvents(this, EVENT_GAMEOBJECT_TRAP_SEARCH_TARGET);
+	sEventMgr.RemoveEvents(this, EVENT_GAMEOBJECT_TRAP_REPEAT);
 	Despawn(0, 0);
 }
 
@@ -818,30 +906,6 @@ void GameObject::Rebuild()
 	m_Go_Uint32Values[GO_UINT32_HEALTH] = IntactHealth + DamagedHealth;
 }
 
-void GameObject::AuraGenSearchTarget()
-{
-	if(m_event_Instanceid != m_instanceId)
-	{
-		event_Relocate();
-		return;
-	}
-
-	if(!IsInWorld() || m_deleted || !spell)
-		return;
-
-	Object::InRangeSet::iterator itr,it2;
-	for( it2 = GetInRangeSetBegin(); it2 != GetInRangeSetEnd(); it2++)
-	{
-		itr = it2;
-		Unit* thing = NULL; // Crow: Shouldn't radius be sq?
-		if( (*itr)->IsUnit() && GetDistanceSq((*itr)) <= pInfo->AuraGenerator.Radius && ((*itr)->IsPlayer() || (*itr)->IsVehicle()) && !(TO_UNIT((*itr))->HasAura(spell->Id)))
-		{
-			thing = TO_UNIT((*itr));
-			thing->AddAura(new Aura(spell, -1, thing, thing));
-		}
-	}
-}
-
 void GameObject::Damage()
 {
 	SetFlags(GO_FLAG_DAMAGED);
@@ -417,7 +417,6 @@ public:
 	bool m_scripted_use;
 	float range;
 	uint8 checkrate;
-	uint16 counter;
 	int32 charges;//used for type==22,to limit number of usages.
 	bool invisible;//invisible
 	uint8 invisibilityFlag;
@@ -428,7 +427,19 @@ public:
 
 	HEARTHSTONE_INLINE GameObjectAIScript* GetScript() { return myScript; }
 
-	void TrapSearchTarget();	// Traps need to find targets faster :P
+	void TrapSearchTarget();	// Arming scan for units already standing in the trap
+
+	// Traps and aura generators are trigger volumes: the map checks them when a unit moves (MapMgr::AddTriggerVolume)
+	HEARTHSTONE_INLINE bool IsTriggerVolume() { return spell != NULL; }
+	bool IsInTriggerVolume(Unit* pUnit);
+	bool CrossedTriggerVolume(Unit* pUnit, const LocationVector & from);
+	void OnTriggerEnter(Unit* pUnit);
+	void OnTriggerLeave(Unit* pUnit);
+	void EventTriggerRepeat();
+	bool TriggerTrap(Unit* pUnit);
+	std::set<uint64> m_triggerOccupants;
+	bool m_triggerRegistered;
+	uint32 m_triggerCells[4];	// first x, last x, first y, last y
 
 	HEARTHSTONE_INLINE bool HasAI() { return spell != 0; }
 	GOSpawn * m_spawn;
@@ -470,8 +481,6 @@ public:
 	void Destroy();
 	void Damage();
 	void Rebuild();
-	//Aura Generator
-	void AuraGenSearchTarget();
 
 	uint32 GetGOui32Value(uint32 id)
 	{
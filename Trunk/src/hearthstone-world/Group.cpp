@@ -42,6 +42,7 @@ enum PartyUpdateFlagGroups
 Group::Group(bool Assign)
 {
 	m_GroupType = GROUP_TYPE_PARTY;	 // Always init as party
+	m_groupLock.SetLockName("Group::m_groupLock");
 
 	// Create initial subgroup
 	memset(m_SubGroups,0, sizeof(SubGroup*)*8);
@@ -755,7 +756,7 @@ void Group::SendPartyKillLog( Object* player, Object* Unit )
 
 void Group::LoadFromDB(Field *fields)
 {
-#define LOAD_ASSISTANT(__i, __d) g = fields[__i].GetUInt32(); if(g != 0) { __d = objmgr.GetPlayerInfo(g); }
+#define LOAD_ASSISTANT(__i, __d) g = fields[__i].GetUInt32(); if(g != 0) { __d = objmgr.LoadPlayerInfo(g); }
 
 	uint32 g;
 	m_updateblock=true;
@@ -787,7 +788,7 @@ void Group::LoadFromDB(Field *fields)
 			if( guid == 0 )
 				continue;
 
-			PlayerInfo * inf = objmgr.GetPlayerInfo(guid);
+			PlayerInfo * inf = objmgr.LoadPlayerInfo(guid);
 			if(inf == NULL)
 				continue;
 
@@ -1070,7 +1071,6 @@ void Group::HandleUpdateFieldChange(uint32 Index, Player* pPlayer)
 	if( m_dirty )//sth has corrupted this, workaround
 		return;
 
-	m_groupLock.Acquire();
 	switch(Index)
 	{
 	case UNIT_FIELD_HEALTH:
@@ -1101,20 +1101,17 @@ void Group::HandleUpdateFieldChange(uint32 Index, Player* pPlayer)
 		Flags = GROUP_UPDATE_FLAG_LEVEL;
 		break;
 	default:
-		break;
+		return;
 	}
 
-	if( Flags != 0 )
-		UpdateOutOfRangePlayer( pPlayer, Flags, true, 0 );
-
+	m_groupLock.Acquire();
+	pPlayer->m_groupUpdateFlags |= Flags;
 	m_groupLock.Release();
 }
 
 void Group::HandlePartialChange(uint32 Type, Player* pPlayer)
 {
 	uint32 Flags = 0;
-	m_groupLock.Acquire();
-
 	switch(Type)
 	{
 	case PARTY_UPDATE_FLAG_POSITION:
@@ -1124,12 +1121,25 @@ void Group::HandlePartialChange(uint32 Type, Player* pPlayer)
 	case PARTY_UPDATE_FLAG_ZONEID:
 		Flags = GROUP_UPDATE_FLAG_ZONEID;
 		break;
+	default:
+		return;
 	}
 
-	if(Flags)
-		UpdateOutOfRangePlayer(pPlayer, Flags, true, 0);
+	m_groupLock.Acquire();
+	pPlayer->m_groupUpdateFlags |= Flags;
+	m_groupLock.Release();
+}
 
+void Group::SendMemberUpdate(Player* pPlayer)
+{
+	m_groupLock.Acquire();
+	uint32 Flags = pPlayer->m_groupUpdateFlags;
+	pPlayer->m_groupUpdateFlags = 0;
 	m_groupLock.Release();
+
+	// Values are read when the packet is built, so it carries the latest of each
+	if(Flags != 0)
+		UpdateOutOfRangePlayer(pPlayer, Flags, true, NULL);
 }
 
 void WorldSession::HandlePartyMemberStatsOpcode(WorldPacket & recv_data)
@@ -176,8 +176,10 @@ public:
 
 	void UpdateOutOfRangePlayer(Player* pPlayer, uint32 Flags, bool Distribute, WorldPacket * Packet);
 	void UpdateAllOutOfRangePlayersFor(Player* pPlayer);
+	// Only mark what changed, SendMemberUpdate sends it all at once from the member's own update
 	void HandleUpdateFieldChange(uint32 Index, Player* pPlayer);
 	void HandlePartialChange(uint32 Type, Player* pPlayer);
+	void SendMemberUpdate(Player* pPlayer);
 
 	uint64 m_targetIcons[8];
 	HEARTHSTONE_INLINE Mutex& getLock() { return m_groupLock; }
@@ -257,7 +257,7 @@ void GuildMgr::LoadAllGuilds()
 				rankstorage = ConstructRankStorage(GuildId);
 
 			uint32 guid = f[1].GetUInt32();
-			GuildMember* gm = new GuildMember(guid, objmgr.GetPlayerInfo(guid), NULL);
+			GuildMember* gm = new GuildMember(guid, objmgr.LoadPlayerInfo(guid), NULL);
 			if(gm->pPlayer == NULL)
 			{
 				delete gm;
@@ -594,13 +594,13 @@ void GuildMgr::LogGuildEvent(Player* plr, uint32 GuildId, uint8 iEvent, const ch
 	WorldPacket data(SMSG_GUILD_EVENT, 2+uint32(size));
 	data << uint8(iEvent);
 	data << uint8(count);
-	data << strdup(arguement1);
+	data << arguement1;
 	if(count > 1)
-		data << strdup(arguement2);
+		data << arguement2;
 	if(count > 2)
-		data << strdup(arguement3);
+		data << arguement3;
 	if(count > 3)
-		data << strdup(arguement4);
+		data << arguement4;
 	if(plr != NULL)
 	{
 		if(plr->IsInWorld())
@@ -617,17 +617,17 @@ void GuildMgr::LogGuildEvent(Player* plr, uint32 GuildId, uint8 iEvent, const ch
 		if(MemberMapStorage != NULL)
 		{
 			Player* target = NULL;
+			SharedWorldPacket* shared = NULL;
 			MemberMapStorage->MemberMapLock.Acquire();
 			for(GuildMemberMap::iterator itr = MemberMapStorage->MemberMap.begin(); itr != MemberMapStorage->MemberMap.end(); itr++)
 			{
 				target = itr->second->pPlayer->m_loggedInPlayer;
-				if(target != NULL)
-				{
-					WorldPacket* data2 = new WorldPacket(data);
-					target->SendPacket(data2);
-				}
+				if(target != NULL && target->GetSession() != NULL)
+					target->GetSession()->SendSharedPacket(&data, shared);
 			}
 			MemberMapStorage->MemberMapLock.Release();
+			if(shared != NULL)
+				WorldPacketPool::Free(shared);
 		}
 	}
 }
@@ -1591,17 +1591,20 @@ void GuildMgr::GuildChat(WorldSession* m_session, uint32 Language, const char* m
 
 	Player* Target = NULL;
 	WorldPacket * data = sChatHandler.FillMessageData( CHAT_MSG_GUILD, LANG_UNIVERSAL, message, plr->GetGUID(), plr->GetChatTag());
+	SharedWorldPacket* shared = NULL;
 	MemberMapStorage->MemberMapLock.Acquire();
 	for(GuildMemberMap::iterator itr = MemberMapStorage->MemberMap.begin(); itr != MemberMapStorage->MemberMap.end(); itr++)
 	{
 		Target = itr->second->pPlayer->m_loggedInPlayer;
-		if(Target == NULL)
+		if(Target == NULL || Target->GetSession() == NULL)
 			continue;
 
 		if(HasGuildRights(Target, GR_RIGHT_GCHATLISTEN))
-			Target->SendPacket(data);
+			Target->GetSession()->SendSharedPacket(data, shared);
 	}
 	MemberMapStorage->MemberMapLock.Release();
+	if(shared != NULL)
+		WorldPacketPool::Free(shared);
 
 	delete data;
 }
@@ -1630,17 +1633,20 @@ void GuildMgr::OfficerChat(WorldSession* m_session, uint32 Language, const char*
 
 	Player* Target = NULL;
 	WorldPacket * data = sChatHandler.FillMessageData( CHAT_MSG_OFFICER, Language, message, plr->GetGUID(), plr->GetChatTag());
+	SharedWorldPacket* shared = NULL;
 	MemberMapStorage->MemberMapLock.Acquire();
 	for(GuildMemberMap::iterator itr = MemberMapStorage->MemberMap.begin(); itr != MemberMapStorage->MemberMap.end(); itr++)
 	{
 		Target = itr->second->pPlayer->m_loggedInPlayer;
-		if(Target == NULL)
+		if(Target == NULL || Target->GetSession() == NULL)
 			continue;
 
 		if(HasGuildRights(Target, GR_RIGHT_OFFCHATLISTEN))
-			Target->SendPacket(data);
+			Target->GetSession()->SendSharedPacket(data, shared);
 	}
 	MemberMapStorage->MemberMapLock.Release();
+	if(shared != NULL)
+		WorldPacketPool::Free(shared);
 
 	delete data;
 }
@@ -1780,7 +1786,7 @@ Charter::Charter(Field * fields)
 		Signatures[i] = fields[f++].GetUInt32();
 		if(Signatures[i])
 		{
-			PlayerInfo * inf = objmgr.GetPlayerInfo(Signatures[i]);
+			PlayerInfo * inf = objmgr.LoadPlayerInfo(Signatures[i]);
 			if( inf == NULL )
 			{
 				Signatures[i] = 0;
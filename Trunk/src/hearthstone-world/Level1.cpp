@@ -295,14 +295,8 @@ bool ChatHandler::HandleSummonCommand(const char* args, WorldSession *m_session)
 	}
 	else
 	{
-		PlayerInfo * pinfo = objmgr.GetPlayerInfoByName(args);
-		if(!pinfo)
-		{
-			char buf[256];
-			snprintf((char*)buf,256,"Player (%s) does not exist.", args);
-			SystemMessage(m_session, buf);
-		}
-		else
+		PlayerInfo * pinfo = getPlayerInfoByName(args, m_session);
+		if(pinfo != NULL)
 		{
 			Player* pPlayer = m_session->GetPlayer();
 			char query[512];
@@ -342,7 +336,7 @@ bool ChatHandler::HandleAppearCommand(const char* args, WorldSession *m_session)
 	else
 	{
 		std::stringstream ss;
-		PlayerInfo* PI = objmgr.GetPlayerInfoByName(args);
+		PlayerInfo* PI = getPlayerInfoByName(args, m_session);
 		if(PI)
 		{
 			if(!chr) // Send message telling
@@ -356,11 +350,9 @@ bool ChatHandler::HandleAppearCommand(const char* args, WorldSession *m_session)
 				ss << "\nTeleporting to last known location of player " << args;
 				sWorld.LogGM(m_session, "Appeared to the last known location of %s", args);
 			}
-		}
-		else
-			ss << "Player " << args << " does not exist.";
 
-		SystemMessage(m_session, ss.str().c_str());
+			SystemMessage(m_session, ss.str().c_str());
+		}
 	}
 
 	return true;
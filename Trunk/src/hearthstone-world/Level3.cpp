@@ -304,12 +304,9 @@ bool ChatHandler::HandleBanCharacterCommand(const char* args, WorldSession *m_se
 	Player* pPlayer = objmgr.GetPlayer(pCharacter, false);
 	if(pPlayer == NULL)
 	{
-		pInfo = objmgr.GetPlayerInfoByName(pCharacter);
+		pInfo = getPlayerInfoByName(pCharacter, m_session);
 		if(pInfo == NULL)
-		{
-			SystemMessage(m_session, "Player not found.");
 			return true;
-		}
 
 		SystemMessage(m_session, "Banning player '%s' in database for '%s'.", pCharacter, pReason);
 		string escaped_reason = CharacterDatabase.EscapeString(string(pReason));
@@ -710,6 +707,16 @@ bool ChatHandler::HandleAccountUnmuteCommand(const char * args, WorldSession * m
 	return true;
 }
 
+bool ChatHandler::HandleAccountRefreshCommand(const char * args, WorldSession * m_session)
+{
+	if( !*args )
+		return false;
+
+	sLogonCommHandler.Account_Refresh( args );
+	GreenSystemMessage(m_session, "Logon server asked to reread account '%s'.", args);
+	return true;
+}
+
 bool ChatHandler::HandleGetTransporterTime(const char* args, WorldSession* m_session)
 {
 	Creature* crt = getSelectedCreature(m_session, false);
@@ -2071,12 +2078,9 @@ bool ChatHandler::HandleForceRenameCommand(const char * args, WorldSession * m_s
 		return false;
 
 	string tmp = string(args);
-	PlayerInfo * pi = objmgr.GetPlayerInfoByName(tmp.c_str());
+	PlayerInfo * pi = getPlayerInfoByName(tmp.c_str(), m_session);
 	if(pi == NULL)
-	{
-		RedSystemMessage(m_session, "Player with that name not found.");
 		return true;
-	}
 
 	Player* plr = objmgr.GetPlayer((uint32)pi->guid);
 	if(plr == NULLPLR)
@@ -2103,12 +2107,9 @@ bool ChatHandler::HandleRecustomizeCharCommand(const char * args, WorldSession *
 		return false;
 
 	string tmp = string(args);
-	PlayerInfo * pi = objmgr.GetPlayerInfoByName(tmp.c_str());
+	PlayerInfo * pi = getPlayerInfoByName(tmp.c_str(), m_session);
 	if(pi == NULL)
-	{
-		RedSystemMessage(m_session, "Player with that name not found.");
 		return true;
-	}
 
 	Player* plr = objmgr.GetPlayer((uint32)pi->guid);
 	if(plr == NULLPLR)
@@ -409,6 +409,17 @@ void LogonCommHandler::Account_SetMute(const char * account, uint32 muted)
 	logon->SendPacket(&data, false);
 }
 
+void LogonCommHandler::Account_Refresh(const char * account)
+{
+	if(logon == NULL) // No valid logonserver is connected.
+		return;
+
+	WorldPacket data(RCMSG_MODIFY_DATABASE, 50);
+	data << uint32(6);		// 6 = reread account
+	data << account;
+	logon->SendPacket(&data, false);
+}
+
 void LogonCommHandler::IPBan_Add(const char * ip, uint32 duration, const char* reason)
 {
 	if(logon == NULL) // No valid logonserver is connected.
@@ -81,6 +81,7 @@ public:
 	void Account_SetBanned(const char * account, uint32 banned, const char* reason);
 	void Account_SetGM(const char * account, const char * flags);
 	void Account_SetMute(const char * account, uint32 muted);
+	void Account_Refresh(const char * account);
 	void IPBan_Add(const char * ip, uint32 duration, const char* reason);
 	void IPBan_Remove(const char * ip);
 
@@ -464,7 +464,8 @@ void WorldSession::HandleSendMail(WorldPacket & recv_data )
 	PlayerInfo* player = ObjectMgr::getSingleton().GetPlayerInfoByName(recepient.c_str());
 	if( player == NULL )
 	{
-		SendMailError(MAIL_ERR_RECIPIENT_NOT_FOUND);
+		if( !DeferUntilPlayerInfoLoaded(objmgr.GetPlayerGuidByName(recepient.c_str()), recv_data) )
+			SendMailError(MAIL_ERR_RECIPIENT_NOT_FOUND);
 		return;
 	}
 	msg.player_guid = player->guid;
@@ -8,6 +8,8 @@
 
 #include "StdAfx.h"
 
+volatile uint32 Map::s_templateGeneration = 1;
+
 Map::Map(uint32 mapid, MapInfo * inf)
 {
 	_mapInfo = inf;
@@ -15,6 +17,8 @@ Map::Map(uint32 mapid, MapInfo * inf)
 
 	//new stuff Load Spawns
 	LoadSpawns();
+	if(sWorld.m_spawnTemplates)
+		BuildCreatureTemplates();
 
 	// Setup terrain
 	_terrain = new TerrainMgr(sWorld.MapPath, _mapId, !(inf->type == INSTANCE_NULL));
@@ -91,11 +95,88 @@ Map::~Map()
 	}
 	m_spawns.clear();
 
+	for(CreatureTemplateMap::iterator itr = m_creatureTemplates.begin(); itr != m_creatureTemplates.end(); ++itr)
+		delete itr->second;
+	m_creatureTemplates.clear();
+	for(std::vector<CreatureSpawnTemplate*>::iterator itr = m_retiredTemplates.begin(); itr != m_retiredTemplates.end(); ++itr)
+		delete (*itr);
+	m_retiredTemplates.clear();
+
 	// collision
 	if (sWorld.Collision)
 		CollideInterface.DeactivateMap(_mapId);
 }
 
+CreatureSpawnTemplate* Map::GetCreatureTemplate(uint32 entry, uint32 mode)
+{
+	uint32 key = (entry << 2) | (mode & 3);
+	CreatureSpawnTemplate* t = NULL;
+	m_templateLock.AcquireReadLock();
+	CreatureTemplateMap::iterator itr = m_creatureTemplates.find(key);
+	if(itr != m_creatureTemplates.end())
+		t = itr->second;
+	m_templateLock.ReleaseReadLock();
+	if(t != NULL && t->Generation == s_templateGeneration)
+		return t;
+
+	// Not cached or the tables were reloaded, entries that can't load aren't cached at all
+	CreatureSpawnTemplate* nt = new CreatureSpawnTemplate();
+	if(!Creature::BuildSpawnTemplate(entry, mode, *nt))
+	{
+		delete nt;
+		return NULL;
+	}
+	nt->Generation = s_templateGeneration;
+
+	m_templateLock.AcquireWriteLock();
+	itr = m_creatureTemplates.find(key);
+	if(itr != m_creatureTemplates.end() && itr->second->Generation == nt->Generation)
+	{
+		// Another instance of the map got here first
+		delete nt;
+		nt = itr->second;
+	}
+	else
+	{
+		if(itr != m_creatureTemplates.end())
+			m_retiredTemplates.push_back(itr->second);
+		m_creatureTemplates[key] = nt;
+	}
+	m_templateLock.ReleaseWriteLock();
+	return nt;
+}
+
+void Map::BuildCreatureTemplates()
+{
+	// Every difficulty the map can be entered in
+	uint32 modes = 1;
+	if(_mapInfo->type == INSTANCE_RAID)
+		modes = 4;
+	else if(_mapInfo->type == INSTANCE_MULTIMODE)
+		modes = 2;
+
+	std::set<uint32> entries;
+	for(SpawnsMap::iterator itr = m_spawns.begin(); itr != m_spawns.end(); ++itr)
+	{
+		if(itr->second == NULL)
+			continue;
+
+		for(CellSpawnsMap::iterator itr2 = itr->second->begin(); itr2 != itr->second->end(); ++itr2)
+		{
+			if(itr2->second == NULL)
+				continue;
+
+			CreatureSpawnList & cell = itr2->second->CreatureSpawns;
+			for(CreatureSpawnList::iterator itr3 = cell.begin(); itr3 != cell.end(); ++itr3)
+				entries.insert((*itr3)->entry);
+		}
+	}
+
+	for(std::set<uint32>::iterator itr = entries.begin(); itr != entries.end(); ++itr)
+		for(uint32 mode = 0; mode < modes; ++mode)
+			GetCreatureTemplate(*itr, mode);
+}
+
 bool first_table_warning = true;
 bool CheckResultLengthCreatures(QueryResult * res)
 {
@@ -14,6 +14,7 @@ class TerrainMgr;
 class TemplateMgr;
 
 struct Formation;
+struct CreatureSpawnTemplate;
 
 struct SpawnBytes
 {
@@ -145,6 +146,12 @@ public:
 
 	void LoadSpawns(bool reload = false);//set to true to make clean up
 	uint32 CreatureSpawnCount;
+
+	// Creature templates, resolved once per entry and mode and shared by every instance of this map
+	CreatureSpawnTemplate* GetCreatureTemplate(uint32 entry, uint32 mode);
+	void BuildCreatureTemplates();
+	static void InvalidateCreatureTemplates() { ++s_templateGeneration; }
+
 	TerrainMgr* GetMapTerrain() { return _terrain; };
 
 	HEARTHSTONE_INLINE float  GetLandHeight(float x, float y)
@@ -219,4 +226,10 @@ private:
 	MapEntry *me;
 
 	SpawnsMap m_spawns;
+
+	typedef HM_NAMESPACE::hash_map<uint32, CreatureSpawnTemplate*> CreatureTemplateMap;
+	CreatureTemplateMap m_creatureTemplates;
+	std::vector<CreatureSpawnTemplate*> m_retiredTemplates;		// a map thread may still be loading from these
+	RWLock m_templateLock;
+	static volatile uint32 s_templateGeneration;
 };
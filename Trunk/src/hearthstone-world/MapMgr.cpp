@@ -35,9 +35,14 @@ MapMgr::MapMgr(Map *map, uint32 mapId, uint32 instanceid) : ThreadContext(), Cel
 
 	m_holder = &eventHolder;
 	m_event_Instanceid = eventHolder.GetInstanceID();
+
+	ActiveLock.SetLockName("MapMgr::ActiveLock");
+	m_objectinsertlock.SetLockName("MapMgr::m_objectinsertlock");
+	m_updateMutex.SetLockName("MapMgr::m_updateMutex");
 	forced_expire = false;
 	InactiveMoveTime = 0;
 	mLoopCounter = 0;
+	ResetTickStats();
 	pInstance = NULL;
 	thread_kill_only = false;
 	thread_running = false;
@@ -207,6 +212,17 @@ MapMgr::~MapMgr()
 
 }
 
+// Sizes are read without the map's locks, a scrape can be off by the objects that moved meanwhile
+void MapMgr::AddMetrics(MapMetrics & metrics)
+{
+	++metrics.Instances;
+	metrics.Players += uint32(m_PlayerStorage.size());
+	metrics.Sessions += uint32(MapSessions.size());
+	metrics.Creatures += uint32(m_CreatureStorage.size());
+	metrics.GameObjects += uint32(m_gameObjectStorage.size());
+	metrics.PendingUpdates += uint32(_updates.size());
+}
+
 void MapMgr::PushObject(Object* obj)
 {
 	/////////////
@@ -436,6 +452,24 @@ void MapMgr::RemoveObject(Object* obj, bool free_guid)
 	obj->ClearUpdateMask();
 	Player* plObj = (obj->IsPlayer()) ? TO_PLAYER( obj ) : NULLPLR;
 
+	// Leaving the map is leaving anything it was standing in, aura generators take their aura back
+	if(obj->IsUnit() && obj->GetMapCell() != NULL && !m_triggerVolumes.empty())
+	{
+		TriggerVolumeMap::iterator itr = m_triggerVolumes.find((obj->GetMapCell()->_x << 16) | obj->GetMapCell()->_y);
+		if(itr != m_triggerVolumes.end())
+		{
+			std::vector<GameObject*> left;
+			for(TriggerVolumeList::iterator it2 = itr->second.begin(); it2 != itr->second.end(); ++it2)
+			{
+				if((*it2)->m_triggerOccupants.erase(obj->GetGUID()))
+					left.push_back(*it2);
+			}
+
+			for(std::vector<GameObject*>::iterator it3 = left.begin(); it3 != left.end(); ++it3)
+				(*it3)->OnTriggerLeave(TO_UNIT(obj));
+		}
+	}
+
 	///////////////////////////////////////
 	// Remove object from all needed places
 	///////////////////////////////////////
@@ -479,6 +513,7 @@ void MapMgr::RemoveObject(Object* obj, bool free_guid)
 
 	case HIGHGUID_TYPE_GAMEOBJECT:
 		{
+			RemoveTriggerVolume(TO_GAMEOBJECT(obj));
 			m_gameObjectStorage.erase(obj->GetUIdFromGUID());
 			if(TO_GAMEOBJECT(obj)->m_spawn != NULL)
 				_sqlids_gameobjects.erase(TO_GAMEOBJECT(obj)->m_spawn->id);
@@ -714,6 +749,16 @@ void MapMgr::ChangeObjectLocation( Object* obj )
 				{
 					UpdateCellActivity( pOldCell->_x, pOldCell->_y, 2 );
 				}
+
+				// read the collision tile ahead of the player before the cells there activate
+				if( collision && sWorld.m_collisionPrefetchDistance > 0.0f )
+				{
+					float dx = float( (int)pOldCell->_x - (int)cellX );		// cell indices grow opposite to coords
+					float dy = float( (int)pOldCell->_y - (int)cellY );
+					float len = sqrtf( dx*dx + dy*dy );
+					CollideInterface.PrefetchPosition( _mapId, obj->GetPositionX() + dx / len * sWorld.m_collisionPrefetchDistance,
+						obj->GetPositionY() + dy / len * sWorld.m_collisionPrefetchDistance );
+				}
 			}
 		}
 	}
@@ -729,9 +774,128 @@ void MapMgr::ChangeObjectLocation( Object* obj )
 
 	UpdateInrangeSetOnCells(obj->GetGUID(), startX, endX, startY, endY);
 	if(obj->IsUnit())
+		TO_UNIT(obj)->OnPositionChange();
+}
+
+void MapMgr::AddTriggerVolume(GameObject* go)
+{
+	if(go->m_triggerRegistered)
+		return;
+
+	// cell indices grow opposite to coords
+	float r = sqrtf(go->range);
+	float x1 = std::max(go->GetPositionX() - r, float(_minX)), x2 = std::min(go->GetPositionX() + r, float(_maxX));
+	float y1 = std::max(go->GetPositionY() - r, float(_minY)), y2 = std::min(go->GetPositionY() + r, float(_maxY));
+	go->m_triggerCells[0] = std::min<uint32>(GetPosX(x2), _sizeX - 1);
+	go->m_triggerCells[1] = std::min<uint32>(GetPosX(x1), _sizeX - 1);
+	go->m_triggerCells[2] = std::min<uint32>(GetPosY(y2), _sizeY - 1);
+	go->m_triggerCells[3] = std::min<uint32>(GetPosY(y1), _sizeY - 1);
+
+	for(uint32 x = go->m_triggerCells[0]; x <= go->m_triggerCells[1]; ++x)
+		for(uint32 y = go->m_triggerCells[2]; y <= go->m_triggerCells[3]; ++y)
+			m_triggerVolumes[(x << 16) | y].push_back(go);
+
+	go->m_triggerRegistered = true;
+	go->m_triggerOccupants.clear();
+
+	// Nobody has to move for what's standing there already, look once when the trap is armed
+	sEventMgr.AddEvent(go, &GameObject::TrapSearchTarget, EVENT_GAMEOBJECT_TRAP_SEARCH_TARGET, 100, 1, EVENT_FLAG_DO_NOT_EXECUTE_IN_WORLD_CONTEXT);
+}
+
+void MapMgr::RemoveTriggerVolume(GameObject* go)
+{
+	if(!go->m_triggerRegistered)
+		return;
+
+	for(uint32 x = go->m_triggerCells[0]; x <= go->m_triggerCells[1]; ++x)
+	{
+		for(uint32 y = go->m_triggerCells[2]; y <= go->m_triggerCells[3]; ++y)
+		{
+			TriggerVolumeMap::iterator itr = m_triggerVolumes.find((x << 16) | y);
+			if(itr == m_triggerVolumes.end())
+				continue;
+
+			TriggerVolumeList::iterator it2 = std::find(itr->second.begin(), itr->second.end(), go);
+			if(it2 != itr->second.end())
+				itr->second.erase(it2);
+			if(itr->second.empty())
+				m_triggerVolumes.erase(itr);
+		}
+	}
+
+	// Aura generators take their aura back from whoever is still inside
+	if(go->GetType() == GAMEOBJECT_TYPE_AURA_GENERATOR)
+	{
+		for(std::set<uint64>::iterator itr = go->m_triggerOccupants.begin(); itr != go->m_triggerOccupants.end(); ++itr)
+		{
+			Unit* pUnit = GetUnit(*itr);
+			if(pUnit != NULL)
+				go->OnTriggerLeave(pUnit);
+		}
+	}
+
+	go->m_triggerOccupants.clear();
+	go->m_triggerRegistered = false;
+	sEventMgr.RemoveEvents(go, EVENT_GAMEOBJECT_TRAP_REPEAT);
+}
+
+void MapMgr::UpdateTriggerVolume(GameObject* go, Unit* pUnit)
+{
+	bool inside = go->IsInTriggerVolume(pUnit);
+	std::set<uint64>::iterator itr = go->m_triggerOccupants.find(pUnit->GetGUID());
+	if(inside == (itr != go->m_triggerOccupants.end()))
+		return;
+
+	if(inside)
 	{
-		Unit* pobj = TO_UNIT(obj);
-		pobj->OnPositionChange();
+		go->m_triggerOccupants.insert(pUnit->GetGUID());
+		go->OnTriggerEnter(pUnit);
+	}
+	else
+	{
+		go->m_triggerOccupants.erase(itr);
+		go->OnTriggerLeave(pUnit);
+	}
+}
+
+void MapMgr::UpdateTriggerVolumes(Unit* pUnit, const LocationVector & from)
+{
+	if(m_triggerVolumes.empty())
+		return;
+
+	// A unit can only be inside volumes listed in its cell, and only leave ones listed in the cell it came from
+	std::vector<uint32> volumes;
+	uint32 cellX = GetPosX(pUnit->GetPositionX()), cellY = GetPosY(pUnit->GetPositionY());
+	uint32 oldCellX = GetPosX(from.x), oldCellY = GetPosY(from.y);
+	TriggerVolumeMap::iterator itr = m_triggerVolumes.find((cellX << 16) | cellY);
+	if(itr != m_triggerVolumes.end())
+		for(TriggerVolumeList::iterator it2 = itr->second.begin(); it2 != itr->second.end(); ++it2)
+			volumes.push_back((*it2)->GetUIdFromGUID());
+
+	if(cellX != oldCellX || cellY != oldCellY)
+	{
+		itr = m_triggerVolumes.find((oldCellX << 16) | oldCellY);
+		if(itr != m_triggerVolumes.end())
+			for(TriggerVolumeList::iterator it2 = itr->second.begin(); it2 != itr->second.end(); ++it2)
+				if(std::find(volumes.begin(), volumes.end(), (*it2)->GetUIdFromGUID()) == volumes.end())
+					volumes.push_back((*it2)->GetUIdFromGUID());
+	}
+
+	// Looked up again each time, a trap going off can cast anything, including something that removes another
+	for(std::vector<uint32>::iterator it3 = volumes.begin(); it3 != volumes.end(); ++it3)
+	{
+		GameObject* go = GetGameObject(*it3);
+		if(go == NULL || !go->m_triggerRegistered)
+			continue;
+
+		// A trap passed straight through between two position updates still goes off
+		if(go->m_triggerOccupants.find(pUnit->GetGUID()) == go->m_triggerOccupants.end() &&
+			!go->IsInTriggerVolume(pUnit) && go->CrossedTriggerVolume(pUnit, from))
+			go->TriggerTrap(pUnit);
+		else
+			UpdateTriggerVolume(go, pUnit);
+		if(pUnit->GetMapMgr() != this)
+			return;
 	}
 }
 
@@ -1401,6 +1565,13 @@ void MapMgr::ChangeFarsightLocation(Player* plr, float X, float Y, bool apply)
 /* new stuff
 */
 
+static THREAD_LOCAL MapMgr* t_threadMapMgr = NULL;
+
+MapMgr* MapMgr::GetThreadMapMgr()
+{
+	return t_threadMapMgr;
+}
+
 bool MapMgr::run()
 {
 	return Do();
@@ -1411,6 +1582,7 @@ bool MapMgr::Do()
 #ifdef WIN32
 	threadid=GetCurrentThreadId();
 #endif
+	t_threadMapMgr = this;
 	thread_running = true;
 	ObjectSet::iterator i;
 	uint32 last_exec=getMSTime();
@@ -1438,6 +1610,7 @@ bool MapMgr::Do()
 	// otherwise theres a lot of sub esp; going on.
 
 	uint32 exec_time, exec_start;
+	uint64 exec_start_us;
 #ifdef WIN32
 	HANDLE hThread = GetCurrentThread();
 #endif
@@ -1447,6 +1620,7 @@ bool MapMgr::Do()
 			break;
 
 		exec_start = getMSTime();
+		exec_start_us = getUSTime();
 		//first push to world new objects
 		m_objectinsertlock.Acquire();
 		if(m_objectinsertpool.size())
@@ -1467,6 +1641,11 @@ bool MapMgr::Do()
 
 		last_exec=getMSTime();
 		exec_time=last_exec-exec_start;
+		++m_tickCount;
+		m_tickTotalTime += exec_time;
+		if(exec_time > m_tickMaxTime)
+			m_tickMaxTime = exec_time;
+		ServerMetrics::RecordMapTick(_mapId, uint32(getUSTime() - exec_start_us), exec_time > MAP_MGR_UPDATE_PERIOD);
 		if(exec_time<MAP_MGR_UPDATE_PERIOD)
 			Delay(MAP_MGR_UPDATE_PERIOD-exec_time);
 
@@ -1501,6 +1680,9 @@ bool MapMgr::Do()
 	// Teleport any left-over players out.
 	TeleportPlayers();
 
+	sHookInterface.OnMapShutdown(this);
+	t_threadMapMgr = NULL;
+
 	thread_running = false;
 	if(thread_kill_only)
 		return false;
@@ -1655,13 +1837,30 @@ void MapMgr::_PerformObjectDuties()
 		if(activeCreatures.size())
 		{
 			Creature* ptr;
+			uint32 delay, diff;
+			bool tiered = sWorld.m_creatureUpdateTiered && pMapInfo->type == INSTANCE_NULL;
 			__creature_iterator = activeCreatures.begin();
 			for(; __creature_iterator != activeCreatures.end();)
 			{
 				ptr = *__creature_iterator;
 				++__creature_iterator;
 
-				ptr->Update(difftime);
+				if(ptr->m_updateDeferUntil && int32(ptr->m_updateDeferUntil - mstime) > 0)
+				{
+					ptr->m_deferredUpdateTime += difftime;
+					++m_creatureDeferrals;
+					continue;
+				}
+
+				diff = difftime + ptr->m_deferredUpdateTime;
+				ptr->m_deferredUpdateTime = 0;
+
+				// decided before the update, the creature may be gone after it
+				delay = tiered ? GetCreatureUpdateDelay(ptr) : 0;
+				ptr->m_updateDeferUntil = delay ? ((mstime + delay) | 1) : 0;
+				++m_creatureUpdates;
+
+				ptr->Update(diff);
 			}
 		}
 
@@ -1766,6 +1965,7 @@ void MapMgr::_PerformObjectDuties()
 	// Sessions are updated every loop.
 	{
 		int result = 0;
+		uint64 sessionStart;
 		WorldSession * MapSession;
 		SessionSet::iterator itr = MapSessions.begin();
 		SessionSet::iterator it2;
@@ -1789,7 +1989,9 @@ void MapMgr::_PerformObjectDuties()
 				MapSession->GetPlayer()->GetMapMgr() != this)
 				continue;
 
+			sessionStart = getUSTime();
 			result = MapSession->Update(m_instanceID);
+			ServerMetrics::RecordSessionUpdate(uint32(getUSTime() - sessionStart));
 			if(result)//session or socket deleted?
 			{
 				if(result == 1)//socket don't exist anymore, delete from both world- and map-sessions.
@@ -1803,6 +2005,32 @@ void MapMgr::_PerformObjectDuties()
 	_UpdateObjects();
 }
 
+uint32 MapMgr::GetCreatureUpdateDelay(Creature* ctr)
+{
+	// Anything that reacts or is watched closely keeps the full tick rate
+	if(ctr->CombatStatus.IsInCombat() || ctr->GetCurrentSpell() != NULL || ctr->GetSummonedByGUID() || ctr->m_escorter != NULL)
+		return 0;
+
+	uint8 state = ctr->GetAIInterface()->getAIState();
+	if(state != STATE_IDLE && state != STATE_MOVEWP && state != STATE_WANDER)
+		return 0;
+
+	// A cell only stays active with a player next to it, so the tier goes by how far the closest player is
+	float nearDist = sWorld.m_creatureUpdateNearDistance * sWorld.m_creatureUpdateNearDistance;
+	float farDist = sWorld.m_creatureUpdateFarDistance * sWorld.m_creatureUpdateFarDistance;
+	float closest = farDist, dist;
+	for(unordered_set<Player*>::iterator itr = ctr->GetInRangePlayerSetBegin(); itr != ctr->GetInRangePlayerSetEnd(); ++itr)
+	{
+		dist = ctr->GetDistance2dSq(*itr);
+		if(dist < nearDist)
+			return 0;
+		if(dist < closest)
+			closest = dist;
+	}
+
+	return closest < farDist ? sWorld.m_creatureUpdateMidInterval : sWorld.m_creatureUpdateFarInterval;
+}
+
 void MapMgr::EventCorpseDespawn(uint64 guid)
 {
 	objmgr.DespawnCorpse(guid);
@@ -192,6 +192,13 @@ public:
 	void PushStaticObject(Object* obj);
 	void RemoveObject(Object* obj, bool free_guid);
 	void ChangeObjectLocation(Object* obj); // update inrange lists
+
+	// Traps and aura generators: checked when a unit moves instead of scanning every tick
+	void AddTriggerVolume(GameObject* go);
+	void RemoveTriggerVolume(GameObject* go);
+	void UpdateTriggerVolume(GameObject* go, Unit* pUnit);
+	// Every position change, however small, from is where the unit was before it
+	void UpdateTriggerVolumes(Unit* pUnit, const LocationVector & from);
 	void ChangeFarsightLocation(Player* plr, Unit* farsight, bool apply);
 	void ChangeFarsightLocation(Player* plr, float X, float Y, bool apply);
 	bool IsInRange(float fRange, Object* obj, Object* currentobj);
@@ -230,9 +237,19 @@ public:
 
 	void UpdateAllCells(bool apply, uint32 areamask = 0);
 	HEARTHSTONE_INLINE size_t GetPlayerCount() { return m_PlayerStorage.size(); }
+	void AddMetrics(MapMetrics & metrics);
 
 	void _PerformObjectDuties();
+	uint32 GetCreatureUpdateDelay(Creature* ctr);
 	uint32 mLoopCounter;
+
+	// tick timings for the mapticks console command, written by the map thread only
+	uint32 m_tickCount;
+	uint64 m_tickTotalTime;
+	uint32 m_tickMaxTime;
+	uint64 m_creatureUpdates;
+	uint64 m_creatureDeferrals;
+	HEARTHSTONE_INLINE void ResetTickStats() { m_tickCount = m_tickMaxTime = 0; m_tickTotalTime = m_creatureUpdates = m_creatureDeferrals = 0; }
 	uint32 lastGameobjectUpdate;
 	uint32 lastDynamicUpdate;
 	uint32 lastUnitUpdate;
@@ -271,6 +288,9 @@ public:
 		OnShutdown();
 	}
 
+	// The map whose thread is calling, NULL on any other thread
+	static MapMgr* GetThreadMapMgr();
+
 	// kill the worker thread only
 	void KillThread()
 	{
@@ -293,6 +313,11 @@ private:
 
 	bool _CellActive(uint32 x, uint32 y);
 	void UpdateInRangeSet(Object* obj, Player* plObj, MapCell* cell);
+
+	// by cell, a volume is listed in every cell it overlaps
+	typedef std::vector<GameObject*> TriggerVolumeList;
+	typedef HM_NAMESPACE::hash_map<uint32, TriggerVolumeList> TriggerVolumeMap;
+	TriggerVolumeMap m_triggerVolumes;
 	void UpdateInRangeSet(uint64 guid, MapCell* cell);
 
 public:
@@ -78,6 +78,14 @@ bool StartConsoleListener();
 void CloseConsoleListener();
 ThreadContext * GetConsoleListener();
 
+static void TrimObjectPools()
+{
+	ObjectPool<Spell>::Trim();
+	ObjectPool<Aura>::Trim();
+	WorldPacketPool::ReleaseThreadCache();
+	ServerMetrics::ReleaseThreadTable();
+}
+
 bool Master::Run(int argc, char ** argv)
 {
 	m_stopEvent = false;
@@ -229,6 +237,9 @@ bool Master::Run(int argc, char ** argv)
 	new EventMgr();
 	EventableObjectHolder* m_Holder = new EventableObjectHolder(-1);
 
+	// Map threads come and go with their instances, don't leave their pooled blocks behind
+	ThreadPool.SetThreadExitHandler(&TrimObjectPools);
+
 	new World();
 
 	/* load the config file */
@@ -400,6 +411,12 @@ bool Master::Run(int argc, char ** argv)
 	Log.Notice("MailSystem", "~MailSystem()");
 	delete MailSystem::getSingletonPtr();
 
+	if(sWorld.Collision)
+	{
+		Log.Notice("CollideInterface", "Stopping tile loader...");
+		CollideInterface.DeInit();
+	}
+
 	/* Shut down console system */
 	CloseConsoleListener();
 	console->terminate();
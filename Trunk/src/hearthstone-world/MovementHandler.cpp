@@ -346,10 +346,16 @@ void WorldSession::HandleMovementOpcodes( WorldPacket & recv_data )
 		/************************************************************************/
 		/* Distribute to all inrange players.                                   */
 		/************************************************************************/
+		// Heartbeats only carry position, far away players can do with fewer of them
+		const MovementLODSettings & lod = sWorld.GetMovementLOD(GetMovementLODMapType(_player->GetMapMgr()->GetMapInfo()->type));
+		bool decimate = (lod.Enabled && recv_data.GetOpcode() == MSG_MOVE_HEARTBEAT);
 		for(unordered_set<Player*  >::iterator itr = _player->m_inRangePlayers.begin(); itr != _player->m_inRangePlayers.end(); itr++)
 		{
 			if( (*itr)->GetSession() && (*itr)->IsInWorld() )
 			{
+				if(decimate && !lod.ShouldRelay(_player->GetDistanceSq(*itr), mstime, _player->m_movementRelayTimes[(*itr)->GetLowGUID()]))
+					continue;
+
 				*(uint32*)&_player->movement_packet[pos+6] = uint32(move_time + (*itr)->GetSession()->m_moveDelayTime);
 				(*itr)->GetSession()->OutPacket(recv_data.GetOpcode(), uint16(recv_data.size() + pos), _player->movement_packet);
 			}
@@ -0,0 +1,45 @@
+/***
+ * Demonstrike Core
+ */
+
+#include "StdAfx.h"
+
+void ParseMovementLODSettings(MovementLODSettings & settings, const char * str)
+{
+	float nearDist = 0.0f, farDist = 0.0f;
+	uint32 midInterval = 0, farInterval = 0;
+	settings.Enabled = (sscanf(str, "%f %f %u %u", &nearDist, &farDist, &midInterval, &farInterval) == 4 && nearDist > 0.0f);
+	if(!settings.Enabled)
+	{
+		settings.NearDistSq = settings.FarDistSq = 0.0f;
+		settings.MidInterval = settings.FarInterval = 0;
+		return;
+	}
+
+	if(farDist < nearDist)
+		farDist = nearDist;
+	if(farInterval < midInterval)
+		farInterval = midInterval;
+	if(midInterval <= MOVEMENT_HEARTBEAT_INTERVAL)
+		Log.Warning("MovementLOD", "\"%s\": intervals of %u ms or less relay every heartbeat anyway.", str, MOVEMENT_HEARTBEAT_INTERVAL);
+
+	settings.NearDistSq = nearDist * nearDist;
+	settings.FarDistSq = farDist * farDist;
+	settings.MidInterval = midInterval;
+	settings.FarInterval = farInterval;
+}
+
+uint32 GetMovementLODMapType(uint32 instanceType)
+{
+	switch(instanceType)
+	{
+	case INSTANCE_RAID:
+		return MOVEMENT_LOD_RAID;
+	case INSTANCE_NONRAID:
+	case INSTANCE_MULTIMODE:
+		return MOVEMENT_LOD_DUNGEON;
+	case INSTANCE_PVP:
+		return MOVEMENT_LOD_BATTLEGROUND;
+	}
+	return MOVEMENT_LOD_CONTINENT;
+}
@@ -0,0 +1,53 @@
+/***
+ * Demonstrike Core
+ */
+
+#pragma once
+
+/************************************************************************/
+/* Movement relay level of detail                                       */
+/************************************************************************/
+// Players close to a mover get every movement packet it sends. Further out,
+// heartbeats are only relayed once per interval; the next one sent carries the
+// latest position, so nothing is lost but the in-between points. Anything that
+// changes the movement state (start, stop, jump, facing...) always goes out.
+
+enum MovementLODMapType
+{
+	MOVEMENT_LOD_CONTINENT		= 0,
+	MOVEMENT_LOD_DUNGEON		= 1,
+	MOVEMENT_LOD_RAID			= 2,
+	MOVEMENT_LOD_BATTLEGROUND	= 3,
+	NUM_MOVEMENT_LOD_TYPES,
+};
+
+// Moving clients send a heartbeat about this often (ms). Relay intervals at or
+// below it drop nothing, so useful ones are well above it.
+#define MOVEMENT_HEARTBEAT_INTERVAL 500
+
+struct MovementLODSettings
+{
+	bool Enabled;
+	float NearDistSq;		// full rate inside this
+	float FarDistSq;		// MidInterval inside this, FarInterval beyond
+	uint32 MidInterval;
+	uint32 FarInterval;
+
+	// Whether a heartbeat goes to a viewer distSq away, lastSent is the viewer's last relay time
+	HEARTHSTONE_INLINE bool ShouldRelay(float distSq, uint32 now, uint32 & lastSent) const
+	{
+		if(distSq <= NearDistSq)
+			return true;
+
+		uint32 interval = (distSq <= FarDistSq ? MidInterval : FarInterval);
+		if(now - lastSent < interval)
+			return false;
+
+		lastSent = now;
+		return true;
+	}
+};
+
+// Reads "near far midInterval farInterval", anything else disables the level of detail
+void ParseMovementLODSettings(MovementLODSettings & settings, const char * str);
+uint32 GetMovementLODMapType(uint32 instanceType);
@@ -10,6 +10,7 @@ void CNavMeshInterface::Init()
 {
 	Log.Notice("NavMeshInterface", "Init");
 	memset( MMaps, 0, sizeof(MMapManager*)*NUM_MAPS );
+	MMapManager::InitFilters();
 }
 
 void CNavMeshInterface::DeInit()
@@ -66,14 +67,66 @@ LocationVectorMapContainer* CNavMeshInterface::BuildFullPath(Unit* m_Unit, uint3
 
 float CNavMeshInterface::GetWalkingHeight(uint32 mapid, float x, float y, float z, float z2)
 {
-	LocationVector Step;
+	// Anything between the two heights, closest to the first
 	float height = MMAP_UNAVAILABLE;
 	MMapManager* mmap = GetOrCreateMMapManager(mapid);
-	if(mmap->GetWalkingHeightInternal(x, y, z, z2, Step))
-		height = Step.z;
+	if(!mmap->GetHeight(x, y, z, std::max(fabs(z - z2), 4.0f), height, MMapManager::GetFilter(NAV_FILTER_ALL)))
+		height = MMAP_UNAVAILABLE;
 	return height;
 }
 
+float CNavMeshInterface::GetHeight(uint32 mapid, float x, float y, float z, float maxSearchDist)
+{
+	float height = MMAP_UNAVAILABLE;
+	MMapManager* mmap = GetOrCreateMMapManager(mapid);
+	if(!mmap->GetHeight(x, y, z, maxSearchDist, height, MMapManager::GetFilter(NAV_FILTER_ALL)))
+		height = MMAP_UNAVAILABLE;
+	return height;
+}
+
+bool CNavMeshInterface::IsWalkable(uint32 mapid, float x, float y, float z, Unit* unit)
+{
+	MMapManager* mmap = GetOrCreateMMapManager(mapid);
+	return mmap->IsWalkable(x, y, z, MMapManager::GetFilter(unit));
+}
+
+bool CNavMeshInterface::Raycast(uint32 mapid, float startx, float starty, float startz, float endx, float endy, float endz, LocationVector& hit, Unit* unit)
+{
+	MMapManager* mmap = GetOrCreateMMapManager(mapid);
+	return mmap->Raycast(startx, starty, startz, endx, endy, endz, hit, MMapManager::GetFilter(unit));
+}
+
+static dtQueryFilter NavMeshFilters[NUM_NAV_FILTERS];
+
+void MMapManager::InitFilters()
+{
+	NavMeshFilters[NAV_FILTER_GROUND].setIncludeFlags(NAV_GROUND);
+	NavMeshFilters[NAV_FILTER_GROUND_WATER].setIncludeFlags(NAV_GROUND | NAV_WATER);
+	NavMeshFilters[NAV_FILTER_LIQUIDS].setIncludeFlags(NAV_GROUND | NAV_WATER | NAV_MAGMA | NAV_SLIME);
+}
+
+const dtQueryFilter* MMapManager::GetFilter(NavMeshFilterType type)
+{
+	return &NavMeshFilters[type];
+}
+
+const dtQueryFilter* MMapManager::GetFilter(Unit* unit)
+{
+	if(unit == NULL)
+		return &NavMeshFilters[NAV_FILTER_ALL];
+
+	if (unit->GetTypeId() == TYPEID_UNIT)
+	{
+		// creatures don't take environmental damage
+		if (TO_CREATURE(unit)->GetCanMove() & LIMIT_WATER)
+			return &NavMeshFilters[NAV_FILTER_LIQUIDS];
+		return &NavMeshFilters[NAV_FILTER_GROUND];
+	}
+
+	// perfect support not possible for players, just stay 'safe'
+	return &NavMeshFilters[NAV_FILTER_GROUND_WATER];
+}
+
 MMapManager::MMapManager(uint32 mapid)
 {
 	lastTileRef = 0;
@@ -287,71 +340,8 @@ bool MMapManager::IsNavmeshLoaded(uint32 x, uint32 y)
 
 LocationVector MMapManager::getNextPositionOnPathToLocation(float startx, float starty, float startz, float endx, float endy, float endz)
 {
-	if(m_navMesh == NULL)
-		return LocationVector(endx, endy, endz);
-
-	//convert to nav coords.
-	float startPos[3] = { starty, startz, startx };
-	float endPos[3] = { endy, endz, endx };
-	float mPolyPickingExtents[3] = { 2.00f, 4.00f, 2.00f };
-	float closestPoint[3] = {0.0f, 0.0f, 0.0f};
-	LocationVector pos;
-	pos.x = endx;
-	pos.y = endy;
-	pos.z = endz;
-	dtStatus result;
-	dtQueryFilter* mPathFilter = new dtQueryFilter();
-	if(mPathFilter)
-	{
-		dtPolyRef mStartRef;
-		result = m_navMeshQuery->findNearestPoly(startPos, mPolyPickingExtents, mPathFilter, &mStartRef, closestPoint);
-		if(result != DT_SUCCESS || !mStartRef)
-		{
-			delete mPathFilter;
-			mPathFilter = NULL;
-			return pos;
-		}
-
-		dtPolyRef mEndRef;
-		result = m_navMeshQuery->findNearestPoly(endPos, mPolyPickingExtents, mPathFilter, &mEndRef, closestPoint);
-		if(result != DT_SUCCESS || !mEndRef)
-		{
-			delete mPathFilter;
-			mPathFilter = NULL;
-			return pos;
-		}
-
-		if (mStartRef != 0 && mEndRef != 0)
-		{
-			int mNumPathResults;
-			dtPolyRef mPathResults[50];
-			result = m_navMeshQuery->findPath(mStartRef, mEndRef,startPos, endPos, mPathFilter, mPathResults, &mNumPathResults, 50);
-			if(result != DT_SUCCESS || mNumPathResults <= 0)
-			{
-				delete mPathFilter;
-				mPathFilter = NULL;
-				return pos;
-			}
-
-			int mNumPathPoints;
-			float actualpath[3*20];
-			dtPolyRef polyrefs = 0;
-			result = m_navMeshQuery->findStraightPath(startPos, endPos, mPathResults, mNumPathResults, actualpath, NULL, &polyrefs, &mNumPathPoints, 20);
-			if (result != DT_SUCCESS /*|| mNumPathPoints < 3*/)
-			{
-				delete mPathFilter;
-				mPathFilter = NULL;
-				return pos;
-			}
-
-			pos.y = actualpath[3]; //0 3 6
-			pos.z = actualpath[4]; //1 4 7
-			pos.x = actualpath[5]; //2 5 8
-			delete mPathFilter;
-			mPathFilter = NULL;
-			return pos;
-		}
-	}
+	LocationVector pos(endx, endy, endz);
+	getNextPositionOnPathToLocation(startx, starty, startz, endx, endy, endz, pos);
 	return pos;
 }
 
@@ -360,65 +350,38 @@ bool MMapManager::getNextPositionOnPathToLocation(float startx, float starty, fl
 	if(m_navMesh == NULL)
 		return false;
 
-	dtStatus result;
 	//convert to nav coords.
 	float startPos[3] = { starty, startz, startx };
 	float endPos[3] = { endy, endz, endx };
 	float mPolyPickingExtents[3] = { 2.00f, 4.00f, 2.00f };
 	float closestPoint[3] = {0.0f, 0.0f, 0.0f};
-	dtQueryFilter* mPathFilter = new dtQueryFilter();
-	if(mPathFilter)
-	{
-		dtPolyRef mStartRef;
-		result = m_navMeshQuery->findNearestPoly(startPos, mPolyPickingExtents, mPathFilter, &mStartRef, closestPoint);
-		if(result != DT_SUCCESS || !mStartRef)
-		{
-			delete mPathFilter;
-			mPathFilter = NULL;
-			return false;
-		}
+	const dtQueryFilter* mPathFilter = GetFilter(NAV_FILTER_ALL);
 
-		dtPolyRef mEndRef;
-		result = m_navMeshQuery->findNearestPoly(endPos, mPolyPickingExtents, mPathFilter, &mEndRef, closestPoint);
-		if(result != DT_SUCCESS || !mEndRef)
-		{
-			delete mPathFilter;
-			mPathFilter = NULL;
-			return false;
-		}
+	dtPolyRef mStartRef = findNearestPoly(startPos, mPolyPickingExtents, mPathFilter, closestPoint);
+	if(!mStartRef)
+		return false;
 
-		if (mStartRef != 0 && mEndRef != 0)
-		{
-			int mNumPathResults;
-			dtPolyRef mPathResults[50];
-			result = m_navMeshQuery->findPath(mStartRef, mEndRef,startPos, endPos, mPathFilter, mPathResults, &mNumPathResults, 50);
-			if(result != DT_SUCCESS || mNumPathResults <= 0)
-			{
-				delete mPathFilter;
-				mPathFilter = NULL;
-				return false;
-			}
+	dtPolyRef mEndRef = findNearestPoly(endPos, mPolyPickingExtents, mPathFilter, closestPoint);
+	if(!mEndRef)
+		return false;
 
-			int mNumPathPoints;
-			float actualpath[3*20];
-			dtPolyRef polyrefs = 0;
-			result = m_navMeshQuery->findStraightPath(startPos, endPos, mPathResults, mNumPathResults, actualpath, NULL, &polyrefs, &mNumPathPoints, 20);
-			if (result != DT_SUCCESS /*|| mNumPathPoints < 3*/)
-			{
-				delete mPathFilter;
-				mPathFilter = NULL;
-				return false;
-			}
+	int mNumPathResults;
+	dtPolyRef mPathResults[50];
+	dtStatus result = m_navMeshQuery->findPath(mStartRef, mEndRef,startPos, endPos, mPathFilter, mPathResults, &mNumPathResults, 50);
+	if(result != DT_SUCCESS || mNumPathResults <= 0)
+		return false;
 
-			out.y = actualpath[3]; //0 3 6
-			out.z = actualpath[4]; //1 4 7
-			out.x = actualpath[5]; //2 5 8
-			delete mPathFilter;
-			mPathFilter = NULL;
-			return true;
-		}
-	}
-	return false;
+	int mNumPathPoints;
+	float actualpath[3*20];
+	dtPolyRef polyrefs = 0;
+	result = m_navMeshQuery->findStraightPath(startPos, endPos, mPathResults, mNumPathResults, actualpath, NULL, &polyrefs, &mNumPathPoints, 20);
+	if (result != DT_SUCCESS /*|| mNumPathPoints < 3*/)
+		return false;
+
+	out.y = actualpath[3]; //0 3 6
+	out.z = actualpath[4]; //1 4 7
+	out.x = actualpath[5]; //2 5 8
+	return true;
 }
 
 LocationVector MMapManager::getBestPositionOnPathToLocation(float startx, float starty, float startz, float endx, float endy, float endz)
@@ -534,7 +497,7 @@ bool MMapManager::getSteerTarget(float* startPos, float* endPos, float minTarget
 	return true;
 }
 
-dtStatus MMapManager::findSmoothPath(dtQueryFilter* m_filter, float* startPos, float* endPos, dtPolyRef* polyPath, uint32 polyPathSize, float* smoothPath, int* smoothPathSize, bool &usedOffmesh, const uint32 maxSmoothPathSize)
+dtStatus MMapManager::findSmoothPath(const dtQueryFilter* m_filter, float* startPos, float* endPos, dtPolyRef* polyPath, uint32 polyPathSize, float* smoothPath, int* smoothPathSize, bool &usedOffmesh, const uint32 maxSmoothPathSize)
 {
 	ASSERT(polyPathSize <= 64);
 	*smoothPathSize = 0;
@@ -661,22 +624,7 @@ LocationVectorMapContainer* MMapManager::BuildFullPath(Unit* m_Unit, float start
 	if(m_navMesh == NULL)
 		return NULL;
 
-	dtQueryFilter* mPathFilter = new dtQueryFilter();
-	unsigned short includeFlags = 0x01;
-
-	if (m_Unit->GetTypeId() == TYPEID_UNIT)
-	{
-		// creatures don't take environmental damage
-		Creature* creature = (Creature*)m_Unit;
-		if (creature->GetCanMove() & LIMIT_WATER)
-			includeFlags |= (0x08/*Water*/ | 0x02/*Magma*/ | 0x04/*Slime*/);
-	}
-	else if (m_Unit->GetTypeId() == TYPEID_PLAYER)
-	{
-		// perfect support not possible, just stay 'safe'
-		includeFlags |= 0x08;
-	}
-	mPathFilter->setIncludeFlags(includeFlags);
+	const dtQueryFilter* mPathFilter = GetFilter(m_Unit);
 
 	uint32 m_polyLength = 0;
 	dtPolyRef m_pathPolyRefs[64]; // array of detour polygon references
@@ -690,25 +638,15 @@ LocationVectorMapContainer* MMapManager::BuildFullPath(Unit* m_Unit, float start
 	dtStatus dtResult = DT_FAILURE;
 	bool usedOffmesh = false;
 
-	dtPolyRef mStartRef;
-	dtStatus result = m_navMeshQuery->findNearestPoly(startPoint, mPolyPickingExtents, mPathFilter, &mStartRef, closestPoint);
-	if(result != DT_SUCCESS || !mStartRef)
-	{
-		delete mPathFilter;
-		mPathFilter = NULL;
+	dtPolyRef mStartRef = findNearestPoly(startPoint, mPolyPickingExtents, mPathFilter, closestPoint);
+	if(!mStartRef)
 		return NULL;
-	}
 
-	dtPolyRef mEndRef;
-	result = m_navMeshQuery->findNearestPoly(endPoint, mPolyPickingExtents, mPathFilter, &mEndRef, closestPoint);
-	if(result != DT_SUCCESS || !mEndRef)
-	{
-		delete mPathFilter;
-		mPathFilter = NULL;
+	dtPolyRef mEndRef = findNearestPoly(endPoint, mPolyPickingExtents, mPathFilter, closestPoint);
+	if(!mEndRef)
 		return NULL;
-	}
 
-	result = m_navMeshQuery->findPath(
+	dtStatus result = m_navMeshQuery->findPath(
 		mStartRef,			// start polygon
 		mEndRef,			// end polygon
 		startPoint,			// start position
@@ -719,11 +657,7 @@ LocationVectorMapContainer* MMapManager::BuildFullPath(Unit* m_Unit, float start
 		64);   // max number of polygons in output path
 
 	if(result != DT_SUCCESS || !m_polyLength)
-	{
-		delete mPathFilter;
-		mPathFilter = NULL;
 		return NULL;
-	}
 
 	if (straight)
 	{
@@ -756,8 +690,6 @@ LocationVectorMapContainer* MMapManager::BuildFullPath(Unit* m_Unit, float start
 		// only happens if pass bad data to findStraightPath or navmesh is broken
 		// single point paths can be generated here
 		// TODO : check the exact cases
-		delete mPathFilter;
-		mPathFilter = NULL;
 		return NULL;
 	}
 
@@ -777,78 +709,102 @@ LocationVectorMapContainer* MMapManager::BuildFullPath(Unit* m_Unit, float start
 	return map;
 }
 
-bool MMapManager::GetWalkingHeightInternal(float positionx, float positiony, float positionz, float endz, LocationVector& out)
+dtPolyRef MMapManager::findNearestPoly(const float* navPos, const float* extents, const dtQueryFilter* filter, float* nearestPt)
+{
+	dtPolyRef ref = 0;
+	if(m_navMeshQuery->findNearestPoly(navPos, extents, filter, &ref, nearestPt) != DT_SUCCESS)
+		return 0;
+	return ref;
+}
+
+static bool GetHeightOnPoly(const dtNavMeshQuery* query, float x, float y, float z, float maxSearchDist, float& height, const dtQueryFilter* filter)
+{
+	//convert to nav coords.
+	float pos[3] = { y, z, x };
+	float extents[3] = { 2.00f, maxSearchDist, 2.00f };
+	float nearest[3] = {0.0f, 0.0f, 0.0f};
+	dtPolyRef ref = 0;
+	if(query->findNearestPoly(pos, extents, filter, &ref, nearest) != DT_SUCCESS || !ref)
+		return false;
+
+	// The nearest point is clamped onto the poly, if we stand over it take the height right below us
+	if(query->getPolyHeight(ref, pos, &height) != DT_SUCCESS)
+		height = nearest[1];
+	return true;
+}
+
+bool MMapManager::GetHeight(float x, float y, float z, float maxSearchDist, float& height, const dtQueryFilter* filter)
 {
 	if(m_navMesh == NULL)
 		return false;
+	return GetHeightOnPoly(m_navMeshQuery, x, y, z, maxSearchDist, height, filter);
+}
 
-	dtStatus result;
-	//convert to nav coords.
-	float startPos[3] = { positionx, positiony, positionz };
-	float endPos[3] = { positionx, positiony, endz };
-	float mPolyPickingExtents[3] = { 2.00f, 2.00f, 4.00f };
-	float closestPoint[3] = {0.0f, 0.0f, 0.0f};
-	dtQueryFilter* mPathFilter = new dtQueryFilter();
-	if(mPathFilter)
-	{
-		dtPolyRef mStartRef;
-		result = m_navMeshQuery->findNearestPoly(startPos, mPolyPickingExtents, mPathFilter, &mStartRef, closestPoint);
-		if(result != DT_SUCCESS || !mStartRef)
-		{
-			delete mPathFilter;
-			mPathFilter = NULL;
-			return false;
-		}
+bool MMapManager::IsWalkable(float x, float y, float z, const dtQueryFilter* filter)
+{
+	if(m_navMesh == NULL)
+		return false;
 
-		dtPolyRef mEndRef;
-		result = m_navMeshQuery->findNearestPoly(endPos, mPolyPickingExtents, mPathFilter, &mEndRef, closestPoint);
-		if(result != DT_SUCCESS || !mEndRef)
-		{
-			delete mPathFilter;
-			mPathFilter = NULL;
-			return false;
-		}
+	float pos[3] = { y, z, x };
+	float extents[3] = { 0.50f, 2.00f, 0.50f };
+	float nearest[3] = {0.0f, 0.0f, 0.0f};
+	dtPolyRef ref = findNearestPoly(pos, extents, filter, nearest);
+	if(!ref)
+		return false;
 
-		if (mStartRef != 0 && mEndRef != 0)
-		{
-			int mNumPathResults;
-			dtPolyRef mPathResults[50];
-			result = m_navMeshQuery->findPath(mStartRef, mEndRef,startPos, endPos, mPathFilter, mPathResults, &mNumPathResults, 50);
-			if(result != DT_SUCCESS || mNumPathResults <= 0)
-			{
-				delete mPathFilter;
-				mPathFilter = NULL;
-				return false;
-			}
+	float height;
+	if(m_navMeshQuery->getPolyHeight(ref, pos, &height) != DT_SUCCESS)
+		return false;
+	return fabs(height - z) < 2.0f;
+}
 
-			int mNumPathPoints;
-			float actualpath[3*2];
-			dtPolyRef polyrefs = 0;
-			result = m_navMeshQuery->findStraightPath(startPos, endPos, mPathResults, mNumPathResults, actualpath, NULL, &polyrefs, &mNumPathPoints, 2);
-			if (result != DT_SUCCESS)
-			{
-				delete mPathFilter;
-				mPathFilter = NULL;
-				return false;
-			}
+static const uint32 MAX_RAYCAST_POLYS = 64;
 
-			if(mNumPathPoints < 3)
-			{
-				out.y = positiony;
-				out.z = positionz;
-				out.x = positionx;
-				delete mPathFilter;
-				mPathFilter = NULL;
-				return true;
-			}
+bool MMapManager::Raycast(float startx, float starty, float startz, float endx, float endy, float endz, LocationVector& hit, const dtQueryFilter* filter)
+{
+	if(m_navMesh == NULL)
+		return false;
 
-			out.y = actualpath[3];
-			out.z = actualpath[4];
-			out.x = actualpath[5];
-			delete mPathFilter;
-			mPathFilter = NULL;
-			return true;
-		}
+	float startPos[3] = { starty, startz, startx };
+	float endPos[3] = { endy, endz, endx };
+	float mPolyPickingExtents[3] = { 2.00f, 4.00f, 2.00f };
+	float start[3] = {0.0f, 0.0f, 0.0f};
+	dtPolyRef startRef = findNearestPoly(startPos, mPolyPickingExtents, filter, start);
+	if(!startRef)
+		return false;
+
+	float t = 0.0f, hitNormal[3];
+	int nvisited = 0;
+	dtPolyRef visited[MAX_RAYCAST_POLYS];
+	if(m_navMeshQuery->raycast(startRef, start, endPos, filter, &t, hitNormal, visited, &nvisited, MAX_RAYCAST_POLYS) != DT_SUCCESS)
+		return false;
+
+	float delta[3];
+	dtsub(delta, endPos, start);
+	if(t > 1.0f) // FLT_MAX, nothing in the way
+		t = 1.0f;
+	else
+	{
+		// Stop short of the wall instead of inside it
+		float len = sqrtf(delta[0]*delta[0] + delta[2]*delta[2]);
+		t = len > 0.5f ? std::max(t - 0.5f / len, 0.0f) : 0.0f;
+	}
+
+	float hitPos[3];
+	dtmad(hitPos, start, delta, t);
+
+	// The ray only runs along the surface, take the height from the last poly it crossed
+	dtPolyRef lastRef = (nvisited > 0 && nvisited < int(MAX_RAYCAST_POLYS)) ? visited[nvisited-1] : startRef;
+	if(m_navMeshQuery->getPolyHeight(lastRef, hitPos, &hitPos[1]) != DT_SUCCESS)
+	{
+		float nearest[3];
+		dtPolyRef ref = findNearestPoly(hitPos, mPolyPickingExtents, filter, nearest);
+		if(ref)
+			hitPos[1] = nearest[1];
 	}
-	return false;
+
+	hit.x = hitPos[2];
+	hit.y = hitPos[0];
+	hit.z = hitPos[1];
+	return true;
 }
@@ -28,6 +28,25 @@ struct TileReferenceC
 	dtTileRef ID;
 };
 
+// Poly flags written by the mmap generator
+enum NavTerrainFlags
+{
+	NAV_GROUND	= 0x01,
+	NAV_MAGMA	= 0x02,
+	NAV_SLIME	= 0x04,
+	NAV_WATER	= 0x08,
+};
+
+// Query filters are built once and shared, a query never changes them
+enum NavMeshFilterType
+{
+	NAV_FILTER_ALL,				// every poly
+	NAV_FILTER_GROUND,			// creatures that stay out of liquids
+	NAV_FILTER_GROUND_WATER,	// players, who take damage in magma and slime
+	NAV_FILTER_LIQUIDS,			// creatures that can swim, no environmental damage
+	NUM_NAV_FILTERS
+};
+
 typedef map<uint32, TileReferenceC*> ReferenceMap;
 typedef map<dtTileRef, uint32> ReverseReferenceMap;
 
@@ -48,6 +67,10 @@ public:
 	MMapManager(uint32 mapid);
 	~MMapManager();
 
+	static void InitFilters();
+	static const dtQueryFilter* GetFilter(NavMeshFilterType type);
+	static const dtQueryFilter* GetFilter(Unit* unit);
+
 private:
 //	Mutex m_Lock; // One day we'll need this, but for now, it's our silent knight, always watching...
 	uint32 ManagerMapId;
@@ -70,13 +93,22 @@ public:
 	// Smooth pathing
 	uint32 fixupCorridor(dtPolyRef* path, uint32 npath, uint32 maxPath, dtPolyRef* visited, uint32 nvisited);
 	bool getSteerTarget(float* startPos, float* endPos, float minTargetDist, dtPolyRef* path, uint32 pathSize, float* steerPos, unsigned char& steerPosFlag, dtPolyRef& steerPosRef);
-	dtStatus findSmoothPath(dtQueryFilter* m_filter, float* startPos, float* endPos, dtPolyRef* polyPath, uint32 polyPathSize, float* smoothPath, int* smoothPathSize, bool &usedOffmesh, uint32 smoothPathMaxSize);
+	dtStatus findSmoothPath(const dtQueryFilter* m_filter, float* startPos, float* endPos, dtPolyRef* polyPath, uint32 polyPathSize, float* smoothPath, int* smoothPathSize, bool &usedOffmesh, uint32 smoothPathMaxSize);
+
+	// Point queries, positions in world coordinates. They only look at the polys around the point,
+	// no path search, so they are cheap enough to run per movement update.
+	bool GetHeight(float x, float y, float z, float maxSearchDist, float& height, const dtQueryFilter* filter);
+	bool IsWalkable(float x, float y, float z, const dtQueryFilter* filter);
+	// Walks the surface from start towards end and sets hit to the furthest point reachable in a straight line,
+	// which is end itself if nothing is in the way. False only if the start isn't on the navmesh.
+	bool Raycast(float startx, float starty, float startz, float endx, float endy, float endz, LocationVector& hit, const dtQueryFilter* filter);
 
-	bool GetWalkingHeightInternal(float startx, float starty, float startz, float endz, LocationVector& out);
 	bool getNextPositionOnPathToLocation(float startx, float starty, float startz, float endx, float endy, float endz, LocationVector& out);
 
 	static float calcAngle( float Position1X, float Position1Y, float Position2X, float Position2Y );
 private:
+	dtPolyRef findNearestPoly(const float* navPos, const float* extents, const dtQueryFilter* filter, float* nearestPt);
+
 	bool inRangeYZX(float* v1, float* v2, float r, float h)
 	{
 		float dx = v2[0] - v1[0];
@@ -126,6 +158,9 @@ public: // Navmesh settings
 	bool IsNavmeshLoadedAtPosition(uint32 mapid, float x, float y) { if(!AreCoordinatesValid(x, y)) return false; return IsNavmeshLoaded(mapid, (GetPosX(x)/8), (GetPosY(y)/8)); };
 
 	float GetWalkingHeight(uint32 mapid, float positionx, float positiony, float positionz, float positionz2);
+	float GetHeight(uint32 mapid, float x, float y, float z, float maxSearchDist = 4.0f);
+	bool IsWalkable(uint32 mapid, float x, float y, float z, Unit* unit = NULL);
+	bool Raycast(uint32 mapid, float startx, float starty, float startz, float endx, float endy, float endz, LocationVector& hit, Unit* unit = NULL);
 	bool BuildPath(uint32 mapid, float startx, float starty, float startz, float endx, float endy, float endz, LocationVector& out);
 	LocationVector BuildPath(uint32 mapid, float startx, float starty, float startz, float endx, float endy, float endz, bool best = false);
 	LocationVectorMapContainer* BuildFullPath(Unit* m_Unit, uint32 mapid, float startx, float starty, float startz, float endx, float endy, float endz, bool straight = true);
@@ -1139,6 +1139,7 @@ WorldPacket * Object::BuildTeleportAckMsg(const LocationVector & v)
 bool Object::SetPosition(const LocationVector & v, bool allowPorting /* = false */)
 {
 	bool updateMap = false, result = true;
+	LocationVector from = m_position;
 
 	if (m_position.x != v.x || m_position.y != v.y)
 		updateMap = true;
@@ -1162,12 +1163,16 @@ bool Object::SetPosition(const LocationVector & v, bool allowPorting /* = false
 		m_mapMgr->ChangeObjectLocation(this);
 	}
 
+	if (IsInWorld() && IsUnit())
+		m_mapMgr->UpdateTriggerVolumes(TO_UNIT(this), from);
+
 	return result;
 }
 
 bool Object::SetPosition( float newX, float newY, float newZ, float newOrientation, bool allowPorting )
 {
 	bool updateMap = false, result = true;
+	LocationVector from = m_position;
 
 	//if (m_position.x != newX || m_position.y != newY)
 		//updateMap = true;
@@ -1196,6 +1201,10 @@ bool Object::SetPosition( float newX, float newY, float newZ, float newOrientati
 		}
 	}
 
+	// Traps are small, they are checked on every step rather than every 2 yards
+	if (IsInWorld() && IsUnit())
+		m_mapMgr->UpdateTriggerVolumes(TO_UNIT(this), from);
+
 	return result;
 }
 
@@ -2212,6 +2221,8 @@ int32 Object::DealDamage(Unit* pVictim, uint32 damage, uint32 targetEvent, uint3
 		return 0;
 	if( pVictim->IsSpiritHealer() )
 		return 0;
+	if( pVictim->IsCreature() )
+		TO_CREATURE(pVictim)->WakeForUpdate();
 
 	if( pVictim->GetStandState() )//not standing-> standup
 		pVictim->SetStandState( STANDSTATE_STAND );//probably mobs also must standup
@@ -3342,7 +3353,11 @@ void Object::Activate(MapMgr* mgr)
 		if(IsVehicle())
 			mgr->activeVehicles.insert(TO_VEHICLE(this));
 		else
+		{
+			TO_CREATURE(this)->m_updateDeferUntil = 0;
+			TO_CREATURE(this)->m_deferredUpdateTime = 0;
 			mgr->activeCreatures.insert(TO_CREATURE(this));
+		}
 		break;
 
 	case TYPEID_GAMEOBJECT:
@@ -6,8 +6,23 @@
 
 initialiseSingleton( ObjectMgr );
 
-ObjectMgr::ObjectMgr()
-{
+#define PLAYERINFO_FIELDS "guid,name,race,class,level,gender,zoneId,timestamp,acct,instance_id,mapId,positionX,positionY,positionZ,orientation"
+#define PLAYERINFO_LOAD_BATCH 100
+#define PLAYERINFO_IDLE_TIME 600
+#define PLAYERINFO_GRAVEYARD_TIME 600
+#define PLAYERINFO_TRIM_INTERVAL 300
+
+ObjectMgr::ObjectMgr() : m_playerInfoLoadCond(&m_playerInfoLoadLock)
+{
+	_playerslock.SetLockName("ObjectMgr::_playerslock");
+	playernamelock.SetLockName("ObjectMgr::playernamelock");
+	m_groupLock.SetLockName("ObjectMgr::m_groupLock");
+	_corpseslock.SetLockName("ObjectMgr::_corpseslock");
+	m_petlock.SetLockName("ObjectMgr::m_petlock");
+	m_playerguidlock.SetLockName("ObjectMgr::m_playerguidlock");
+	m_guidGenMutex.SetLockName("ObjectMgr::m_guidGenMutex");
+	m_CreatureSpawnIdMutex.SetLockName("ObjectMgr::m_CreatureSpawnIdMutex");
+
 	m_hiPetGuid = 0;
 	m_hiContainerGuid = 0;
 	m_hiItemGuid = 0;
@@ -19,6 +34,11 @@ ObjectMgr::ObjectMgr()
 	m_ticketid = 1;
 	m_equipmentSetGuid = 0;
 	mQuestPOIMap.clear();
+	m_playerInfoResidentDays = 0;
+	m_lastPlayerInfoTrim = 0;
+	m_playerInfoLoads = m_playerInfoEvictions = 0;
+	m_playerInfoLoaderRunning = false;
+	m_playerInfoLoaderShutdown = false;
 }
 
 ObjectMgr::~ObjectMgr()
@@ -140,6 +160,7 @@ ObjectMgr::~ObjectMgr()
 	}
 
 	Log.Notice("ObjectMgr", "Deleting Player Information...");
+	ShutdownPlayerInfoLoader();
 	for(HM_NAMESPACE::hash_map<uint32, PlayerInfo*>::iterator itr = m_playersinfo.begin(); itr != m_playersinfo.end(); itr++)
 	{
 		itr->second->m_Group = NULL;
@@ -147,6 +168,12 @@ ObjectMgr::~ObjectMgr()
 		delete itr->second;
 	}
 
+	for(list< pair<uint32, PlayerInfo*> >::iterator itr = m_playerInfoGraveyard.begin(); itr != m_playerInfoGraveyard.end(); ++itr)
+	{
+		free(itr->second->name);
+		delete itr->second;
+	}
+
 	Log.Notice("ObjectMgr", "Deleting GM Tickets...");
 	for(GmTicketList::iterator itr = GM_TicketList.begin(); itr != GM_TicketList.end(); itr++)
 		delete (*itr);
@@ -253,12 +280,18 @@ Group * ObjectMgr::GetGroupById(uint32 id)
 //
 // Player names
 //
-void ObjectMgr::DeletePlayerInfo( uint32 guid )
+void ObjectMgr::DeletePlayerInfo( uint32 guid, const char * name )
 {
 	PlayerInfo * pl;
 	HM_NAMESPACE::hash_map<uint32,PlayerInfo*>::iterator i;
 	PlayerNameStringIndexMap::iterator i2;
+	string pnam = string(name);
+	HEARTHSTONE_TOLOWER(pnam);
 	playernamelock.AcquireWriteLock();
+	i2 = m_playersInfoByName.find(pnam);
+	if( i2 != m_playersInfoByName.end() && i2->second == guid )
+		m_playersInfoByName.erase( i2 );
+
 	i=m_playersinfo.find(guid);
 	if(i==m_playersinfo.end())
 	{
@@ -273,12 +306,6 @@ void ObjectMgr::DeletePlayerInfo( uint32 guid )
 		pl->m_Group = NULL;
 	}
 
-	string pnam = string(pl->name);
-	HEARTHSTONE_TOLOWER(pnam);
-	i2 = m_playersInfoByName.find(pnam);
-	if( i2 != m_playersInfoByName.end() && i2->second == pl )
-		m_playersInfoByName.erase( i2 );
-
 	free(pl->name);
 	delete i->second;
 	m_playersinfo.erase(i);
@@ -286,27 +313,96 @@ void ObjectMgr::DeletePlayerInfo( uint32 guid )
 	playernamelock.ReleaseWriteLock();
 }
 
-PlayerInfo *ObjectMgr::GetPlayerInfo( uint32 guid )
+PlayerInfo *ObjectMgr::GetCachedPlayerInfo( uint32 guid )
 {
 	HM_NAMESPACE::hash_map<uint32,PlayerInfo*>::iterator i;
 	PlayerInfo * rv;
 	playernamelock.AcquireReadLock();
 	i=m_playersinfo.find(guid);
 	if(i!=m_playersinfo.end())
+	{
+		// Other readers may be doing the same, only the trim reads it and that holds the write lock
 		rv = i->second;
+		if(rv->lastAccess.GetVal() != (long)UNIXTIME)
+			rv->lastAccess.Exchange((long)UNIXTIME);
+	}
 	else
 		rv = NULL;
 	playernamelock.ReleaseReadLock();
 	return rv;
 }
 
+PlayerInfo *ObjectMgr::GetPlayerInfo( uint32 guid )
+{
+	PlayerInfo * rv = GetCachedPlayerInfo(guid);
+	if(rv == NULL && guid != 0)
+		LoadPlayerInfoAsync(guid, 0, NULL);
+	return rv;
+}
+
+PlayerInfo *ObjectMgr::LoadPlayerInfo( uint32 guid )
+{
+	PlayerInfo * rv = GetCachedPlayerInfo(guid);
+	if(rv != NULL || guid == 0)
+		return rv;
+
+	QueryResult * result = CharacterDatabase.Query("SELECT " PLAYERINFO_FIELDS " FROM characters WHERE guid = %u", guid);
+	if(result == NULL)
+		return NULL;
+
+	rv = _AddPlayerInfo(result->Fetch());
+	delete result;
+	return rv;
+}
+
+PlayerInfo * ObjectMgr::_AddPlayerInfo(Field * fields)
+{
+	PlayerInfo * pn = new PlayerInfo;
+	memset(pn, 0, sizeof(PlayerInfo));
+	pn->guid = fields[0].GetUInt32();
+	pn->name = strdup(fields[1].GetString());
+	pn->race = fields[2].GetUInt8();
+	pn->_class = fields[3].GetUInt8();
+	pn->lastLevel = fields[4].GetUInt32();
+	pn->gender = fields[5].GetUInt8();
+	pn->lastZone=fields[6].GetUInt32();
+	pn->lastOnline=fields[7].GetUInt32();
+	pn->acct = fields[8].GetUInt32();
+	pn->curInstanceID = fields[9].GetUInt32();
+	pn->lastmapid = fields[10].GetUInt32();
+	pn->lastpositionx = fields[11].GetFloat();
+	pn->lastpositiony = fields[12].GetFloat();
+	pn->lastpositionz = fields[13].GetFloat();
+	pn->lastorientation = fields[14].GetFloat();
+	pn->lastAccess.Exchange((long)UNIXTIME);
+	CharRaceEntry * race = dbcCharRace.LookupEntryForced(pn->race);
+	pn->team = race ? race->team_id : 0;
+
+	playernamelock.AcquireWriteLock();
+	HM_NAMESPACE::hash_map<uint32,PlayerInfo*>::iterator itr = m_playersinfo.find(pn->guid);
+	if(itr != m_playersinfo.end())
+	{
+		// Someone else loaded it first
+		playernamelock.ReleaseWriteLock();
+		free(pn->name);
+		delete pn;
+		return itr->second;
+	}
+
+	m_playersinfo[pn->guid] = pn;
+	++m_playerInfoLoads;
+	playernamelock.ReleaseWriteLock();
+	return pn;
+}
+
 void ObjectMgr::AddPlayerInfo(PlayerInfo *pn)
 {
+	pn->lastAccess.Exchange((long)UNIXTIME);
 	playernamelock.AcquireWriteLock();
 	m_playersinfo[pn->guid] =  pn ;
 	string pnam = string(pn->name);
 	HEARTHSTONE_TOLOWER(pnam);
-	m_playersInfoByName[pnam] = pn;
+	m_playersInfoByName[pnam] = pn->guid;
 	playernamelock.ReleaseWriteLock();
 }
 
@@ -317,15 +413,207 @@ void ObjectMgr::RenamePlayerInfo(PlayerInfo * pn, const char * oldname, const ch
 	HEARTHSTONE_TOLOWER(oldn);
 
 	PlayerNameStringIndexMap::iterator itr = m_playersInfoByName.find( oldn );
-	if( itr != m_playersInfoByName.end() && itr->second == pn )
+	if( itr != m_playersInfoByName.end() && itr->second == pn->guid )
 	{
 		string newn = string(newname);
 		HEARTHSTONE_TOLOWER(newn);
 		m_playersInfoByName.erase( itr );
-		m_playersInfoByName[newn] = pn;
+		m_playersInfoByName[newn] = pn->guid;
+	}
+
+	playernamelock.ReleaseWriteLock();
+}
+
+void ObjectMgr::LoadPlayerInfoAsync(uint32 guid, uint32 accountId, WorldPacket * replay)
+{
+	m_playerInfoLoadCond.BeginSynchronized();
+	if(!m_playerInfoLoaderRunning)
+	{
+		m_playerInfoLoadCond.EndSynchronized();
+		WorldPacketPool::Free(replay);
+		return;
+	}
+
+	map<uint32, list< pair<uint32, WorldPacket*> > >::iterator itr = m_playerInfoWaiters.find(guid);
+	if(itr == m_playerInfoWaiters.end())
+	{
+		itr = m_playerInfoWaiters.insert(make_pair(guid, list< pair<uint32, WorldPacket*> >())).first;
+		m_playerInfoLoadQueue.push_back(guid);
+		m_playerInfoLoadCond.Signal();
+	}
+	if(replay != NULL)
+		itr->second.push_back(make_pair(accountId, replay));
+	m_playerInfoLoadCond.EndSynchronized();
+}
+
+void ObjectMgr::ProcessPlayerInfoLoadQueue(vector<uint32> & guids)
+{
+	// One query for every guid that piled up while the last one ran
+	std::stringstream ss;
+	ss << "SELECT " PLAYERINFO_FIELDS " FROM characters WHERE guid IN(";
+	for(size_t i = 0; i < guids.size(); ++i)
+	{
+		if(i)
+			ss << ",";
+		ss << guids[i];
+	}
+	ss << ")";
+
+	QueryResult * result = CharacterDatabase.QueryNA(ss.str().c_str());
+	if(result != NULL)
+	{
+		do
+		{
+			_AddPlayerInfo(result->Fetch());
+		} while(result->NextRow());
+		delete result;
+	}
+
+	list< pair<uint32, WorldPacket*> > waiters;
+	list< pair<uint32, WorldPacket*> >::iterator witr;
+	for(size_t i = 0; i < guids.size(); ++i)
+	{
+		m_playerInfoLoadLock.Acquire();
+		map<uint32, list< pair<uint32, WorldPacket*> > >::iterator itr = m_playerInfoWaiters.find(guids[i]);
+		if(itr != m_playerInfoWaiters.end())
+		{
+			waiters.swap(itr->second);
+			m_playerInfoWaiters.erase(itr);
+		}
+		m_playerInfoLoadLock.Release();
+
+		// Nothing is sent from here, the sessions handle the packets again on their own threads.
+		// Not replaying for a character that doesn't exist keeps a bogus name query from looping.
+		bool found = (GetCachedPlayerInfo(guids[i]) != NULL);
+		for(witr = waiters.begin(); witr != waiters.end(); ++witr)
+		{
+			if(!found || !sWorld.QueueSessionPacket(witr->first, witr->second))
+				WorldPacketPool::Free(witr->second);
+		}
+		waiters.clear();
+	}
+}
+
+bool PlayerInfoLoaderThread::run()
+{
+	SetThreadName("PlayerInfoLoader");
+	vector<uint32> guids;
+	for(;;)
+	{
+		objmgr.m_playerInfoLoadCond.BeginSynchronized();
+		while(!objmgr.m_playerInfoLoaderShutdown && objmgr.m_playerInfoLoadQueue.empty())
+			objmgr.m_playerInfoLoadCond.Wait();
+
+		if(objmgr.m_playerInfoLoaderShutdown)
+		{
+			objmgr.m_playerInfoLoadCond.EndSynchronized();
+			break;
+		}
+
+		guids.clear();
+		while(objmgr.m_playerInfoLoadQueue.size() && guids.size() < PLAYERINFO_LOAD_BATCH)
+		{
+			guids.push_back(objmgr.m_playerInfoLoadQueue.front());
+			objmgr.m_playerInfoLoadQueue.pop_front();
+		}
+		objmgr.m_playerInfoLoadCond.EndSynchronized();
+
+		objmgr.ProcessPlayerInfoLoadQueue(guids);
+	}
+
+	objmgr.m_playerInfoLoaderRunning = false;
+	return true;
+}
+
+void ObjectMgr::ShutdownPlayerInfoLoader()
+{
+	m_playerInfoLoadCond.BeginSynchronized();
+	m_playerInfoLoaderShutdown = true;
+	m_playerInfoLoadCond.Broadcast();
+	m_playerInfoLoadCond.EndSynchronized();
+
+	while(m_playerInfoLoaderRunning)
+		Sleep(10);
+
+	list< pair<uint32, WorldPacket*> >::iterator witr;
+	for(map<uint32, list< pair<uint32, WorldPacket*> > >::iterator itr = m_playerInfoWaiters.begin(); itr != m_playerInfoWaiters.end(); ++itr)
+	{
+		for(witr = itr->second.begin(); witr != itr->second.end(); ++witr)
+			WorldPacketPool::Free(witr->second);
+	}
+	m_playerInfoWaiters.clear();
+	m_playerInfoLoadQueue.clear();
+}
+
+bool ObjectMgr::_IsPlayerInfoReferenced(PlayerInfo * pn)
+{
+	if(pn->m_loggedInPlayer != NULL || pn->m_Group != NULL || pn->GuildId != 0)
+		return true;
+
+	for(uint32 i = 0; i < NUM_ARENA_TEAM_TYPES; ++i)
+	{
+		if(pn->arenaTeam[i] != NULL)
+			return true;
+	}
+
+	for(uint32 i = 0; i < NUM_CHARTER_TYPES; ++i)
+	{
+		if(pn->charterId[i] != 0)
+			return true;
 	}
 
+	return false;
+}
+
+void ObjectMgr::UpdatePlayerInfoCache()
+{
+	if(m_playerInfoResidentDays == 0 || m_lastPlayerInfoTrim + PLAYERINFO_TRIM_INTERVAL > (uint32)UNIXTIME)
+		return;
+
+	m_lastPlayerInfoTrim = (uint32)UNIXTIME;
+	uint32 now = (uint32)UNIXTIME;
+	time_t cutoff = UNIXTIME - time_t(m_playerInfoResidentDays * 86400);
+
+	playernamelock.AcquireWriteLock();
+	for(HM_NAMESPACE::hash_map<uint32,PlayerInfo*>::iterator itr = m_playersinfo.begin(); itr != m_playersinfo.end();)
+	{
+		PlayerInfo * pn = itr->second;
+		if(pn->lastOnline >= cutoff || uint32(pn->lastAccess.GetVal()) + PLAYERINFO_IDLE_TIME > now || _IsPlayerInfoReferenced(pn))
+		{
+			++itr;
+			continue;
+		}
+
+		// Pointers handed out just before this stay valid until the graveyard is emptied
+		m_playerInfoGraveyard.push_back(make_pair(now, pn));
+		m_playersinfo.erase(itr++);
+		++m_playerInfoEvictions;
+	}
 	playernamelock.ReleaseWriteLock();
+
+	while(m_playerInfoGraveyard.size() && m_playerInfoGraveyard.front().first + PLAYERINFO_GRAVEYARD_TIME <= now)
+	{
+		PlayerInfo * pn = m_playerInfoGraveyard.front().second;
+		m_playerInfoGraveyard.pop_front();
+		free(pn->name);
+		delete pn;
+	}
+}
+
+void ObjectMgr::PrintPlayerInfoStats(BaseConsole * pConsole)
+{
+	playernamelock.AcquireReadLock();
+	uint32 indexed = (uint32)m_playersInfoByName.size();
+	uint32 resident = (uint32)m_playersinfo.size();
+	playernamelock.ReleaseReadLock();
+
+	// Rough figures, hash node plus the name for each index entry, and the full struct for resident ones
+	uint32 indexKB = uint32((uint64(indexed) * (sizeof(string) + sizeof(uint32) + 32)) / 1024);
+	uint32 residentKB = uint32((uint64(resident) * (sizeof(PlayerInfo) + 48)) / 1024);
+
+	pConsole->Write("Characters indexed: %u (~%u KB)\r\n", indexed, indexKB);
+	pConsole->Write("PlayerInfo resident: %u (~%u KB), kept %u days after last login\r\n", resident, residentKB, m_playerInfoResidentDays);
+	pConsole->Write("Loaded on demand: %u, evicted: %u (%u awaiting release)\r\n", m_playerInfoLoads, m_playerInfoEvictions, (uint32)m_playerInfoGraveyard.size());
 }
 
 void ObjectMgr::LoadSpellSkills()
@@ -351,8 +639,11 @@ skilllinespell* ObjectMgr::GetSpellSkill(uint32 id)
 
 void ObjectMgr::LoadPlayersInfo()
 {
-	PlayerInfo * pn;
-	QueryResult *result = CharacterDatabase.Query("SELECT guid,name,race,class,level,gender,zoneId,timestamp,acct,instance_id,mapId,positionX,positionY,positionZ,orientation FROM characters");
+	uint32 start = getMSTime();
+	m_playerInfoResidentDays = Config.MainConfig.GetIntDefault("Startup", "PlayerInfoResidentDays", 30);
+
+	// Every name goes in the index, only two columns so this stays quick on large realms
+	QueryResult *result = CharacterDatabase.Query("SELECT guid,name FROM characters");
 	uint32 period, c;
 	if(result)
 	{
@@ -362,69 +653,86 @@ void ObjectMgr::LoadPlayersInfo()
 		do
 		{
 			Field *fields = result->Fetch();
-			pn = new PlayerInfo;
-			memset(pn, 0, sizeof(PlayerInfo));
-			pn->guid = fields[0].GetUInt32();
-			pn->name = strdup(fields[1].GetString());
-			pn->race = fields[2].GetUInt8();
-			pn->_class = fields[3].GetUInt8();
-			pn->lastLevel = fields[4].GetUInt32();
-			pn->gender = fields[5].GetUInt8();
-			pn->lastZone=fields[6].GetUInt32();
-			pn->lastOnline=fields[7].GetUInt32();
-			pn->acct = fields[8].GetUInt32();
-			pn->curInstanceID = fields[9].GetUInt32();
-			pn->lastmapid = fields[10].GetUInt32();
-			pn->lastpositionx = fields[11].GetFloat();
-			pn->lastpositiony = fields[12].GetFloat();
-			pn->lastpositionz = fields[13].GetFloat();
-			pn->lastorientation = fields[14].GetFloat();
-			CharRaceEntry * race = dbcCharRace.LookupEntryForced(pn->race);
-			pn->team = race->team_id;
-
-			if( GetPlayerInfoByName(pn->name) != NULL )
+			uint32 guid = fields[0].GetUInt32();
+			string name = fields[1].GetString();
+			string lpn = name;
+			HEARTHSTONE_TOLOWER(lpn);
+
+			if( m_playersInfoByName.find(lpn) != m_playersInfoByName.end() )
 			{
 				// gotta rename him
 				char temp[300];
-				snprintf(temp, 300, "%s__%X__", pn->name, pn->guid);
-				Log.Notice("ObjectMgr", "Renaming duplicate player %s to %s. (%u)", pn->name,temp,pn->guid);
+				snprintf(temp, 300, "%s__%X__", name.c_str(), guid);
+				Log.Notice("ObjectMgr", "Renaming duplicate player %s to %s. (%u)", name.c_str(),temp,guid);
 				CharacterDatabase.WaitExecute("UPDATE characters SET name = '%s', forced_rename_pending = 1 WHERE guid = %u",
-					CharacterDatabase.EscapeString(string(temp)).c_str(), pn->guid);
+					CharacterDatabase.EscapeString(string(temp)).c_str(), guid);
 
-				free(pn->name);
-				pn->name = strdup(temp);
+				lpn = temp;
+				HEARTHSTONE_TOLOWER(lpn);
 			}
 
-			string lpn=string(pn->name);
-			HEARTHSTONE_TOLOWER(lpn);
-			m_playersInfoByName[lpn] = pn;
-
-			//this is startup -> no need in lock -> don't use addplayerinfo
-			m_playersinfo[(uint32)pn->guid] = pn;
+			//this is startup -> no need in lock
+			m_playersInfoByName[lpn] = guid;
 
 			 if( !((++c) % period) )
-				 Log.Notice("PlayerInfo", "Done %u/%u, %u%% complete.", c, result->GetRowCount(), float2int32( (float(c) / float(result->GetRowCount()))*100.0f ));
+				 Log.Notice("PlayerInfo", "Indexed %u/%u, %u%% complete.", c, result->GetRowCount(), float2int32( (float(c) / float(result->GetRowCount()))*100.0f ));
+		} while( result->NextRow() );
+
+		delete result;
+	}
+
+	// Full details for whoever is likely to be looked up, guild rosters need their members
+	if(m_playerInfoResidentDays)
+	{
+		result = CharacterDatabase.Query("SELECT " PLAYERINFO_FIELDS " FROM characters WHERE timestamp >= %u OR guid IN(SELECT playerid FROM guild_data)",
+			uint32(UNIXTIME - time_t(m_playerInfoResidentDays * 86400)));
+	}
+	else
+		result = CharacterDatabase.Query("SELECT " PLAYERINFO_FIELDS " FROM characters");
+
+	if(result)
+	{
+		do
+		{
+			_AddPlayerInfo(result->Fetch());
 		} while( result->NextRow() );
 
 		delete result;
 	}
-	Log.Notice("ObjectMgr", "%u players loaded.", m_playersinfo.size());
+	m_playerInfoLoads = 0;
+
+	m_playerInfoLoaderRunning = true;
+	ThreadPool.ExecuteTask("PlayerInfoLoader", new PlayerInfoLoaderThread());
+
+	Log.Notice("ObjectMgr", "%u players indexed, %u loaded in %ums.", m_playersInfoByName.size(), m_playersinfo.size(), getMSTime() - start);
 }
 
-PlayerInfo* ObjectMgr::GetPlayerInfoByName(const char * name)
+uint32 ObjectMgr::GetPlayerGuidByName(const char * name)
 {
 	string lpn = string(name);
 	HEARTHSTONE_TOLOWER(lpn);
 	PlayerNameStringIndexMap::iterator i;
-	PlayerInfo *rv = NULL;
+	uint32 guid = 0;
 	playernamelock.AcquireReadLock();
 
 	i = m_playersInfoByName.find(lpn);
 	if( i != m_playersInfoByName.end() )
-		rv = i->second;
+		guid = i->second;
 
 	playernamelock.ReleaseReadLock();
-	return rv;
+	return guid;
+}
+
+PlayerInfo* ObjectMgr::GetPlayerInfoByName(const char * name)
+{
+	uint32 guid = GetPlayerGuidByName(name);
+	return guid ? GetPlayerInfo(guid) : NULL;
+}
+
+PlayerInfo* ObjectMgr::LoadPlayerInfoByName(const char * name)
+{
+	uint32 guid = GetPlayerGuidByName(name);
+	return guid ? LoadPlayerInfo(guid) : NULL;
 }
 
 void ObjectMgr::LoadPlayerCreateInfo()
@@ -926,36 +1234,16 @@ void ObjectMgr::ProcessGameobjectQuests()
 Player* ObjectMgr::GetPlayer(const char* name, bool caseSensitive)
 {
 	Player * rv = NULLPLR;
-	PlayerStorageMap::const_iterator itr;
-	_playerslock.AcquireReadLock();
+	string key = Utf8FoldCase(name);
 
-	if(!caseSensitive)
-	{
-		std::string strName = name;
-		HEARTHSTONE_TOLOWER(strName);
-		for (itr = _players.begin(); itr != _players.end();)
-		{
-			if(!stricmp(itr->second->GetNameString()->c_str(), strName.c_str()))
-			{
-				rv = itr->second;
-				break;
-			}
-			++itr;
-		}
-	}
-	else
+	_playerslock.AcquireReadLock();
+	PlayerNameStorageMap::const_iterator itr = _playersByName.find(key);
+	if(itr != _playersByName.end())
 	{
-		for (itr = _players.begin(); itr != _players.end();)
-		{
-			if(!strcmp(itr->second->GetName(), name))
-			{
-				rv = itr->second;
-				break;
-			}
-			++itr;
-		}
+		// The index is case insensitive, an exact match has to compare the real name
+		if(!caseSensitive || !strcmp(itr->second->GetName(), name))
+			rv = itr->second;
 	}
-
 	_playerslock.ReleaseReadLock();
 
 	return rv;
@@ -2149,15 +2437,41 @@ Player* ObjectMgr::CreatePlayer()
 
 void ObjectMgr::AddPlayer(Player* p)//add it to global storage
 {
+	string key = Utf8FoldCase(p->GetName());
+
 	_playerslock.AcquireWriteLock();
 	_players[p->GetLowGUID()] = p;
+	_playersByName[key] = p;
 	_playerslock.ReleaseWriteLock();
 }
 
 void ObjectMgr::RemovePlayer(Player* p)
 {
+	string key = Utf8FoldCase(p->GetName());
+
 	_playerslock.AcquireWriteLock();
 	_players.erase(p->GetLowGUID());
+
+	// Removal can happen twice on logout, only drop the name if it is still ours
+	PlayerNameStorageMap::iterator itr = _playersByName.find(key);
+	if(itr != _playersByName.end() && itr->second == p)
+		_playersByName.erase(itr);
+	_playerslock.ReleaseWriteLock();
+}
+
+void ObjectMgr::RenamePlayer(Player* p, string & newname)
+{
+	string oldkey = Utf8FoldCase(p->GetName());
+	string newkey = Utf8FoldCase(newname.c_str());
+
+	_playerslock.AcquireWriteLock();
+	PlayerNameStorageMap::iterator itr = _playersByName.find(oldkey);
+	if(itr != _playersByName.end() && itr->second == p)
+	{
+		_playersByName.erase(itr);
+		_playersByName[newkey] = p;
+	}
+	p->SetName(newname);
 	_playerslock.ReleaseWriteLock();
 }
 
@@ -310,7 +310,9 @@ namespace __gnu_cxx
 #endif
 #endif
 // vc++ has the type for a string hash already, so we don't need to do anything special
-typedef HM_NAMESPACE::hash_map<string, PlayerInfo*> PlayerNameStringIndexMap;
+typedef HM_NAMESPACE::hash_map<string, uint32> PlayerNameStringIndexMap;
+// Online players keyed by Utf8FoldCase of their name
+typedef HM_NAMESPACE::hash_map<string, Player*> PlayerNameStorageMap;
 
 typedef std::map<uint32, uint32> PetLevelupSpellSet;
 typedef std::map<uint32, PetLevelupSpellSet> PetLevelupSpellMap;
@@ -355,6 +357,8 @@ struct QuestPOI
 typedef std::vector<QuestPOI> QuestPOIVector;
 typedef std::tr1::unordered_map<uint32, QuestPOIVector> QuestPOIMap;
 
+class BaseConsole;
+
 class SERVER_DECL ObjectMgr : public Singleton < ObjectMgr >
 {
 public:
@@ -442,11 +446,28 @@ public:
 	void LoadGroups();
 
 	// player names
+	// Every character is indexed by name, full PlayerInfo is only kept for recently
+	// active characters and anyone referenced by a guild, group or arena team.
+	// GetPlayerInfo never touches the database, anything else is loaded in the
+	// background and is there for the next lookup. Only startup, the world thread
+	// and threads of their own may wait on LoadPlayerInfo.
 	void AddPlayerInfo(PlayerInfo *pn);
 	PlayerInfo *GetPlayerInfo(uint32 guid );
+	PlayerInfo *GetCachedPlayerInfo(uint32 guid);
 	PlayerInfo *GetPlayerInfoByName(const char * name);
+	PlayerInfo *LoadPlayerInfo(uint32 guid);
+	PlayerInfo *LoadPlayerInfoByName(const char * name);
+	uint32 GetPlayerGuidByName(const char * name);
 	void RenamePlayerInfo(PlayerInfo * pn, const char * oldname, const char * newname);
-	void DeletePlayerInfo(uint32 guid);
+	void DeletePlayerInfo(uint32 guid, const char * name);
+
+	// Loads a character in the background. Once it is in, replay (if any) is queued
+	// back to the account's session, which handles it again on its own thread. replay must come
+	// from WorldPacketPool::Allocate, it ends up on _recvQueue or is freed back to the pool.
+	void LoadPlayerInfoAsync(uint32 guid, uint32 accountId, WorldPacket * replay);
+	void UpdatePlayerInfoCache();
+	void ShutdownPlayerInfoLoader();
+	void PrintPlayerInfoStats(BaseConsole * pConsole);
 	PlayerCreateInfo* GetPlayerCreateInfo(uint8 race, uint8 class_) const;
 
 	void LoadAchievements();
@@ -518,11 +539,13 @@ public:
 	Player* CreatePlayer();
 	Mutex m_playerguidlock;
 	PlayerStorageMap _players;
+	PlayerNameStorageMap _playersByName;	// Guarded by _playerslock as well
 	RWLock _playerslock;
 	uint32 m_hiPlayerGuid;
 
 	void AddPlayer(Player* p);//add it to global storage
 	void RemovePlayer(Player* p);
+	void RenamePlayer(Player* p, string & newname);
 
 	QuestPOIVector const* GetQuestPOIVector(uint32 questId)
 	{
@@ -662,7 +685,24 @@ protected:
 
 	uint64 TransportersCount;
 	HM_NAMESPACE::hash_map<uint32,PlayerInfo*> m_playersinfo;
-	PlayerNameStringIndexMap m_playersInfoByName;
+	PlayerNameStringIndexMap m_playersInfoByName;		// Lower case name to guid, every character
+
+	friend class PlayerInfoLoaderThread;
+	PlayerInfo * _AddPlayerInfo(Field * fields);
+	bool _IsPlayerInfoReferenced(PlayerInfo * pn);
+	void ProcessPlayerInfoLoadQueue(vector<uint32> & guids);
+
+	list< pair<uint32, PlayerInfo*> > m_playerInfoGraveyard;
+	uint32 m_playerInfoResidentDays;
+	uint32 m_lastPlayerInfoTrim;
+	uint32 m_playerInfoLoads, m_playerInfoEvictions;
+
+	Mutex m_playerInfoLoadLock;
+	Condition m_playerInfoLoadCond;
+	deque<uint32> m_playerInfoLoadQueue;
+	map<uint32, list< pair<uint32, WorldPacket*> > > m_playerInfoWaiters;		// Guid to the account and packet waiting on it
+	volatile bool m_playerInfoLoaderRunning;
+	bool m_playerInfoLoaderShutdown;
 
 	HM_NAMESPACE::hash_map<uint32,WayPointMap*> m_waypoints;//stored by spawnid
 	uint32 m_hiCreatureSpawnId;
@@ -703,6 +743,12 @@ protected:
 	PetLevelupSpellMap  mPetLevelupSpellMap;
 };
 
+class PlayerInfoLoaderThread : public ThreadContext
+{
+public:
+	bool run();
+};
+
 
 #define objmgr ObjectMgr::getSingleton()
 
@@ -897,11 +897,17 @@ bool Storage_ReloadTable(const char * TableName)
 	if(!stricmp(TableName, "items"))					// Items
 		ItemPrototypeStorage.Reload();
 	else if(!stricmp(TableName, "creature_proto"))		// Creature Proto
+	{
 		CreatureProtoStorage.Reload();
+		Map::InvalidateCreatureTemplates();
+	}
 	else if(!stricmp(TableName, "creature_proto_vehicle"))	// Creature Vehicle Proto
 		CreatureProtoVehicleStorage.Reload();
 	else if(!stricmp(TableName, "creature_names"))		// Creature Names
+	{
 		CreatureNameStorage.Reload();
+		Map::InvalidateCreatureTemplates();
+	}
 	else if(!stricmp(TableName, "gameobject_names"))	// GO Names
 		GameObjectNameStorage.Reload();
 	else if(!stricmp(TableName, "areatriggers"))		// Areatriggers
@@ -0,0 +1,195 @@
+/***
+ * Demonstrike Core
+ */
+
+#include "StdAfx.h"
+
+static HEARTHSTONE_INLINE uint32 GetLatencyBucket(uint32 us)
+{
+	if(us < 4)
+		return us;
+
+	uint32 exp = 2;
+	while(exp < 25 && (us >> (exp + 1)) != 0)
+		++exp;
+	if((us >> (exp + 1)) != 0)
+		return OPCODE_LATENCY_BUCKETS - 1;
+	return 4 + (exp - 2) * 4 + ((us >> (exp - 2)) & 3);
+}
+
+// Highest latency that still falls into the bucket
+static uint32 GetLatencyBucketLimit(uint32 bucket)
+{
+	if(bucket < 4)
+		return bucket;
+
+	uint32 exp = (bucket - 4) / 4 + 2;
+	return ((4 + (bucket - 4) % 4 + 1) << (exp - 2)) - 1;
+}
+
+uint32 OpcodeHandlerStats::GetPercentile(uint32 percent) const
+{
+	uint64 target = (Count * percent + 99) / 100, seen = 0;
+	for(uint32 i = 0; i < OPCODE_LATENCY_BUCKETS; ++i)
+	{
+		seen += Buckets[i];
+		if(seen >= target && seen != 0)
+			return std::min(GetLatencyBucketLimit(i), MaxUs);
+	}
+	return MaxUs;
+}
+
+struct OpcodeStatsThread
+{
+	OpcodeHandlerStats * Handlers[NUM_MSG_TYPES];
+	volatile uint32 Generation;
+
+	OpcodeStatsThread(uint32 generation) : Generation(generation)
+	{
+		memset(Handlers, 0, sizeof(Handlers));
+	}
+
+	// Readers may be walking the table, so entries are zeroed but never freed
+	void Clear(uint32 generation)
+	{
+		for(uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+		{
+			if(Handlers[i] != NULL)
+			{
+				memset(Handlers[i], 0, sizeof(OpcodeHandlerStats));
+				Handlers[i]->Opcode = uint16(i);
+			}
+		}
+		Generation = generation;
+	}
+
+	HEARTHSTONE_INLINE void Record(uint16 opcode, uint32 us)
+	{
+		OpcodeHandlerStats * stats = Handlers[opcode];
+		if(stats == NULL)
+		{
+			stats = new OpcodeHandlerStats;
+			memset(stats, 0, sizeof(OpcodeHandlerStats));
+			stats->Opcode = opcode;
+			Handlers[opcode] = stats;
+		}
+
+		++stats->Count;
+		stats->TotalUs += us;
+		if(us > stats->MaxUs)
+			stats->MaxUs = us;
+		++stats->Buckets[GetLatencyBucket(us)];
+	}
+};
+
+// Tables outlive their threads; map and pool threads are reused, so there are only ever a handful
+static Mutex s_threadListLock;
+static std::vector<OpcodeStatsThread*> s_threads;
+static volatile uint32 s_generation = 0;
+static time_t s_resetTime = 0;
+static THREAD_LOCAL OpcodeStatsThread * t_opcodeStats = NULL;
+
+void OpcodeStats::Record(uint16 opcode, uint32 us)
+{
+	if(opcode >= NUM_MSG_TYPES)
+		return;
+
+	OpcodeStatsThread * table = t_opcodeStats;
+	if(table == NULL)
+	{
+		table = new OpcodeStatsThread(s_generation);
+		s_threadListLock.Acquire();
+		if(s_resetTime == 0)
+			s_resetTime = UNIXTIME;
+		s_threads.push_back(table);
+		s_threadListLock.Release();
+		t_opcodeStats = table;
+	}
+	else if(table->Generation != s_generation)
+		table->Clear(s_generation);
+
+	table->Record(opcode, us);
+}
+
+static bool SortByTotalTime(const OpcodeHandlerStats & a, const OpcodeHandlerStats & b)
+{
+	return a.TotalUs > b.TotalUs;
+}
+
+void OpcodeStats::GetStats(std::vector<OpcodeHandlerStats> & stats)
+{
+	std::vector<OpcodeHandlerStats> merged(NUM_MSG_TYPES);
+	memset(&merged[0], 0, sizeof(OpcodeHandlerStats) * NUM_MSG_TYPES);
+
+	s_threadListLock.Acquire();
+	for(std::vector<OpcodeStatsThread*>::iterator itr = s_threads.begin(); itr != s_threads.end(); ++itr)
+	{
+		// Threads that haven't dispatched since the reset still hold the old numbers
+		OpcodeStatsThread * table = *itr;
+		if(table->Generation != s_generation)
+			continue;
+
+		// The owners keep counting while we read, close enough for a report
+		for(uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+		{
+			OpcodeHandlerStats * src = table->Handlers[i];
+			if(src == NULL || src->Count == 0)
+				continue;
+
+			OpcodeHandlerStats & dst = merged[i];
+			dst.Count += src->Count;
+			dst.TotalUs += src->TotalUs;
+			if(src->MaxUs > dst.MaxUs)
+				dst.MaxUs = src->MaxUs;
+			for(uint32 b = 0; b < OPCODE_LATENCY_BUCKETS; ++b)
+				dst.Buckets[b] += src->Buckets[b];
+		}
+	}
+	s_threadListLock.Release();
+
+	stats.clear();
+	for(uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+	{
+		if(merged[i].Count == 0)
+			continue;
+
+		merged[i].Opcode = uint16(i);
+		stats.push_back(merged[i]);
+	}
+	std::sort(stats.begin(), stats.end(), SortByTotalTime);
+}
+
+void OpcodeStats::Reset()
+{
+	// Each thread clears its own table the next time it records
+	s_resetTime = UNIXTIME;
+	++s_generation;
+}
+
+uint32 OpcodeStats::GetSecondsSinceReset()
+{
+	return s_resetTime ? uint32(UNIXTIME - s_resetTime) : 0;
+}
+
+bool OpcodeStats::WriteDump(const char * filename)
+{
+	FILE * f = fopen(filename, "w");
+	if(f == NULL)
+		return false;
+
+	std::vector<OpcodeHandlerStats> stats;
+	GetStats(stats);
+
+	uint32 seconds = GetSecondsSinceReset();
+	fprintf(f, "# Opcode handler timing over the last %u seconds, busiest first\n", seconds);
+	fprintf(f, "# %-44s %10s %10s %12s %8s %8s %8s %8s\n", "opcode", "count", "per sec", "total ms", "avg us", "p50 us", "p99 us", "max us");
+	for(std::vector<OpcodeHandlerStats>::iterator itr = stats.begin(); itr != stats.end(); ++itr)
+	{
+		fprintf(f, "%-46s %10u %10.1f %12.1f %8u %8u %8u %8u\n", LookupOpcodeName(itr->Opcode), uint32(itr->Count),
+			seconds ? double(itr->Count) / seconds : 0.0, double(itr->TotalUs) / 1000.0, uint32(itr->TotalUs / itr->Count),
+			itr->GetPercentile(50), itr->GetPercentile(99), itr->MaxUs);
+	}
+
+	fclose(f);
+	return true;
+}
@@ -0,0 +1,40 @@
+/***
+ * Demonstrike Core
+ */
+
+#pragma once
+
+struct OpcodeStatsThread;
+
+/************************************************************************/
+/* Opcode handler timing                                                */
+/************************************************************************/
+// Every handler WorldSession::Update dispatches is timed and counted in the
+// dispatching thread's own table, so recording never takes a lock. Latencies go
+// into log buckets with four steps per power of two, good to about 25% from
+// 1 us up to a minute. Readers add the thread tables up when they ask.
+
+#define OPCODE_LATENCY_BUCKETS 100
+
+struct OpcodeHandlerStats
+{
+	uint16 Opcode;
+	uint64 Count;
+	uint64 TotalUs;
+	uint32 MaxUs;
+	uint32 Buckets[OPCODE_LATENCY_BUCKETS];
+
+	uint32 GetPercentile(uint32 percent) const;
+};
+
+class SERVER_DECL OpcodeStats
+{
+public:
+	static void Record(uint16 opcode, uint32 us);
+
+	// Handlers seen since the last reset, busiest (by total time) first
+	static void GetStats(std::vector<OpcodeHandlerStats> & stats);
+	static void Reset();
+	static uint32 GetSecondsSinceReset();
+	static bool WriteDump(const char * filename);
+};
@@ -355,6 +355,8 @@ void Player::Init()
 	m_speedhackCheckTimer		= 0;
 	m_mallCheckTimer			= 0;
 	m_UpdateHookTimer			= 0;
+	m_groupUpdateFlags			= 0;
+	m_groupUpdateTimer			= 0;
 	m_speedChangeInProgress		= false;
 	m_passOnLoot				= false;
 	m_changingMaps				= true;
@@ -380,6 +382,9 @@ void Player::Init()
 	m_removequests.clear();
 	m_finishedQuests.clear();
 	m_finishedDailyQuests.clear();
+	m_questGiverStatus.clear();
+	m_questGiverStatusGeneration = 0;
+	m_questGiverStatusCoinage = 0;
 	quest_spells.clear();
 	quest_mobs.clear();
 	loginauras.clear();
@@ -972,6 +977,15 @@ void Player::Update( uint32 p_time )
 		m_UpdateHookTimer = mstime+1000;
 	}
 
+	if(m_groupUpdateFlags && mstime >= m_groupUpdateTimer)
+	{
+		if(GetGroup())
+			GetGroup()->SendMemberUpdate(TO_PLAYER(this));
+		else
+			m_groupUpdateFlags = 0;
+		m_groupUpdateTimer = mstime + sWorld.m_partyStatsInterval;
+	}
+
 	if(m_attacking)
 	{
 		// Check attack timer.
@@ -3057,7 +3071,7 @@ void Player::LoadFromDBProc(QueryResultVector & results)
 #define get_next_field fields[field_index++]
 
 	// set playerinfo
-	m_playerInfo = objmgr.GetPlayerInfo(GetLowGUID());
+	m_playerInfo = objmgr.LoadPlayerInfo(GetLowGUID());
 	if( m_playerInfo == NULL )
 	{
 		RemovePendingPlayer();
@@ -3962,6 +3976,7 @@ void Player::SetQuestLogSlot(QuestLogEntry *entry, uint32 slot)
 {
 	ASSERT(slot < 25);
 	m_questlog[slot] = entry;
+	InvalidateQuestGiverStatus();
 }
 
 void Player::AddToWorld(bool loggingin /* = false */)
@@ -5351,6 +5366,7 @@ uint32 Player::GetQuestStatusForQuest(uint32 questid, uint8 type, bool skiplevel
 void Player::AddToFinishedQuests(uint32 quest_id)
 {
 	m_finishedQuests.insert(quest_id);
+	InvalidateQuestGiverStatus();
 	GetAchievementInterface()->HandleAchievementCriteriaQuestCount( uint32(m_finishedQuests.size()));
 }
 
@@ -5368,11 +5384,13 @@ void Player::AddToFinishedDailyQuests(uint32 quest_id)
 	SetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1 + uint32(m_finishedDailyQuests.size()), quest_id);
 	m_finishedDailyQuests.insert(quest_id);
 	DailyMutex.Release();
+	InvalidateQuestGiverStatus();
 }
 
 void Player::ResetDailyQuests()
 {
 	m_finishedDailyQuests.clear();
+	InvalidateQuestGiverStatus();
 
 	for(uint32 i = 0; i < 25; i++)
 		SetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1 + i, 0);
@@ -5382,6 +5400,33 @@ bool Player::HasFinishedDailyQuest(uint32 quest_id)
 {
 	return (m_finishedDailyQuests.find(quest_id) != m_finishedDailyQuests.end());
 }
+
+bool Player::GetCachedQuestGiverStatus(uint64 key, uint8 & status)
+{
+	uint32 generation = sQuestMgr.GetQuestRelationGeneration();
+	if(m_questGiverStatusGeneration != generation)
+	{
+		InvalidateQuestGiverStatus();
+		m_questGiverStatusGeneration = generation;
+		return false;
+	}
+
+	// Quests that require money finish with the coinage, which changes in too many places to hook
+	uint32 coinage = GetUInt32Value(PLAYER_FIELD_COINAGE);
+	if(m_questGiverStatusCoinage != coinage)
+	{
+		InvalidateQuestGiverStatus();
+		m_questGiverStatusCoinage = coinage;
+		return false;
+	}
+
+	HM_NAMESPACE::hash_map<uint64, uint8>::iterator itr = m_questGiverStatus.find(key);
+	if(itr == m_questGiverStatus.end())
+		return false;
+
+	status = itr->second;
+	return true;
+}
 void Player::_LoadSkills(QueryResult * result)
 {
 	int32 proff_counter = 2;
@@ -6044,7 +6089,7 @@ void Player::UpdateAreaAndZoneInfo(uint32 areaid, uint32 zoneid)
 			m_areaDBC = dbcArea.LookupEntryForced(zoneid);
 		UpdatePvPArea();
 		if(GetGroup())
-			GetGroup()->UpdateOutOfRangePlayer(TO_PLAYER(this), 128, true, NULL);
+			GetGroup()->HandlePartialChange(PARTY_UPDATE_FLAG_ZONEID, TO_PLAYER(this));
 	}
 
 	if(m_zoneId == 0)
@@ -6466,6 +6511,8 @@ void Player::OnRemoveInRangeObject(Object* pObj)
 
 	pObj->DestroyForPlayer(this);
 	m_visibleObjects.erase(pObj);
+	if(pObj->IsPlayer())
+		m_movementRelayTimes.erase(pObj->GetLowGUID());
 	Unit::OnRemoveInRangeObject(pObj);
 
 	if( pObj == m_CurrentCharm)
@@ -7214,6 +7261,7 @@ void Player::RemoveQuestsFromLine(uint32 skill_line)
 				m_finishedQuests.erase(itr2);
 	}
 
+	InvalidateQuestGiverStatus();
 	UpdateNearbyGameObjects();
 }
 
@@ -7854,6 +7902,9 @@ void Player::UpdateNearbyGameObjects()
 
 void Player::UpdateNearbyQuestGivers()
 {
+	// Whatever made the caller ask has changed what the givers show
+	InvalidateQuestGiverStatus();
+
 	GameObject* Gobj = NULL;
 	for (Object::InRangeSet::iterator itr = GetInRangeSetBegin(); itr != GetInRangeSetEnd(); itr++)
 	{
@@ -7904,6 +7955,14 @@ void Player::EventTaxiInterpolate()
 		return;
 
 	SetPosition(x,y,z,0);
+
+	// Have the collision tile we'll be over in a while read before the cells there activate
+	if(ntime > m_taxi_ride_time && sWorld.m_collisionFlightPrefetch && m_mapMgr->IsCollisionEnabled())
+	{
+		uint32 aheadNode = lastNode;
+		m_CurrentTaxiPath->SetPosForTime(x, y, z, ntime - m_taxi_ride_time + sWorld.m_collisionFlightPrefetch, &aheadNode, m_mapId);
+		CollideInterface.PrefetchPosition(m_mapId, x, y);
+	}
 }
 
 void Player::TaxiStart(TaxiPath *path, uint32 modelid, uint32 start_node)
@@ -9436,6 +9495,7 @@ void Player::ApplyLevelInfo(uint32 Level)
 	// Apply level
 	uint32 PreviousLevel = GetUInt32Value(UNIT_FIELD_LEVEL);
 	SetUInt32Value(UNIT_FIELD_LEVEL, Level);
+	InvalidateQuestGiverStatus();
 
 	CalculateBaseStats();
 
@@ -10957,6 +11017,9 @@ void Player::_AddSkillLine(uint32 SkillLine, uint32 Curr_sk, uint32 Max_sk)
 
 void Player::_UpdateSkillFields()
 {
+	// Tradeskill requirements of quests
+	InvalidateQuestGiverStatus();
+
 	uint32 f = PLAYER_SKILL_INFO_1_1;
 	/* Set the valid skills */
 	for(SkillMap::iterator itr = m_skills.begin(); itr != m_skills.end();)
@@ -12319,8 +12382,9 @@ void Player::Social_SendFriendList(uint32 flag)
 			data << uint8(0);
 
 		// online/offline flag
-		plr = objmgr.GetPlayerInfo( itr->first );
-		if(plr->m_loggedInPlayer != NULL)
+		// Anyone online is resident, the rest are listed offline
+		plr = objmgr.GetCachedPlayerInfo( itr->first );
+		if(plr != NULL && plr->m_loggedInPlayer != NULL)
 		{
 			data << plr->m_loggedInPlayer->GetChatTag();
 			data << plr->m_loggedInPlayer->GetZoneId();
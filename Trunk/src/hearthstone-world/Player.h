@@ -542,6 +542,7 @@ struct PlayerInfo
 	time_t lastOnline;
 	uint32 lastZone;
 	uint32 lastLevel;
+	AtomicCounter lastAccess;	// Last fetched from ObjectMgr, idle infos are released
 
 	Group * m_Group;
 	int8 subGroup;
@@ -1010,6 +1011,11 @@ public:
 	void				RemoveQuestsFromLine(uint32 skill_line);
 	void				ResetDailyQuests();
 	uint16				FindQuestSlot(uint32 questid);
+
+	// Quest giver status cache, see QuestMgr::CalcStatus
+	bool				GetCachedQuestGiverStatus(uint64 key, uint8 & status);
+	void				SetCachedQuestGiverStatus(uint64 key, uint8 status) { m_questGiverStatus[key] = status; }
+	HEARTHSTONE_INLINE void InvalidateQuestGiverStatus() { if(!m_questGiverStatus.empty()) m_questGiverStatus.clear(); }
 	uint32 GetQuestSlotQuestId(uint16 slot) const { return GetUInt32Value(PLAYER_QUEST_LOG_1_1 + slot * 5 + (uint32)NULL); }
 
 	//Quest related variables
@@ -1019,6 +1025,9 @@ public:
 	std::set<uint32>	m_finishedQuests;
 	std::set<uint32>	m_finishedDailyQuests;
 	uint32				m_questSharer;
+	HM_NAMESPACE::hash_map<uint64, uint8> m_questGiverStatus;
+	uint32				m_questGiverStatusGeneration;
+	uint32				m_questGiverStatusCoinage;
 	std::set<uint32>	quest_spells;
 	std::set<uint32>	quest_mobs;
 	Mutex				DailyMutex;
@@ -1711,6 +1720,9 @@ public:
 
 	void ResetHeartbeatCoords();
 
+	// Last time one of our heartbeats was relayed to a far away player, by their low guid
+	HM_NAMESPACE::hash_map<uint32, uint32> m_movementRelayTimes;
+
 	// speedhack buster!
 	LocationVector						m_lastHeartbeatPosition;
 	uint32								m_startMoveTime;	// time
@@ -1945,6 +1957,8 @@ public:
 	float m_WeaponSubClassDamagePct[21];
 
 	LocationVector m_last_group_position;
+	uint32 m_groupUpdateFlags;		// party member stats changed since the last send, under the group lock
+	uint32 m_groupUpdateTimer;
 	int32 m_rap_mod_pct;
 	void SummonRequest(Object* Requestor, uint32 ZoneID, uint32 MapID, uint32 InstanceID, const LocationVector & Position);
 	uint8 m_lastMoveType;
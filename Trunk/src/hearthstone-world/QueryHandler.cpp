@@ -13,9 +13,14 @@ void WorldSession::HandleNameQueryOpcode( WorldPacket & recv_data )
 	uint64 guid;
 	recv_data >> guid;
 
-	PlayerInfo *pn = objmgr.GetPlayerInfo( (uint32)guid );
+	// Characters that have not been online for a while are not kept in memory,
+	// fetch those in the background rather than stalling this thread on the database
+	PlayerInfo *pn = objmgr.GetCachedPlayerInfo( (uint32)guid );
 	if(pn == NULL)
+	{
+		DeferUntilPlayerInfoLoaded( (uint32)guid, recv_data );
 		return;
+	}
 
 	// We query our own name on player create so check to send MOTD
 	if(!_player->sentMOTD)
@@ -25,8 +30,13 @@ void WorldSession::HandleNameQueryOpcode( WorldPacket & recv_data )
 	}
 
 	DEBUG_LOG("WorldSession","Received CMSG_NAME_QUERY for: %s", pn->name );
+	SendNameQueryResponse(pn);
+}
+
+void WorldSession::SendNameQueryResponse(PlayerInfo * pn)
+{
 	WorldPacket data(SMSG_NAME_QUERY_RESPONSE, 10000);
-	data << WoWGuid(guid);
+	data << WoWGuid(uint64(pn->guid));
 	data << uint8(0);
 	data << pn->name;
 //	if(blablabla)
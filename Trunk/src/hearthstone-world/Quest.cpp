@@ -381,6 +381,8 @@ void QuestLogEntry::UpdatePlayerFields()
 	if(!m_plr)
 		return;
 
+	// Objective progress decides between finished and not finished givers
+	m_plr->InvalidateQuestGiverStatus();
 	m_plr->SetUInt32Value(PLAYER_QUEST_LOG_1_1 + m_slot*5 + 0, m_quest->id);
 
 	uint32 i = 0, field0 = 0x04;
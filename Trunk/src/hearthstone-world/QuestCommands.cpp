@@ -30,6 +30,7 @@ string RemoveQuestFromPlayer(Player* plr, Quest *qst)
 		if( plr->m_finishedQuests.find(qst->id) != plr->m_finishedQuests.end())
 		{
 			plr->m_finishedQuests.erase(qst->id);
+			plr->InvalidateQuestGiverStatus();
 			recout += "Quest removed from finished quests history.\n\n";
 			has = true;
 		}
@@ -40,6 +41,7 @@ string RemoveQuestFromPlayer(Player* plr, Quest *qst)
 		if( plr->m_finishedDailyQuests.find(qst->id) != plr->m_finishedDailyQuests.end())
 		{
 			plr->m_finishedDailyQuests.erase(qst->id);
+			plr->InvalidateQuestGiverStatus();
 			recout += "Quest removed from finished dailies history.\n\n";
 			has = true;
 		}
@@ -141,6 +143,17 @@ bool ChatHandler::HandleQuestLookupCommand(const char * args, WorldSession * m_s
 	return true;
 }
 
+bool ChatHandler::HandleQuestCacheStatsCommand(const char * args, WorldSession * m_session)
+{
+	uint32 hits = sQuestMgr.GetStatusCacheHits();
+	uint32 recalcs = sQuestMgr.GetStatusCacheRecalcs();
+	uint32 total = hits + recalcs;
+
+	BlueSystemMessage(m_session, "Quest giver status cache: %u hits, %u recomputations (%u%% hit rate).",
+		hits, recalcs, total ? uint32(uint64(hits) * 100 / total) : 0);
+	return true;
+}
+
 bool ChatHandler::HandleQuestStatusCommand(const char * args, WorldSession * m_session)
 {
 	if(!*args) return false;
@@ -506,6 +506,27 @@ uint32 QuestMgr::CalcQuestStatus(Player* plr, Quest* qst, uint8 type, bool skipl
 }
 
 uint8 QuestMgr::CalcStatus(Object* quest_giver, Player* plr)
+{
+	// Creatures and gameobjects share their quest lists per entry, so the result
+	// is cached per player and giver entry until something it depends on changes.
+	if( quest_giver->GetTypeId() != TYPEID_UNIT && quest_giver->GetTypeId() != TYPEID_GAMEOBJECT )
+		return _CalcStatus(quest_giver, plr);
+
+	uint64 key = (uint64(quest_giver->GetTypeId()) << 32) | quest_giver->GetEntry();
+	uint8 status;
+	if( plr->GetCachedQuestGiverStatus(key, status) )
+	{
+		++m_statusCacheHits;
+		return status;
+	}
+
+	++m_statusCacheRecalcs;
+	status = _CalcStatus(quest_giver, plr);
+	plr->SetCachedQuestGiverStatus(key, status);
+	return status;
+}
+
+uint8 QuestMgr::_CalcStatus(Object* quest_giver, Player* plr)
 {
 	uint32 status = QMGR_QUEST_NOT_AVAILABLE;
 	std::list<QuestRelation *>::const_iterator itr;
@@ -1306,13 +1327,13 @@ void QuestMgr::OnPlayerItemPickup(Player* plr, Item* item, uint32 pickedupstacks
 						WorldPacket data(SMSG_QUESTUPDATE_ADD_ITEM, 8);
 						data << qle->GetQuest()->objectives->required_item[j] << uint32(1);
 						plr->GetSession()->SendPacket(&data);
+						qle->UpdatePlayerFields();
 						if(qle->CanBeFinished())
 						{
 							plr->UpdateNearbyQuestGivers();
 							plr->UpdateNearbyGameObjects();
 							qle->SendQuestComplete();
 						}
-						qle->UpdatePlayerFields();
 						break;
 					}
 				}
@@ -46,10 +46,17 @@ public:
 	uint32 PlayerMeetsReqs(Player* plr, Quest* qst, bool skiplevelcheck);
 
 	uint8 CalcStatus(Object* quest_giver, Player* plr);
+	uint8 _CalcStatus(Object* quest_giver, Player* plr);
 	uint32 CalcQuestStatus(Player* plr, QuestRelation* qst);
 	uint32 CalcQuestStatus(Player* plr, Quest* qst, uint8 type, bool skiplevelcheck);
 	uint32 ActiveQuestsCount(Object* quest_giver, Player* plr);
 
+	// Quest giver relations changed at runtime, drop every player's cached giver status
+	void OnQuestRelationsChanged() { ++m_questRelationGeneration; }
+	uint32 GetQuestRelationGeneration() { return uint32(m_questRelationGeneration.GetVal()); }
+	uint32 GetStatusCacheHits() { return uint32(m_statusCacheHits.GetVal()); }
+	uint32 GetStatusCacheRecalcs() { return uint32(m_statusCacheRecalcs.GetVal()); }
+
 	//Packet Forging...
 	void BuildOfferReward(WorldPacket* data,Quest* qst, Object* qst_giver, uint32 menutype, Player* plr);
 	void BuildQuestDetails(WorldPacket* data, Quest* qst, Object* qst_giver, uint32 menutype, Player* plr);
@@ -143,6 +150,10 @@ private:
 
 	HM_NAMESPACE::hash_map<uint32, uint32>		  m_ObjectLootQuestList;
 
+	AtomicCounter m_questRelationGeneration;
+	AtomicCounter m_statusCacheHits;
+	AtomicCounter m_statusCacheRecalcs;
+
 	template <class T> void _AddQuest(uint32 entryid, Quest *qst, uint8 type);
 
 	template <class T> HM_NAMESPACE::hash_map<uint32, list<QuestRelation *>* >& _GetList();
@@ -172,6 +172,8 @@ void Player::SetStanding(uint32 Faction, int32 Value)
 		
 		OnModStanding( dbc, itr->second );
 	}
+
+	InvalidateQuestGiverStatus();
 }
 
 Standing Player::GetStandingRank(uint32 Faction)
@@ -203,6 +205,7 @@ void Player::ModStanding(uint32 Faction, int32 Value)
 	if (dbc == NULL || dbc->RepListId < 0)
 		return;
 
+	InvalidateQuestGiverStatus();
 	if(itr == m_reputation.end())
 	{
 		if (AddNewFaction(dbc, 0, true)) 
@@ -1388,3 +1388,10 @@ void HookInterface::OnSlowLockOpen(GameObject* go,Player* plr)
 		(call)(go,plr);
 	OUTER_LOOP_END;
 }
+
+void HookInterface::OnMapShutdown(MapMgr* pMgr)
+{
+	OUTER_LOOP_BEGIN(SERVER_HOOK_EVENT_ON_MAP_SHUTDOWN, tOnMapShutdown)
+		(call)(pMgr);
+	OUTER_LOOP_END;
+}
@@ -66,6 +66,7 @@ enum ServerHookEvents
 	SERVER_HOOK_EVENT_ON_MOUNT_FLYING		= 46,
 	SERVER_HOOK_EVENT_ON_PRE_AURA_REMOVE	= 47,
 	SERVER_HOOK_EVENT_ON_SLOW_LOCK_OPEN		= 48,
+	SERVER_HOOK_EVENT_ON_MAP_SHUTDOWN		= 49,
 	NUM_SERVER_HOOKS,
 };
 
@@ -131,6 +132,7 @@ typedef void(*tOnDamageBuilding)(GameObject* go);
 typedef bool(*tOnMountFlying) (Player* plr);
 typedef bool(*tOnPreAuraRemove)(Player* plr,uint32 spellID);
 typedef void(*tOnSlowLockOpen)(GameObject* go,Player* plr);
+typedef void(*tOnMapShutdown)(MapMgr* mgr);
 
 class CreatureAIScript;
 class GossipScript;
@@ -389,6 +391,9 @@ public:
 	bool OnMountFlying(Player* plr);
 	bool OnPreAuraRemove(Player* remover,uint32 spellID);
 	void OnSlowLockOpen(GameObject* go,Player* plr);
+
+	// Called on the map's own thread just before it stops
+	void OnMapShutdown(MapMgr* pMgr);
 };
 
 #define sScriptMgr ScriptMgr::getSingleton()
@@ -0,0 +1,407 @@
+/***
+ * Demonstrike Core
+ */
+
+#include "StdAfx.h"
+#if PLATFORM != PLATFORM_WIN
+#include <dirent.h>
+#endif
+
+// Upper bounds in us. Map ticks are aimed at MAP_MGR_UPDATE_PERIOD (100 ms), session updates mostly drain an empty queue
+static const uint32 s_mapTickBounds[METRIC_HISTOGRAM_BOUNDS] = { 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000 };
+static const uint32 s_sessionBounds[METRIC_HISTOGRAM_BOUNDS] = { 10, 25, 50, 100, 250, 500, 1000, 2500, 10000, 50000 };
+
+void MetricHistogram::Add(const MetricHistogram & other)
+{
+	Count += other.Count;
+	SumUs += other.SumUs;
+	for(uint32 i = 0; i <= METRIC_HISTOGRAM_BOUNDS; ++i)
+		Buckets[i] += other.Buckets[i];
+}
+
+struct MapTickMetrics
+{
+	MetricHistogram Ticks;
+	uint64 Overruns;
+};
+
+struct ServerMetricsThread
+{
+	MapTickMetrics * Maps[NUM_MAPS];
+	MetricHistogram SessionUpdates;
+
+	ServerMetricsThread()
+	{
+		memset(Maps, 0, sizeof(Maps));
+		memset(&SessionUpdates, 0, sizeof(SessionUpdates));
+	}
+
+	~ServerMetricsThread()
+	{
+		for(uint32 i = 0; i < NUM_MAPS; ++i)
+			delete Maps[i];
+	}
+
+	HEARTHSTONE_INLINE void RecordMapTick(uint32 mapId, uint32 us, bool overrun)
+	{
+		MapTickMetrics * map = Maps[mapId];
+		if(map == NULL)
+		{
+			map = new MapTickMetrics;
+			memset(map, 0, sizeof(MapTickMetrics));
+			Maps[mapId] = map;
+		}
+
+		map->Ticks.Observe(us, s_mapTickBounds);
+		if(overrun)
+			++map->Overruns;
+	}
+
+	void Add(const ServerMetricsThread & other)
+	{
+		SessionUpdates.Add(other.SessionUpdates);
+		for(uint32 i = 0; i < NUM_MAPS; ++i)
+		{
+			MapTickMetrics * src = other.Maps[i];
+			if(src == NULL)
+				continue;
+
+			MapTickMetrics * dst = Maps[i];
+			if(dst == NULL)
+			{
+				dst = new MapTickMetrics;
+				memset(dst, 0, sizeof(MapTickMetrics));
+				Maps[i] = dst;
+			}
+			dst->Ticks.Add(src->Ticks);
+			dst->Overruns += src->Overruns;
+		}
+	}
+};
+
+// Tables are never reset, the exported counters have to keep rising. A thread that exits
+// folds its table into s_retired, so pool threads coming and going don't grow the list.
+static Mutex s_threadListLock;
+static std::vector<ServerMetricsThread*> s_threads;
+static ServerMetricsThread s_retired;
+static THREAD_LOCAL ServerMetricsThread * t_serverMetrics = NULL;
+
+static ServerMetricsThread * GetThreadTable()
+{
+	ServerMetricsThread * table = t_serverMetrics;
+	if(table == NULL)
+	{
+		table = new ServerMetricsThread;
+		s_threadListLock.Acquire();
+		s_threads.push_back(table);
+		s_threadListLock.Release();
+		t_serverMetrics = table;
+	}
+	return table;
+}
+
+void ServerMetrics::ReleaseThreadTable()
+{
+	ServerMetricsThread * table = t_serverMetrics;
+	if(table == NULL)
+		return;
+
+	t_serverMetrics = NULL;
+	s_threadListLock.Acquire();
+	s_threads.erase(std::find(s_threads.begin(), s_threads.end(), table));
+	s_retired.Add(*table);
+	s_threadListLock.Release();
+	delete table;
+}
+
+void ServerMetrics::RecordMapTick(uint32 mapId, uint32 us, bool overrun)
+{
+	if(mapId >= NUM_MAPS)
+		return;
+
+	GetThreadTable()->RecordMapTick(mapId, us, overrun);
+}
+
+void ServerMetrics::RecordSessionUpdate(uint32 us)
+{
+	GetThreadTable()->SessionUpdates.Observe(us, s_sessionBounds);
+}
+
+// The owners keep counting while we read, close enough for a scrape
+static void MergeThreadTables(std::vector<MapTickMetrics> & maps, MetricHistogram & sessions)
+{
+	maps.resize(NUM_MAPS);
+	memset(&maps[0], 0, sizeof(MapTickMetrics) * NUM_MAPS);
+	memset(&sessions, 0, sizeof(MetricHistogram));
+
+	s_threadListLock.Acquire();
+	for(size_t t = 0; t <= s_threads.size(); ++t)
+	{
+		const ServerMetricsThread * table = t < s_threads.size() ? s_threads[t] : &s_retired;
+		sessions.Add(table->SessionUpdates);
+		for(uint32 i = 0; i < NUM_MAPS; ++i)
+		{
+			MapTickMetrics * src = table->Maps[i];
+			if(src == NULL)
+				continue;
+
+			maps[i].Ticks.Add(src->Ticks);
+			maps[i].Overruns += src->Overruns;
+		}
+	}
+	s_threadListLock.Release();
+}
+
+/************************************************************************/
+/* Prometheus text                                                      */
+/************************************************************************/
+
+static void Appendf(std::string & out, const char * format, ...)
+{
+	char buffer[512];
+	va_list ap;
+	va_start(ap, format);
+	int len = vsnprintf(buffer, sizeof(buffer), format, ap);
+	va_end(ap);
+	if(len > 0)
+		out.append(buffer, std::min(size_t(len), sizeof(buffer) - 1));
+}
+
+static void AppendHeader(std::string & out, const char * name, const char * type, const char * help)
+{
+	Appendf(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+static void AppendHistogram(std::string & out, const char * name, const char * labels, const MetricHistogram & hist, const uint32 * bounds)
+{
+	const char * sep = labels[0] ? "," : "";
+	uint64 cumulative = 0;
+	for(uint32 i = 0; i < METRIC_HISTOGRAM_BOUNDS; ++i)
+	{
+		cumulative += hist.Buckets[i];
+		Appendf(out, "%s_bucket{%s%sle=\"%g\"} " I64FMTD "\n", name, labels, sep, double(bounds[i]) / 1000000.0, cumulative);
+	}
+	cumulative += hist.Buckets[METRIC_HISTOGRAM_BOUNDS];
+	Appendf(out, "%s_bucket{%s%sle=\"+Inf\"} " I64FMTD "\n", name, labels, sep, cumulative);
+	if(labels[0])
+	{
+		Appendf(out, "%s_sum{%s} %.6f\n", name, labels, double(hist.SumUs) / 1000000.0);
+		Appendf(out, "%s_count{%s} " I64FMTD "\n", name, labels, cumulative);
+	}
+	else
+	{
+		Appendf(out, "%s_sum %.6f\n", name, double(hist.SumUs) / 1000000.0);
+		Appendf(out, "%s_count " I64FMTD "\n", name, cumulative);
+	}
+}
+
+static void AppendMapGauge(std::string & out, const std::vector<MapMetrics> & maps, const char * name, const char * help, uint32 MapMetrics::*field)
+{
+	AppendHeader(out, name, "gauge", help);
+	for(uint32 i = 0; i < NUM_MAPS; ++i)
+	{
+		if(maps[i].Instances)
+			Appendf(out, "%s{map=\"%u\"} %u\n", name, i, maps[i].*field);
+	}
+}
+
+// Each family has to come in one piece under its own HELP and TYPE, so every one loops over the databases
+static void AppendDatabases(std::string & out)
+{
+	Database * dbs[2] = { Database_World, Database_Character };
+	const char * labels[2] = { "world", "character" };
+	uint32 i;
+
+	AppendHeader(out, "hearthstone_db_queue_depth", "gauge", "Statements waiting for a database thread.");
+	for(i = 0; i < 2; ++i)
+	{
+		if(dbs[i] == NULL)
+			continue;
+		Appendf(out, "hearthstone_db_queue_depth{db=\"%s\",queue=\"async\"} %u\n", labels[i], dbs[i]->GetQueueSize());
+		Appendf(out, "hearthstone_db_queue_depth{db=\"%s\",queue=\"buffer\"} %u\n", labels[i], dbs[i]->GetBufferQueueSize());
+	}
+
+	AppendHeader(out, "hearthstone_db_queries_total", "counter", "Statements sent to the database server.");
+	for(i = 0; i < 2; ++i)
+	{
+		if(dbs[i] != NULL)
+			Appendf(out, "hearthstone_db_queries_total{db=\"%s\"} " I64FMTD "\n", labels[i], uint64(dbs[i]->QueriesSent.GetVal()));
+	}
+
+	AppendHeader(out, "hearthstone_db_query_seconds_total", "counter", "Time spent waiting on the database server.");
+	for(i = 0; i < 2; ++i)
+	{
+		if(dbs[i] != NULL)
+			Appendf(out, "hearthstone_db_query_seconds_total{db=\"%s\"} %.6f\n", labels[i], double(dbs[i]->QueryTimeUs.GetVal()) / 1000000.0);
+	}
+}
+
+#if PLATFORM != PLATFORM_WIN
+// Name and utime + stime of a /proc stat file, the name may hold spaces and parentheses itself
+static bool ReadProcStat(const char * path, std::string & name, double & cpuSeconds)
+{
+	char buffer[512];
+	FILE * f = fopen(path, "r");
+	if(f == NULL)
+		return false;
+	size_t len = fread(buffer, 1, sizeof(buffer) - 1, f);
+	fclose(f);
+	buffer[len] = 0;
+
+	char * open = strchr(buffer, '(');
+	char * close = strrchr(buffer, ')');
+	if(open == NULL || close == NULL || close < open)
+		return false;
+
+	unsigned long utime, stime;
+	char state;
+	if(sscanf(close + 1, " %c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &state, &utime, &stime) != 3)
+		return false;
+
+	name.assign(open + 1, close - open - 1);
+	for(std::string::iterator itr = name.begin(); itr != name.end(); ++itr)
+	{
+		if(*itr == '"' || *itr == '\\' || *itr == '\n')
+			*itr = '_';
+	}
+	cpuSeconds = double(utime + stime) / double(sysconf(_SC_CLK_TCK));
+	return true;
+}
+
+static void AppendProcess(std::string & out)
+{
+	unsigned long size, resident;
+	FILE * f = fopen("/proc/self/statm", "r");
+	if(f != NULL)
+	{
+		if(fscanf(f, "%lu %lu", &size, &resident) == 2)
+		{
+			uint64 page = uint64(sysconf(_SC_PAGESIZE));
+			AppendHeader(out, "process_virtual_memory_bytes", "gauge", "Virtual memory size in bytes.");
+			Appendf(out, "process_virtual_memory_bytes " I64FMTD "\n", uint64(size) * page);
+			AppendHeader(out, "process_resident_memory_bytes", "gauge", "Resident memory size in bytes.");
+			Appendf(out, "process_resident_memory_bytes " I64FMTD "\n", uint64(resident) * page);
+		}
+		fclose(f);
+	}
+
+	std::string name;
+	double cpu;
+	if(ReadProcStat("/proc/self/stat", name, cpu))
+	{
+		AppendHeader(out, "process_cpu_seconds_total", "counter", "User and system cpu time of the whole process.");
+		Appendf(out, "process_cpu_seconds_total %.2f\n", cpu);
+	}
+
+	DIR * dir = opendir("/proc/self/task");
+	if(dir == NULL)
+		return;
+
+	AppendHeader(out, "hearthstone_thread_cpu_seconds_total", "counter", "User and system cpu time per thread.");
+	char path[64];
+	struct dirent * entry;
+	while((entry = readdir(dir)) != NULL)
+	{
+		if(entry->d_name[0] < '0' || entry->d_name[0] > '9')
+			continue;
+
+		snprintf(path, sizeof(path), "/proc/self/task/%s/stat", entry->d_name);
+		if(ReadProcStat(path, name, cpu))
+			Appendf(out, "hearthstone_thread_cpu_seconds_total{tid=\"%s\",thread=\"%s\"} %.2f\n", entry->d_name, name.c_str(), cpu);
+	}
+	closedir(dir);
+}
+#endif
+
+void ServerMetrics::Write(std::string & out)
+{
+	std::vector<MapTickMetrics> ticks;
+	MetricHistogram sessions;
+	MergeThreadTables(ticks, sessions);
+
+	std::vector<MapMetrics> maps(NUM_MAPS);
+	memset(&maps[0], 0, sizeof(MapMetrics) * NUM_MAPS);
+	sInstanceMgr.GetMapMetrics(&maps[0]);
+
+	char labels[32];
+	AppendHeader(out, "hearthstone_map_tick_seconds", "histogram", "Time one map update loop took, all instances of the map together.");
+	for(uint32 i = 0; i < NUM_MAPS; ++i)
+	{
+		if(ticks[i].Ticks.Count == 0)
+			continue;
+
+		snprintf(labels, sizeof(labels), "map=\"%u\"", i);
+		AppendHistogram(out, "hearthstone_map_tick_seconds", labels, ticks[i].Ticks, s_mapTickBounds);
+	}
+
+	AppendHeader(out, "hearthstone_map_tick_overruns_total", "counter", "Map ticks that took longer than the update period.");
+	for(uint32 i = 0; i < NUM_MAPS; ++i)
+	{
+		if(ticks[i].Ticks.Count != 0)
+			Appendf(out, "hearthstone_map_tick_overruns_total{map=\"%u\"} " I64FMTD "\n", i, ticks[i].Overruns);
+	}
+
+	AppendMapGauge(out, maps, "hearthstone_map_instances", "Running map managers.", &MapMetrics::Instances);
+	AppendMapGauge(out, maps, "hearthstone_map_players", "Players in the world.", &MapMetrics::Players);
+	AppendMapGauge(out, maps, "hearthstone_map_sessions", "Sessions updated by the map.", &MapMetrics::Sessions);
+	AppendMapGauge(out, maps, "hearthstone_map_creatures", "Creatures in the world.", &MapMetrics::Creatures);
+	AppendMapGauge(out, maps, "hearthstone_map_gameobjects", "Gameobjects in the world.", &MapMetrics::GameObjects);
+	AppendMapGauge(out, maps, "hearthstone_map_pending_updates", "Objects waiting for their update block.", &MapMetrics::PendingUpdates);
+
+	AppendHeader(out, "hearthstone_session_update_seconds", "histogram", "Time one session update took, packet handlers included.");
+	AppendHistogram(out, "hearthstone_session_update_seconds", "", sessions, s_sessionBounds);
+
+	AppendHeader(out, "hearthstone_sessions", "gauge", "Authenticated sessions.");
+	Appendf(out, "hearthstone_sessions %u\n", uint32(sWorld.GetSessionCount()));
+	AppendHeader(out, "hearthstone_players_online", "gauge", "Players in the world by faction.");
+	Appendf(out, "hearthstone_players_online{faction=\"alliance\"} %u\n", sWorld.AlliancePlayers);
+	Appendf(out, "hearthstone_players_online{faction=\"horde\"} %u\n", sWorld.HordePlayers);
+
+	AppendDatabases(out);
+
+	if(SocketEngine::getSingletonPtr() != NULL)
+	{
+		AppendHeader(out, "hearthstone_socket_connections", "gauge", "Connected sockets.");
+		Appendf(out, "hearthstone_socket_connections %ld\n", sSocketEngine.Connections.GetVal());
+		AppendHeader(out, "hearthstone_socket_received_bytes_total", "counter", "Bytes read from sockets.");
+		Appendf(out, "hearthstone_socket_received_bytes_total " I64FMTD "\n", uint64(sSocketEngine.BytesReceived.GetVal()));
+		AppendHeader(out, "hearthstone_socket_sent_bytes_total", "counter", "Bytes written to sockets.");
+		Appendf(out, "hearthstone_socket_sent_bytes_total " I64FMTD "\n", uint64(sSocketEngine.BytesSent.GetVal()));
+		AppendHeader(out, "hearthstone_socket_events_total", "counter", "Readiness events returned by the socket engine.");
+		Appendf(out, "hearthstone_socket_events_total " I64FMTD "\n", uint64(sSocketEngine.Events.GetVal()));
+	}
+
+	AppendHeader(out, "process_start_time_seconds", "gauge", "Start time of the process since the epoch.");
+	Appendf(out, "process_start_time_seconds %u\n", sWorld.GetStartTime());
+#if PLATFORM != PLATFORM_WIN
+	AppendProcess(out);
+#endif
+}
+
+bool ServerMetrics::WriteFile(const char * filename)
+{
+	std::string out;
+	out.reserve(64 * 1024);
+	Write(out);
+
+	// Scrapers only read *.prom, the temporary name is skipped
+	std::string tmp = std::string(filename) + ".tmp";
+	FILE * f = fopen(tmp.c_str(), "wb");
+	if(f == NULL)
+		return false;
+
+	bool written = fwrite(out.data(), 1, out.size(), f) == out.size();
+	if(fclose(f) != 0)
+		written = false;
+	if(!written)
+	{
+		remove(tmp.c_str());
+		return false;
+	}
+
+#ifdef WIN32
+	// rename doesn't replace here, the file is missing for a moment
+	remove(filename);
+#endif
+	return rename(tmp.c_str(), filename) == 0;
+}
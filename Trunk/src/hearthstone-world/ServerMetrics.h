@@ -0,0 +1,60 @@
+/***
+ * Demonstrike Core
+ */
+
+#pragma once
+
+/************************************************************************/
+/* Metrics export                                                       */
+/************************************************************************/
+// Map ticks and session updates are counted in the updating thread's own table,
+// the same way opcode timing is, so recording never takes a lock. Everything
+// else (player and object counts, database queues, sockets, process cpu and
+// memory) is read when the export is written. The export is Prometheus text,
+// written to a temporary file and renamed over the old one so a scraper never
+// sees half of it.
+
+#define METRIC_HISTOGRAM_BOUNDS 10
+
+struct MetricHistogram
+{
+	uint64 Count;
+	uint64 SumUs;
+	uint64 Buckets[METRIC_HISTOGRAM_BOUNDS + 1];	// not cumulative, the last one is +Inf
+
+	HEARTHSTONE_INLINE void Observe(uint32 us, const uint32 * bounds)
+	{
+		uint32 i = 0;
+		while(i < METRIC_HISTOGRAM_BOUNDS && us > bounds[i])
+			++i;
+		++Buckets[i];
+		++Count;
+		SumUs += us;
+	}
+
+	void Add(const MetricHistogram & other);
+};
+
+// Read from the map managers under the instance lock when the export is written
+struct MapMetrics
+{
+	uint32 Instances;
+	uint32 Players;
+	uint32 Sessions;
+	uint32 Creatures;
+	uint32 GameObjects;
+	uint32 PendingUpdates;
+};
+
+class SERVER_DECL ServerMetrics
+{
+public:
+	static void RecordMapTick(uint32 mapId, uint32 us, bool overrun);
+	static void RecordSessionUpdate(uint32 us);
+
+	// Called by a thread on its way out, its counts move to the retired totals
+	static void ReleaseThreadTable();
+
+	static void Write(std::string & out);
+	static bool WriteFile(const char * filename);
+};
@@ -19,6 +19,9 @@ void WorldSession::HandleAddFriendOpcode( WorldPacket & recv_data )
 	recv_data >> name;
 	recv_data >> note;
 
+	if( objmgr.GetPlayerInfoByName(name.c_str()) == NULL && DeferUntilPlayerInfoLoaded(objmgr.GetPlayerGuidByName(name.c_str()), recv_data) )
+		return;
+
 	_player->Social_AddFriend( name.c_str(), note.size() ? note.c_str() : NULL );
 }
 
@@ -39,6 +42,9 @@ void WorldSession::HandleAddIgnoreOpcode( WorldPacket & recv_data )
 	std::string ignoreName = "UNKNOWN";
 	recv_data >> ignoreName;
 
+	if( objmgr.GetPlayerInfoByName(ignoreName.c_str()) == NULL && DeferUntilPlayerInfoLoaded(objmgr.GetPlayerGuidByName(ignoreName.c_str()), recv_data) )
+		return;
+
 	_player->Social_AddIgnore( ignoreName.c_str() );
 }
 
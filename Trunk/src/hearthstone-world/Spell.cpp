@@ -1061,7 +1061,7 @@ bool Spell::GenerateTargets(SpellCastTargets *t)
 uint8 Spell::prepare( SpellCastTargets * targets )
 {
 	uint8 ccr;
-	if( p_caster && (GetSpellProto()->Id == 51514 || GetSpellProto()->NameHash == SPELL_HASH_ARCANE_SHOT || GetSpellProto()->NameHash == SPELL_HASH_MIND_FLAY))
+	if( p_caster && (GetSpellProto()->Id == 51514 || GetSpellProto()->HasBehaviour(SPELL_BEHAVIOUR_RETARGET_ON_PREPARE)) )
 	{
 		targets->m_unitTarget = 0;
 		GenerateTargets( targets );
@@ -1401,7 +1401,7 @@ void Spell::cast(bool check)
 			else if(m_spellInfo->NameHash == SPELL_HASH_VICTORY_RUSH)
 				p_caster->RemoveFlag(UNIT_FIELD_AURASTATE, AURASTATE_FLAG_VICTORIOUS);
 
-			if(m_spellInfo->NameHash == SPELL_HASH_HOLY_LIGHT || m_spellInfo->NameHash == SPELL_HASH_FLASH_OF_LIGHT)
+			if(m_spellInfo->HasBehaviour(SPELL_BEHAVIOUR_HOLY_LIGHT))
 			{
 				p_caster->RemoveAura(53672);
 				p_caster->RemoveAura(54149);
@@ -3552,7 +3552,7 @@ uint8 Spell::CanCast(bool tolerate)
 		// check if spell is allowed while we have a battleground flag
 		if(p_caster->m_bgHasFlag)
 		{
-			if( (GetSpellProto()->NameHash == SPELL_HASH_DIVINE_SHIELD || GetSpellProto()->NameHash == SPELL_HASH_ICE_BLOCK) )
+			if( GetSpellProto()->HasBehaviour(SPELL_BEHAVIOUR_DROPS_BG_FLAG) )
 			{
 				if(p_caster->m_bg && p_caster->m_bg->GetType() == BATTLEGROUND_WARSONG_GULCH)
 					TO_WARSONGGULCH(p_caster->m_bg)->DropFlag( p_caster );
@@ -3644,7 +3644,7 @@ uint8 Spell::CanCast(bool tolerate)
 		}
 
 		// stealth check
-		if( GetSpellProto()->NameHash == SPELL_HASH_STEALTH || GetSpellProto()->NameHash == SPELL_HASH_PROWL )
+		if( GetSpellProto()->HasBehaviour(SPELL_BEHAVIOUR_STEALTH) )
 		{
 			if( p_caster->CombatStatus.IsInCombat() )
 				return SPELL_FAILED_TARGET_IN_COMBAT;
@@ -4826,11 +4826,7 @@ void Spell::Heal(int32 amount)
 				amount += float2int32( float(amount) * b );
 			}
 
-			if( u_caster->HasDummyAura(SPELL_HASH_LIVING_SEED) &&
-				( GetSpellProto()->NameHash == SPELL_HASH_SWIFTMEND ||
-				GetSpellProto()->NameHash == SPELL_HASH_REGROWTH ||
-				GetSpellProto()->NameHash == SPELL_HASH_NOURISH ||
-				GetSpellProto()->NameHash == SPELL_HASH_HEALING_TOUCH) )
+			if( GetSpellProto()->HasBehaviour(SPELL_BEHAVIOUR_LIVING_SEED) && u_caster->HasDummyAura(SPELL_HASH_LIVING_SEED) )
 			{
 				uint32 chance = ( u_caster->GetDummyAura(SPELL_HASH_LIVING_SEED)->RankNumber * 33 ) + 1;
 				if( Rand( chance ) )
@@ -4867,9 +4863,7 @@ void Spell::Heal(int32 amount)
 			u_caster->HandleProc(NULL, PROC_ON_SPELL_CRIT_HIT, unitTarget, m_spellInfo, amount);
 		}
 
-		if( unitTarget != NULL && (GetSpellProto()->NameHash == SPELL_HASH_GREATER_HEAL ||
-			GetSpellProto()->NameHash == SPELL_HASH_FLASH_HEAL ||
-			GetSpellProto()->NameHash == SPELL_HASH_PENANCE ) &&
+		if( unitTarget != NULL && GetSpellProto()->HasBehaviour(SPELL_BEHAVIOUR_RAPTURE) &&
 			u_caster->HasDummyAura( SPELL_HASH_RAPTURE ) && u_caster->m_CustomTimers[CUSTOM_TIMER_RAPTURE] <= getMSTime() )
 		{
 			SpellEntry *spellInfo = dbcSpell.LookupEntry( 47755 );
@@ -4897,8 +4891,8 @@ void Spell::Heal(int32 amount)
 	} else
 		unitTarget->ModUnsigned32Value(UNIT_FIELD_HEALTH, amount);
 
-	if( overheal && u_caster && u_caster->HasDummyAura(SPELL_HASH_SERENDIPITY) && u_caster->m_LastSpellManaCost &&
-		( GetSpellProto()->NameHash == SPELL_HASH_GREATER_HEAL || GetSpellProto()->NameHash == SPELL_HASH_FLASH_HEAL ) )
+	if( overheal && u_caster && GetSpellProto()->HasBehaviour(SPELL_BEHAVIOUR_SERENDIPITY) && u_caster->m_LastSpellManaCost &&
+		u_caster->HasDummyAura(SPELL_HASH_SERENDIPITY) )
 	{
 		int32 amt = float2int32( u_caster->m_LastSpellManaCost * ( 0.08f * u_caster->GetDummyAura(SPELL_HASH_SERENDIPITY)->RankNumber ));
 		SpellEntry* SpellInfo = dbcSpell.LookupEntry( 47762 );
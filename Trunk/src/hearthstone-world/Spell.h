@@ -87,6 +87,9 @@ public:
 	~Spell();
 	virtual void Destruct();
 
+	// Spells are created and destroyed per cast, keep their storage in a per thread pool
+	DECLARE_POOLED_ALLOCATOR(Spell)
+
 	float m_missilePitch;
 	uint32 m_missileTravelTime;
 	uint32 MSTimeToAddToTravel;
@@ -601,5 +604,9 @@ void GenerateSpellCoeffFile();
 void CopyEffect(SpellEntry *fromSpell, uint8 fromEffect, SpellEntry *toSpell, uint8 toEffect);
 void ApplySingleSpellFixes(SpellEntry *sp);
 void ApplyCoeffSpellFixes(SpellEntry *sp);
+void SetSpellBehaviourFlags(SpellEntry *sp);
+#ifdef _DEBUG
+uint32 CheckSpellBehaviourFlags(uint32 & checked);
+#endif
 void SetProcFlags(SpellEntry *sp);
 void SetupSpellTargets();
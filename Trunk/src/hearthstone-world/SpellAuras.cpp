@@ -1515,7 +1515,7 @@ void Aura::EventPeriodicDamage(uint32 amount)
 		Unit * m_caster = GetUnitCaster();
 		if( m_caster != NULL )
 		{
-			if( proto->NameHash == SPELL_HASH_EXPLOSIVE_SHOT || proto->NameHash == SPELL_HASH_MIND_FLAY )
+			if( proto->HasBehaviour(SPELL_BEHAVIOUR_DOT_CAN_CRIT) )
 				DOTCanCrit = true;
 
 			m_caster->m_AuraInterface.RemoveAllAurasByInterruptFlagButSkip(AURA_INTERRUPT_ON_START_ATTACK, GetSpellId());
@@ -3362,7 +3362,7 @@ void Aura::SpellAuraPeriodicHeal( bool apply )
 		uint32 time = m_spellProto->EffectAmplitude[mod->i] > 0 ? m_spellProto->EffectAmplitude[mod->i] : 3000;
 		sEventMgr.AddEvent( this, &Aura::EventPeriodicHeal, (uint32)amount, EVENT_AURA_PERIODIC_HEAL, time, 0, EVENT_FLAG_DO_NOT_EXECUTE_IN_WORLD_CONTEXT );
 
-		if( m_spellProto->NameHash == SPELL_HASH_REJUVENATION || m_spellProto->NameHash == SPELL_HASH_REGROWTH || m_spellProto->NameHash == SPELL_HASH_LIFEBLOOM || m_spellProto->NameHash == SPELL_HASH_WILD_GROWTH)
+		if( m_spellProto->HasBehaviour(SPELL_BEHAVIOUR_REJUVENATE_AURASTATE) )
 		{
 			m_target->SetFlag(UNIT_FIELD_AURASTATE, AURASTATE_FLAG_REJUVENATE);
 			if(!sEventMgr.HasEvent( m_target, EVENT_REJUVENATION_FLAG_EXPIRE ) )
@@ -3962,7 +3962,7 @@ void Aura::SpellAuraModResistance(bool apply)
 	else
 		amt = -mod->m_amount;
 
-	if( m_spellProto && ( m_spellProto->NameHash == SPELL_HASH_FAERIE_FIRE || m_spellProto->NameHash == SPELL_HASH_FAERIE_FIRE__FERAL_ ) )
+	if( m_spellProto && m_spellProto->HasBehaviour(SPELL_BEHAVIOUR_FAERIE_FIRE) )
 		m_target->m_can_stealth = !apply;
 
 	if( m_target->IsPlayer() )
@@ -4171,7 +4171,7 @@ void Aura::SpellAuraModRoot(bool apply)
 		if(m_target->GetTypeId() == TYPEID_UNIT && m_caster != NULL)
 			m_target->GetAIInterface()->AttackReaction(m_caster, 1, 0);
 
-		if (m_spellProto->NameHash == SPELL_HASH_FROST_NOVA || m_spellProto->NameHash == SPELL_HASH_FROSTBITE)
+		if( m_spellProto->HasBehaviour(SPELL_BEHAVIOUR_FROZEN_AURASTATE) )
 			m_target->RemoveFlag(UNIT_FIELD_AURASTATE, AURASTATE_FLAG_FROZEN);
 	}
 }
@@ -4857,7 +4857,7 @@ void Aura::SpellAuraModSchoolImmunity(bool apply)
 			TO_PLAYER(m_target)->m_bgFlagIneligible--;
 	}
 
-	if( apply && ( m_spellProto->NameHash == SPELL_HASH_DIVINE_SHIELD || m_spellProto->NameHash == SPELL_HASH_ICE_BLOCK) ) // Paladin - Divine Shield
+	if( apply && m_spellProto->HasBehaviour(SPELL_BEHAVIOUR_DROPS_BG_FLAG) ) // Paladin - Divine Shield
 	{
 		if( !m_target || !m_target->isAlive())
 			return;
@@ -73,6 +73,8 @@ public:
 	Aura(SpellEntry *proto, int32 duration, Object* caster, Unit* target);
 	~Aura();
 
+	DECLARE_POOLED_ALLOCATOR(Aura)
+
 	void ExpireRemove();
 	void Remove();
 	void Expire();
@@ -1344,6 +1344,52 @@ enum SpellIsFlags
 	SPELL_FLAG_CASTED_ON_ENEMIES					= 0x01000000,
 };
 
+// NameHash groups the combat code used to compare one by one, compiled into SpellEntry::c_behaviour
+// at load (Spellfixes/SpellBehaviour.cpp). Test them with SpellEntry::HasBehaviour, at most 64.
+enum SpellBehaviour
+{
+	SPELL_BEHAVIOUR_HOLY_LIGHT,				// Holy Light, Flash of Light
+	SPELL_BEHAVIOUR_INFECTED_WOUNDS,		// Shred, Maul, Mangle
+	SPELL_BEHAVIOUR_HOLY_CONCENTRATION,		// Flash Heal, Binding Heal, Greater Heal
+	SPELL_BEHAVIOUR_BLOOD_FRENZY,			// Rend, Deep Wounds
+	SPELL_BEHAVIOUR_SWORD_AND_BOARD,		// Devastate, Revenge
+	SPELL_BEHAVIOUR_BLADE_TWISTING,			// Backstab, Sinister Strike, Shiv, Gouge
+	SPELL_BEHAVIOUR_NIGHTFALL,				// Corruption, Drain Life
+	SPELL_BEHAVIOUR_SHADOW_EMBRACE,			// Shadow Bolt, Haunt
+	SPELL_BEHAVIOUR_PYROCLASM,				// Rain of Fire, Hellfire, Soul Fire
+	SPELL_BEHAVIOUR_LIVING_SEED,			// Swiftmend, Regrowth, Healing Touch, Nourish
+	SPELL_BEHAVIOUR_INITIATIVE,				// Cheap Shot, Ambush, Garrote
+	SPELL_BEHAVIOUR_ART_OF_WAR,				// Crusader Strike, Divine Storm
+	SPELL_BEHAVIOUR_LIGHTNING_OVERLOAD,		// Lightning Bolt, Chain Lightning
+	SPELL_BEHAVIOUR_FINGERS_OF_FROST,		// Frostbolt, Cone of Cold, Frostfire Bolt
+	SPELL_BEHAVIOUR_IMMOLATE_CORRUPTION,	// Immolate, Corruption
+	SPELL_BEHAVIOUR_HOT_STREAK,				// Fireball, Fire Blast, Scorch, Living Bomb, Frostfire Bolt
+	SPELL_BEHAVIOUR_ANCESTRAL_AWAKENING,	// Healing Wave, Lesser Healing Wave, Riptide
+	SPELL_BEHAVIOUR_FIRESTARTER,			// Blast Wave, Dragon's Breath
+	SPELL_BEHAVIOUR_TIDAL_WAVES,			// Chain Heal, Riptide
+	SPELL_BEHAVIOUR_IMPROVED_SPIRIT_TAP,	// Mind Blast, Shadow Word: Death
+	SPELL_BEHAVIOUR_MISERY,					// Mind Flay, Vampiric Touch, Shadow Word: Pain
+	SPELL_BEHAVIOUR_EARTH_AND_MOON,			// Wrath, Starfire
+	SPELL_BEHAVIOUR_BLOODSURGE,				// Heroic Strike, Bloodthirst, Whirlwind
+	SPELL_BEHAVIOUR_MISSILE_BARRAGE,		// Arcane Blast, Arcane Barrage, Fireball, Frostbolt, Frostfire Bolt
+	SPELL_BEHAVIOUR_ILLUMINATION,			// Holy Light, Flash of Light, Holy Shock
+	SPELL_BEHAVIOUR_GAG_ORDER,				// Shield Bash, Heroic Throw
+	SPELL_BEHAVIOUR_DESECRATION,			// Plague Strike, Scourge Strike
+	SPELL_BEHAVIOUR_MELEE_WEAPON_RANGED,	// Hammer of Wrath, Avenger's Shield: ranged but hit with the main hand
+	SPELL_BEHAVIOUR_REND_AND_TEAR,			// Maul, Shred
+	SPELL_BEHAVIOUR_SEAL_FATE_GOUGE,		// Gouge, Mutilate
+	SPELL_BEHAVIOUR_RETARGET_ON_PREPARE,	// Arcane Shot, Mind Flay
+	SPELL_BEHAVIOUR_DROPS_BG_FLAG,			// Divine Shield, Ice Block
+	SPELL_BEHAVIOUR_STEALTH,				// Stealth, Prowl
+	SPELL_BEHAVIOUR_RAPTURE,				// Greater Heal, Flash Heal, Penance
+	SPELL_BEHAVIOUR_SERENDIPITY,			// Greater Heal, Flash Heal
+	SPELL_BEHAVIOUR_DOT_CAN_CRIT,			// Explosive Shot, Mind Flay
+	SPELL_BEHAVIOUR_REJUVENATE_AURASTATE,	// Rejuvenation, Regrowth, Lifebloom, Wild Growth
+	SPELL_BEHAVIOUR_FAERIE_FIRE,			// Faerie Fire, Faerie Fire (Feral)
+	SPELL_BEHAVIOUR_FROZEN_AURASTATE,		// Frost Nova, Frostbite
+	NUM_SPELL_BEHAVIOURS
+};
+
 enum PoisonTypes
 {
 	POISON_TYPE_DEADLY			= 1,
@@ -3326,6 +3326,18 @@ void Spell::SpellEffectCharge(uint32 i)
 	if(dx == 0.0f || dy == 0.0f)
 		return;
 
+	// Stop at the first wall on the way instead of running through it
+	if(sWorld.PathFinding && NavMeshInterface.IsNavmeshLoadedAtPosition(u_caster->GetMapId(), u_caster->GetPositionX(), u_caster->GetPositionY()))
+	{
+		LocationVector hit;
+		if(NavMeshInterface.Raycast(u_caster->GetMapId(), u_caster->GetPositionX(), u_caster->GetPositionY(), u_caster->GetPositionZ(), x, y, z, hit, u_caster))
+		{
+			x = hit.x;
+			y = hit.y;
+			z = hit.z;
+		}
+	}
+
 	uint32 time = uint32( (m_caster->CalcDistance(x,y,z) / ((u_caster->m_runSpeed * 3.5) * 0.001f)) + 0.5);
 	u_caster->GetAIInterface()->SendMoveToPacket(x, y, z, 0.0f, time, MONSTER_MOVE_FLAG_WALK);
 	u_caster->SetPosition(x,y,z,0.0f,true);
@@ -3648,7 +3660,6 @@ void Spell::SpellEffectSummonObjectSlot(uint32 i)
 		GoSummon->invisibilityFlag = INVIS_FLAG_TRAP;
 		GoSummon->charges = 1;
 		GoSummon->checkrate = 1;
-		sEventMgr.AddEvent(GoSummon, &GameObject::TrapSearchTarget, EVENT_GAMEOBJECT_TRAP_SEARCH_TARGET, 100, 0,0);
 	}
 	else
 		GoSummon->ExpireAndDelete(GetDuration());
@@ -4761,6 +4772,7 @@ void Spell::SpellEffectClearFinishedQuest(uint32 i)
 		return;
 
 	playerTarget->m_finishedQuests.erase(GetSpellProto()->EffectMiscValue[i]);
+	playerTarget->InvalidateQuestGiverStatus();
 }
 
 void Spell::SpellEffectApplyDemonAura( uint32 i )
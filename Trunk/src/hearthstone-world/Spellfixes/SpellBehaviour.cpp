@@ -0,0 +1,195 @@
+/***
+ * Demonstrike Core
+ */
+
+#include "StdAfx.h"
+
+struct SpellBehaviourRule
+{
+	uint32 behaviour;
+	uint32 hashes[6];	// zero terminated
+};
+
+static const SpellBehaviourRule SpellBehaviourRules[] =
+{
+	{ SPELL_BEHAVIOUR_HOLY_LIGHT,			{ SPELL_HASH_FLASH_OF_LIGHT, SPELL_HASH_HOLY_LIGHT, 0 } },
+	{ SPELL_BEHAVIOUR_INFECTED_WOUNDS,		{ SPELL_HASH_SHRED, SPELL_HASH_MAUL, SPELL_HASH_MANGLE__CAT_, SPELL_HASH_MANGLE__BEAR_, 0 } },
+	{ SPELL_BEHAVIOUR_HOLY_CONCENTRATION,	{ SPELL_HASH_FLASH_HEAL, SPELL_HASH_BINDING_HEAL, SPELL_HASH_GREATER_HEAL, 0 } },
+	{ SPELL_BEHAVIOUR_BLOOD_FRENZY,			{ SPELL_HASH_REND, SPELL_HASH_DEEP_WOUNDS, 0 } },
+	{ SPELL_BEHAVIOUR_SWORD_AND_BOARD,		{ SPELL_HASH_DEVASTATE, SPELL_HASH_REVENGE, 0 } },
+	{ SPELL_BEHAVIOUR_BLADE_TWISTING,		{ SPELL_HASH_BACKSTAB, SPELL_HASH_SINISTER_STRIKE, SPELL_HASH_SHIV, SPELL_HASH_GOUGE, 0 } },
+	{ SPELL_BEHAVIOUR_NIGHTFALL,			{ SPELL_HASH_CORRUPTION, SPELL_HASH_DRAIN_LIFE, 0 } },
+	{ SPELL_BEHAVIOUR_SHADOW_EMBRACE,		{ SPELL_HASH_SHADOW_BOLT, SPELL_HASH_HAUNT, 0 } },
+	{ SPELL_BEHAVIOUR_PYROCLASM,			{ SPELL_HASH_RAIN_OF_FIRE, SPELL_HASH_HELLFIRE_EFFECT, SPELL_HASH_SOUL_FIRE, 0 } },
+	{ SPELL_BEHAVIOUR_LIVING_SEED,			{ SPELL_HASH_SWIFTMEND, SPELL_HASH_REGROWTH, SPELL_HASH_HEALING_TOUCH, SPELL_HASH_NOURISH, 0 } },
+	{ SPELL_BEHAVIOUR_INITIATIVE,			{ SPELL_HASH_CHEAP_SHOT, SPELL_HASH_AMBUSH, SPELL_HASH_GARROTE, 0 } },
+	{ SPELL_BEHAVIOUR_ART_OF_WAR,			{ SPELL_HASH_CRUSADER_STRIKE, SPELL_HASH_DIVINE_STORM, 0 } },
+	{ SPELL_BEHAVIOUR_LIGHTNING_OVERLOAD,	{ SPELL_HASH_LIGHTNING_BOLT, SPELL_HASH_CHAIN_LIGHTNING, 0 } },
+	{ SPELL_BEHAVIOUR_FINGERS_OF_FROST,		{ SPELL_HASH_FROSTBOLT, SPELL_HASH_CONE_OF_COLD, SPELL_HASH_FROSTFIRE_BOLT, 0 } },
+	{ SPELL_BEHAVIOUR_IMMOLATE_CORRUPTION,	{ SPELL_HASH_IMMOLATE, SPELL_HASH_CORRUPTION, 0 } },
+	{ SPELL_BEHAVIOUR_HOT_STREAK,			{ SPELL_HASH_FIREBALL, SPELL_HASH_FIRE_BLAST, SPELL_HASH_SCORCH, SPELL_HASH_LIVING_BOMB, SPELL_HASH_FROSTFIRE_BOLT, 0 } },
+	{ SPELL_BEHAVIOUR_ANCESTRAL_AWAKENING,	{ SPELL_HASH_HEALING_WAVE, SPELL_HASH_LESSER_HEALING_WAVE, SPELL_HASH_RIPTIDE, 0 } },
+	{ SPELL_BEHAVIOUR_FIRESTARTER,			{ SPELL_HASH_BLAST_WAVE, SPELL_HASH_DRAGON_S_BREATH, 0 } },
+	{ SPELL_BEHAVIOUR_TIDAL_WAVES,			{ SPELL_HASH_CHAIN_HEAL, SPELL_HASH_RIPTIDE, 0 } },
+	{ SPELL_BEHAVIOUR_IMPROVED_SPIRIT_TAP,	{ SPELL_HASH_MIND_BLAST, SPELL_HASH_SHADOW_WORD__DEATH, 0 } },
+	{ SPELL_BEHAVIOUR_MISERY,				{ SPELL_HASH_MIND_FLAY, SPELL_HASH_VAMPIRIC_TOUCH, SPELL_HASH_SHADOW_WORD__PAIN, 0 } },
+	{ SPELL_BEHAVIOUR_EARTH_AND_MOON,		{ SPELL_HASH_WRATH, SPELL_HASH_STARFIRE, 0 } },
+	{ SPELL_BEHAVIOUR_BLOODSURGE,			{ SPELL_HASH_HEROIC_STRIKE, SPELL_HASH_BLOODTHIRST, SPELL_HASH_WHIRLWIND, 0 } },
+	{ SPELL_BEHAVIOUR_MISSILE_BARRAGE,		{ SPELL_HASH_ARCANE_BLAST, SPELL_HASH_ARCANE_BARRAGE, SPELL_HASH_FIREBALL, SPELL_HASH_FROSTBOLT, SPELL_HASH_FROSTFIRE_BOLT, 0 } },
+	{ SPELL_BEHAVIOUR_ILLUMINATION,			{ SPELL_HASH_HOLY_LIGHT, SPELL_HASH_FLASH_OF_LIGHT, SPELL_HASH_HOLY_SHOCK, 0 } },
+	{ SPELL_BEHAVIOUR_GAG_ORDER,			{ SPELL_HASH_SHIELD_BASH, SPELL_HASH_HEROIC_THROW, 0 } },
+	{ SPELL_BEHAVIOUR_DESECRATION,			{ SPELL_HASH_PLAGUE_STRIKE, SPELL_HASH_SCOURGE_STRIKE, 0 } },
+	{ SPELL_BEHAVIOUR_MELEE_WEAPON_RANGED,	{ SPELL_HASH_HAMMER_OF_WRATH, SPELL_HASH_AVENGER_S_SHIELD, 0 } },
+	{ SPELL_BEHAVIOUR_REND_AND_TEAR,		{ SPELL_HASH_MAUL, SPELL_HASH_SHRED, 0 } },
+	{ SPELL_BEHAVIOUR_SEAL_FATE_GOUGE,		{ SPELL_HASH_GOUGE, SPELL_HASH_MUTILATE, 0 } },
+	{ SPELL_BEHAVIOUR_RETARGET_ON_PREPARE,	{ SPELL_HASH_ARCANE_SHOT, SPELL_HASH_MIND_FLAY, 0 } },
+	{ SPELL_BEHAVIOUR_DROPS_BG_FLAG,		{ SPELL_HASH_DIVINE_SHIELD, SPELL_HASH_ICE_BLOCK, 0 } },
+	{ SPELL_BEHAVIOUR_STEALTH,				{ SPELL_HASH_STEALTH, SPELL_HASH_PROWL, 0 } },
+	{ SPELL_BEHAVIOUR_RAPTURE,				{ SPELL_HASH_GREATER_HEAL, SPELL_HASH_FLASH_HEAL, SPELL_HASH_PENANCE, 0 } },
+	{ SPELL_BEHAVIOUR_SERENDIPITY,			{ SPELL_HASH_GREATER_HEAL, SPELL_HASH_FLASH_HEAL, 0 } },
+	{ SPELL_BEHAVIOUR_DOT_CAN_CRIT,			{ SPELL_HASH_EXPLOSIVE_SHOT, SPELL_HASH_MIND_FLAY, 0 } },
+	{ SPELL_BEHAVIOUR_REJUVENATE_AURASTATE,	{ SPELL_HASH_REJUVENATION, SPELL_HASH_REGROWTH, SPELL_HASH_LIFEBLOOM, SPELL_HASH_WILD_GROWTH, 0 } },
+	{ SPELL_BEHAVIOUR_FAERIE_FIRE,			{ SPELL_HASH_FAERIE_FIRE, SPELL_HASH_FAERIE_FIRE__FERAL_, 0 } },
+	{ SPELL_BEHAVIOUR_FROZEN_AURASTATE,		{ SPELL_HASH_FROST_NOVA, SPELL_HASH_FROSTBITE, 0 } },
+};
+
+// Fails to compile unless there is a row for each behaviour and they all fit in c_behaviour
+typedef char SpellBehaviourRulesComplete[(sizeof(SpellBehaviourRules) / sizeof(SpellBehaviourRule) == NUM_SPELL_BEHAVIOURS) ? 1 : -1];
+typedef char SpellBehaviourBitsFit[(NUM_SPELL_BEHAVIOURS <= 64) ? 1 : -1];
+
+// Runs after the other fixes, they can still rename spells
+void SetSpellBehaviourFlags(SpellEntry *sp)
+{
+	sp->c_behaviour[0] = sp->c_behaviour[1] = 0;
+	for(uint32 i = 0; i < sizeof(SpellBehaviourRules) / sizeof(SpellBehaviourRule); ++i)
+	{
+		const SpellBehaviourRule & rule = SpellBehaviourRules[i];
+		for(uint32 j = 0; rule.hashes[j] != 0; ++j)
+		{
+			if(sp->NameHash == rule.hashes[j])
+			{
+				sp->c_behaviour[rule.behaviour >> 5] |= (1u << (rule.behaviour & 31));
+				break;
+			}
+		}
+	}
+}
+
+#ifdef _DEBUG
+// The comparisons exactly as the combat code had them before the behaviour bits, kept to prove the table right
+static bool LegacySpellBehaviour(SpellEntry *sp, uint32 behaviour)
+{
+	switch(behaviour)
+	{
+	case SPELL_BEHAVIOUR_HOLY_LIGHT:
+		return sp->NameHash == SPELL_HASH_FLASH_OF_LIGHT || sp->NameHash == SPELL_HASH_HOLY_LIGHT;
+	case SPELL_BEHAVIOUR_INFECTED_WOUNDS:
+		return !(sp->NameHash != SPELL_HASH_SHRED && sp->NameHash != SPELL_HASH_MAUL &&
+			sp->NameHash != SPELL_HASH_MANGLE__CAT_ && sp->NameHash != SPELL_HASH_MANGLE__BEAR_);
+	case SPELL_BEHAVIOUR_HOLY_CONCENTRATION:
+		return !(sp->NameHash != SPELL_HASH_FLASH_HEAL && sp->NameHash != SPELL_HASH_BINDING_HEAL && sp->NameHash != SPELL_HASH_GREATER_HEAL);
+	case SPELL_BEHAVIOUR_BLOOD_FRENZY:
+		return !(sp->NameHash != SPELL_HASH_REND && sp->NameHash != SPELL_HASH_DEEP_WOUNDS);
+	case SPELL_BEHAVIOUR_SWORD_AND_BOARD:
+		return !(sp->NameHash != SPELL_HASH_DEVASTATE && sp->NameHash != SPELL_HASH_REVENGE);
+	case SPELL_BEHAVIOUR_BLADE_TWISTING:
+		return !(sp->NameHash != SPELL_HASH_BACKSTAB && sp->NameHash != SPELL_HASH_SINISTER_STRIKE &&
+			sp->NameHash != SPELL_HASH_SHIV && sp->NameHash != SPELL_HASH_GOUGE);
+	case SPELL_BEHAVIOUR_NIGHTFALL:
+		return !(sp->NameHash != SPELL_HASH_CORRUPTION && sp->NameHash != SPELL_HASH_DRAIN_LIFE);
+	case SPELL_BEHAVIOUR_SHADOW_EMBRACE:
+		return !(sp->NameHash != SPELL_HASH_SHADOW_BOLT && sp->NameHash != SPELL_HASH_HAUNT);
+	case SPELL_BEHAVIOUR_PYROCLASM:
+		return !(sp->NameHash != SPELL_HASH_RAIN_OF_FIRE && sp->NameHash != SPELL_HASH_HELLFIRE_EFFECT && sp->NameHash != SPELL_HASH_SOUL_FIRE);
+	case SPELL_BEHAVIOUR_LIVING_SEED:
+		return !(sp->NameHash != SPELL_HASH_SWIFTMEND && sp->NameHash != SPELL_HASH_REGROWTH &&
+			sp->NameHash != SPELL_HASH_HEALING_TOUCH && sp->NameHash != SPELL_HASH_NOURISH);
+	case SPELL_BEHAVIOUR_INITIATIVE:
+		return !(sp->NameHash != SPELL_HASH_CHEAP_SHOT && sp->NameHash != SPELL_HASH_AMBUSH && sp->NameHash != SPELL_HASH_GARROTE);
+	case SPELL_BEHAVIOUR_ART_OF_WAR:
+		return !(sp->NameHash != SPELL_HASH_CRUSADER_STRIKE && sp->NameHash != SPELL_HASH_DIVINE_STORM);
+	case SPELL_BEHAVIOUR_LIGHTNING_OVERLOAD:
+		return sp->NameHash == SPELL_HASH_LIGHTNING_BOLT || sp->NameHash == SPELL_HASH_CHAIN_LIGHTNING;
+	case SPELL_BEHAVIOUR_FINGERS_OF_FROST:
+		return !(sp->NameHash != SPELL_HASH_FROSTBOLT && sp->NameHash != SPELL_HASH_CONE_OF_COLD && sp->NameHash != SPELL_HASH_FROSTFIRE_BOLT);
+	case SPELL_BEHAVIOUR_IMMOLATE_CORRUPTION:
+		return !(sp->NameHash != SPELL_HASH_IMMOLATE && sp->NameHash != SPELL_HASH_CORRUPTION);
+	case SPELL_BEHAVIOUR_HOT_STREAK:
+		return !(sp->NameHash != SPELL_HASH_FIREBALL && sp->NameHash != SPELL_HASH_FIRE_BLAST && sp->NameHash != SPELL_HASH_SCORCH &&
+			sp->NameHash != SPELL_HASH_LIVING_BOMB && sp->NameHash != SPELL_HASH_FROSTFIRE_BOLT);
+	case SPELL_BEHAVIOUR_ANCESTRAL_AWAKENING:
+		return !(sp->NameHash != SPELL_HASH_HEALING_WAVE && sp->NameHash != SPELL_HASH_LESSER_HEALING_WAVE && sp->NameHash != SPELL_HASH_RIPTIDE);
+	case SPELL_BEHAVIOUR_FIRESTARTER:
+		return !(sp->NameHash != SPELL_HASH_BLAST_WAVE && sp->NameHash != SPELL_HASH_DRAGON_S_BREATH);
+	case SPELL_BEHAVIOUR_TIDAL_WAVES:
+		return !(sp->NameHash != SPELL_HASH_CHAIN_HEAL && sp->NameHash != SPELL_HASH_RIPTIDE);
+	case SPELL_BEHAVIOUR_IMPROVED_SPIRIT_TAP:
+		return !(sp->NameHash != SPELL_HASH_MIND_BLAST && sp->NameHash != SPELL_HASH_SHADOW_WORD__DEATH);
+	case SPELL_BEHAVIOUR_MISERY:
+		return !(sp->NameHash != SPELL_HASH_MIND_FLAY && sp->NameHash != SPELL_HASH_VAMPIRIC_TOUCH && sp->NameHash != SPELL_HASH_SHADOW_WORD__PAIN);
+	case SPELL_BEHAVIOUR_EARTH_AND_MOON:
+		return !(sp->NameHash != SPELL_HASH_WRATH && sp->NameHash != SPELL_HASH_STARFIRE);
+	case SPELL_BEHAVIOUR_BLOODSURGE:
+		return !(sp->NameHash != SPELL_HASH_HEROIC_STRIKE && sp->NameHash != SPELL_HASH_BLOODTHIRST && sp->NameHash != SPELL_HASH_WHIRLWIND);
+	case SPELL_BEHAVIOUR_MISSILE_BARRAGE:
+		return !(sp->NameHash != SPELL_HASH_ARCANE_BLAST && sp->NameHash != SPELL_HASH_ARCANE_BARRAGE && sp->NameHash != SPELL_HASH_FIREBALL &&
+			sp->NameHash != SPELL_HASH_FROSTBOLT && sp->NameHash != SPELL_HASH_FROSTFIRE_BOLT);
+	case SPELL_BEHAVIOUR_ILLUMINATION:
+		return !(sp->NameHash != SPELL_HASH_HOLY_LIGHT && sp->NameHash != SPELL_HASH_FLASH_OF_LIGHT && sp->NameHash != SPELL_HASH_HOLY_SHOCK);
+	case SPELL_BEHAVIOUR_GAG_ORDER:
+		return !(sp->NameHash != SPELL_HASH_SHIELD_BASH && sp->NameHash != SPELL_HASH_HEROIC_THROW);
+	case SPELL_BEHAVIOUR_DESECRATION:
+		return !(sp->NameHash != SPELL_HASH_PLAGUE_STRIKE && sp->NameHash != SPELL_HASH_SCOURGE_STRIKE);
+	case SPELL_BEHAVIOUR_MELEE_WEAPON_RANGED:
+		return sp->NameHash == SPELL_HASH_HAMMER_OF_WRATH || sp->NameHash == SPELL_HASH_AVENGER_S_SHIELD;
+	case SPELL_BEHAVIOUR_REND_AND_TEAR:
+		return sp->NameHash == SPELL_HASH_MAUL || sp->NameHash == SPELL_HASH_SHRED;
+	case SPELL_BEHAVIOUR_SEAL_FATE_GOUGE:
+		return sp->NameHash == SPELL_HASH_GOUGE || sp->NameHash == SPELL_HASH_MUTILATE;
+	case SPELL_BEHAVIOUR_RETARGET_ON_PREPARE:
+		return sp->NameHash == SPELL_HASH_ARCANE_SHOT || sp->NameHash == SPELL_HASH_MIND_FLAY;
+	case SPELL_BEHAVIOUR_DROPS_BG_FLAG:
+		return sp->NameHash == SPELL_HASH_DIVINE_SHIELD || sp->NameHash == SPELL_HASH_ICE_BLOCK;
+	case SPELL_BEHAVIOUR_STEALTH:
+		return sp->NameHash == SPELL_HASH_STEALTH || sp->NameHash == SPELL_HASH_PROWL;
+	case SPELL_BEHAVIOUR_RAPTURE:
+		return sp->NameHash == SPELL_HASH_GREATER_HEAL || sp->NameHash == SPELL_HASH_FLASH_HEAL || sp->NameHash == SPELL_HASH_PENANCE;
+	case SPELL_BEHAVIOUR_SERENDIPITY:
+		return sp->NameHash == SPELL_HASH_GREATER_HEAL || sp->NameHash == SPELL_HASH_FLASH_HEAL;
+	case SPELL_BEHAVIOUR_DOT_CAN_CRIT:
+		return sp->NameHash == SPELL_HASH_EXPLOSIVE_SHOT || sp->NameHash == SPELL_HASH_MIND_FLAY;
+	case SPELL_BEHAVIOUR_REJUVENATE_AURASTATE:
+		return sp->NameHash == SPELL_HASH_REJUVENATION || sp->NameHash == SPELL_HASH_REGROWTH ||
+			sp->NameHash == SPELL_HASH_LIFEBLOOM || sp->NameHash == SPELL_HASH_WILD_GROWTH;
+	case SPELL_BEHAVIOUR_FAERIE_FIRE:
+		return sp->NameHash == SPELL_HASH_FAERIE_FIRE || sp->NameHash == SPELL_HASH_FAERIE_FIRE__FERAL_;
+	case SPELL_BEHAVIOUR_FROZEN_AURASTATE:
+		return sp->NameHash == SPELL_HASH_FROST_NOVA || sp->NameHash == SPELL_HASH_FROSTBITE;
+	}
+	return false;
+}
+
+// Debug builds compare every loaded spell once at startup, returns how many spell/behaviour pairs disagree
+uint32 CheckSpellBehaviourFlags(uint32 & checked)
+{
+	uint32 mismatches = 0;
+	checked = 0;
+	for(uint32 x = 0; x < dbcSpell.GetNumRows(); ++x)
+	{
+		SpellEntry *sp = dbcSpell.LookupRow(x);
+		if(sp == NULL)
+			continue;
+
+		++checked;
+		for(uint32 b = 0; b < NUM_SPELL_BEHAVIOURS; ++b)
+		{
+			if(sp->HasBehaviour(b) == LegacySpellBehaviour(sp, b))
+				continue;
+
+			if(mismatches++ < 20)
+				Log.Error("SpellBehaviour", "Spell %u (%s) disagrees on behaviour %u", sp->Id, sp->Name, b);
+		}
+	}
+	return mismatches;
+}
+#endif
@@ -769,6 +769,7 @@ void ApplyNormalFixes()
 		// Apply spell fixes.
 		ApplySingleSpellFixes(sp);
 		ApplyCoeffSpellFixes(sp);
+		SetSpellBehaviourFlags(sp);
 	}
 
 	Log.Notice("World", "Setting target flags...");
@@ -784,12 +785,21 @@ void ApplyNormalFixes()
 			SetSingleSpellDefaults(Sp = CreateDummySpell(*itr));
 			ApplySingleSpellFixes(Sp);
 			ApplyCoeffSpellFixes(Sp);
+			SetSpellBehaviourFlags(Sp);
 			SetProcFlags(Sp);
 			if(dummySpellLevels.find(*itr) != dummySpellLevels.end())
 				Sp->spellLevel = dummySpellLevels[*itr];
 		}
 	}
 
+#ifdef _DEBUG
+	uint32 behaviourChecked, behaviourMismatches = CheckSpellBehaviourFlags(behaviourChecked);
+	if(behaviourMismatches)
+		Log.Error("World", "%u spell behaviour bits disagree with the old NameHash comparisons over %u spells.", behaviourMismatches, behaviourChecked);
+	else
+		Log.Notice("World", "Spell behaviour bits match the old NameHash comparisons for all %u spells.", behaviourChecked);
+#endif
+
 	/////////////////////////////////////////////////////////////////
 	//FORCER CREATURE SPELL TARGETING
 	//////////////////////////////////////////////////////////////////
@@ -1245,6 +1255,7 @@ void SetSingleSpellDefaults(SpellEntry *sp)
 	sp->proc_interval = 0; //trigger at each event
 	sp->ProcsPerMinute = 0;
 	sp->c_is_flags = 0;
+	sp->c_behaviour[0] = sp->c_behaviour[1] = 0;
 	sp->isAOE = false;
 	sp->SP_coef_override = 0;
 	sp->AP_coef_override = 0;
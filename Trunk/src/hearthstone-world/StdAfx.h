@@ -66,6 +66,7 @@
 #include "../hearthstone-shared/Auth/WowCrypt.h"
 #include "../hearthstone-shared/CrashHandler.h"
 #include "../hearthstone-shared/FastQueue.h"
+#include "../hearthstone-shared/ObjectPool.h"
 #include "../hearthstone-shared/CircularQueue.h"
 #include "../hearthstone-shared/Threading/RWLock.h"
 #include "../hearthstone-shared/Threading/Condition.h"
@@ -97,6 +98,7 @@
 #include "AddonMgr.h"
 #include "AI/AI_Headers.h"
 #include "AreaTrigger.h"
+#include "BattlegroundQueue.h"
 #include "BattlegroundMgr.h"
 #include "AlteracValley.h"
 #include "ArathiBasin.h"
@@ -128,7 +130,11 @@
 #include "NPCHandler.h"
 #include "Pet.h"
 #include "Summons.h"
+#include "WorldPacketPool.h"
+#include "OpcodeStats.h"
+#include "ServerMetrics.h"
 #include "WorldSocket.h"
+#include "MovementLOD.h"
 #include "World.h"
 #include "WorldSession.h"
 #include "WorldStateManager.h"
@@ -6,6 +6,7 @@
 
 TerrainMgr::TerrainMgr(string MapPath, uint32 MapId, bool Instanced) : mapPath(MapPath), mapId(MapId), Instance(Instanced)
 {
+	mutex.SetLockName("TerrainMgr::mutex");
 	TileCountX = TileCountY = 0;
 	TileStartX = TileEndX = 0;
 	TileStartY = TileEndY = 0;
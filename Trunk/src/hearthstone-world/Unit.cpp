@@ -367,7 +367,17 @@ void Unit::Update( uint32 p_time )
 
 		/*-----------------------POWER & HP REGENERATION-----------------*/
 		if( p_time >= m_H_regenTimer )
+		{
+			// Creatures nobody is near update less often, give them the regen ticks they slept through
+			uint32 missed = IsPlayer() ? 0 : p_time - m_H_regenTimer;
 			RegenerateHealth();
+			while( missed >= m_H_regenTimer )
+			{
+				missed -= m_H_regenTimer;
+				RegenerateHealth();
+			}
+			m_H_regenTimer -= missed;
+		}
 		else
 			m_H_regenTimer -= p_time;
 
@@ -377,7 +387,15 @@ void Unit::Update( uint32 p_time )
 			{
 				if( p_time >= m_p_DelayTimer )
 				{
+					// Same catch up as health, counted from whichever of the two timers ran out last
+					uint32 missed = p_time - std::max(m_P_regenTimer, m_p_DelayTimer);
 					RegeneratePower( false );
+					while( m_P_regenTimer && missed >= m_P_regenTimer )
+					{
+						missed -= m_P_regenTimer;
+						RegeneratePower( false );
+					}
+					m_P_regenTimer -= std::min(missed, m_P_regenTimer);
 					m_interruptedRegenTime = 0;
 				}
 				else m_p_DelayTimer -= p_time;
@@ -702,8 +720,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 				if( !CastingSpell )
 					continue;
 
-				if( CastingSpell->NameHash == SPELL_HASH_FLASH_OF_LIGHT ||
-					CastingSpell->NameHash == SPELL_HASH_HOLY_LIGHT )
+				if( CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_HOLY_LIGHT) )
 				{
 					spellId = 40471;
 					proc_Chance -= 35;
@@ -850,18 +867,13 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 						case 58180:
 						case 58181:
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_SHRED &&
-									CastingSpell->NameHash != SPELL_HASH_MAUL &&
-									CastingSpell->NameHash != SPELL_HASH_MANGLE__CAT_ &&
-									CastingSpell->NameHash != SPELL_HASH_MANGLE__BEAR_ )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_INFECTED_WOUNDS) )
 									continue;
 							}break;
 
 						case 34754: //holy concentration
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_FLASH_HEAL &&
-									CastingSpell->NameHash != SPELL_HASH_BINDING_HEAL &&
-									CastingSpell->NameHash != SPELL_HASH_GREATER_HEAL )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_HOLY_CONCENTRATION) )
 									continue;
 							}break;
 
@@ -869,16 +881,14 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 						case 30069:
 						case 30070:
 							{
-									if( CastingSpell->NameHash != SPELL_HASH_REND &&
-										CastingSpell->NameHash != SPELL_HASH_DEEP_WOUNDS )
+									if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_BLOOD_FRENZY) )
 										continue;
 							}break;
 
 							// Sword and Board
 						case 50227:
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_DEVASTATE &&
-									CastingSpell->NameHash != SPELL_HASH_REVENGE )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_SWORD_AND_BOARD) )
 									continue;
 							}break;
 
@@ -901,10 +911,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 						case 31125:
 							{
 								//only trigger effect for specified spells
-								if( CastingSpell->NameHash != SPELL_HASH_BACKSTAB && //backstab
-									CastingSpell->NameHash != SPELL_HASH_SINISTER_STRIKE && //sinister strike
-									CastingSpell->NameHash != SPELL_HASH_SHIV && //shiv
-									CastingSpell->NameHash != SPELL_HASH_GOUGE ) //gouge
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_BLADE_TWISTING) ) //backstab, sinister strike, shiv, gouge
 									continue;
 							}break;
 
@@ -979,8 +986,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 						case 17941:
 							{
 								//only trigger effect for specified spells
-								if( CastingSpell->NameHash != SPELL_HASH_CORRUPTION && //Corruption
-									CastingSpell->NameHash != SPELL_HASH_DRAIN_LIFE )//Drain Life
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_NIGHTFALL) ) //Corruption, Drain Life
 									continue;
 							}break;
 
@@ -990,8 +996,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 						case 32390:
 						case 32391:
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_SHADOW_BOLT &&
-									CastingSpell->NameHash != SPELL_HASH_HAUNT )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_SHADOW_EMBRACE) )
 									continue;
 							}break;
 
@@ -1022,9 +1027,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 						case 18093:
 							{
 								//only trigger effect for specified spells
-								if( CastingSpell->NameHash != SPELL_HASH_RAIN_OF_FIRE && //Rain of Fire
-									CastingSpell->NameHash != SPELL_HASH_HELLFIRE_EFFECT && //Hellfire
-									CastingSpell->NameHash != SPELL_HASH_SOUL_FIRE ) //Soul Fire
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_PYROCLASM) ) //Rain of Fire, Hellfire, Soul Fire
 									continue;
 							}break;
 
@@ -1074,10 +1077,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 							//Druid Living Seed
 						case 48504:
 							{
-								if ( CastingSpell->NameHash != SPELL_HASH_SWIFTMEND &&
-									CastingSpell->NameHash != SPELL_HASH_REGROWTH &&
-									CastingSpell->NameHash != SPELL_HASH_HEALING_TOUCH &&
-									CastingSpell->NameHash != SPELL_HASH_NOURISH )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_LIVING_SEED) )
 									continue;
 							}break;
 
@@ -1247,9 +1247,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 						case 13977:
 							{
 								//we need a Ambush, Garrote, or Cheap Shot
-								if( CastingSpell->NameHash != SPELL_HASH_CHEAP_SHOT && //Cheap Shot
-									CastingSpell->NameHash != SPELL_HASH_AMBUSH && //Ambush
-									CastingSpell->NameHash != SPELL_HASH_GARROTE )  //Garrote
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_INITIATIVE) )
 									continue;
 							}break;
 
@@ -1380,8 +1378,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 						case 53489:
 						case 59578:
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_CRUSADER_STRIKE &&
-									CastingSpell->NameHash != SPELL_HASH_DIVINE_STORM &&
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_ART_OF_WAR) &&
 									!(CastingSpell->buffType & SPELL_TYPE_JUDGEMENT) )
 									continue;
 							}break;
@@ -1392,8 +1389,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 									continue;
 								if(!IsPlayer())
 									continue;
-								if( CastingSpell->NameHash != SPELL_HASH_CRUSADER_STRIKE &&
-									CastingSpell->NameHash != SPELL_HASH_DIVINE_STORM &&
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_ART_OF_WAR) &&
 									CastingSpell->buffType != SPELL_TYPE_JUDGEMENT )
 									continue;
 
@@ -1435,7 +1431,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 						case 39805:
 							{
 								//trigger on lightning and chain lightning. Spell should be identical , well maybe next time :P
-								if(	CastingSpell->NameHash == SPELL_HASH_LIGHTNING_BOLT || CastingSpell->NameHash == SPELL_HASH_CHAIN_LIGHTNING )
+								if( CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_LIGHTNING_OVERLOAD) )
 								{
 									spellId = CastingSpell->Id;
 									dmg_overwrite = (CastingSpell->EffectBasePoints[0] + 1) / 2; //only half dmg
@@ -1456,9 +1452,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 						case 44544: //Fingers of Frost
 						case 57761: //Brain Freeze
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_FROSTBOLT &&
-									CastingSpell->NameHash != SPELL_HASH_CONE_OF_COLD &&
-									CastingSpell->NameHash != SPELL_HASH_FROSTFIRE_BOLT )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_FINGERS_OF_FROST) )
 									continue;
 							}break;
 
@@ -1523,8 +1517,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 
 						case 43837:
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_FLASH_OF_LIGHT &&
-									CastingSpell->NameHash != SPELL_HASH_HOLY_LIGHT )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_HOLY_LIGHT) )
 									continue;
 							}break;
 
@@ -1635,18 +1628,13 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 
 						case 38395:
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_IMMOLATE &&
-									CastingSpell->NameHash != SPELL_HASH_CORRUPTION)
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_IMMOLATE_CORRUPTION) )
 									continue;
 							}break;
 
 						case 48108: // [Mage] Hot Streak
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_FIREBALL &&
-									CastingSpell->NameHash != SPELL_HASH_FIRE_BLAST &&
-									CastingSpell->NameHash != SPELL_HASH_SCORCH &&
-									CastingSpell->NameHash != SPELL_HASH_LIVING_BOMB &&
-									CastingSpell->NameHash != SPELL_HASH_FROSTFIRE_BOLT )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_HOT_STREAK) )
 									continue;
 
 								m_hotStreakCount++;
@@ -1701,10 +1689,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 							{
 								if(ospinfo == NULL)
 									continue;
-								if((CastingSpell->NameHash != SPELL_HASH_HEALING_WAVE &&
-									CastingSpell->NameHash != SPELL_HASH_LESSER_HEALING_WAVE &&
-									CastingSpell->NameHash != SPELL_HASH_RIPTIDE) ||
-									!IsPlayer())
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_ANCESTRAL_AWAKENING) || !IsPlayer() )
 									continue;
 
 								targets.m_unitTarget = Spell::FindLowestHealthRaidMember(TO_PLAYER(this), 1600); // within 40 yards
@@ -1723,8 +1708,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 
 						case 54741: //Firestarter
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_BLAST_WAVE &&
-									CastingSpell->NameHash != SPELL_HASH_DRAGON_S_BREATH )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_FIRESTARTER) )
 									continue;
 							}break;
 
@@ -1737,8 +1721,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 
 						case 53390: //Tidal Waves
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_CHAIN_HEAL &&
-									CastingSpell->NameHash != SPELL_HASH_RIPTIDE )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_TIDAL_WAVES) )
 									continue;
 							}break;
 
@@ -1774,8 +1757,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 						case 49694://Improved Spirit Tap
 						case 59000:
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_MIND_BLAST &&
-									CastingSpell->NameHash != SPELL_HASH_SHADOW_WORD__DEATH )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_IMPROVED_SPIRIT_TAP) )
 									continue;
 							}break;
 
@@ -1783,9 +1765,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 						case 33197:
 						case 33198:
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_MIND_FLAY &&
-									CastingSpell->NameHash != SPELL_HASH_VAMPIRIC_TOUCH &&
-									CastingSpell->NameHash != SPELL_HASH_SHADOW_WORD__PAIN )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_MISERY) )
 									continue;
 							}break;
 
@@ -1836,17 +1816,14 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 						case 60432:
 						case 60431: // Earth and Moon
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_WRATH &&
-									CastingSpell->NameHash != SPELL_HASH_STARFIRE )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_EARTH_AND_MOON) )
 									continue;
 							}break;
 
 							// Bloodsurge
 						case 46916:
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_HEROIC_STRIKE &&
-									CastingSpell->NameHash != SPELL_HASH_BLOODTHIRST &&
-									CastingSpell->NameHash != SPELL_HASH_WHIRLWIND )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_BLOODSURGE) )
 									continue;
 							}break;
 
@@ -1865,11 +1842,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 
 						case 44401: // Missile Barrage
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_ARCANE_BLAST &&
-									CastingSpell->NameHash != SPELL_HASH_ARCANE_BARRAGE &&
-									CastingSpell->NameHash != SPELL_HASH_FIREBALL &&
-									CastingSpell->NameHash != SPELL_HASH_FROSTBOLT &&
-									CastingSpell->NameHash != SPELL_HASH_FROSTFIRE_BOLT )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_MISSILE_BARRAGE) )
 									continue;
 							}break;
 
@@ -1888,9 +1861,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 							// Illumination
 						case 20272:
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_HOLY_LIGHT &&
-									CastingSpell->NameHash != SPELL_HASH_FLASH_OF_LIGHT &&
-									CastingSpell->NameHash != SPELL_HASH_HOLY_SHOCK )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_ILLUMINATION) )
 									continue;
 
 								dmg_overwrite = float2int32(GetSpellBaseCost(CastingSpell) * 0.3f);
@@ -1907,7 +1878,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 							// Gag order
 						case 18498:
 							{
-								if( CastingSpell->NameHash != SPELL_HASH_SHIELD_BASH && CastingSpell->NameHash != SPELL_HASH_HEROIC_THROW )
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_GAG_ORDER) )
 									continue;
 							}break;
 
@@ -1971,7 +1942,7 @@ uint32 Unit::HandleProc( uint32 flag, uint32 flag2, Unit* victim, SpellEntry* Ca
 						case 55666: // Desecration Rank 1
 						case 55667: // Desecration Rank 2
 							{
-								if(CastingSpell->NameHash != SPELL_HASH_PLAGUE_STRIKE && CastingSpell->NameHash != SPELL_HASH_SCOURGE_STRIKE)
+								if( !CastingSpell->HasBehaviour(SPELL_BEHAVIOUR_DESECRATION) )
 									continue;
 							}break;
 
@@ -2823,7 +2794,7 @@ uint32 Unit::GetSpellDidHitResult( Unit* pVictim, uint32 weapon_damage_type, Spe
 
 		// erm. some spells don't use ranged weapon skill but are still a ranged spell and use melee stats instead
 		// i.e. hammer of wrath
-		if( ability && (ability->NameHash == SPELL_HASH_HAMMER_OF_WRATH || ability->NameHash == SPELL_HASH_AVENGER_S_SHIELD) )
+		if( ability && ability->HasBehaviour(SPELL_BEHAVIOUR_MELEE_WEAPON_RANGED) )
 		{
 			it = pr->GetItemInterface()->GetInventoryItem( EQUIPMENT_SLOT_MAINHAND );
 			hitmodifier += pr->CalcRating( PLAYER_RATING_MODIFIER_MELEE_HIT );
@@ -3588,8 +3559,8 @@ int32 Unit::Strike( Unit* pVictim, uint32 weapon_damage_type, SpellEntry* abilit
 			if( IsPet() && !TO_PET(this)->IsSummonedPet() )
 				dmg.full_damage = ( dmg.full_damage <= 0 ) ? 0 : float2int32( dmg.full_damage * TO_PET(this)->GetHappinessDmgMod() );
 
-			if( HasDummyAura(SPELL_HASH_REND_AND_TEAR) && ability &&
-				( ability->NameHash == SPELL_HASH_MAUL || ability->NameHash == SPELL_HASH_SHRED) && pVictim->m_AuraInterface.HasNegAuraWithMechanic(MECHANIC_BLEEDING) )
+			if( ability && ability->HasBehaviour(SPELL_BEHAVIOUR_REND_AND_TEAR) && HasDummyAura(SPELL_HASH_REND_AND_TEAR) &&
+				pVictim->m_AuraInterface.HasNegAuraWithMechanic(MECHANIC_BLEEDING) )
 			{
 				dmg.full_damage += float2int32(dmg.full_damage * ( ( GetDummyAura(SPELL_HASH_REND_AND_TEAR)->RankNumber * 4 ) / 100.f ) );
 			}
@@ -3699,7 +3670,7 @@ int32 Unit::Strike( Unit* pVictim, uint32 weapon_damage_type, SpellEntry* abilit
 
 						// UGLY GOUGE HAX
 						// too lazy to fix this properly...
-						if( this && IsPlayer() && TO_PLAYER(this)->HasDummyAura(SPELL_HASH_SEAL_FATE) && ability && ( ability->NameHash == SPELL_HASH_GOUGE || ability->NameHash == SPELL_HASH_MUTILATE ) )
+						if( ability && ability->HasBehaviour(SPELL_BEHAVIOUR_SEAL_FATE_GOUGE) && IsPlayer() && TO_PLAYER(this)->HasDummyAura(SPELL_HASH_SEAL_FATE) )
 						{
 							if( Rand( TO_PLAYER(this)->GetDummyAura(SPELL_HASH_SEAL_FATE)->RankNumber * 20.0f ) )
 								TO_PLAYER(this)->AddComboPoints(pVictim->GetGUID(), 1);
@@ -5596,6 +5567,8 @@ void CombatStatusHandler::UpdateFlag()
 			//printf(I64FMT" is now in combat.\n", m_Unit->GetGUID());
 			m_Unit->SetFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_COMBAT);
 			if(!m_Unit->hasStateFlag(UF_ATTACKING)) m_Unit->addStateFlag(UF_ATTACKING);
+			if(m_Unit->IsCreature())
+				TO_CREATURE(m_Unit)->WakeForUpdate();
 		}
 		else
 		{
@@ -6442,6 +6415,18 @@ void Unit::knockback(int32 basepoint, uint32 miscvalue, bool disengage )
 		float x = GetPositionX() + (value1 * dx);
 		float y = GetPositionY() + (value1 * dy);
 		float z = GetPositionZ();
+
+		// Land against a wall instead of behind it, and on the ground rather than at our old height
+		if(sWorld.PathFinding && NavMeshInterface.IsNavmeshLoadedAtPosition(GetMapId(), GetPositionX(), GetPositionY()))
+		{
+			LocationVector hit;
+			if(NavMeshInterface.Raycast(GetMapId(), GetPositionX(), GetPositionY(), GetPositionZ(), x, y, z, hit, this))
+			{
+				x = hit.x;
+				y = hit.y;
+				z = hit.z;
+			}
+		}
 		float dist = CalcDistance(x, y, z);
 		uint32 movetime = GetAIInterface()->GetMovementTime(dist);
 		GetAIInterface()->SendMoveToPacket( x, y, z, 0.0f, movetime, MONSTER_MOVE_FLAG_JUMP );
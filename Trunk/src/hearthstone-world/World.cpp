@@ -9,6 +9,11 @@ initialiseSingleton( World );
 
 World::World()
 {
+	m_sessionlock.SetLockName("World::m_sessionlock");
+	SessionsMutex.SetLockName("World::SessionsMutex");
+	queueMutex.SetLockName("World::queueMutex");
+	gmList_lock.SetLockName("World::gmList_lock");
+
 	m_playerLimit = 0;
 	m_allowMovement = true;
 	m_gmTicketSystem = true;
@@ -35,6 +40,11 @@ World::World()
 	m_speedHackLatencyMultiplier = 0.0f;
 	m_speedHackResetInterval = 5000;
 	m_CEThreshold = 10000;
+	m_slowHandlerThreshold = 0;
+	m_opcodeStatsDumpInterval = 0;
+	m_opcodeStatsLastDump = 0;
+	m_metricsInterval = 0;
+	m_metricsLastWrite = 0;
 	LacrimiThread = NULL;
 	LacrimiPtr = NULL;
 
@@ -174,6 +184,22 @@ WorldSession* World::FindSession(uint32 id)
 	return ret;
 }
 
+bool World::QueueSessionPacket(uint32 id, WorldPacket * packet)
+{
+	// Sessions leave the map under the write lock before they are deleted
+	m_sessionlock.AcquireReadLock();
+	SessionMap::const_iterator itr = m_sessions.find(id);
+	if(itr == m_sessions.end())
+	{
+		m_sessionlock.ReleaseReadLock();
+		return false;
+	}
+
+	itr->second->QueuePacket(packet);
+	m_sessionlock.ReleaseReadLock();
+	return true;
+}
+
 void World::RemoveSession(uint32 id)
 {
 	SessionMap::iterator itr = m_sessions.find(id);
@@ -388,6 +414,8 @@ bool World::SetInitialWorldSettings()
 		return false;
 	}
 
+	BuildFactionRelations();
+
 	/* Convert area table ids/flags */
 	DBCFile area;
 	if( !area.open( format("%s/AreaTable.dbc", sWorld.DBCPath.c_str()).c_str() ) )
@@ -448,9 +476,8 @@ bool World::SetInitialWorldSettings()
 
 	Storage_LoadAdditionalTables();
 
-	ThreadPool.ExecuteTask("TaskExecutor", new BasicTaskExecutor(new CallbackP0<ObjectMgr>(ObjectMgr::getSingletonPtr(),
-		&ObjectMgr::LoadPlayersInfo), BTE_PRIORITY_MED));
-
+	// Guilds, groups and arena teams look their members up, so this has to finish first
+	MAKE_TASK(ObjectMgr, LoadPlayersInfo);
 	MAKE_TASK(ObjectMgr, LoadPlayerCreateInfo);
 	MAKE_TASK(ObjectMgr, LoadSpellSkills);
 	tl.wait();
@@ -698,6 +725,33 @@ void World::Update(time_t diff)
 
 	if(GuildMgr::getSingletonPtr() != NULL)
 		guildmgr.Update(pDiff);
+
+	if(ObjectMgr::getSingletonPtr() != NULL)
+		objmgr.UpdatePlayerInfoCache();
+
+	if(m_opcodeStatsDumpInterval)
+	{
+		uint32 now = getMSTime();
+		if(m_opcodeStatsLastDump == 0)
+			m_opcodeStatsLastDump = now;
+		else if(now - m_opcodeStatsLastDump >= m_opcodeStatsDumpInterval)
+		{
+			m_opcodeStatsLastDump = now;
+			if(!OpcodeStats::WriteDump(m_opcodeStatsDumpFile.c_str()))
+				Log.Error("World", "Could not write opcode stats to %s", m_opcodeStatsDumpFile.c_str());
+		}
+	}
+
+	if(m_metricsInterval)
+	{
+		uint32 now = getMSTime();
+		if(now - m_metricsLastWrite >= m_metricsInterval)
+		{
+			m_metricsLastWrite = now;
+			if(!ServerMetrics::WriteFile(m_metricsFile.c_str()))
+				Log.Error("World", "Could not write metrics to %s", m_metricsFile.c_str());
+		}
+	}
 }
 
 void World::SendMessageToGMs(WorldSession *self, const char * text, ...)
@@ -879,6 +933,7 @@ void World::UpdateSessions(uint32 diff)
 	SessionSet::iterator itr, it2;
 	WorldSession *GlobalSession;
 	int result;
+	uint64 sessionStart;
 	SessionsMutex.Acquire();
 	for(itr = GlobalSessions.begin(); itr != GlobalSessions.end();)
 	{
@@ -897,7 +952,9 @@ void World::UpdateSessions(uint32 diff)
 
 		if(bServerShutdown)
 			break;
+		sessionStart = getUSTime();
 		result = GlobalSession->Update(0);
+		ServerMetrics::RecordSessionUpdate(uint32(getUSTime() - sessionStart));
 		if(result)
 		{
 			if(result == 1)//socket don't exist anymore, delete from worldsessions.
@@ -1488,6 +1545,31 @@ void World::Rehash(bool load)
 	m_movementCompressThreshold = Config.MainConfig.GetFloatDefault("Movement", "CompressThreshold", 25.0f);
 	m_movementCompressThreshold *= m_movementCompressThreshold;		// square it to avoid sqrt() on checks
 
+	ParseMovementLODSettings(m_movementLOD[MOVEMENT_LOD_CONTINENT], Config.MainConfig.GetStringDefault("MovementLOD", "Continent", "30 70 1000 2000").c_str());
+	ParseMovementLODSettings(m_movementLOD[MOVEMENT_LOD_DUNGEON], Config.MainConfig.GetStringDefault("MovementLOD", "Dungeon", "0").c_str());
+	ParseMovementLODSettings(m_movementLOD[MOVEMENT_LOD_RAID], Config.MainConfig.GetStringDefault("MovementLOD", "Raid", "40 80 1000 2000").c_str());
+	ParseMovementLODSettings(m_movementLOD[MOVEMENT_LOD_BATTLEGROUND], Config.MainConfig.GetStringDefault("MovementLOD", "Battleground", "40 80 1000 2000").c_str());
+
+	m_slowHandlerThreshold = Config.MainConfig.GetIntDefault("OpcodeStats", "SlowHandler", 50) * 1000;
+	m_opcodeStatsDumpInterval = Config.MainConfig.GetIntDefault("OpcodeStats", "DumpInterval", 300) * 1000;
+	m_opcodeStatsDumpFile = Config.MainConfig.GetStringDefault("OpcodeStats", "DumpFile", "opcodestats.txt");
+
+	m_collisionPrefetchDistance = Config.MainConfig.GetFloatDefault("Collision", "PrefetchDistance", 150.0f);
+	m_collisionFlightPrefetch = Config.MainConfig.GetIntDefault("Collision", "FlightPrefetch", 15) * 1000;
+	m_collisionPrefetchExpire = Config.MainConfig.GetIntDefault("Collision", "PrefetchExpire", 60) * 1000;
+
+	m_creatureUpdateTiered = Config.MainConfig.GetBoolDefault("CreatureUpdate", "Tiered", true);
+	m_creatureUpdateNearDistance = Config.MainConfig.GetFloatDefault("CreatureUpdate", "NearDistance", 60.0f);
+	m_creatureUpdateFarDistance = Config.MainConfig.GetFloatDefault("CreatureUpdate", "FarDistance", 120.0f);
+	m_creatureUpdateMidInterval = Config.MainConfig.GetIntDefault("CreatureUpdate", "MidInterval", 400);
+	m_creatureUpdateFarInterval = Config.MainConfig.GetIntDefault("CreatureUpdate", "FarInterval", 1000);
+
+	m_partyStatsInterval = Config.MainConfig.GetIntDefault("PartyStats", "Interval", 500);
+	m_spawnTemplates = Config.MainConfig.GetBoolDefault("SpawnTemplates", "Enabled", true);
+
+	m_metricsInterval = Config.MainConfig.GetIntDefault("Metrics", "Interval", 15) * 1000;
+	m_metricsFile = Config.MainConfig.GetStringDefault("Metrics", "File", "hearthstone-world.prom");
+
 	m_speedHackThreshold = Config.MainConfig.GetFloatDefault("AntiHack", "SpeedThreshold", -500.0f);
 	m_speedHackLatencyMultiplier = Config.MainConfig.GetFloatDefault("AntiHack", "SpeedLatencyCompensation", 0.25f);
 	m_speedHackResetInterval = Config.MainConfig.GetIntDefault("AntiHack", "SpeedResetPeriod", 5000);
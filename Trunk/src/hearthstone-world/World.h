@@ -427,6 +427,8 @@ public:
 
 	void CleanupCheaters();
 	WorldSession* FindSession(uint32 id);
+	// Hands a packet to the account's session for its own thread to handle, safe from any thread
+	bool QueueSessionPacket(uint32 id, WorldPacket * packet);
 	WorldSession* FindSessionByName(const char *);
 	void AddSession(WorldSession *s);
 	void RemoveSession(uint32 id);
@@ -764,6 +766,25 @@ public:
 	float m_movementCompressThresholdCreatures;
 	uint32 m_movementCompressRate;
 	uint32 m_movementCompressInterval;
+	MovementLODSettings m_movementLOD[NUM_MOVEMENT_LOD_TYPES];
+	HEARTHSTONE_INLINE const MovementLODSettings & GetMovementLOD(uint32 lodType) { return m_movementLOD[lodType]; }
+	uint32 m_slowHandlerThreshold;			// us
+	uint32 m_opcodeStatsDumpInterval;		// ms
+	uint32 m_opcodeStatsLastDump;
+	std::string m_opcodeStatsDumpFile;
+	float m_collisionPrefetchDistance;
+	uint32 m_collisionFlightPrefetch;		// ms
+	uint32 m_collisionPrefetchExpire;		// ms
+	bool m_creatureUpdateTiered;
+	float m_creatureUpdateNearDistance;
+	float m_creatureUpdateFarDistance;
+	uint32 m_creatureUpdateMidInterval;		// ms
+	uint32 m_creatureUpdateFarInterval;		// ms
+	uint32 m_partyStatsInterval;			// ms
+	bool m_spawnTemplates;
+	uint32 m_metricsInterval;				// ms
+	uint32 m_metricsLastWrite;
+	std::string m_metricsFile;
 	float m_speedHackThreshold;
 	float m_speedHackLatencyMultiplier;
 	uint32 m_speedHackResetInterval;
@@ -782,6 +782,30 @@ void InstanceMgr::BuildXMLStats(char * m_file)
 	Log.Debug("InstanceMgr", "Dumping XML stats...");
 }
 
+void InstanceMgr::GetMapMetrics(MapMetrics * maps)
+{
+	InstanceMap::iterator itr;
+	InstanceMap * instancemap;
+
+	m_mapLock.Acquire();
+	for(uint32 i = 0; i < NUM_MAPS; ++i)
+	{
+		if(m_singleMaps[i] != NULL)
+			m_singleMaps[i]->AddMetrics(maps[i]);
+
+		instancemap = m_instances[i];
+		if(instancemap == NULL)
+			continue;
+
+		for(itr = instancemap->begin(); itr != instancemap->end(); ++itr)
+		{
+			if(itr->second->m_mapMgr != NULL)
+				itr->second->m_mapMgr->AddMetrics(maps[i]);
+		}
+	}
+	m_mapLock.Release();
+}
+
 void InstanceMgr::_LoadInstances()
 {
 	MapInfo* inf;
@@ -145,6 +145,7 @@ public:
 
 	uint32 GenerateInstanceID();
 	void BuildXMLStats(char * m_file);
+	void GetMapMetrics(MapMetrics * maps);		// NUM_MAPS entries, added to
 	void Load(TaskList * l);
 	void Load(uint32 mapid);
 
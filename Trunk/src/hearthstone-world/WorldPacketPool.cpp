@@ -0,0 +1,226 @@
+/***
+ * Demonstrike Core
+ */
+
+#include "StdAfx.h"
+
+#define PACKET_POOL_MAX_CACHED 512		// per thread and size class
+
+static const size_t s_sizeClasses[NUM_PACKET_SIZE_CLASSES] = { 64, 256, 1024, 4096 };
+
+struct WorldPacketCache
+{
+	PooledWorldPacket * FreeList[NUM_PACKET_SIZE_CLASSES];
+	uint32 FreeCount[NUM_PACKET_SIZE_CLASSES];
+
+	// Packets other threads freed, only touched under ReturnLock
+	Mutex ReturnLock;
+	PooledWorldPacket * Returned[NUM_PACKET_SIZE_CLASSES];
+	uint32 ReturnedCount[NUM_PACKET_SIZE_CLASSES];
+	volatile bool HasReturns;
+	bool Retired;						// owner thread exited, under ReturnLock
+
+	uint64 Allocations;
+	uint64 PoolHits;
+	uint64 LocalFrees;
+	uint64 RemoteFrees;
+
+	WorldPacketCache() : HasReturns(false), Retired(false), Allocations(0), PoolHits(0), LocalFrees(0), RemoteFrees(0)
+	{
+		for(uint32 i = 0; i < NUM_PACKET_SIZE_CLASSES; ++i)
+		{
+			FreeList[i] = Returned[i] = NULL;
+			FreeCount[i] = ReturnedCount[i] = 0;
+		}
+	}
+
+	void TakeReturns()
+	{
+		ReturnLock.Acquire();
+		for(uint32 i = 0; i < NUM_PACKET_SIZE_CLASSES; ++i)
+		{
+			while(Returned[i] != NULL)
+			{
+				PooledWorldPacket * packet = Returned[i];
+				Returned[i] = packet->m_nextFree;
+				packet->m_nextFree = FreeList[i];
+				FreeList[i] = packet;
+			}
+			FreeCount[i] += ReturnedCount[i];
+			ReturnedCount[i] = 0;
+		}
+		HasReturns = false;
+		ReturnLock.Release();
+	}
+};
+
+// Packets in flight point at their cache, so a cache outlives its thread. An exiting
+// thread frees its packets and leaves the cache for the next thread that needs one.
+static Mutex s_cacheListLock;
+static std::vector<WorldPacketCache*> s_caches;
+static std::vector<WorldPacketCache*> s_idleCaches;
+static THREAD_LOCAL WorldPacketCache * t_packetCache = NULL;
+
+static WorldPacketCache * GetThreadPacketCache()
+{
+	WorldPacketCache * cache = t_packetCache;
+	if(cache == NULL)
+	{
+		s_cacheListLock.Acquire();
+		if(s_idleCaches.size())
+		{
+			cache = s_idleCaches.back();
+			s_idleCaches.pop_back();
+			cache->ReturnLock.Acquire();
+			cache->Retired = false;
+			cache->ReturnLock.Release();
+		}
+		else
+		{
+			cache = new WorldPacketCache;
+			s_caches.push_back(cache);
+		}
+		s_cacheListLock.Release();
+		t_packetCache = cache;
+	}
+	return cache;
+}
+
+void WorldPacketPool::ReleaseThreadCache()
+{
+	WorldPacketCache * cache = t_packetCache;
+	if(cache == NULL)
+		return;
+
+	// From here on packets freed elsewhere are deleted rather than returned to us
+	t_packetCache = NULL;
+	cache->ReturnLock.Acquire();
+	cache->Retired = true;
+	cache->ReturnLock.Release();
+
+	cache->TakeReturns();
+	for(uint32 i = 0; i < NUM_PACKET_SIZE_CLASSES; ++i)
+	{
+		while(cache->FreeList[i] != NULL)
+		{
+			PooledWorldPacket * packet = cache->FreeList[i];
+			cache->FreeList[i] = packet->m_nextFree;
+			delete packet;
+		}
+		cache->FreeCount[i] = 0;
+	}
+
+	s_cacheListLock.Acquire();
+	s_idleCaches.push_back(cache);
+	s_cacheListLock.Release();
+}
+
+WorldPacket * WorldPacketPool::Allocate(uint16 opcode, size_t size)
+{
+	WorldPacketCache * cache = GetThreadPacketCache();
+	++cache->Allocations;
+
+	uint8 sizeClass = PACKET_SIZE_CLASS_NONE;
+	for(uint8 i = 0; i < NUM_PACKET_SIZE_CLASSES; ++i)
+	{
+		if(size <= s_sizeClasses[i])
+		{
+			sizeClass = i;
+			break;
+		}
+	}
+
+	if(sizeClass == PACKET_SIZE_CLASS_NONE)
+		return new PooledWorldPacket(opcode, size, NULL, PACKET_SIZE_CLASS_NONE);
+
+	if(cache->FreeList[sizeClass] == NULL && cache->HasReturns)
+		cache->TakeReturns();
+
+	PooledWorldPacket * packet = cache->FreeList[sizeClass];
+	if(packet == NULL)
+		return new PooledWorldPacket(opcode, s_sizeClasses[sizeClass], cache, sizeClass);
+
+	cache->FreeList[sizeClass] = packet->m_nextFree;
+	--cache->FreeCount[sizeClass];
+	++cache->PoolHits;
+	packet->m_nextFree = NULL;
+	packet->Initialize(opcode);
+	return packet;
+}
+
+void WorldPacketPool::Free(WorldPacket * packet)
+{
+	if(packet == NULL)
+		return;
+
+	PooledWorldPacket * pooled = static_cast<PooledWorldPacket*>(packet);
+	WorldPacketCache * owner = pooled->m_owner;
+	uint8 sizeClass = pooled->m_sizeClass;
+	if(sizeClass == PACKET_SIZE_CLASS_SHARED)
+	{
+		if(--static_cast<SharedWorldPacket*>(pooled)->m_references == 0)
+			delete pooled;
+		return;
+	}
+
+	// Don't hang on to packets that grew well past their class
+	if(owner == NULL || sizeClass >= NUM_PACKET_SIZE_CLASSES || pooled->GetCapacity() > (s_sizeClasses[sizeClass] << 2))
+	{
+		delete pooled;
+		return;
+	}
+
+	if(owner == t_packetCache)
+	{
+		if(owner->FreeCount[sizeClass] >= PACKET_POOL_MAX_CACHED)
+		{
+			delete pooled;
+			return;
+		}
+
+		pooled->m_nextFree = owner->FreeList[sizeClass];
+		owner->FreeList[sizeClass] = pooled;
+		++owner->FreeCount[sizeClass];
+		++owner->LocalFrees;
+		return;
+	}
+
+	owner->ReturnLock.Acquire();
+	if(owner->Retired || owner->ReturnedCount[sizeClass] >= PACKET_POOL_MAX_CACHED)
+	{
+		owner->ReturnLock.Release();
+		delete pooled;
+		return;
+	}
+
+	pooled->m_nextFree = owner->Returned[sizeClass];
+	owner->Returned[sizeClass] = pooled;
+	++owner->ReturnedCount[sizeClass];
+	++owner->RemoteFrees;
+	owner->HasReturns = true;
+	owner->ReturnLock.Release();
+}
+
+SharedWorldPacket * WorldPacketPool::Share(const WorldPacket & packet)
+{
+	return new SharedWorldPacket(packet);
+}
+
+void WorldPacketPool::GetStats(WorldPacketPoolStats & stats)
+{
+	memset(&stats, 0, sizeof(stats));
+	s_cacheListLock.Acquire();
+	for(std::vector<WorldPacketCache*>::iterator itr = s_caches.begin(); itr != s_caches.end(); ++itr)
+	{
+		// The owners keep counting while we read, close enough for a report
+		WorldPacketCache * cache = *itr;
+		stats.Allocations += cache->Allocations;
+		stats.PoolHits += cache->PoolHits;
+		stats.LocalFrees += cache->LocalFrees;
+		stats.RemoteFrees += cache->RemoteFrees;
+		for(uint32 i = 0; i < NUM_PACKET_SIZE_CLASSES; ++i)
+			stats.Cached += cache->FreeCount[i] + cache->ReturnedCount[i];
+	}
+	stats.Threads = uint32(s_caches.size() - s_idleCaches.size());
+	s_cacheListLock.Release();
+}
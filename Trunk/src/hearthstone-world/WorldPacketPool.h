@@ -0,0 +1,80 @@
+/***
+ * Demonstrike Core
+ */
+
+#pragma once
+
+struct WorldPacketCache;
+
+/************************************************************************/
+/* Pooled packets for the socket and session queues                     */
+/************************************************************************/
+// Received packets are made on the socket threads and freed on the map
+// threads, queued outgoing ones the other way round. Every thread keeps its
+// own free lists per size class, so allocating never takes a lock. A packet
+// freed on another thread goes back on its owner's return list, which the
+// owner takes over in one go once its own list runs dry. Pooled packets keep
+// the storage they were reserved with, so common opcodes never reallocate.
+
+enum WorldPacketSizeClass
+{
+	PACKET_SIZE_CLASS_64		= 0,
+	PACKET_SIZE_CLASS_256		= 1,
+	PACKET_SIZE_CLASS_1024		= 2,
+	PACKET_SIZE_CLASS_4096		= 3,
+	NUM_PACKET_SIZE_CLASSES,
+	PACKET_SIZE_CLASS_NONE		= NUM_PACKET_SIZE_CLASSES,
+	PACKET_SIZE_CLASS_SHARED,
+};
+
+class PooledWorldPacket : public WorldPacket
+{
+public:
+	PooledWorldPacket(uint16 opcode, size_t res, WorldPacketCache * owner, uint8 sizeClass)
+		: WorldPacket(opcode, res), m_owner(owner), m_sizeClass(sizeClass), m_nextFree(NULL) {}
+
+	HEARTHSTONE_INLINE size_t GetCapacity() const { return _storage.capacity(); }
+
+	WorldPacketCache * m_owner;
+	uint8 m_sizeClass;
+	PooledWorldPacket * m_nextFree;
+};
+
+// One copy of a broadcast, queued on every socket that had no room to send it
+// straight away. Each queue holds a reference, and so does the broadcaster
+// until it has been through all recipients.
+class SharedWorldPacket : public PooledWorldPacket
+{
+public:
+	SharedWorldPacket(const WorldPacket & packet) : PooledWorldPacket(packet.GetOpcode(), packet.size(), NULL, PACKET_SIZE_CLASS_SHARED)
+	{
+		if(packet.size())
+			append(packet.contents(), packet.size());
+		++m_references;
+	}
+
+	AtomicCounter m_references;
+};
+
+struct WorldPacketPoolStats
+{
+	uint64 Allocations;
+	uint64 PoolHits;
+	uint64 LocalFrees;
+	uint64 RemoteFrees;
+	uint64 Cached;
+	uint32 Threads;
+};
+
+class SERVER_DECL WorldPacketPool
+{
+public:
+	// Use instead of new WorldPacket for anything going through _recvQueue or the socket queue
+	static WorldPacket * Allocate(uint16 opcode, size_t size);
+	// Any thread, only for packets from Allocate or Share; shared ones lose a reference
+	static void Free(WorldPacket * packet);
+	static SharedWorldPacket * Share(const WorldPacket & packet);
+	// On a thread that is about to exit, frees the packets it has cached
+	static void ReleaseThreadCache();
+	static void GetStats(WorldPacketPoolStats & stats);
+};
@@ -62,7 +62,7 @@ WorldSession::~WorldSession()
 	WorldPacket *packet;
 
 	while((packet = _recvQueue.Pop()))
-		delete packet;
+		WorldPacketPool::Free(packet);
 
 	for(uint32 x= 0;x<8;x++)
 	{
@@ -152,6 +152,7 @@ int WorldSession::Update(uint32 InstanceID)
 						{
 							bool fail = false;
 							packet->opcodename = LookupOpcodeName(packet->GetOpcode()); // Needed for ByteBuffer
+							uint64 handlerStart = getUSTime();
 							try
 							{
 								(this->*Handler->handler)(*packet);
@@ -162,6 +163,11 @@ int WorldSession::Update(uint32 InstanceID)
 								Log.Error("WorldSession", "Incorrect handling of opcode %s (0x%.4X) REPORT TO DEVS", LookupOpcodeName(packet->GetOpcode()), packet->GetOpcode());
 							}
 
+							uint32 handlerUs = uint32(getUSTime() - handlerStart);
+							OpcodeStats::Record(packet->GetOpcode(), handlerUs);
+							if(sWorld.m_slowHandlerThreshold && handlerUs >= sWorld.m_slowHandlerThreshold)
+								LogSlowHandler(packet->GetOpcode(), handlerUs);
+
 							if(!fail && sLog.IsOutProccess() && (packet->rpos() < packet->wpos()))
 								LogUnprocessedTail(packet);
 
@@ -173,7 +179,7 @@ int WorldSession::Update(uint32 InstanceID)
 				}
 			}
 
-			delete packet;
+			WorldPacketPool::Free(packet);
 			packet = NULL;
 			if(InstanceID != instanceId)
 				return 2; // If we hit this it means that an opcode has changed our map.
@@ -1007,6 +1013,21 @@ void WorldSession::LogUnprocessedTail(WorldPacket *packet)
 	packet->print_storage();
 }
 
+void WorldSession::LogSlowHandler(uint16 opcode, uint32 us)
+{
+	// The handler may have logged the player out or moved them, so look at where they are now
+	if(_player != NULL)
+	{
+		Log.Warning("WorldSession", "Slow handler: %s (0x%.4X) took %u ms for %s (account %s), map %u instance %u",
+			LookupOpcodeName(opcode), opcode, us / 1000, _player->GetName(), GetAccountNameS(), _player->GetMapId(), _player->GetInstanceID());
+	}
+	else
+	{
+		Log.Warning("WorldSession", "Slow handler: %s (0x%.4X) took %u ms for account %s, not in world",
+			LookupOpcodeName(opcode), opcode, us / 1000, GetAccountNameS());
+	}
+}
+
 void WorldSession::SystemMessage(const char * format, ...)
 {
 	WorldPacket * data;
@@ -1071,6 +1092,15 @@ void WorldSession::SendPacket(WorldPacket* packet)
 		_socket->SendPacket(packet, World);
 }
 
+void WorldSession::SendSharedPacket(WorldPacket * packet, SharedWorldPacket *& shared)
+{
+	bool World = false;
+	if(_player && _player->IsInWorld())
+		World = true;
+	if(_socket && _socket->IsConnected())
+		_socket->SendSharedPacket(packet, shared, World);
+}
+
 void WorldSession::OutPacket(uint16 opcode, uint16 len, const void* data)
 {
 	bool World = false;
@@ -1751,3 +1781,16 @@ void WorldSession::SendGossipForObject(Object* pObject)
 		}break;
 	}
 }
+
+bool WorldSession::DeferUntilPlayerInfoLoaded(uint32 guid, WorldPacket & recv_data)
+{
+	if(guid == 0)
+		return false;
+
+	// Queued on _recvQueue, so it has to come from the pool like any received packet
+	WorldPacket * replay = WorldPacketPool::Allocate(recv_data.GetOpcode(), recv_data.size());
+	if(recv_data.size())
+		replay->append(recv_data.contents(), recv_data.size());
+	objmgr.LoadPlayerInfoAsync(guid, GetAccountId(), replay);
+	return true;
+}
@@ -17,6 +17,7 @@ class MapMgr;
 class Creature;
 class MovementInfo;
 struct TrainerSpell;
+struct PlayerInfo;
 
 //#define SESSION_CAP 5
 
@@ -199,13 +200,17 @@ public:
 
 	HEARTHSTONE_INLINE void SendPacket(WorldPacket* packet);
 	void OutPacket(uint16 opcode, uint16 len = 0, const void* data = NULL);
+	// Broadcast send, see WorldSocket::SendSharedPacket; release shared with WorldPacketPool::Free once done
+	void SendSharedPacket(WorldPacket * packet, SharedWorldPacket *& shared);
 
 	void Delete();
 
 	void SendChatPacket(WorldPacket * data, uint32 langpos, int32 lang, WorldSession * originator);
+	void SendNameQueryResponse(PlayerInfo * pn);
 
 	// Process Logs
 	void LogUnprocessedTail(WorldPacket *packet);
+	void LogSlowHandler(uint16 opcode, uint32 us);
 
 	uint32 m_currMsTime;
 	uint32 m_lastPing;
@@ -283,6 +288,10 @@ public:
 		_recvQueue.Push(packet);
 	}
 
+	// For handlers that need a character who isn't resident: loads them in the background and
+	// handles recv_data again once they are in. False if there is no such character.
+	bool DeferUntilPlayerInfoLoaded(uint32 guid, WorldPacket & recv_data);
+
 	HEARTHSTONE_INLINE WorldSocket* GetSocket() { return _socket; }
 
 	void Disconnect()
@@ -39,6 +39,7 @@ WorldSocket::WorldSocket(SOCKET fd, const sockaddr_in * peer) : TcpSocket(fd, WO
 	mRequestID = 0;
 	m_nagleEanbled = false;
 	m_fullAccountName = NULL;
+	queueLock.SetLockName("WorldSocket::queueLock");
 }
 
 WorldSocket::~WorldSocket()
@@ -46,11 +47,11 @@ WorldSocket::~WorldSocket()
 	WorldPacket * pck;
 	queueLock.Acquire();
 	while((pck = _queue.Pop()))
-		delete pck;
+		WorldPacketPool::Free(pck);
 	queueLock.Release();
 
 	if(pAuthenticationPacket)
-		delete pAuthenticationPacket;
+		WorldPacketPool::Free(pAuthenticationPacket);
 
 	if(mSession)
 	{
@@ -89,7 +90,7 @@ void WorldSocket::OnDisconnect()
 	queueLock.Acquire();
 	WorldPacket *pck;
 	while((pck = _queue.Pop()))
-		delete pck;
+		WorldPacketPool::Free(pck);
 	queueLock.Release();
 }
 
@@ -110,8 +111,7 @@ void WorldSocket::OutPacket(uint16 opcode, size_t len, const void* data, bool In
 	{
 		/* queue the packet */
 		queueLock.Acquire();
-		WorldPacket *pck = new WorldPacket(opcode, len);
-		pck->SetOpcode(opcode);
+		WorldPacket *pck = WorldPacketPool::Allocate(opcode, len);
 		if(len)
 			pck->append((const uint8*)data, len);
 		_queue.Push(pck);
@@ -119,6 +119,27 @@ void WorldSocket::OutPacket(uint16 opcode, size_t len, const void* data, bool In
 	}
 }
 
+void WorldSocket::SendSharedPacket(WorldPacket * packet, SharedWorldPacket *& shared, bool InWorld)
+{
+	size_t len = packet->size();
+	if( (len + 10) > WORLDSOCKET_SENDBUF_SIZE )
+	{
+		printf("WARNING: Tried to send a packet of %u bytes (which is too large) to a socket. Opcode was: %u (0x%03X)\n", uint(len), uint(packet->GetOpcode()), uint(packet->GetOpcode()));
+		return;
+	}
+
+	if(_OutPacket(packet->GetOpcode(), len, len ? packet->contents() : NULL, InWorld) != OUTPACKET_RESULT_NO_ROOM_IN_BUFFER)
+		return;
+
+	if(shared == NULL)
+		shared = WorldPacketPool::Share(*packet);
+
+	queueLock.Acquire();
+	++shared->m_references;
+	_queue.Push(shared);
+	queueLock.Release();
+}
+
 void WorldSocket::UpdateQueuedPackets()
 {
 	queueLock.Acquire();
@@ -136,7 +157,7 @@ void WorldSocket::UpdateQueuedPackets()
 		{
 		case OUTPACKET_RESULT_SUCCESS:
 			{
-				delete pck;
+				WorldPacketPool::Free(pck);
 				_queue.pop_front();
 			}break;
 
@@ -151,7 +172,7 @@ void WorldSocket::UpdateQueuedPackets()
 			{
 				/* kill everything in the buffer */
 				while((pck = _queue.Pop()))
-					delete pck;
+					WorldPacketPool::Free(pck);
 				queueLock.Release();
 				return;
 			}break;
@@ -453,7 +474,7 @@ void WorldSocket::Authenticate()
 	sAddonMgr.SendAddonInfoPacket(pAuthenticationPacket, (uint32)pAuthenticationPacket->rpos(), pSession);
 	pSession->_latency = _latency;
 
-	delete pAuthenticationPacket;
+	WorldPacketPool::Free(pAuthenticationPacket);
 	pAuthenticationPacket = NULL;
 
 	sWorld.AddSession(pSession);
@@ -542,7 +563,7 @@ void WorldSocket::OnRecvData()
 			}
 		}
 
-		WorldPacket *Packet = new WorldPacket(mOpcode, mSize);
+		WorldPacket *Packet = WorldPacketPool::Allocate(mOpcode, mSize);
 		if(mRemaining > 0)
 		{
 			Packet->resize(mRemaining);
@@ -559,7 +580,7 @@ void WorldSocket::OnRecvData()
 		case CMSG_PING:
 			{
 				_HandlePing(Packet);
-				delete Packet;
+				WorldPacketPool::Free(Packet);
 			}break;
 		case CMSG_AUTH_SESSION:
 			{
@@ -571,7 +592,7 @@ void WorldSocket::OnRecvData()
 					mSession->QueuePacket(Packet);
 				else
 				{
-					delete Packet;
+					WorldPacketPool::Free(Packet);
 					Packet = NULL;
 				}
 			}break;
@@ -32,6 +32,8 @@ public:
 	HEARTHSTONE_INLINE void SendPacket(WorldPacket* packet, bool inWorld = false) { if(!packet) return; OutPacket(packet->GetOpcode(), packet->size(), (packet->size() ? (const void*)packet->contents() : NULL), inWorld); }
 
 	void __fastcall OutPacket(uint16 opcode, size_t len, const void* data, bool InWorld = false);
+	// For broadcasts; if there's no room, queues shared (made on first need) instead of a copy
+	void SendSharedPacket(WorldPacket * packet, SharedWorldPacket *& shared, bool InWorld = false);
 	OUTPACKET_RESULT __fastcall _OutPacket(uint16 opcode, size_t len, const void* data, bool InWorld = false);
 
 	HEARTHSTONE_INLINE uint32 GetLatency() { return _latency; }
@@ -558,3 +558,44 @@ bool ChatHandler::HandleSetPlayerStartLocation(const char* args, WorldSession *m
 
 	return true;
 }
+
+bool ChatHandler::HandleDebugPoolStatsCommand(const char* args, WorldSession *m_session)
+{
+	ObjectPoolStats stats;
+	ObjectPool<Spell>::GetStats(stats);
+	GreenSystemMessage(m_session, "Spell pool: %u allocations, %u recycled, %u in use, %u cached, %u poison faults.",
+		uint32(stats.allocations), uint32(stats.recycled), uint32(stats.inUse), uint32(stats.cached), uint32(stats.poisonFaults));
+
+	ObjectPool<Aura>::GetStats(stats);
+	GreenSystemMessage(m_session, "Aura pool: %u allocations, %u recycled, %u in use, %u cached, %u poison faults.",
+		uint32(stats.allocations), uint32(stats.recycled), uint32(stats.inUse), uint32(stats.cached), uint32(stats.poisonFaults));
+	return true;
+}
+
+bool ChatHandler::HandleDebugOpcodeStatsCommand(const char* args, WorldSession *m_session)
+{
+	if(args != NULL && !stricmp(args, "reset"))
+	{
+		OpcodeStats::Reset();
+		GreenSystemMessage(m_session, "Opcode handler stats reset.");
+		return true;
+	}
+
+	uint32 count = 10;
+	if(args != NULL && *args)
+		count = atoi(args);
+	if(count == 0)
+		return false;
+
+	std::vector<OpcodeHandlerStats> stats;
+	OpcodeStats::GetStats(stats);
+	uint32 seconds = OpcodeStats::GetSecondsSinceReset();
+	GreenSystemMessage(m_session, "%u handlers used over the last %u seconds, busiest first:", uint32(stats.size()), seconds);
+	for(uint32 i = 0; i < stats.size() && i < count; ++i)
+	{
+		OpcodeHandlerStats & s = stats[i];
+		SystemMessage(m_session, "%s: %u calls, %u ms total, avg %u us, p50 %u us, p99 %u us, max %u us", LookupOpcodeName(s.Opcode),
+			uint32(s.Count), uint32(s.TotalUs / 1000), uint32(s.TotalUs / s.Count), s.GetPercentile(50), s.GetPercentile(99), s.MaxUs);
+	}
+	return true;
+}
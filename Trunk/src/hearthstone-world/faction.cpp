@@ -4,6 +4,111 @@
 
 #include "StdAfx.h"
 
+#define UNIT_FLAGS_UNTARGETABLE (UNIT_FLAG_NOT_ATTACKABLE_9 | UNIT_FLAG_MOUNTED_TAXI | UNIT_FLAG_NOT_SELECTABLE)
+
+/************************************************************************/
+/* Template relations                                                   */
+/************************************************************************/
+// The template against template part of the checks below only depends on the
+// DBC, so it is worked out once for every pair and kept two bits a pair. A
+// template is keyed by its row in the DBC block, which can't go stale however
+// an object's m_faction gets set.
+
+#define FACTION_RELATION_HOSTILE		1	// A's masks and lists make B hostile
+#define FACTION_RELATION_HOSTILE_EITHER	2	// either side's masks and lists do
+
+static FactionTemplateDBC * s_factionRelationBase = NULL;
+static uint32 s_factionRelationCount = 0;
+static uint8 * s_factionRelations = NULL;
+
+static bool CalcTemplateHostile(FactionTemplateDBC * a, FactionTemplateDBC * b)
+{
+	bool hostile = false;
+	// Check our hostile and non hostile faction masks
+	if(a->HostileMask & b->FactionMask || b->HostileMask & a->FactionMask)
+		hostile = true;
+
+	// check friend/enemy list
+	for(uint32 i = 0; i < 4; i++)
+	{
+		if(a->EnemyFactions[i] && a->EnemyFactions[i] == b->Faction)
+			hostile = true;
+
+		if(a->FriendlyFactions[i] && a->FriendlyFactions[i] == b->Faction)
+			hostile = false;
+	}
+	return hostile;
+}
+
+static bool CalcTemplateHostileEither(FactionTemplateDBC * a, FactionTemplateDBC * b)
+{
+	bool hostile = false;
+	// Check our hostile and non hostile faction masks
+	if(a->HostileMask & b->FactionMask || b->HostileMask & a->FactionMask)
+		hostile = true;
+
+	// check friend/enemy list
+	for(uint32 i = 0; i < 4; i++)
+	{
+		if(a->EnemyFactions[i] && a->EnemyFactions[i] == b->Faction)
+			hostile = true;
+		if(a->FriendlyFactions[i] && a->FriendlyFactions[i] == b->Faction)
+			hostile = false;
+		if(b->EnemyFactions[i] && b->EnemyFactions[i] == a->Faction)
+			hostile = true;
+		if(b->FriendlyFactions[i] && b->FriendlyFactions[i] == a->Faction)
+			hostile = false;
+	}
+	return hostile;
+}
+
+static uint8 CalcFactionRelation(FactionTemplateDBC * a, FactionTemplateDBC * b)
+{
+	return (CalcTemplateHostile(a, b) ? FACTION_RELATION_HOSTILE : 0) | (CalcTemplateHostileEither(a, b) ? FACTION_RELATION_HOSTILE_EITHER : 0);
+}
+
+static HEARTHSTONE_INLINE uint32 GetFactionRelationIndex(FactionTemplateDBC * faction)
+{
+	return uint32(((uintptr_t)faction - (uintptr_t)s_factionRelationBase) / sizeof(FactionTemplateDBC));
+}
+
+static HEARTHSTONE_INLINE uint8 GetFactionRelation(FactionTemplateDBC * a, FactionTemplateDBC * b)
+{
+	// Anything not in the DBC block (or before the table is built) takes the long way
+	uint32 ia = GetFactionRelationIndex(a), ib = GetFactionRelationIndex(b);
+	if(s_factionRelations == NULL || ia >= s_factionRelationCount || ib >= s_factionRelationCount)
+		return CalcFactionRelation(a, b);
+
+	size_t pair = size_t(ia) * s_factionRelationCount + ib;
+	return (s_factionRelations[pair >> 2] >> ((pair & 3) << 1)) & 3;
+}
+
+void BuildFactionRelations()
+{
+	uint32 start = getMSTime();
+	uint32 count = dbcFactionTemplate.GetNumRows();
+	if(count == 0)
+		return;
+
+	FactionTemplateDBC * base = *dbcFactionTemplate.begin();
+	size_t pairs = size_t(count) * count;
+	uint8 * relations = new uint8[(pairs + 3) >> 2];
+	memset(relations, 0, (pairs + 3) >> 2);
+	for(uint32 a = 0; a < count; ++a)
+	{
+		for(uint32 b = 0; b < count; ++b)
+		{
+			size_t pair = size_t(a) * count + b;
+			relations[pair >> 2] |= CalcFactionRelation(&base[a], &base[b]) << ((pair & 3) << 1);
+		}
+	}
+
+	s_factionRelationBase = base;
+	s_factionRelationCount = count;
+	s_factionRelations = relations;
+	Log.Notice("World", "Built faction relations for %u templates (%u KB) in %u ms.", count, uint32(((pairs + 3) >> 2) / 1024), getMSTime() - start);
+}
+
 /// Where we check if we object A can attack object B. This is used in many feature's
 /// Including the spell class, the player class, and the AI interface class.
 int intisAttackable(Object* objA, Object* objB, bool CheckStealth)// A can attack B?
@@ -15,10 +120,6 @@ int intisAttackable(Object* objA, Object* objB, bool CheckStealth)// A can attac
 	if( !objA->IsInWorld() )
 		return 0;
 
-	MapMgr* mgr = objA->GetMapMgr();
-
-	uint32 AreaIDobjA = objA->GetAreaID(mgr), AreaIDobjB = objB->GetAreaID(mgr);
-
 	// can't attack corpses neither...
 	if( objA->GetTypeId() == TYPEID_CORPSE || objB->GetTypeId() == TYPEID_CORPSE )
 		return 0;
@@ -28,12 +129,10 @@ int intisAttackable(Object* objA, Object* objB, bool CheckStealth)// A can attac
 		return 0;
 
 	// Checks for untouchable, unattackable
-	if( objA->IsUnit() && (objA->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NOT_ATTACKABLE_9) ||
-		objA->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_MOUNTED_TAXI) || objA->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NOT_SELECTABLE)))
+	if( objA->IsUnit() && objA->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAGS_UNTARGETABLE) )
 		return 0;
 
-	if( objB->IsUnit() && (objB->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NOT_ATTACKABLE_9) ||
-		objB->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_MOUNTED_TAXI) || objB->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NOT_SELECTABLE)))
+	if( objB->IsUnit() && objB->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAGS_UNTARGETABLE) )
 		return 0;
 
 	if(!objA->PhasedCanInteract(objB))
@@ -113,6 +212,10 @@ int intisAttackable(Object* objA, Object* objB, bool CheckStealth)// A can attac
 		}
 	}
 
+	// Area lookups hit the terrain, so only do them once the cheap checks have passed
+	MapMgr* mgr = objA->GetMapMgr();
+	uint32 AreaIDobjA = objA->GetAreaID(mgr), AreaIDobjB = objB->GetAreaID(mgr);
+
 	// Do not let units attack each other in sanctuary
 	// We know they aren't dueling
 	if(sWorld.IsSanctuaryMap(objA->GetMapId()))
@@ -255,21 +358,7 @@ int intisAttackable(Object* objA, Object* objB, bool CheckStealth)// A can attac
 	if(objA->m_faction == objB->m_faction)
 		return 0;
 
-	bool hostile = false;
-	// Check our hostile and non hostile faction masks
-	if(objA->m_faction->HostileMask & objB->m_faction->FactionMask
-		|| objB->m_faction->HostileMask & objA->m_faction->FactionMask)
-		hostile = true;
-
-	// check friend/enemy list
-	for(uint32 i = 0; i < 4; i++)
-	{
-		if(objA->m_faction->EnemyFactions[i] && objA->m_faction->EnemyFactions[i] == objB->m_faction->Faction)
-			hostile = true;
-
-		if(objA->m_faction->FriendlyFactions[i] && objA->m_faction->FriendlyFactions[i] == objB->m_faction->Faction)
-			hostile = false;
-	}
+	bool hostile = ((GetFactionRelation(objA->m_faction, objB->m_faction) & FACTION_RELATION_HOSTILE) != 0);
 
 	// Reputation System Checks
 	if(player_objA && !player_objB)
@@ -303,10 +392,6 @@ bool CanEitherUnitAttack(Object* objA, Object* objB, bool CheckStealth)// A can
 	if( !objA->IsInWorld() || !objB->IsInWorld() )
 		return false;
 
-	MapMgr* mgr = objA->GetMapMgr();
-
-	uint32 AreaIDobjA = objA->GetAreaID(mgr), AreaIDobjB = objB->GetAreaID(mgr);
-
 	// We do need all factiondata for this
 	if( (objB->m_factionDBC == NULL || objA->m_factionDBC == NULL || objB->m_faction == NULL || objA->m_faction == NULL) || (
 		((objA->IsPlayer() && !TO_PLAYER(objA)->IsFFAPvPFlagged()) ? true : false) && 
@@ -323,12 +408,10 @@ bool CanEitherUnitAttack(Object* objA, Object* objB, bool CheckStealth)// A can
 		return false;
 
 	// Checks for untouchable, unattackable
-	if( objA->IsUnit() && (objA->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NOT_ATTACKABLE_9) ||
-		objA->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_MOUNTED_TAXI) || objA->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NOT_SELECTABLE)))
+	if( objA->IsUnit() && objA->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAGS_UNTARGETABLE) )
 		return false;
 
-	if( objB->IsUnit() && (objB->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NOT_ATTACKABLE_9) ||
-		objB->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_MOUNTED_TAXI) || objB->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NOT_SELECTABLE)))
+	if( objB->IsUnit() && objB->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAGS_UNTARGETABLE) )
 		return false;
 
 	if(!objA->PhasedCanInteract(objB) || !objB->PhasedCanInteract(objA))
@@ -374,6 +457,10 @@ bool CanEitherUnitAttack(Object* objA, Object* objB, bool CheckStealth)// A can
 	if(objA->IsCreature() && isTargetDummy(objA->GetEntry()))
 		return false; // Bwahahaha
 
+	// Area lookups hit the terrain, so only do them once the cheap checks have passed
+	MapMgr* mgr = objA->GetMapMgr();
+	uint32 AreaIDobjA = objA->GetAreaID(mgr), AreaIDobjB = objB->GetAreaID(mgr);
+
 	if( player_objA && player_objB )
 	{
 		if(player_objA->DuelingWith == player_objB && player_objA->GetDuelState() == DUEL_STATE_STARTED )
@@ -500,24 +587,7 @@ bool CanEitherUnitAttack(Object* objA, Object* objB, bool CheckStealth)// A can
 		return true; // Skip the rest of this, it's all faction shit.
 	}
 
-	bool hostile = false;
-	// Check our hostile and non hostile faction masks
-	if(objA->m_faction->HostileMask & objB->m_faction->FactionMask
-		|| objB->m_faction->HostileMask & objA->m_faction->FactionMask)
-		hostile = true;
-
-	// check friend/enemy list
-	for(uint32 i = 0; i < 4; i++)
-	{
-		if(objA->m_faction->EnemyFactions[i] && objA->m_faction->EnemyFactions[i] == objB->m_faction->Faction)
-			hostile = true;
-		if(objA->m_faction->FriendlyFactions[i] && objA->m_faction->FriendlyFactions[i] == objB->m_faction->Faction)
-			hostile = false;
-		if(objB->m_faction->EnemyFactions[i] && objB->m_faction->EnemyFactions[i] == objA->m_faction->Faction)
-			hostile = true;
-		if(objB->m_faction->FriendlyFactions[i] && objB->m_faction->FriendlyFactions[i] == objA->m_faction->Faction)
-			hostile = false;
-	}
+	bool hostile = ((GetFactionRelation(objA->m_faction, objB->m_faction) & FACTION_RELATION_HOSTILE_EITHER) != 0);
 
 	// Reputation System Checks
 	if(player_objA && !player_objB)
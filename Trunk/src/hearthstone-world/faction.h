@@ -20,6 +20,9 @@ SERVER_DECL bool isCombatSupport(Object* objA, Object* objB); // B combat suppor
 SERVER_DECL bool isAlliance(Object* objA); // A is alliance?
 SERVER_DECL bool CanEitherUnitAttack(Object* objA, Object* objB, bool CheckStealth = true);
 
+// Works out the template against template relations after the DBCs are loaded
+void BuildFactionRelations();
+
 HEARTHSTONE_INLINE bool isFriendly(Object* objA, Object* objB)// B is friendly to A if its not hostile
 {
 	return !isHostile(objA, objB);